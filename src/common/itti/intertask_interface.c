@@ -17,6 +17,8 @@
 
 #define _GNU_SOURCE
 #include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
 #include <malloc.h>
 #include <pthread.h>
 #include <signal.h>
@@ -26,6 +28,7 @@
 #include <string.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "bstrlib.h"
@@ -70,6 +73,9 @@ const int itti_debug = ITTI_DEBUG_ISSUES | ITTI_DEBUG_MP_STATISTICS;
 #define MESSAGE_SIZE(mESSAGEiD) \
   (sizeof(MessageHeader) + itti_desc.messages_info[mESSAGEiD].size)
 
+/* Sleep between two enqueue attempts with ITTI_QUEUE_FULL_BLOCK */
+#define ITTI_QUEUE_FULL_BLOCK_SLEEP_US 100
+
 #define VCD_SIGNAL_DUMPER_DUMP_VARIABLE_BY_NAME(...)
 #define VCD_SIGNAL_DUMPER_DUMP_FUNCTION_BY_NAME(...)
 #define VCD_SIGNAL_DUMPER_FUNCTIONS_ITTI_ENQUEUE_MESSAGE(...)
@@ -85,6 +91,7 @@ typedef enum task_state_s {
 /* This list acts as a FIFO of messages received by tasks (RRC, NAS, ...) */
 typedef struct message_list_s {
   MessageDef *msg;  ///< Pointer to the message
+  struct message_list_s *next;  ///< Next message in the overflow list
 
   message_number_t message_number;  ///< Unique message number
   uint32_t message_priority;        ///< Message priority
@@ -126,6 +133,13 @@ typedef struct thread_desc_s {
 
   int epoll_nb_events;
 
+  /*
+   * Set by itti_set_task_wake_if_sleeping(): senders only write the event fd
+   * when the task announced it is going to sleep in epoll_wait.
+   */
+  bool wake_if_sleeping;
+  bool sleeping;
+
   //#ifdef RTAI
   /*
    * Flag to mark real time thread
@@ -147,6 +161,40 @@ typedef struct task_desc_s {
   struct lfds710_queue_bmm_state message_queue
       __attribute__((aligned(LFDS710_PAL_ATOMIC_ISOLATION_IN_BYTES)));
   struct lfds710_queue_bmm_element *qbmme;
+
+  /*
+   * Messages that did not fit in the bounded queue (ITTI_QUEUE_FULL_OVERFLOW),
+   * received once the bounded queue is empty. While the list is not empty
+   * senders append to it, so that the messages of a sender stay ordered.
+   */
+  pthread_mutex_t overflow_mutex;
+  message_list_t *overflow_head;
+  message_list_t *overflow_tail;
+  uint32_t overflow_depth;
+
+  /*
+   * Only the messages of this id are subject to the policy, their senders
+   * release them when rejected; the others overflow
+   */
+  uint32_t queue_full_policy_message_id;
+  itti_queue_full_policy_t queue_full_policy;
+  uint32_t block_timeout_ms;
+
+  /*
+   * Queue counters, see itti_queue_stats_t
+   */
+  int32_t depth;
+  uint32_t high_watermark;
+  uint64_t nb_overflowed;
+  uint64_t nb_blocked;
+  uint64_t nb_rejected;
+
+  /*
+   * Overload watermarks in messages, 0 if the task is not monitored
+   */
+  uint32_t overload_start_depth;
+  uint32_t overload_stop_depth;
+  bool is_overloaded;
 } task_desc_t;
 
 typedef struct itti_desc_s {
@@ -172,6 +220,11 @@ typedef struct itti_desc_s {
 
   int running;
 
+  /*
+   * Number of monitored tasks currently overloaded
+   */
+  uint32_t nb_overloaded_tasks;
+
   volatile uint32_t created_tasks;
   volatile uint32_t ready_tasks;
   volatile int wait_tasks;
@@ -191,6 +244,10 @@ void *itti_malloc(task_id_t origin_task_id, task_id_t destination_task_id,
 
   ptr = memory_pools_allocate(itti_desc.memory_pools_handle, size,
                               origin_task_id, destination_task_id);
+  /*
+   * Pools grow when they run dry: only a size bigger than the biggest pool or
+   * the exhaustion of the system memory lead here
+   */
   if (ptr == NULL) {
     char *statistics = memory_pools_statistics(itti_desc.memory_pools_handle);
     OAILOG_ERROR(LOG_ITTI, " Memory pools statistics:\n%s", statistics);
@@ -215,6 +272,35 @@ void itti_print_DEBUG() {
   char *statistics = memory_pools_statistics(itti_desc.memory_pools_handle);
   OAILOG_INFO(LOG_ITTI, "Periodic memory pools statistics:\n%s", statistics);
   free_wrapper((void **)&statistics);
+  for (task_id_t task_id = TASK_FIRST; task_id < itti_desc.task_max;
+       task_id++) {
+    task_desc_t *task = &itti_desc.tasks[task_id];
+
+    if (task->high_watermark) {
+      OAILOG_INFO(LOG_ITTI,
+                  "Queue %-20s size %4u depth %4d high watermark %6u "
+                  "overflowed %" PRIu64 " blocked %" PRIu64
+                  " rejected %" PRIu64 "%s\n",
+                  itti_get_task_name(task_id),
+                  itti_desc.tasks_info[task_id].queue_size, task->depth,
+                  task->high_watermark, task->nb_overflowed, task->nb_blocked,
+                  task->nb_rejected, (task->is_overloaded) ? " OVERLOAD" : "");
+    }
+    if (task_id < MEMORY_POOLS_INFO_NUMBER) {
+      memory_pools_info_statistics_t memory_statistics;
+
+      memory_pools_get_info_statistics(itti_desc.memory_pools_handle, task_id,
+                                       &memory_statistics);
+      if (memory_statistics.alloc_number) {
+        OAILOG_INFO(LOG_ITTI,
+                    "Memory %-20s allocs %" PRIu64 " frees %" PRIu64
+                    " used %" PRId64 " high watermark %" PRId64 "\n",
+                    itti_get_task_name(task_id), memory_statistics.alloc_number,
+                    memory_statistics.free_number, memory_statistics.used,
+                    memory_statistics.high_watermark);
+      }
+    }
+  }
 }
 
 static inline message_number_t itti_increment_message_number(void) {
@@ -273,6 +359,227 @@ void itti_update_lte_time(__time_t seconds, __suseconds_t useconds) {
   itti_desc.lte_time.time.tv_usec = useconds;
 }
 
+static void itti_update_queue_depth(task_id_t task_id, int32_t delta) {
+  task_desc_t *task = &itti_desc.tasks[task_id];
+  int32_t depth = __atomic_add_fetch(&task->depth, delta, __ATOMIC_RELAXED);
+  uint32_t high_watermark = 0;
+  bool is_overloaded = false;
+
+  if (delta > 0) {
+    high_watermark = __atomic_load_n(&task->high_watermark, __ATOMIC_RELAXED);
+    while (((uint32_t)depth > high_watermark) &&
+           (!__atomic_compare_exchange_n(&task->high_watermark, &high_watermark,
+                                         (uint32_t)depth, true,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED))) {
+    }
+  }
+  if (!task->overload_start_depth) {
+    return;
+  }
+  is_overloaded = __atomic_load_n(&task->is_overloaded, __ATOMIC_RELAXED);
+  if ((!is_overloaded) && ((uint32_t)depth >= task->overload_start_depth)) {
+    if (__atomic_compare_exchange_n(&task->is_overloaded, &is_overloaded, true,
+                                    false, __ATOMIC_RELAXED,
+                                    __ATOMIC_RELAXED)) {
+      __atomic_add_fetch(&itti_desc.nb_overloaded_tasks, 1, __ATOMIC_RELEASE);
+      OAILOG_WARNING(LOG_ITTI, "Task %s overloaded, %d queued messages\n",
+                     itti_get_task_name(task_id), depth);
+    }
+  } else if ((is_overloaded) &&
+             ((uint32_t)depth <= task->overload_stop_depth)) {
+    if (__atomic_compare_exchange_n(&task->is_overloaded, &is_overloaded,
+                                    false, false, __ATOMIC_RELAXED,
+                                    __ATOMIC_RELAXED)) {
+      __atomic_sub_fetch(&itti_desc.nb_overloaded_tasks, 1, __ATOMIC_RELEASE);
+      OAILOG_NOTICE(LOG_ITTI, "Task %s no longer overloaded\n",
+                    itti_get_task_name(task_id));
+    }
+  }
+}
+
+static void itti_overflow_message(task_id_t task_id, message_list_t *new) {
+  task_desc_t *task = &itti_desc.tasks[task_id];
+
+  new->next = NULL;
+  pthread_mutex_lock(&task->overflow_mutex);
+  if (task->overflow_tail) {
+    task->overflow_tail->next = new;
+  } else {
+    task->overflow_head = new;
+  }
+  task->overflow_tail = new;
+  __atomic_add_fetch(&task->overflow_depth, 1, __ATOMIC_RELEASE);
+  task->nb_overflowed++;
+  pthread_mutex_unlock(&task->overflow_mutex);
+}
+
+/*
+ * Returns 0 if the message is queued, -1 if it has to be released
+ */
+static int itti_enqueue_message(task_id_t task_id, message_list_t *new) {
+  task_desc_t *task = &itti_desc.tasks[task_id];
+  itti_queue_full_policy_t policy = ITTI_QUEUE_FULL_OVERFLOW;
+  struct timespec now, deadline;
+
+  itti_update_queue_depth(task_id, 1);
+  if ((!__atomic_load_n(&task->overflow_depth, __ATOMIC_ACQUIRE)) &&
+      (lfds710_queue_bmm_enqueue(&task->message_queue, NULL, new))) {
+    return 0;
+  }
+
+  if (new->msg->ittiMsgHeader.messageId == task->queue_full_policy_message_id) {
+    policy = task->queue_full_policy;
+  }
+  switch (policy) {
+    case ITTI_QUEUE_FULL_BLOCK:
+      // A task waiting for room in its own queue would wait forever
+      if ((!__atomic_load_n(&task->overflow_depth, __ATOMIC_ACQUIRE)) &&
+          (itti_get_current_task_id() != task_id)) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += task->block_timeout_ms / 1000;
+        deadline.tv_nsec += (task->block_timeout_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+          deadline.tv_sec++;
+          deadline.tv_nsec -= 1000000000;
+        }
+        __atomic_add_fetch(&task->nb_blocked, 1, __ATOMIC_RELAXED);
+        do {
+          usleep(ITTI_QUEUE_FULL_BLOCK_SLEEP_US);
+          // Other senders overflowed meanwhile, queue after their messages
+          if (__atomic_load_n(&task->overflow_depth, __ATOMIC_ACQUIRE)) {
+            itti_overflow_message(task_id, new);
+            return 0;
+          }
+          if (lfds710_queue_bmm_enqueue(&task->message_queue, NULL, new)) {
+            return 0;
+          }
+          clock_gettime(CLOCK_MONOTONIC, &now);
+        } while ((now.tv_sec < deadline.tv_sec) ||
+                 ((now.tv_sec == deadline.tv_sec) &&
+                  (now.tv_nsec < deadline.tv_nsec)));
+        break;
+      }
+      itti_overflow_message(task_id, new);
+      return 0;
+
+    case ITTI_QUEUE_FULL_OVERFLOW:
+      itti_overflow_message(task_id, new);
+      return 0;
+
+    case ITTI_QUEUE_FULL_REJECT:
+    default:
+      break;
+  }
+  __atomic_add_fetch(&task->nb_rejected, 1, __ATOMIC_RELAXED);
+  itti_update_queue_depth(task_id, -1);
+  return -1;
+}
+
+/*
+ * Called after the message is enqueued, returns false if the receiving thread
+ * is running and will dequeue the message without being woken up
+ */
+static inline bool itti_task_needs_wakeup(thread_id_t thread_id) {
+  thread_desc_t *thread = &itti_desc.threads[thread_id];
+
+  if (!__atomic_load_n(&thread->wake_if_sleeping, __ATOMIC_ACQUIRE)) {
+    return true;
+  }
+  // Pairs with the fence in itti_receive_msgs_internal(): either we see the
+  // sleeping flag or the receiver sees our message when it checks again
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  return __atomic_exchange_n(&thread->sleeping, false, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * Returns 1 if a message has been dequeued, 0 if there is none
+ */
+static int itti_dequeue_message(task_id_t task_id, message_list_t **message) {
+  task_desc_t *task = &itti_desc.tasks[task_id];
+
+  *message = NULL;
+  if (!lfds710_queue_bmm_dequeue(&task->message_queue, NULL,
+                                 (void **)message)) {
+    if (!__atomic_load_n(&task->overflow_depth, __ATOMIC_ACQUIRE)) {
+      return 0;
+    }
+    pthread_mutex_lock(&task->overflow_mutex);
+    if ((*message = task->overflow_head)) {
+      task->overflow_head = (*message)->next;
+      if (!task->overflow_head) {
+        task->overflow_tail = NULL;
+      }
+      __atomic_sub_fetch(&task->overflow_depth, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&task->overflow_mutex);
+    if (!*message) {
+      return 0;
+    }
+  }
+  itti_update_queue_depth(task_id, -1);
+  return 1;
+}
+
+void itti_set_task_queue_full_policy(task_id_t task_id,
+                                     MessagesIds message_id,
+                                     itti_queue_full_policy_t policy,
+                                     uint32_t block_timeout_ms) {
+  AssertFatal(task_id < itti_desc.task_max,
+              "Task id (%d) is out of range (%d)!\n", task_id,
+              itti_desc.task_max);
+  itti_desc.tasks[task_id].queue_full_policy_message_id = message_id;
+  itti_desc.tasks[task_id].block_timeout_ms = block_timeout_ms;
+  itti_desc.tasks[task_id].queue_full_policy = policy;
+}
+
+void itti_set_task_overload_watermarks(task_id_t task_id,
+                                       uint32_t start_percent,
+                                       uint32_t stop_percent) {
+  uint32_t queue_size = 0;
+
+  AssertFatal(task_id < itti_desc.task_max,
+              "Task id (%d) is out of range (%d)!\n", task_id,
+              itti_desc.task_max);
+  AssertFatal(stop_percent <= start_percent,
+              "Overload stop watermark (%u%%) above start watermark (%u%%)\n",
+              stop_percent, start_percent);
+  queue_size = itti_desc.tasks_info[task_id].queue_size;
+  itti_desc.tasks[task_id].overload_stop_depth =
+      (queue_size * stop_percent) / 100;
+  itti_desc.tasks[task_id].overload_start_depth =
+      (start_percent) ? ((queue_size * start_percent) / 100) + 1 : 0;
+}
+
+bool itti_is_overloaded(void) {
+  return __atomic_load_n(&itti_desc.nb_overloaded_tasks, __ATOMIC_ACQUIRE) > 0;
+}
+
+void itti_get_queue_stats(task_id_t task_id, itti_queue_stats_t *stats,
+                          bool reset_high_watermark) {
+  task_desc_t *task = NULL;
+  int32_t depth = 0;
+
+  AssertFatal(task_id < itti_desc.task_max,
+              "Task id (%d) is out of range (%d)!\n", task_id,
+              itti_desc.task_max);
+  task = &itti_desc.tasks[task_id];
+  depth = __atomic_load_n(&task->depth, __ATOMIC_RELAXED);
+  stats->queue_size = itti_desc.tasks_info[task_id].queue_size;
+  stats->depth = (depth > 0) ? depth : 0;
+  stats->high_watermark =
+      (reset_high_watermark)
+          ? __atomic_exchange_n(&task->high_watermark, stats->depth,
+                                __ATOMIC_RELAXED)
+          : __atomic_load_n(&task->high_watermark, __ATOMIC_RELAXED);
+  stats->overflow_depth =
+      __atomic_load_n(&task->overflow_depth, __ATOMIC_RELAXED);
+  stats->nb_overflowed = __atomic_load_n(&task->nb_overflowed, __ATOMIC_RELAXED);
+  stats->nb_blocked = __atomic_load_n(&task->nb_blocked, __ATOMIC_RELAXED);
+  stats->nb_rejected = __atomic_load_n(&task->nb_rejected, __ATOMIC_RELAXED);
+  stats->is_overloaded =
+      __atomic_load_n(&task->is_overloaded, __ATOMIC_RELAXED);
+}
+
 int itti_send_broadcast_message(MessageDef *message_p) {
   task_id_t destination_task_id;
   task_id_t origin_task_id;
@@ -310,9 +617,13 @@ int itti_send_broadcast_message(MessageDef *message_p) {
         memcpy(new_message_p, message_p, size);
         result = itti_send_msg_to_task(destination_task_id, INSTANCE_DEFAULT,
                                        new_message_p);
-        AssertFatal(
-            result >= 0, "Failed to send message %d to thread %d (task %d)!\n",
-            message_p->ittiMsgHeader.messageId, thread_id, destination_task_id);
+        if (result < 0) {
+          ITTI_DEBUG(ITTI_DEBUG_ISSUES,
+                     " Failed to broadcast message %d to thread %d (task %d)\n",
+                     message_p->ittiMsgHeader.messageId, thread_id,
+                     destination_task_id);
+          ret = -1;
+        }
       }
     }
   }
@@ -368,6 +679,7 @@ int itti_send_msg_to_task(task_id_t destination_task_id, instance_t instance,
   uint32_t priority;
   message_number_t message_number;
   uint32_t message_id;
+  int ret = 0;
 
   VCD_SIGNAL_DUMPER_DUMP_VARIABLE_BY_NAME(
       VCD_SIGNAL_DUMPER_VARIABLE_ITTI_SEND_MSG,
@@ -436,15 +748,23 @@ int itti_send_msg_to_task(task_id_t destination_task_id, instance_t instance,
       /*
        * Enqueue message in destination task queue
        */
-      lfds710_queue_bmm_enqueue(
-          &itti_desc.tasks[destination_task_id].message_queue, NULL, new);
-      VCD_SIGNAL_DUMPER_DUMP_FUNCTION_BY_NAME(
-          VCD_SIGNAL_DUMPER_FUNCTIONS_ITTI_ENQUEUE_MESSAGE, VCD_FUNCTION_OUT);
-      {
+      if (itti_enqueue_message(destination_task_id, new) < 0) {
+        OAILOG_ERROR(LOG_ITTI,
+                     "Queue of task %s full, message %s from %s rejected\n",
+                     itti_get_task_name(destination_task_id),
+                     itti_desc.messages_info[message_id].name,
+                     itti_get_task_name(origin_task_id));
+        // The sender still owns the message
+        itti_free(origin_task_id, new);
+        ret = -1;
+      } else {
+        VCD_SIGNAL_DUMPER_DUMP_FUNCTION_BY_NAME(
+            VCD_SIGNAL_DUMPER_FUNCTIONS_ITTI_ENQUEUE_MESSAGE, VCD_FUNCTION_OUT);
         /*
          * Only use event fd for tasks, subtasks will pool the queue
          */
-        if (TASK_GET_PARENT_TASK_ID(destination_task_id) == TASK_UNKNOWN) {
+        if ((TASK_GET_PARENT_TASK_ID(destination_task_id) == TASK_UNKNOWN) &&
+            (itti_task_needs_wakeup(destination_thread_id))) {
           ssize_t write_ret;
           eventfd_t sem_counter = 1;
 
@@ -459,14 +779,15 @@ int itti_send_msg_to_task(task_id_t destination_task_id, instance_t instance,
                       destination_thread_id, (int)write_ret,
                       (int)sizeof(sem_counter));
         }
-      }
 
-      ITTI_DEBUG(ITTI_DEBUG_SEND,
-                 " Message %s, number %lu with priority %d successfully sent "
-                 "from %s to queue (%u:%s)\n",
-                 itti_desc.messages_info[message_id].name, message_number,
-                 priority, itti_get_task_name(origin_task_id),
-                 destination_task_id, itti_get_task_name(destination_task_id));
+        ITTI_DEBUG(ITTI_DEBUG_SEND,
+                   " Message %s, number %lu with priority %d successfully "
+                   "sent from %s to queue (%u:%s)\n",
+                   itti_desc.messages_info[message_id].name, message_number,
+                   priority, itti_get_task_name(origin_task_id),
+                   destination_task_id,
+                   itti_get_task_name(destination_task_id));
+      }
     }
   } else {
     /*
@@ -482,7 +803,7 @@ int itti_send_msg_to_task(task_id_t destination_task_id, instance_t instance,
       VCD_SIGNAL_DUMPER_VARIABLE_ITTI_SEND_MSG,
       __sync_and_and_fetch(&itti_desc.vcd_send_msg,
                            ~(1L << destination_task_id)));
-  return 0;
+  return ret;
 }
 
 void itti_subscribe_event_fd(task_id_t task_id, int fd) {
@@ -558,6 +879,109 @@ int itti_get_events(task_id_t task_id, struct epoll_event **events) {
   return itti_desc.threads[thread_id].epoll_nb_events;
 }
 
+static int itti_epoll_wait(task_id_t task_id, int epoll_timeout) {
+  thread_id_t thread_id = TASK_GET_THREAD_ID(task_id);
+  int epoll_ret = 0;
+
+  do {
+    epoll_ret =
+        epoll_wait(itti_desc.threads[thread_id].epoll_fd,
+                   itti_desc.threads[thread_id].events,
+                   itti_desc.threads[thread_id].nb_events, epoll_timeout);
+  } while (epoll_ret < 0 && errno == EINTR);
+
+  if (epoll_ret < 0) {
+    AssertFatal(0, "epoll_wait failed for task %s: %s!\n",
+                itti_get_task_name(task_id), strerror(errno));
+  }
+  return epoll_ret;
+}
+
+/*
+ * Acknowledge the event fd of a thread in wake if sleeping mode among the
+ * epoll_ret events, returns true if the task has events for other fds
+ */
+static bool itti_ack_wakeup_events(thread_id_t thread_id, int epoll_ret) {
+  thread_desc_t *thread = &itti_desc.threads[thread_id];
+  bool other_events = false;
+
+  for (int i = 0; i < epoll_ret; i++) {
+    if (thread->events[i].data.fd == thread->task_event_fd) {
+      eventfd_t sem_counter;
+
+      // Non blocking: the counter may already be 0 after a spurious wake up
+      if (read(thread->task_event_fd, &sem_counter, sizeof(sem_counter)) < 0) {
+        AssertFatal(errno == EAGAIN,
+                    "Read from task message FD (%d) failed: %s!\n", thread_id,
+                    strerror(errno));
+      }
+      thread->events[i].events &= ~EPOLLIN;
+    } else {
+      other_events = true;
+    }
+  }
+  thread->epoll_nb_events = epoll_ret;
+  return other_events;
+}
+
+static int itti_dequeue_messages(task_id_t task_id, MessageDef **received_msgs,
+                                 int max_msgs) {
+  struct message_list_s *message = NULL;
+  int nb_msgs = 0;
+
+  while ((nb_msgs < max_msgs) &&
+         (itti_dequeue_message(task_id, &message) == 1)) {
+    int result = EXIT_SUCCESS;
+
+    received_msgs[nb_msgs++] = message->msg;
+    result = itti_free(ITTI_MSG_ORIGIN_ID(message->msg), message);
+    AssertFatal(result == EXIT_SUCCESS, "Failed to free memory (%d)!\n",
+                result);
+  }
+  return nb_msgs;
+}
+
+/*
+ * Receive side of the wake if sleeping mode. Messages are dequeued without
+ * any system call while the queue is not empty, the task only sleeps in
+ * epoll_wait after having set its sleeping flag and checked the queue again.
+ * Returns 0 if the task was woken up for one of its other fds only.
+ */
+static int itti_receive_msgs_internal(task_id_t task_id,
+                                      MessageDef **received_msgs,
+                                      int max_msgs) {
+  thread_id_t thread_id = TASK_GET_THREAD_ID(task_id);
+  thread_desc_t *thread = &itti_desc.threads[thread_id];
+  int nb_msgs = 0;
+  int epoll_ret = 0;
+
+  thread->epoll_nb_events = 0;
+  if ((nb_msgs = itti_dequeue_messages(task_id, received_msgs, max_msgs))) {
+    // Do not starve the other fds monitored by the task
+    if (thread->nb_events > 1) {
+      epoll_ret = itti_epoll_wait(task_id, 0);
+      itti_ack_wakeup_events(thread_id, epoll_ret);
+    }
+    return nb_msgs;
+  }
+
+  while (1) {
+    __atomic_store_n(&thread->sleeping, true, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    // A sender may have enqueued before seeing the flag
+    if ((nb_msgs = itti_dequeue_messages(task_id, received_msgs, max_msgs))) {
+      __atomic_store_n(&thread->sleeping, false, __ATOMIC_RELAXED);
+      return nb_msgs;
+    }
+    epoll_ret = itti_epoll_wait(task_id, -1);
+    __atomic_store_n(&thread->sleeping, false, __ATOMIC_RELAXED);
+    if ((itti_ack_wakeup_events(thread_id, epoll_ret)) ||
+        ((nb_msgs = itti_dequeue_messages(task_id, received_msgs, max_msgs)))) {
+      return nb_msgs;
+    }
+  }
+}
+
 static inline void itti_receive_msg_internal_event_fd(
     task_id_t task_id, uint8_t polling, MessageDef **received_msg) {
   thread_id_t thread_id;
@@ -585,17 +1009,7 @@ static inline void itti_receive_msg_internal_event_fd(
     epoll_timeout = -1;
   }
 
-  do {
-    epoll_ret =
-        epoll_wait(itti_desc.threads[thread_id].epoll_fd,
-                   itti_desc.threads[thread_id].events,
-                   itti_desc.threads[thread_id].nb_events, epoll_timeout);
-  } while (epoll_ret < 0 && errno == EINTR);
-
-  if (epoll_ret < 0) {
-    AssertFatal(0, "epoll_wait failed for task %s: %s!\n",
-                itti_get_task_name(task_id), strerror(errno));
-  }
+  epoll_ret = itti_epoll_wait(task_id, epoll_timeout);
 
   if (epoll_ret == 0 && polling) {
     /*
@@ -627,8 +1041,7 @@ static inline void itti_receive_msg_internal_event_fd(
                   "Read from task message FD (%d) failed (%d/%d)!\n", thread_id,
                   (int)read_ret, (int)sizeof(sem_counter));
 
-      if (lfds710_queue_bmm_dequeue(&itti_desc.tasks[task_id].message_queue,
-                                    NULL, (void **)&message) == 0) {
+      if (itti_dequeue_message(task_id, &message) == 0) {
         /*
          * No element in list -> this should not happen
          */
@@ -657,10 +1070,64 @@ void itti_receive_msg(task_id_t task_id, MessageDef **received_msg) {
   VCD_SIGNAL_DUMPER_DUMP_VARIABLE_BY_NAME(
       VCD_SIGNAL_DUMPER_VARIABLE_ITTI_RECV_MSG,
       __sync_and_and_fetch(&itti_desc.vcd_receive_msg, ~(1L << task_id)));
-  itti_receive_msg_internal_event_fd(task_id, 0, received_msg);
+  if (itti_desc.threads[TASK_GET_THREAD_ID(task_id)].wake_if_sleeping) {
+    AssertFatal(received_msg != NULL, "Received message is NULL!\n");
+    *received_msg = NULL;
+    itti_receive_msgs_internal(task_id, received_msg, 1);
+  } else {
+    itti_receive_msg_internal_event_fd(task_id, 0, received_msg);
+  }
+  VCD_SIGNAL_DUMPER_DUMP_VARIABLE_BY_NAME(
+      VCD_SIGNAL_DUMPER_VARIABLE_ITTI_RECV_MSG,
+      __sync_or_and_fetch(&itti_desc.vcd_receive_msg, 1L << task_id));
+}
+
+int itti_receive_msgs(task_id_t task_id, MessageDef **received_msgs,
+                      int max_msgs) {
+  int nb_msgs = 0;
+
+  AssertFatal(task_id < itti_desc.task_max,
+              "Task id (%d) is out of range (%d)!\n", task_id,
+              itti_desc.task_max);
+  AssertFatal((received_msgs != NULL) && (max_msgs > 0),
+              "Bad received messages array!\n");
+  AssertFatal(itti_desc.threads[TASK_GET_THREAD_ID(task_id)].wake_if_sleeping,
+              "Task %s is not in wake if sleeping mode!\n",
+              itti_get_task_name(task_id));
+  VCD_SIGNAL_DUMPER_DUMP_VARIABLE_BY_NAME(
+      VCD_SIGNAL_DUMPER_VARIABLE_ITTI_RECV_MSG,
+      __sync_and_and_fetch(&itti_desc.vcd_receive_msg, ~(1L << task_id)));
+  nb_msgs = itti_receive_msgs_internal(task_id, received_msgs, max_msgs);
   VCD_SIGNAL_DUMPER_DUMP_VARIABLE_BY_NAME(
       VCD_SIGNAL_DUMPER_VARIABLE_ITTI_RECV_MSG,
       __sync_or_and_fetch(&itti_desc.vcd_receive_msg, 1L << task_id));
+  return nb_msgs;
+}
+
+void itti_set_task_wake_if_sleeping(task_id_t task_id) {
+  thread_id_t thread_id;
+  int flags = 0;
+
+  AssertFatal(task_id < itti_desc.task_max,
+              "Task id (%d) is out of range (%d)!\n", task_id,
+              itti_desc.task_max);
+  AssertFatal(TASK_GET_PARENT_TASK_ID(task_id) == TASK_UNKNOWN,
+              "Subtask %s has no event fd!\n", itti_get_task_name(task_id));
+  thread_id = TASK_GET_THREAD_ID(task_id);
+  /*
+   * The event fd counter is no longer one per message: the receiver may have
+   * to read it while it is 0. The messages already signalled are dequeued
+   * before the task sleeps, their remaining counts only cause spurious wake
+   * ups.
+   */
+  flags = fcntl(itti_desc.threads[thread_id].task_event_fd, F_GETFL);
+  AssertFatal((flags >= 0) &&
+                  (fcntl(itti_desc.threads[thread_id].task_event_fd, F_SETFL,
+                         flags | O_NONBLOCK) == 0),
+              "fcntl failed for task %s: %s!\n", itti_get_task_name(task_id),
+              strerror(errno));
+  __atomic_store_n(&itti_desc.threads[thread_id].wake_if_sleeping, true,
+                   __ATOMIC_RELEASE);
 }
 
 void itti_poll_msg(task_id_t task_id, MessageDef **received_msg) {
@@ -674,8 +1141,7 @@ void itti_poll_msg(task_id_t task_id, MessageDef **received_msg) {
   {
     struct message_list_s *message;
 
-    if (lfds710_queue_bmm_dequeue(&itti_desc.tasks[task_id].message_queue, NULL,
-                                  (void **)&message) == 1) {
+    if (itti_dequeue_message(task_id, &message) == 1) {
       int result;
 
       *received_msg = message->msg;
@@ -870,6 +1336,8 @@ int itti_init(task_id_t task_max, thread_id_t thread_max,
     lfds710_queue_bmm_init_valid_on_current_logical_core(
         &itti_desc.tasks[task_id].message_queue, itti_desc.tasks[task_id].qbmme,
         itti_desc.tasks_info[task_id].queue_size, NULL);
+    pthread_mutex_init(&itti_desc.tasks[task_id].overflow_mutex, NULL);
+    itti_desc.tasks[task_id].queue_full_policy = ITTI_QUEUE_FULL_OVERFLOW;
   }
 
   /*
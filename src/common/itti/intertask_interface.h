@@ -24,6 +24,7 @@
 #ifndef INTERTASK_INTERFACE_H_
 #define INTERTASK_INTERFACE_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -47,6 +48,9 @@
 typedef unsigned long message_number_t;
 #define MESSAGE_NUMBER_SIZE (sizeof(unsigned long))
 
+/* Messages dequeued per wake up by the task loops using itti_receive_msgs */
+#define ITTI_RECEIVE_MSGS_BATCH_SIZE 32
+
 typedef enum message_priorities_e {
   MESSAGE_PRIORITY_MAX = 100,
   MESSAGE_PRIORITY_MAX_LEAST = 85,
@@ -76,6 +80,25 @@ typedef enum task_priorities_e {
   TASK_PRIORITY_MIN = 10,
 } task_priorities_t;
 
+/* What itti_send_msg_to_task() does when the bounded queue of the
+   destination task is full */
+typedef enum itti_queue_full_policy_e {
+  ITTI_QUEUE_FULL_OVERFLOW = 0,  ///< spill to an unbounded list (default)
+  ITTI_QUEUE_FULL_BLOCK,         ///< wait for room, up to a timeout
+  ITTI_QUEUE_FULL_REJECT,        ///< return an error to the sender
+} itti_queue_full_policy_t;
+
+typedef struct itti_queue_stats_s {
+  uint32_t queue_size;      ///< bounded queue size (TASK_DEF)
+  uint32_t depth;           ///< messages not yet received, overflow included
+  uint32_t high_watermark;  ///< max depth since start or last reset
+  uint32_t overflow_depth;  ///< messages in the overflow list
+  uint64_t nb_overflowed;   ///< messages spilled to the overflow list
+  uint64_t nb_blocked;      ///< senders that waited for room
+  uint64_t nb_rejected;     ///< messages rejected because the queue was full
+  bool is_overloaded;       ///< depth crossed the overload start watermark
+} itti_queue_stats_t;
+
 typedef struct task_info_s {
   thread_id_t thread;
   task_id_t parent_task;
@@ -102,7 +125,9 @@ int itti_send_broadcast_message(MessageDef* message_p);
  \param task_id Task ID
  \param instance Instance of the task used for virtualization
  \param message Pointer to the message to send
- @returns -1 on failure, 0 otherwise
+ @returns -1 if the queue of the task is full and its policy rejects the
+ message, see itti_set_task_queue_full_policy() (the caller still owns the
+ message), 0 otherwise
  **/
 int itti_send_msg_to_task(task_id_t task_id, instance_t instance,
                           MessageDef* message);
@@ -134,6 +159,25 @@ int itti_get_events(task_id_t task_id, struct epoll_event** events);
  **/
 void itti_receive_msg(task_id_t task_id, MessageDef** received_msg);
 
+/** \brief Retrieves up to max_msgs messages in the queue associated to
+ * task_id, the task must be in wake if sleeping mode.
+ * If the queue is empty, the thread is blocked till a new message arrives.
+ \param task_id Task ID of the receiving task
+ \param received_msgs Array of at least max_msgs messages
+ \param max_msgs Maximum number of messages to retrieve
+ @returns the number of messages, 0 if only other fds have events (see
+ itti_get_events)
+ **/
+int itti_receive_msgs(task_id_t task_id, MessageDef** received_msgs,
+                      int max_msgs);
+
+/** \brief Senders only signal the event fd of task_id when the task is
+ * sleeping, and not once per message. To be called by the task itself before
+ * receiving messages, itti_receive_msg keeps working in this mode.
+ \param task_id Task ID of the calling task
+ **/
+void itti_set_task_wake_if_sleeping(task_id_t task_id);
+
 /** \brief Try to retrieves a message in the queue associated to task_id.
  \param task_id Task ID of the receiving task
  \param received_msg Pointer to the allocated message
@@ -222,5 +266,38 @@ int itti_free(task_id_t task_id, void* ptr);
 
 void itti_print_DEBUG(void);
 
+/** \brief Set the behaviour of itti_send_msg_to_task() when the queue of the
+ *task is full, for the messages of one id; the other messages overflow.
+ *A task never blocks on its own queue, it overflows instead.
+ *ITTI_QUEUE_FULL_BLOCK rejects the message after the timeout. The senders of
+ *message_id must release the message when the send fails.
+ * \param task_id destination task
+ * \param message_id messages subject to the policy
+ * \param policy see itti_queue_full_policy_t
+ * \param block_timeout_ms max wait for ITTI_QUEUE_FULL_BLOCK
+ **/
+void itti_set_task_queue_full_policy(task_id_t task_id,
+                                     MessagesIds message_id,
+                                     itti_queue_full_policy_t policy,
+                                     uint32_t block_timeout_ms);
+
+/** \brief Mark the task overloaded when its queue depth reaches
+ *start_percent of the queue size, until it drops to stop_percent.
+ * \param task_id task to monitor, start_percent 0 disables the monitoring
+ **/
+void itti_set_task_overload_watermarks(task_id_t task_id,
+                                       uint32_t start_percent,
+                                       uint32_t stop_percent);
+
+/** \brief Returns true while at least one monitored task is overloaded
+ **/
+bool itti_is_overloaded(void);
+
+/** \brief Copy the queue counters of a task
+ * \param reset_high_watermark restart the high watermark from current depth
+ **/
+void itti_get_queue_stats(task_id_t task_id, itti_queue_stats_t* stats,
+                          bool reset_high_watermark);
+
 #endif /* INTERTASK_INTERFACE_H_ */
 /* @} */
@@ -15,6 +15,12 @@
  *      contact@openairinterface.org
  */
 
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
 #include "memory_pools.h"
 #include "assertions.h"
 #include "dynamic_memory_check.h"
@@ -41,28 +47,16 @@ uint64_t vcd_mp_free;
 
 #define MEMORY_POOL_ITEM_INFO_NUMBER 2
 
-/*------------------------------------------------------------------------------*/
-typedef int32_t items_group_position_t;
-typedef int32_t items_group_index_t;
-
-typedef union items_group_positions_u {
-  uint64_t all;
-  struct {
-    items_group_position_t put;
-    items_group_position_t get;
-  } ind;
-} items_group_positions_t;
-
-typedef struct items_group_s {
-  items_group_position_t number_plus_one;
-  volatile uint32_t minimum;
-  volatile items_group_positions_t positions;
-  volatile items_group_index_t *indexes;
-} items_group_t;
+#define MAX_POOLS_NUMBER 20
+#define MAX_POOL_ITEMS_NUMBER (200 * 1000)
+#define MAX_POOL_ITEM_SIZE (100 * 1000)
 
-/*------------------------------------------------------------------------------*/
-static const items_group_position_t ITEMS_GROUP_POSITION_INVALID = -1;
-static const items_group_index_t ITEMS_GROUP_INDEX_INVALID = -1;
+/*
+ * Items cached per thread and per pool. A thread takes/gives back half a
+ * magazine from/to the pool when its magazine is empty/full, so the pool lock
+ * is taken at most once every MEMORY_POOLS_MAGAZINE_SIZE / 2 operations.
+ */
+#define MEMORY_POOLS_MAGAZINE_SIZE 64
 
 /*------------------------------------------------------------------------------*/
 typedef uint32_t pool_item_start_mark_t;
@@ -77,6 +71,14 @@ typedef uint32_t pools_start_mark_t;
 typedef uint8_t pool_id_t;
 typedef uint8_t item_status_t;
 
+/*
+ * Size classes in memory_pool_data_t units, up to MAX_POOL_ITEM_SIZE
+ */
+#define SIZE_CLASSES_NUMBER                                  \
+  (((MAX_POOL_ITEM_SIZE + sizeof(memory_pool_data_t) - 1) / \
+    sizeof(memory_pool_data_t)) +                           \
+   1)
+
 typedef struct memory_pool_item_start_s {
   pool_item_start_mark_t start_mark;
 
@@ -101,22 +103,83 @@ typedef struct memory_pool_s {
   pool_id_t pool_id;
   uint32_t item_data_number;
   uint32_t pool_item_size;
-  items_group_t items_group_free;
-  memory_pool_item_t *items;
+  /*
+   * Items added each time the pool runs dry
+   */
+  uint32_t grow_items_number;
+
+  /*
+   * Free items not cached by any thread (LIFO), protected by mutex
+   */
+  pthread_mutex_t mutex;
+  memory_pool_item_t **free_items;
+  uint32_t free_items_number;
+  uint32_t items_number;
+  uint32_t high_watermark;
+  uint32_t grow_number;
+  /*
+   * Threads without magazine
+   */
+  uint64_t alloc_number;
+  uint64_t free_number;
 } memory_pool_t;
 
+typedef struct memory_pools_magazine_s {
+  uint32_t items_number;
+  memory_pool_item_t *items[MEMORY_POOLS_MAGAZINE_SIZE];
+  uint64_t alloc_number;
+  uint64_t free_number;
+} memory_pools_magazine_t;
+
+typedef struct memory_pools_info_counters_s {
+  uint64_t alloc_number;
+  uint64_t free_number;
+  /*
+   * Allocated minus freed by this thread, the sum over the threads is the
+   * number of items in use
+   */
+  int64_t used;
+} memory_pools_info_counters_t;
+
+typedef struct memory_pools_thread_cache_s {
+  struct memory_pools_s *memory_pools;
+  memory_pools_magazine_t magazines[MAX_POOLS_NUMBER];
+  memory_pools_info_counters_t infos[MEMORY_POOLS_INFO_NUMBER];
+  bool released; /* thread exited */
+  struct memory_pools_thread_cache_s *next;
+} memory_pools_thread_cache_t;
+
 typedef struct memory_pools_s {
   pools_start_mark_t start_mark;
 
   uint32_t pools_number;
   uint32_t pools_defined;
   memory_pool_t *pools;
+
+  /*
+   * Smallest pool fitting a size in memory_pool_data_t units
+   */
+  pool_id_t size_classes[SIZE_CLASSES_NUMBER];
+
+  /*
+   * Thread caches are kept after the exit of their thread for the statistics
+   */
+  pthread_key_t thread_cache_key;
+  pthread_mutex_t thread_caches_mutex;
+  memory_pools_thread_cache_t *thread_caches;
+
+  /*
+   * Threads without magazine, protected by thread_caches_mutex
+   */
+  memory_pools_info_counters_t infos[MEMORY_POOLS_INFO_NUMBER];
+  /*
+   * Highest sum of the used counters seen by the statistics readers
+   */
+  int64_t infos_high_watermark[MEMORY_POOLS_INFO_NUMBER];
 } memory_pools_t;
 
 //------------------------------------------------------------------------------
-static const uint32_t MAX_POOLS_NUMBER = 20;
-static const uint32_t MAX_POOL_ITEMS_NUMBER = 200 * 1000;
-static const uint32_t MAX_POOL_ITEM_SIZE = 100 * 1000;
+static const pool_id_t POOL_ID_INVALID = 0xFF;
 
 static const pool_item_start_mark_t POOL_ITEM_START_MARK =
     CHARS_TO_UINT32('P', 'I', 's', 't');
@@ -132,117 +195,7 @@ static const pool_start_mark_t POOL_START_MARK =
 static const pools_start_mark_t POOLS_START_MARK =
     CHARS_TO_UINT32('P', 'S', 's', 't');
 
-/*------------------------------------------------------------------------------*/
-static inline uint32_t items_group_number_items(items_group_t *items_group) {
-  return items_group->number_plus_one - 1;
-}
-
-//------------------------------------------------------------------------------
-static inline uint32_t items_group_free_items(items_group_t *items_group) {
-  items_group_positions_t positions;
-  uint32_t free_items;
-
-  positions.all = items_group->positions.all;
-  free_items =
-      items_group->number_plus_one + positions.ind.put - positions.ind.get;
-  free_items %= items_group->number_plus_one;
-  return free_items;
-}
-
-//------------------------------------------------------------------------------
-static inline items_group_index_t items_group_get_free_item(
-    items_group_t *items_group) {
-  items_group_position_t get_raw;
-  items_group_position_t put;
-  items_group_position_t get;
-  items_group_position_t free_items;
-  items_group_index_t index = ITEMS_GROUP_INDEX_INVALID;
-
-  /*
-   * Get current put position
-   */
-  put = items_group->positions.ind.put % items_group->number_plus_one;
-  /*
-   * Get current get position and increase it
-   */
-  get_raw = __sync_fetch_and_add(&items_group->positions.ind.get, 1);
-  get = get_raw % items_group->number_plus_one;
-
-  if (put == get) {
-    /*
-     * No more item free, restore previous position
-     */
-    __sync_fetch_and_sub(&items_group->positions.ind.get, 1);
-  } else {
-    /*
-     * Get index at current get position
-     */
-    index = items_group->indexes[get];
-
-    if (index <= ITEMS_GROUP_INDEX_INVALID) {
-      /*
-       * Index has not yet been completely freed, restore previous get position
-       */
-      __sync_fetch_and_sub(&items_group->positions.ind.get, 1);
-    } else {
-      if (get_raw == items_group->number_plus_one) {
-        /*
-         * Wrap get position
-         */
-        __sync_fetch_and_sub(&items_group->positions.ind.get,
-                             items_group->number_plus_one);
-      }
-
-      free_items = items_group_free_items(items_group);
-
-      /*
-       * Updates minimum free items if needed
-       */
-      while (items_group->minimum > free_items) {
-        items_group->minimum = free_items;
-      }
-
-      /*
-       * Clear index at current get position to indicate that item is free
-       */
-      items_group->indexes[get] = ITEMS_GROUP_INDEX_INVALID;
-    }
-  }
-
-  return (index);
-}
-
-//------------------------------------------------------------------------------
-static inline int items_group_put_free_item(items_group_t *items_group,
-                                            items_group_index_t index) {
-  items_group_position_t put_raw;
-  items_group_position_t put;
-
-  /*
-   * Get current put position and increase it
-   */
-  put_raw = __sync_fetch_and_add(&items_group->positions.ind.put, 1);
-  put = put_raw % items_group->number_plus_one;
-
-  if (put_raw == items_group->number_plus_one) {
-    /*
-     * Wrap position
-     */
-    __sync_fetch_and_sub(&items_group->positions.ind.put,
-                         items_group->number_plus_one);
-  }
-
-  AssertError(
-      items_group->indexes[put] <= ITEMS_GROUP_INDEX_INVALID,
-      return (EXIT_FAILURE),
-      "Index at current put position (%d) is not marked as free (%d)!\n", put,
-      items_group->number_plus_one);
-  /*
-   * Save freed item index at current put position
-   */
-  items_group->indexes[put] = index;
-  return (EXIT_SUCCESS);
-}
+static __thread memory_pools_thread_cache_t *t_thread_cache = NULL;
 
 //------------------------------------------------------------------------------
 static inline memory_pools_t *memory_pools_from_handler(
@@ -277,9 +230,6 @@ static inline memory_pool_item_t *memory_pool_item_from_handler(
   /*
    * Sanity check on passed handle
    */
-  // AssertError (memory_pool_item->start.start_mark == POOL_ITEM_START_MARK,
-  // memory_pool_item = NULL, "Handle %p is not a valid memory pool item handle,
-  // start mark is missing!\n", memory_pool_item);
   AssertFatal(memory_pool_item->start.start_mark == POOL_ITEM_START_MARK,
               "Handle %p is not a valid memory pool item handle, start mark is "
               "missing!\n",
@@ -288,19 +238,240 @@ static inline memory_pool_item_t *memory_pool_item_from_handler(
 }
 
 //------------------------------------------------------------------------------
-static inline memory_pool_item_t *memory_pool_item_from_index(
-    memory_pool_t *memory_pool, items_group_index_t index) {
-  void *address;
+// Must be called with the pool mutex held
+static int memory_pool_grow(memory_pool_t *memory_pool,
+                            uint32_t pool_items_number) {
+  memory_pool_item_t **free_items;
+  memory_pool_item_t *memory_pool_item;
+  void *items;
+
+  free_items =
+      realloc(memory_pool->free_items,
+              (memory_pool->items_number + pool_items_number) *
+                  sizeof(memory_pool_item_t *));
+  if (free_items == NULL) {
+    return (EXIT_FAILURE);
+  }
+  memory_pool->free_items = free_items;
+  /*
+   * Allocate items, never released: items stay valid for the MME lifetime
+   */
+  items = calloc(pool_items_number, memory_pool->pool_item_size);
+  if (items == NULL) {
+    return (EXIT_FAILURE);
+  }
+
+  /*
+   * Initialize items, the first ones of the chunk are allocated first
+   */
+  for (uint32_t item_index = pool_items_number; item_index > 0; item_index--) {
+    memory_pool_item =
+        items + ((item_index - 1) * (size_t)memory_pool->pool_item_size);
+    memory_pool_item->start.start_mark = POOL_ITEM_START_MARK;
+    memory_pool_item->start.pool_id = memory_pool->pool_id;
+    memory_pool_item->start.item_status = ITEM_STATUS_FREE;
+    memory_pool_item->data[memory_pool->item_data_number] = POOL_ITEM_END_MARK;
+    memory_pool->free_items[memory_pool->free_items_number++] =
+        memory_pool_item;
+  }
+  memory_pool->items_number += pool_items_number;
+  memory_pool->grow_number++;
+  return (EXIT_SUCCESS);
+}
+
+//------------------------------------------------------------------------------
+static void memory_pools_thread_cache_release(void *thread_cache_p) {
+  memory_pools_thread_cache_t *thread_cache =
+      (memory_pools_thread_cache_t *)thread_cache_p;
+  memory_pools_t *memory_pools = thread_cache->memory_pools;
+
+  /*
+   * Give the cached items back to the pools, keep the counters
+   */
+  thread_cache->released = true;
+  for (pool_id_t pool = 0; pool < memory_pools->pools_defined; pool++) {
+    memory_pool_t *memory_pool = &memory_pools->pools[pool];
+    memory_pools_magazine_t *magazine = &thread_cache->magazines[pool];
+
+    pthread_mutex_lock(&memory_pool->mutex);
+    while (magazine->items_number) {
+      memory_pool->free_items[memory_pool->free_items_number++] =
+          magazine->items[--magazine->items_number];
+    }
+    pthread_mutex_unlock(&memory_pool->mutex);
+  }
+}
+
+//------------------------------------------------------------------------------
+static inline memory_pools_thread_cache_t *memory_pools_get_thread_cache(
+    memory_pools_t *memory_pools) {
+  memory_pools_thread_cache_t *thread_cache = t_thread_cache;
+
+  if (thread_cache) {
+    /*
+     * Only the first memory pools used by a thread get magazines
+     */
+    return ((thread_cache->memory_pools == memory_pools) &&
+            (!thread_cache->released))
+               ? thread_cache
+               : NULL;
+  }
+  thread_cache = calloc(1, sizeof(memory_pools_thread_cache_t));
+  if (thread_cache == NULL) {
+    return NULL;
+  }
+  thread_cache->memory_pools = memory_pools;
+  pthread_mutex_lock(&memory_pools->thread_caches_mutex);
+  thread_cache->next = memory_pools->thread_caches;
+  memory_pools->thread_caches = thread_cache;
+  pthread_mutex_unlock(&memory_pools->thread_caches_mutex);
+  pthread_setspecific(memory_pools->thread_cache_key, thread_cache);
+  t_thread_cache = thread_cache;
+  return thread_cache;
+}
+
+//------------------------------------------------------------------------------
+static memory_pool_item_t *memory_pool_get_item(memory_pools_t *memory_pools,
+                                                pool_id_t pool) {
+  memory_pool_t *memory_pool = &memory_pools->pools[pool];
+  memory_pools_thread_cache_t *thread_cache =
+      memory_pools_get_thread_cache(memory_pools);
+  memory_pools_magazine_t *magazine = NULL;
+  memory_pool_item_t *memory_pool_item = NULL;
+  uint32_t items_number = 1;
+
+  if (thread_cache) {
+    magazine = &thread_cache->magazines[pool];
+    if (magazine->items_number) {
+      __atomic_store_n(&magazine->alloc_number, magazine->alloc_number + 1,
+                       __ATOMIC_RELAXED);
+      return magazine->items[--magazine->items_number];
+    }
+    items_number = MEMORY_POOLS_MAGAZINE_SIZE / 2;
+  }
+
+  pthread_mutex_lock(&memory_pool->mutex);
+  if ((memory_pool->free_items_number == 0) &&
+      (memory_pool_grow(memory_pool, memory_pool->grow_items_number) !=
+       EXIT_SUCCESS)) {
+    pthread_mutex_unlock(&memory_pool->mutex);
+    return NULL;
+  }
+  if (items_number > memory_pool->free_items_number) {
+    items_number = memory_pool->free_items_number;
+  }
+  memory_pool_item =
+      memory_pool->free_items[--memory_pool->free_items_number];
+  if (magazine) {
+    while (--items_number) {
+      magazine->items[magazine->items_number++] =
+          memory_pool->free_items[--memory_pool->free_items_number];
+    }
+    __atomic_store_n(&magazine->alloc_number, magazine->alloc_number + 1,
+                     __ATOMIC_RELAXED);
+  } else {
+    memory_pool->alloc_number++;
+  }
+  /*
+   * Items cached by threads are counted as used
+   */
+  if (memory_pool->items_number - memory_pool->free_items_number >
+      memory_pool->high_watermark) {
+    memory_pool->high_watermark =
+        memory_pool->items_number - memory_pool->free_items_number;
+  }
+  pthread_mutex_unlock(&memory_pool->mutex);
+  return memory_pool_item;
+}
+
+//------------------------------------------------------------------------------
+static void memory_pool_put_item(memory_pools_t *memory_pools, pool_id_t pool,
+                                 memory_pool_item_t *memory_pool_item) {
+  memory_pool_t *memory_pool = &memory_pools->pools[pool];
+  memory_pools_thread_cache_t *thread_cache =
+      memory_pools_get_thread_cache(memory_pools);
+  memory_pools_magazine_t *magazine = NULL;
+
+  if (thread_cache) {
+    magazine = &thread_cache->magazines[pool];
+    __atomic_store_n(&magazine->free_number, magazine->free_number + 1,
+                     __ATOMIC_RELAXED);
+    if (magazine->items_number < MEMORY_POOLS_MAGAZINE_SIZE) {
+      magazine->items[magazine->items_number++] = memory_pool_item;
+      return;
+    }
+  }
+
+  pthread_mutex_lock(&memory_pool->mutex);
+  memory_pool->free_items[memory_pool->free_items_number++] = memory_pool_item;
+  if (magazine) {
+    /*
+     * Keep half a magazine: the thread may allocate again soon
+     */
+    while (magazine->items_number > MEMORY_POOLS_MAGAZINE_SIZE / 2) {
+      memory_pool->free_items[memory_pool->free_items_number++] =
+          magazine->items[--magazine->items_number];
+    }
+  } else {
+    memory_pool->free_number++;
+  }
+  pthread_mutex_unlock(&memory_pool->mutex);
+}
+
+//------------------------------------------------------------------------------
+static inline void memory_pools_info_add(memory_pools_t *memory_pools,
+                                         uint16_t info, uint64_t alloc_number,
+                                         uint64_t free_number, int64_t used) {
+  memory_pools_thread_cache_t *thread_cache =
+      memory_pools_get_thread_cache(memory_pools);
+  memory_pools_info_counters_t *counters;
+
+  if (thread_cache) {
+    /*
+     * Only this thread writes its counters, no read-modify-write needed
+     */
+    counters = &thread_cache->infos[info];
+    __atomic_store_n(&counters->alloc_number,
+                     counters->alloc_number + alloc_number, __ATOMIC_RELAXED);
+    __atomic_store_n(&counters->free_number,
+                     counters->free_number + free_number, __ATOMIC_RELAXED);
+    __atomic_store_n(&counters->used, counters->used + used,
+                     __ATOMIC_RELAXED);
+    return;
+  }
+  pthread_mutex_lock(&memory_pools->thread_caches_mutex);
+  counters = &memory_pools->infos[info];
+  counters->alloc_number += alloc_number;
+  counters->free_number += free_number;
+  counters->used += used;
+  pthread_mutex_unlock(&memory_pools->thread_caches_mutex);
+}
+
+//------------------------------------------------------------------------------
+static inline void memory_pools_info_alloc(memory_pools_t *memory_pools,
+                                           uint16_t info) {
+  if (info < MEMORY_POOLS_INFO_NUMBER) {
+    memory_pools_info_add(memory_pools, info, 1, 0, 1);
+  }
+}
 
-  address = (void *)memory_pool->items;
-  address += index * memory_pool->pool_item_size;
-  return (address);
+//------------------------------------------------------------------------------
+static inline void memory_pools_info_free(memory_pools_t *memory_pools,
+                                          uint16_t info,
+                                          uint16_t alloc_info) {
+  if (info < MEMORY_POOLS_INFO_NUMBER) {
+    memory_pools_info_add(memory_pools, info, 0, 1, 0);
+  }
+  if (alloc_info < MEMORY_POOLS_INFO_NUMBER) {
+    memory_pools_info_add(memory_pools, alloc_info, 0, 0, -1);
+  }
 }
 
 //------------------------------------------------------------------------------
 memory_pools_handle_t memory_pools_create(uint32_t pools_number) {
   memory_pools_t *memory_pools;
   pool_id_t pool;
+  int result;
 
   AssertFatal(pools_number <= MAX_POOLS_NUMBER,
               "Too many memory pools requested (%d/%d)!\n", pools_number,
@@ -308,7 +479,7 @@ memory_pools_handle_t memory_pools_create(uint32_t pools_number) {
   /*
    * Allocate memory_pools
    */
-  memory_pools = malloc(sizeof(memory_pools_t));
+  memory_pools = calloc(1, sizeof(memory_pools_t));
   AssertFatal(memory_pools != NULL,
               "Memory pools structure allocation failed!\n");
   /*
@@ -330,21 +501,110 @@ memory_pools_handle_t memory_pools_create(uint32_t pools_number) {
      */
     for (pool = 0; pool < pools_number; pool++) {
       memory_pools->pools[pool].start_mark = POOL_START_MARK;
+      pthread_mutex_init(&memory_pools->pools[pool].mutex, NULL);
+    }
+
+    for (uint32_t size_class = 0; size_class < SIZE_CLASSES_NUMBER;
+         size_class++) {
+      memory_pools->size_classes[size_class] = POOL_ID_INVALID;
     }
+
+    pthread_mutex_init(&memory_pools->thread_caches_mutex, NULL);
+    result = pthread_key_create(&memory_pools->thread_cache_key,
+                                memory_pools_thread_cache_release);
+    AssertFatal(result == 0, "Memory pools thread key creation failed!\n");
   }
   return ((memory_pools_handle_t)memory_pools);
 }
 
+//------------------------------------------------------------------------------
+void memory_pools_get_pool_statistics(memory_pools_handle_t memory_pools_handle,
+                                      uint32_t pool,
+                                      memory_pool_statistics_t *statistics) {
+  memory_pools_t *memory_pools;
+  memory_pool_t *memory_pool;
+  memory_pools_thread_cache_t *thread_cache;
+
+  memory_pools = memory_pools_from_handler(memory_pools_handle);
+  AssertFatal(memory_pools != NULL,
+              "Failed to retrieve memory pool for handle %p!\n",
+              memory_pools_handle);
+  AssertFatal(pool < memory_pools->pools_defined,
+              "Pool index is invalid (%u/%u)!\n", pool,
+              memory_pools->pools_defined);
+  memory_pool = &memory_pools->pools[pool];
+
+  pthread_mutex_lock(&memory_pool->mutex);
+  statistics->item_size =
+      memory_pool->item_data_number * sizeof(memory_pool_data_t);
+  statistics->items_number = memory_pool->items_number;
+  statistics->free_items_number = memory_pool->free_items_number;
+  statistics->high_watermark = memory_pool->high_watermark;
+  statistics->grow_number = memory_pool->grow_number;
+  statistics->alloc_number = memory_pool->alloc_number;
+  statistics->free_number = memory_pool->free_number;
+  pthread_mutex_unlock(&memory_pool->mutex);
+
+  /*
+   * Counters of the magazines are updated without lock by their thread
+   */
+  pthread_mutex_lock(&memory_pools->thread_caches_mutex);
+  for (thread_cache = memory_pools->thread_caches; thread_cache;
+       thread_cache = thread_cache->next) {
+    statistics->alloc_number += __atomic_load_n(
+        &thread_cache->magazines[pool].alloc_number, __ATOMIC_RELAXED);
+    statistics->free_number += __atomic_load_n(
+        &thread_cache->magazines[pool].free_number, __ATOMIC_RELAXED);
+  }
+  pthread_mutex_unlock(&memory_pools->thread_caches_mutex);
+}
+
+//------------------------------------------------------------------------------
+void memory_pools_get_info_statistics(
+    memory_pools_handle_t memory_pools_handle, uint16_t info,
+    memory_pools_info_statistics_t *statistics) {
+  memory_pools_t *memory_pools;
+  memory_pools_thread_cache_t *thread_cache;
+
+  memory_pools = memory_pools_from_handler(memory_pools_handle);
+  AssertFatal(memory_pools != NULL,
+              "Failed to retrieve memory pool for handle %p!\n",
+              memory_pools_handle);
+  AssertFatal(info < MEMORY_POOLS_INFO_NUMBER, "Info is invalid (%u/%u)!\n",
+              info, MEMORY_POOLS_INFO_NUMBER);
+
+  /*
+   * Sum the counters of the threads, updated without lock by their thread
+   */
+  pthread_mutex_lock(&memory_pools->thread_caches_mutex);
+  statistics->alloc_number = memory_pools->infos[info].alloc_number;
+  statistics->free_number = memory_pools->infos[info].free_number;
+  statistics->used = memory_pools->infos[info].used;
+  for (thread_cache = memory_pools->thread_caches; thread_cache;
+       thread_cache = thread_cache->next) {
+    statistics->alloc_number += __atomic_load_n(
+        &thread_cache->infos[info].alloc_number, __ATOMIC_RELAXED);
+    statistics->free_number += __atomic_load_n(
+        &thread_cache->infos[info].free_number, __ATOMIC_RELAXED);
+    statistics->used +=
+        __atomic_load_n(&thread_cache->infos[info].used, __ATOMIC_RELAXED);
+  }
+  if (statistics->used > memory_pools->infos_high_watermark[info]) {
+    memory_pools->infos_high_watermark[info] = statistics->used;
+  }
+  statistics->high_watermark = memory_pools->infos_high_watermark[info];
+  pthread_mutex_unlock(&memory_pools->thread_caches_mutex);
+}
+
 //------------------------------------------------------------------------------
 char *memory_pools_statistics(memory_pools_handle_t memory_pools_handle) {
   memory_pools_t *memory_pools;
   pool_id_t pool;
   char *statistics;
   int printed_chars;
-  uint32_t allocated_pool_memory;
-  uint32_t allocated_pools_memory = 0;
-  items_group_t *items_group;
-  uint32_t pool_items_size;
+  uint64_t allocated_pool_memory;
+  uint64_t allocated_pools_memory = 0;
+  memory_pool_statistics_t pool_statistics;
 
   /*
    * Recover memory_pools
@@ -353,29 +613,29 @@ char *memory_pools_statistics(memory_pools_handle_t memory_pools_handle) {
   AssertFatal(memory_pools != NULL,
               "Failed to retrieve memory pool for handle %p!\n",
               memory_pools_handle);
-  statistics = malloc(memory_pools->pools_defined * 200);
+  statistics = malloc((memory_pools->pools_defined + 2) * 200);
   printed_chars = sprintf(&statistics[0],
-                          "Pool:   size, number, minimum,   free, address "
-                          "space and memory used in Kbytes\n");
+                          "Pool:   size,  number, high wm,    free, grown, "
+                          "      allocs,        frees, memory used in Kbytes\n");
 
   for (pool = 0; pool < memory_pools->pools_defined; pool++) {
-    items_group = &memory_pools->pools[pool].items_group_free;
-    allocated_pool_memory = items_group_number_items(items_group) *
+    memory_pools_get_pool_statistics(memory_pools_handle, pool,
+                                     &pool_statistics);
+    allocated_pool_memory = (uint64_t)pool_statistics.items_number *
                             memory_pools->pools[pool].pool_item_size;
     allocated_pools_memory += allocated_pool_memory;
-    pool_items_size =
-        memory_pools->pools[pool].item_data_number * sizeof(memory_pool_data_t);
     printed_chars += sprintf(
-        &statistics[printed_chars], "  %2u: %6u, %6u,  %6u, %6u, [%p-%p] %6u\n",
-        pool, pool_items_size, items_group_number_items(items_group),
-        items_group->minimum, items_group_free_items(items_group),
-        memory_pools->pools[pool].items,
-        ((void *)memory_pools->pools[pool].items) + allocated_pool_memory,
-        allocated_pool_memory / (1024));
+        &statistics[printed_chars],
+        "  %2u: %6u, %7u, %7u, %7u, %5u, %12" PRIu64 ", %12" PRIu64
+        ", %6" PRIu64 "\n",
+        pool, pool_statistics.item_size, pool_statistics.items_number,
+        pool_statistics.high_watermark, pool_statistics.free_items_number,
+        pool_statistics.grow_number, pool_statistics.alloc_number,
+        pool_statistics.free_number, allocated_pool_memory / (1024));
   }
 
   printed_chars =
-      sprintf(&statistics[printed_chars], "Pools memory %u Kbytes\n",
+      sprintf(&statistics[printed_chars], "Pools memory %" PRIu64 " Kbytes\n",
               allocated_pools_memory / (1024));
   return (statistics);
 }
@@ -386,8 +646,7 @@ int memory_pools_add_pool(memory_pools_handle_t memory_pools_handle,
   memory_pools_t *memory_pools;
   memory_pool_t *memory_pool;
   pool_id_t pool;
-  items_group_index_t item_index;
-  memory_pool_item_t *memory_pool_item;
+  int result;
 
   AssertFatal(
       pool_items_number <= MAX_POOL_ITEMS_NUMBER,
@@ -429,51 +688,31 @@ int memory_pools_add_pool(memory_pools_handle_t memory_pools_handle,
     memory_pool->pool_item_size =
         (memory_pool->item_data_number * sizeof(memory_pool_data_t)) +
         sizeof(memory_pool_item_t);
-    memory_pool->items_group_free.number_plus_one = pool_items_number + 1;
-    memory_pool->items_group_free.minimum = pool_items_number;
-    memory_pool->items_group_free.positions.ind.put = pool_items_number;
-    memory_pool->items_group_free.positions.ind.get = 0;
-    /*
-     * Allocate free indexes
-     */
-    memory_pool->items_group_free.indexes =
-        malloc(memory_pool->items_group_free.number_plus_one *
-               sizeof(items_group_index_t));
-    AssertFatal(memory_pool->items_group_free.indexes != NULL,
-                "Memory pool indexes allocation failed!\n");
-
-    /*
-     * Initialize free indexes
-     */
-    for (item_index = 0; item_index < pool_items_number; item_index++) {
-      memory_pool->items_group_free.indexes[item_index] = item_index;
+    memory_pool->grow_items_number = pool_items_number / 4;
+    if (memory_pool->grow_items_number < MEMORY_POOLS_MAGAZINE_SIZE) {
+      memory_pool->grow_items_number = MEMORY_POOLS_MAGAZINE_SIZE;
     }
-
-    /*
-     * Last index is not allocated
-     */
-    memory_pool->items_group_free.indexes[item_index] =
-        ITEMS_GROUP_INDEX_INVALID;
-    /*
-     * Allocate items
-     */
-    memory_pool->items = calloc(pool_items_number, memory_pool->pool_item_size);
-    AssertFatal(memory_pool->items != NULL,
+    pthread_mutex_lock(&memory_pool->mutex);
+    result = memory_pool_grow(memory_pool, pool_items_number);
+    pthread_mutex_unlock(&memory_pool->mutex);
+    AssertFatal(result == EXIT_SUCCESS,
                 "Memory pool items allocation failed!\n");
+  }
+  memory_pools->pools_defined++;
 
-    /*
-     * Initialize items
-     */
-    for (item_index = 0; item_index < pool_items_number; item_index++) {
-      memory_pool_item = memory_pool_item_from_index(memory_pool, item_index);
-      memory_pool_item->start.start_mark = POOL_ITEM_START_MARK;
-      memory_pool_item->start.pool_id = pool;
-      memory_pool_item->start.item_status = ITEM_STATUS_FREE;
-      memory_pool_item->data[memory_pool->item_data_number] =
-          POOL_ITEM_END_MARK;
+  /*
+   * Size classes now served by this pool
+   */
+  for (uint32_t size_class = 0; size_class <= memory_pool->item_data_number;
+       size_class++) {
+    pool_id_t current = memory_pools->size_classes[size_class];
+
+    if ((current == POOL_ID_INVALID) ||
+        (memory_pools->pools[current].item_data_number >
+         memory_pool->item_data_number)) {
+      memory_pools->size_classes[size_class] = pool;
     }
   }
-  memory_pools->pools_defined++;
   return (0);
 }
 
@@ -482,10 +721,9 @@ memory_pool_item_handle_t memory_pools_allocate(
     memory_pools_handle_t memory_pools_handle, uint32_t item_size,
     uint16_t info_0, uint16_t info_1) {
   memory_pools_t *memory_pools;
-  memory_pool_item_t *memory_pool_item;
+  memory_pool_item_t *memory_pool_item = NULL;
   memory_pool_item_handle_t memory_pool_item_handle = NULL;
-  pool_id_t pool;
-  items_group_index_t item_index = ITEMS_GROUP_INDEX_INVALID;
+  pool_id_t pool = POOL_ID_INVALID;
 
   VCD_SIGNAL_DUMPER_DUMP_VARIABLE_BY_NAME(
       VCD_SIGNAL_DUMPER_VARIABLE_MP_ALLOC,
@@ -498,55 +736,35 @@ memory_pool_item_handle_t memory_pools_allocate(
               "Failed to retrieve memory pool for handle %p!\n",
               memory_pools_handle);
 
-  for (pool = 0; pool < memory_pools->pools_defined; pool++) {
-    if ((memory_pools->pools[pool].item_data_number *
-         sizeof(memory_pool_data_t)) < item_size) {
-      /*
-       * This memory pool has too small items, skip it
-       */
-      continue;
-    }
-
-    item_index =
-        items_group_get_free_item(&memory_pools->pools[pool].items_group_free);
-
-    if (item_index <= ITEMS_GROUP_INDEX_INVALID) {
-      /*
-       * Allocation failed, skip this pool
-       */
-      continue;
-    } else {
-      /*
-       * Allocation succeed, exit searching loop
-       */
-      break;
-    }
+  /*
+   * Smallest pool with items big enough
+   */
+  if (item_size <= MAX_POOL_ITEM_SIZE) {
+    pool = memory_pools->size_classes[(item_size + sizeof(memory_pool_data_t) -
+                                       1) /
+                                      sizeof(memory_pool_data_t)];
+  }
+  if (pool != POOL_ID_INVALID) {
+    memory_pool_item = memory_pool_get_item(memory_pools, pool);
   }
 
-  if (item_index > ITEMS_GROUP_INDEX_INVALID) {
-    /*
-     * Convert item index into memory_pool_item address
-     */
-    memory_pool_item =
-        memory_pool_item_from_index(&memory_pools->pools[pool], item_index);
+  if (memory_pool_item) {
     /*
      * Sanity check on item status, must be free
      */
     AssertFatal(memory_pool_item->start.item_status == ITEM_STATUS_FREE,
-                "Item status is not set to free (%d) in pool %u, item %d!\n",
-                memory_pool_item->start.item_status, pool, item_index);
+                "Item status is not set to free (%d) in pool %u, item %p!\n",
+                memory_pool_item->start.item_status, pool, memory_pool_item);
     memory_pool_item->start.item_status = ITEM_STATUS_ALLOCATED;
     memory_pool_item->start.info[0] = info_0;
     memory_pool_item->start.info[1] = info_1;
     memory_pool_item_handle = memory_pool_item->data;
-    MP_DEBUG(
-        " Alloc [%2u][%6d]{%6d}, %3u %3u, %6u, %p, %p, %p\n", pool, item_index,
-        items_group_free_items(&memory_pools->pools[pool].items_group_free),
-        info_0, info_1, item_size, memory_pools->pools[pool].items,
-        memory_pool_item, memory_pool_item_handle);
+    memory_pools_info_alloc(memory_pools, info_0);
+    MP_DEBUG(" Alloc [%2u], %3u %3u, %6u, %p, %p\n", pool, info_0, info_1,
+             item_size, memory_pool_item, memory_pool_item_handle);
   } else {
-    MP_DEBUG(" Alloc [--][------]{------}, %3u %3u, %6u, failed!\n", info_0,
-             info_1, item_size);
+    MP_DEBUG(" Alloc [--], %3u %3u, %6u, failed!\n", info_0, info_1,
+             item_size);
   }
 
   VCD_SIGNAL_DUMPER_DUMP_VARIABLE_BY_NAME(
@@ -562,11 +780,8 @@ int memory_pools_free(memory_pools_handle_t memory_pools_handle,
   memory_pools_t *memory_pools;
   memory_pool_item_t *memory_pool_item;
   pool_id_t pool;
-  items_group_index_t item_index;
   uint32_t item_size;
-  uint32_t pool_item_size;
   uint16_t info_1;
-  int result;
 
   /*
    * Recover memory_pools
@@ -594,50 +809,31 @@ int memory_pools_free(memory_pools_handle_t memory_pools_handle,
               "Pool index is invalid (%u/%u)!\n", pool,
               memory_pools->pools_defined);
   item_size = memory_pools->pools[pool].item_data_number;
-  pool_item_size = memory_pools->pools[pool].pool_item_size;
-  item_index =
-      (((void *)memory_pool_item) - ((void *)memory_pools->pools[pool].items)) /
-      pool_item_size;
-  MP_DEBUG(" Free  [%2u][%6d]{%6d}, %3u %3u,         %p, %p, %p, %u\n", pool,
-           item_index,
-           items_group_free_items(&memory_pools->pools[pool].items_group_free),
+  MP_DEBUG(" Free  [%2u], %3u %3u,         %p, %p, %u\n", pool,
            memory_pool_item->start.info[0], info_1, memory_pool_item_handle,
-           memory_pool_item, memory_pools->pools[pool].items,
-           ((uint32_t)(item_size * sizeof(memory_pool_data_t))));
-  /*
-   * Sanity check on calculated item index
-   */
-  AssertFatal(
-      memory_pool_item ==
-          memory_pool_item_from_index(&memory_pools->pools[pool], item_index),
-      "Incorrect memory pool item address (%p, %p) for pool %u, item %d!\n",
-      memory_pool_item,
-      memory_pool_item_from_index(&memory_pools->pools[pool], item_index), pool,
-      item_index);
+           memory_pool_item, ((uint32_t)(item_size * sizeof(memory_pool_data_t))));
   /*
    * Sanity check on end marker, must still be present (no write overflow)
    */
   AssertFatal(memory_pool_item->data[item_size] == POOL_ITEM_END_MARK,
               "Memory pool item is corrupted, end mark is not present for pool "
-              "%u, item %d!\n",
-              pool, item_index);
+              "%u, item %p!\n",
+              pool, memory_pool_item);
   /*
    * Sanity check on item status, must be allocated
    */
   AssertFatal(memory_pool_item->start.item_status == ITEM_STATUS_ALLOCATED,
               "Trying to free a non allocated (%x) memory pool item (pool %u, "
-              "item %d)!\n",
-              memory_pool_item->start.item_status, pool, item_index);
+              "item %p)!\n",
+              memory_pool_item->start.item_status, pool, memory_pool_item);
   memory_pool_item->start.item_status = ITEM_STATUS_FREE;
-  result = items_group_put_free_item(
-      &memory_pools->pools[pool].items_group_free, item_index);
-  AssertError(result == EXIT_SUCCESS, {},
-              "Failed to free memory pool item (pool %u, item %d)!\n", pool,
-              item_index);
+  memory_pools_info_free(memory_pools, info_0,
+                         memory_pool_item->start.info[0]);
+  memory_pool_put_item(memory_pools, pool, memory_pool_item);
   VCD_SIGNAL_DUMPER_DUMP_VARIABLE_BY_NAME(
       VCD_SIGNAL_DUMPER_VARIABLE_MP_FREE,
       __sync_and_and_fetch(&vcd_mp_free, ~(1L << info_1)));
-  return (result);
+  return (EXIT_SUCCESS);
 }
 
 //------------------------------------------------------------------------------
@@ -647,9 +843,7 @@ void memory_pools_set_info(memory_pools_handle_t memory_pools_handle,
   memory_pools_t *memory_pools;
   memory_pool_item_t *memory_pool_item;
   pool_id_t pool;
-  items_group_index_t item_index;
   uint32_t item_size;
-  uint32_t pool_item_size;
 
   AssertFatal(index < MEMORY_POOL_ITEM_INFO_NUMBER,
               "Incorrect info index (%d/%d)!\n", index,
@@ -685,41 +879,23 @@ void memory_pools_set_info(memory_pools_handle_t memory_pools_handle,
                 "Pool index is invalid (%u/%u)!\n", pool,
                 memory_pools->pools_defined);
     item_size = memory_pools->pools[pool].item_data_number;
-    pool_item_size = memory_pools->pools[pool].pool_item_size;
-    item_index = (((void *)memory_pool_item) -
-                  ((void *)memory_pools->pools[pool].items)) /
-                 pool_item_size;
-    MP_DEBUG(
-        " Info  [%2u][%6d]{%6d}, %3u %3u,         %p, %p, %p, %u\n", pool,
-        item_index,
-        items_group_free_items(&memory_pools->pools[pool].items_group_free),
-        memory_pool_item->start.info[0], memory_pool_item->start.info[1],
-        memory_pool_item_handle, memory_pool_item,
-        memory_pools->pools[pool].items,
-        ((uint32_t)(item_size * sizeof(memory_pool_data_t))));
-    /*
-     * Sanity check on calculated item index
-     */
-    AssertFatal(
-        memory_pool_item ==
-            memory_pool_item_from_index(&memory_pools->pools[pool], item_index),
-        "Incorrect memory pool item address (%p, %p) for pool %u, item %d!\n",
-        memory_pool_item,
-        memory_pool_item_from_index(&memory_pools->pools[pool], item_index),
-        pool, item_index);
+    MP_DEBUG(" Info  [%2u], %3u %3u,         %p, %p, %u\n", pool,
+             memory_pool_item->start.info[0], memory_pool_item->start.info[1],
+             memory_pool_item_handle, memory_pool_item,
+             ((uint32_t)(item_size * sizeof(memory_pool_data_t))));
     /*
      * Sanity check on end marker, must still be present (no write overflow)
      */
     AssertFatal(memory_pool_item->data[item_size] == POOL_ITEM_END_MARK,
                 "Memory pool item is corrupted, end mark is not present for "
-                "pool %u, item %d!\n",
-                pool, item_index);
+                "pool %u, item %p!\n",
+                pool, memory_pool_item);
     /*
      * Sanity check on item status, must be allocated
      */
     AssertFatal(memory_pool_item->start.item_status == ITEM_STATUS_ALLOCATED,
                 "Trying to free a non allocated (%x) memory pool item (pool "
-                "%u, item %d)\n",
-                memory_pool_item->start.item_status, pool, item_index);
+                "%u, item %p)\n",
+                memory_pool_item->start.item_status, pool, memory_pool_item);
   }
 }
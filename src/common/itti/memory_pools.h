@@ -20,13 +20,41 @@
 
 #include <stdint.h>
 
+/* Per info_0 (ITTI task) statistics are kept for info_0 below this value */
+#define MEMORY_POOLS_INFO_NUMBER 64
+
 typedef void* memory_pools_handle_t;
 typedef void* memory_pool_item_handle_t;
 
+typedef struct memory_pool_statistics_s {
+  uint32_t item_size;
+  uint32_t items_number;      /* grows when the pool runs dry */
+  uint32_t free_items_number; /* not counting items cached by threads */
+  uint32_t high_watermark;    /* items out of the pool, cached ones included */
+  uint32_t grow_number;
+  uint64_t alloc_number;
+  uint64_t free_number;
+} memory_pool_statistics_t;
+
+typedef struct memory_pools_info_statistics_s {
+  uint64_t alloc_number; /* allocations with this info_0 */
+  uint64_t free_number;  /* frees with this info_0 */
+  int64_t used;          /* items allocated with this info_0 not yet freed */
+  int64_t high_watermark; /* highest used seen by the statistics reads */
+} memory_pools_info_statistics_t;
+
 memory_pools_handle_t memory_pools_create(uint32_t pools_number);
 
 char* memory_pools_statistics(memory_pools_handle_t memory_pools_handle);
 
+void memory_pools_get_pool_statistics(memory_pools_handle_t memory_pools_handle,
+                                      uint32_t pool,
+                                      memory_pool_statistics_t* statistics);
+
+void memory_pools_get_info_statistics(
+    memory_pools_handle_t memory_pools_handle, uint16_t info,
+    memory_pools_info_statistics_t* statistics);
+
 int memory_pools_add_pool(memory_pools_handle_t memory_pools_handle,
                           uint32_t pool_items_number, uint32_t pool_item_size);
 
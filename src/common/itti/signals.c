@@ -59,6 +59,9 @@
 #endif
 
 static sigset_t set;
+static signal_reload_cb_t reload_cb = NULL;
+
+void signal_set_reload_cb(signal_reload_cb_t cb) { reload_cb = cb; }
 
 int signal_mask(void) {
   /*
@@ -73,6 +76,7 @@ int signal_mask(void) {
   sigaddset(&set, SIGABRT);
   sigaddset(&set, SIGSEGV);
   sigaddset(&set, SIGINT);
+  sigaddset(&set, SIGHUP);
 
   if (sigprocmask(SIG_BLOCK, &set, NULL) < 0) {
     perror("sigprocmask");
@@ -92,6 +96,7 @@ int signal_handle(int *end) {
   sigaddset(&set, SIGABRT);
   sigaddset(&set, SIGSEGV);
   sigaddset(&set, SIGINT);
+  sigaddset(&set, SIGHUP);
 
   if (sigprocmask(SIG_BLOCK, &set, NULL) < 0) {
     perror("sigprocmask");
@@ -110,37 +115,36 @@ int signal_handle(int *end) {
   // printf("Received signal %d\n", info.si_signo);
 
   /*
-   * Real-time signals are non constant and are therefore not suitable for
-   * * * use in switch.
+   * Dispatch the signal to sub-handlers, timers are driven by TASK_TIMER
    */
-  if (info.si_signo == SIGTIMER) {
-    timer_handle_signal(&info);
-  } else {
-    /*
-     * Dispatch the signal to sub-handlers
-     */
-    switch (info.si_signo) {
-      case SIGUSR1:
-        SIG_DEBUG("Received SIGUSR1\n");
-        *end = 1;
-        break;
-
-      case SIGSEGV: /* Fall through */
-      case SIGABRT:
-        SIG_DEBUG("Received SIGABORT\n");
-        backtrace_handle_signal(&info);
-        break;
-
-      case SIGINT:
-        printf("Received SIGINT\n");
-        itti_send_terminate_message(TASK_UNKNOWN);
-        *end = 1;
-        break;
-
-      default:
-        SIG_ERROR("Received unknown signal %d\n", info.si_signo);
-        break;
-    }
+  switch (info.si_signo) {
+    case SIGUSR1:
+      SIG_DEBUG("Received SIGUSR1\n");
+      *end = 1;
+      break;
+
+    case SIGSEGV: /* Fall through */
+    case SIGABRT:
+      SIG_DEBUG("Received SIGABORT\n");
+      backtrace_handle_signal(&info);
+      break;
+
+    case SIGHUP:
+      SIG_DEBUG("Received SIGHUP\n");
+      if (reload_cb) {
+        reload_cb();
+      }
+      break;
+
+    case SIGINT:
+      printf("Received SIGINT\n");
+      itti_send_terminate_message(TASK_UNKNOWN);
+      *end = 1;
+      break;
+
+    default:
+      SIG_ERROR("Received unknown signal %d\n", info.si_signo);
+      break;
   }
 
   return 0;
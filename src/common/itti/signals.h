@@ -18,6 +18,11 @@
 #ifndef SIGNALS_H_
 #define SIGNALS_H_
 
+/* Called from the signal handling thread on SIGHUP */
+typedef int (*signal_reload_cb_t)(void);
+
+void signal_set_reload_cb(signal_reload_cb_t cb);
+
 int signal_mask(void);
 
 int signal_handle(int* end);
@@ -15,14 +15,21 @@
  *      contact@openairinterface.org
  */
 
+/*
+ * ITTI timers are kept in a hierarchical timing wheel driven by a single
+ * timerfd polled by TASK_TIMER. Arming, cancelling and expiring a timer are
+ * O(1): timer ids encode the index of the timer element in a chunked slab plus
+ * a generation number, so timer_remove() never searches a list.
+ */
+
 #include <errno.h>
 #include <pthread.h>
-#include <signal.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/timerfd.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -35,101 +42,343 @@
 #include "queue.h"
 #include "timer.h"
 
-int timer_handle_signal(siginfo_t *info);
+/* Wheel granularity, timers are rounded up to the next tick */
+#ifndef TIMER_WHEEL_TICK_MS
+#define TIMER_WHEEL_TICK_MS 10
+#endif
+
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_BITS 8
+#define TIMER_WHEEL_SIZE (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SIZE - 1)
+#define TIMER_WHEEL_MAX_TICKS \
+  ((UINT64_C(1) << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS)) - 1)
+
+/* Timer elements are allocated by chunks that never move once allocated */
+#define TIMER_CHUNK_BITS 10
+#define TIMER_CHUNK_SIZE (1 << TIMER_CHUNK_BITS)
+#define TIMER_CHUNK_MASK (TIMER_CHUNK_SIZE - 1)
+
+/* Expiry messages are sent outside the wheel lock by batches of this size */
+#define TIMER_DISPATCH_BATCH 64
+
+#define TIMER_INDEX_NONE UINT32_MAX
+
+#define TIMER_ID_BUILD(gEN, iNDEX) ((long)(((uint64_t)(gEN) << 32) | (iNDEX)))
+#define TIMER_ID_GENERATION(iD) ((uint32_t)(((uint64_t)(iD)) >> 32))
+#define TIMER_ID_INDEX(iD) ((uint32_t)(((uint64_t)(iD)) & UINT32_MAX))
 
 struct timer_elm_s {
   task_id_t task_id;  ///< Task ID which has requested the timer
   int32_t instance;   ///< Instance of the task which has requested the timer
-  timer_t timer;      ///< Unique timer id
   timer_type_t type;  ///< Timer type
   void
       *timer_arg;  ///< Optional argument that will be passed when timer expires
-  STAILQ_ENTRY(timer_elm_s) entries;  ///< Pointer to next element
+  uint64_t expires;      ///< Absolute expiry, in wheel ticks
+  uint64_t period;       ///< Interval in wheel ticks (for periodic timers)
+  uint32_t index;        ///< Index of this element in the timer slab
+  uint32_t generation;   ///< Incremented each time the element is released
+  uint32_t next_free;    ///< Free list link, valid only if not armed
+  bool armed;            ///< Element is linked in a wheel slot
+  LIST_ENTRY(timer_elm_s) entries;  ///< Wheel slot link
 };
 
+LIST_HEAD(timer_slot_s, timer_elm_s);
+
 typedef struct timer_desc_s {
-  STAILQ_HEAD(timer_list_head, timer_elm_s) timer_queue;
   pthread_mutex_t timer_list_mutex;
-  struct timespec timeout;
-} timer_desc_t;
+  struct timer_slot_s wheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SIZE];
+  uint64_t current_tick;  ///< Next tick to be processed by the wheel
+  uint64_t start_ms;      ///< Monotonic time of the wheel tick 0
 
-static timer_desc_t timer_desc;
+  struct timer_elm_s **chunks;
+  uint32_t nb_chunks;
+  uint32_t free_head;
+  uint32_t nb_armed;
 
-#define TIMER_SEARCH(vAR, tIMERfIELD, tIMERvALUE, tIMERqUEUE) \
-  do {                                                        \
-    STAILQ_FOREACH(vAR, tIMERqUEUE, entries) {                \
-      if (((vAR)->tIMERfIELD == tIMERvALUE)) break;           \
-    }                                                         \
-  } while (0)
+  int timer_fd;
+} timer_desc_t;
 
-int timer_handle_signal(siginfo_t *info) {
-  struct timer_elm_s *timer_p;
-  MessageDef *message_p;
-  timer_has_expired_t *timer_expired_p;
+typedef struct timer_expiry_s {
   task_id_t task_id;
   int32_t instance;
+  MessageDef *message_p;
+} timer_expiry_t;
 
-  /*
-   * Get back pointer to timer list element
-   */
-  timer_p = (struct timer_elm_s *)info->si_ptr;
-  // LG: To many traces for msc timer:
-  // TMR_DEBUG("Timer with id 0x%lx has expired", (long)timer_p->timer);
-  task_id = timer_p->task_id;
-  instance = timer_p->instance;
-  message_p = itti_alloc_new_message(TASK_TIMER, TIMER_HAS_EXPIRED);
-  timer_expired_p = &message_p->ittiMsg.timer_has_expired;
-  timer_expired_p->timer_id = (long)timer_p->timer;
-  timer_expired_p->arg = timer_p->timer_arg;
+static timer_desc_t timer_desc;
 
+//------------------------------------------------------------------------------
+static uint64_t timer_monotonic_ms(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
+//------------------------------------------------------------------------------
+static inline struct timer_elm_s *timer_get_elm(uint32_t index) {
+  return &timer_desc.chunks[index >> TIMER_CHUNK_BITS]
+                           [index & TIMER_CHUNK_MASK];
+}
+
+//------------------------------------------------------------------------------
+// Must be called with timer_list_mutex held
+static struct timer_elm_s *timer_alloc_elm(void) {
+  struct timer_elm_s *timer_p = NULL;
+
+  if (timer_desc.free_head == TIMER_INDEX_NONE) {
+    struct timer_elm_s **chunks = NULL;
+    struct timer_elm_s *chunk = NULL;
+    uint32_t base = timer_desc.nb_chunks << TIMER_CHUNK_BITS;
+
+    chunks = realloc(timer_desc.chunks,
+                     (timer_desc.nb_chunks + 1) * sizeof(*chunks));
+    if (chunks == NULL) {
+      return NULL;
+    }
+    timer_desc.chunks = chunks;
+    chunk = calloc(TIMER_CHUNK_SIZE, sizeof(struct timer_elm_s));
+    if (chunk == NULL) {
+      return NULL;
+    }
+    timer_desc.chunks[timer_desc.nb_chunks++] = chunk;
+    /*
+     * Chain the new elements in the free list, generation starts at 1 so that
+     * a timer id is never 0 nor -1 (used as inactive timer id by callers)
+     */
+    for (uint32_t i = 0; i < TIMER_CHUNK_SIZE; i++) {
+      chunk[i].index = base + i;
+      chunk[i].generation = 1;
+      chunk[i].next_free =
+          (i + 1 < TIMER_CHUNK_SIZE) ? base + i + 1 : TIMER_INDEX_NONE;
+    }
+    timer_desc.free_head = base;
+  }
+
+  timer_p = timer_get_elm(timer_desc.free_head);
+  timer_desc.free_head = timer_p->next_free;
+  timer_p->next_free = TIMER_INDEX_NONE;
+  return timer_p;
+}
+
+//------------------------------------------------------------------------------
+// Must be called with timer_list_mutex held
+static void timer_release_elm(struct timer_elm_s *timer_p) {
+  timer_p->armed = false;
+  timer_p->timer_arg = NULL;
   /*
-   * Timer is a one shot timer, remove it
+   * Invalidate any outstanding id referencing this element
    */
-  if (timer_p->type == TIMER_ONE_SHOT) {
-    //         if (timer_delete(timer_p->timer) < 0) {
-    //             TMR_DEBUG("Failed to delete timer 0x%lx",
-    //             (long)timer_p->timer);
-    //         }
-    //         TMR_DEBUG("Removed timer 0x%lx", (long)timer_p->timer);
-    //         pthread_mutex_lock(&timer_desc.timer_list_mutex);
-    //         STAILQ_REMOVE(&timer_desc.timer_queue, timer_p, timer_elm_s,
-    //         entries); pthread_mutex_unlock(&timer_desc.timer_list_mutex);
-    //         free_wrapper(timer_p);
-    //         timer_p = NULL;
-    if (timer_remove((long)timer_p->timer, NULL) != 0) {
-      OAILOG_DEBUG(LOG_ITTI, "Failed to delete timer 0x%lx\n",
-                   (long)timer_p->timer);
+  timer_p->generation = (timer_p->generation + 1) & INT32_MAX;
+  if (timer_p->generation == 0) timer_p->generation = 1;
+  timer_p->next_free = timer_desc.free_head;
+  timer_desc.free_head = timer_p->index;
+}
+
+//------------------------------------------------------------------------------
+// Must be called with timer_list_mutex held
+static void timer_wheel_add(struct timer_elm_s *timer_p) {
+  uint64_t delta = 0;
+  uint64_t expires = timer_p->expires;
+  int level = 0;
+
+  if (expires < timer_desc.current_tick) {
+    expires = timer_desc.current_tick;
+  }
+  delta = expires - timer_desc.current_tick;
+  if (delta > TIMER_WHEEL_MAX_TICKS) {
+    /*
+     * Parked in the last level, it will be cascaded again until it fits
+     */
+    delta = TIMER_WHEEL_MAX_TICKS;
+    expires = timer_desc.current_tick + delta;
+  }
+  for (level = 0; level < TIMER_WHEEL_LEVELS - 1; level++) {
+    if (delta < (UINT64_C(1) << ((level + 1) * TIMER_WHEEL_BITS))) {
+      break;
+    }
+  }
+  LIST_INSERT_HEAD(&timer_desc.wheel[level][(expires >> (level *
+                                                         TIMER_WHEEL_BITS)) &
+                                            TIMER_WHEEL_MASK],
+                   timer_p, entries);
+  timer_p->armed = true;
+}
+
+//------------------------------------------------------------------------------
+// Must be called with timer_list_mutex held
+static void timer_wheel_cascade(int level) {
+  struct timer_elm_s *timer_p = NULL;
+  int index = (timer_desc.current_tick >> (level * TIMER_WHEEL_BITS)) &
+              TIMER_WHEEL_MASK;
+
+  while ((timer_p = LIST_FIRST(&timer_desc.wheel[level][index]))) {
+    LIST_REMOVE(timer_p, entries);
+    timer_wheel_add(timer_p);
+  }
+  // Higher levels are cascaded when this one wraps around
+  if ((index == 0) && (level + 1 < TIMER_WHEEL_LEVELS)) {
+    timer_wheel_cascade(level + 1);
+  }
+}
+
+//------------------------------------------------------------------------------
+static void timer_dispatch(timer_expiry_t *expiries, int nb_expiries) {
+  for (int i = 0; i < nb_expiries; i++) {
+    if (itti_send_msg_to_task(expiries[i].task_id, expiries[i].instance,
+                              expiries[i].message_p) < 0) {
+      OAILOG_DEBUG(LOG_ITTI,
+                   "Failed to send msg TIMER_HAS_EXPIRED to task %u\n",
+                   expiries[i].task_id);
+      itti_free(TASK_TIMER, expiries[i].message_p);
     }
   }
+}
+
+//------------------------------------------------------------------------------
+static void timer_wheel_run(uint64_t now_tick) {
+  timer_expiry_t expiries[TIMER_DISPATCH_BATCH];
+  int nb_expiries = 0;
+
+  pthread_mutex_lock(&timer_desc.timer_list_mutex);
+  while (timer_desc.current_tick <= now_tick) {
+    struct timer_elm_s *timer_p = NULL;
+    int index = timer_desc.current_tick & TIMER_WHEEL_MASK;
+
+    if (index == 0 && timer_desc.current_tick != 0) {
+      timer_wheel_cascade(1);
+    }
+
+    while ((timer_p = LIST_FIRST(&timer_desc.wheel[0][index]))) {
+      MessageDef *message_p = NULL;
+      timer_has_expired_t *timer_expired_p = NULL;
+
+      LIST_REMOVE(timer_p, entries);
+      timer_p->armed = false;
+      if (timer_p->expires > timer_desc.current_tick) {
+        // Timer was clamped to the wheel range, not yet expired
+        timer_wheel_add(timer_p);
+        continue;
+      }
+
+      if (timer_p->task_id >= TASK_MAX) {
+        OAILOG_ERROR(LOG_ITTI,
+                     " TIMER OBJECT %p (id 0x%lx) task_id %d is invalid. \n",
+                     timer_p,
+                     TIMER_ID_BUILD(timer_p->generation, timer_p->index),
+                     timer_p->task_id);
+        timer_desc.nb_armed--;
+        timer_release_elm(timer_p);
+        continue;
+      }
+
+      message_p = itti_alloc_new_message(TASK_TIMER, TIMER_HAS_EXPIRED);
+      timer_expired_p = &message_p->ittiMsg.timer_has_expired;
+      timer_expired_p->timer_id =
+          TIMER_ID_BUILD(timer_p->generation, timer_p->index);
+      timer_expired_p->arg = timer_p->timer_arg;
+      expiries[nb_expiries].task_id = timer_p->task_id;
+      expiries[nb_expiries].instance = timer_p->instance;
+      expiries[nb_expiries].message_p = message_p;
+      nb_expiries++;
+
+      if (timer_p->type == TIMER_PERIODIC) {
+        timer_p->expires = timer_desc.current_tick + timer_p->period;
+        timer_wheel_add(timer_p);
+      } else {
+        /*
+         * Timer is a one shot timer, remove it
+         */
+        timer_desc.nb_armed--;
+        timer_release_elm(timer_p);
+      }
+
+      if (nb_expiries == TIMER_DISPATCH_BATCH) {
+        pthread_mutex_unlock(&timer_desc.timer_list_mutex);
+        timer_dispatch(expiries, nb_expiries);
+        nb_expiries = 0;
+        pthread_mutex_lock(&timer_desc.timer_list_mutex);
+      }
+    }
+    timer_desc.current_tick++;
+  }
+  pthread_mutex_unlock(&timer_desc.timer_list_mutex);
 
   /*
-   * Notify task of timer expiry
+   * Notify tasks of timer expiries
    */
-  if (abs(task_id) > TASK_MAX) {
-    OAILOG_ERROR(
-        LOG_ITTI,
-        " TIMER OBJECT %x (with inner timer %x) task_id %d is invalid. \n",
-        timer_p, timer_p->timer, timer_p->task_id);
-    itti_free(TASK_TIMER, message_p);
-    return -1;
-  }
-  if (itti_send_msg_to_task(task_id, instance, message_p) < 0) {
-    OAILOG_DEBUG(LOG_ITTI, "Failed to send msg TIMER_HAS_EXPIRED to task %u\n",
-                 task_id);
-    itti_free(TASK_TIMER, message_p);
-    return -1;
+  timer_dispatch(expiries, nb_expiries);
+}
+
+//------------------------------------------------------------------------------
+static void timer_handle_tick(void) {
+  uint64_t expirations = 0;
+
+  if (read(timer_desc.timer_fd, &expirations, sizeof(expirations)) !=
+      sizeof(expirations)) {
+    if (errno != EAGAIN) {
+      OAILOG_ERROR(LOG_ITTI, "Failed to read timer fd: (%s:%d)\n",
+                   strerror(errno), errno);
+    }
+    return;
   }
+  /*
+   * Catch up with wall clock rather than counting expirations, the task may
+   * have been descheduled for several ticks
+   */
+  timer_wheel_run((timer_monotonic_ms() - timer_desc.start_ms) /
+                  TIMER_WHEEL_TICK_MS);
+}
 
-  return 0;
+//------------------------------------------------------------------------------
+static void *timer_task(__attribute__((unused)) void *args_p) {
+  itti_mark_task_ready(TASK_TIMER);
+
+  while (1) {
+    MessageDef *received_message_p = NULL;
+    struct epoll_event *events = NULL;
+    int nb_events = 0;
+
+    itti_receive_msg(TASK_TIMER, &received_message_p);
+
+    if (received_message_p != NULL) {
+      switch (ITTI_MSG_ID(received_message_p)) {
+        case TERMINATE_MESSAGE: {
+          itti_unsubscribe_event_fd(TASK_TIMER, timer_desc.timer_fd);
+          close(timer_desc.timer_fd);
+          timer_desc.timer_fd = -1;
+          itti_free(ITTI_MSG_ORIGIN_ID(received_message_p),
+                    received_message_p);
+          itti_exit_task();
+        } break;
+
+        default: {
+          OAILOG_DEBUG(LOG_ITTI, "Unkwnon message ID %d:%s\n",
+                       ITTI_MSG_ID(received_message_p),
+                       ITTI_MSG_NAME(received_message_p));
+        } break;
+      }
+      itti_free(ITTI_MSG_ORIGIN_ID(received_message_p), received_message_p);
+      received_message_p = NULL;
+    }
+
+    nb_events = itti_get_events(TASK_TIMER, &events);
+    for (int i = 0; (i < nb_events) && (events != NULL); i++) {
+      if ((events[i].events & EPOLLIN) &&
+          (events[i].data.fd == timer_desc.timer_fd)) {
+        timer_handle_tick();
+      }
+    }
+  }
+  return NULL;
 }
 
+//------------------------------------------------------------------------------
 int timer_setup(uint32_t interval_sec, uint32_t interval_us, task_id_t task_id,
                 int32_t instance, timer_type_t type, void *timer_arg,
                 long *timer_id) {
-  struct sigevent se;
-  struct itimerspec its;
   struct timer_elm_s *timer_p;
-  timer_t timer;
+  uint64_t ticks = 0;
 
   if (timer_id == NULL) {
     return -1;
@@ -137,95 +386,68 @@ int timer_setup(uint32_t interval_sec, uint32_t interval_us, task_id_t task_id,
 
   AssertFatal(type < TIMER_TYPE_MAX, "Invalid timer type (%d/%d)!\n", type,
               TIMER_TYPE_MAX);
+
   /*
-   * Allocate new timer list element
+   * Round up to the next tick, a timer never expires before its interval
    */
-  timer_p = malloc(sizeof(struct timer_elm_s));
+  ticks = ((uint64_t)interval_sec * 1000000 + interval_us +
+           (TIMER_WHEEL_TICK_MS * 1000) - 1) /
+          (TIMER_WHEEL_TICK_MS * 1000);
+  if (ticks == 0) {
+    ticks = 1;
+  }
+
+  pthread_mutex_lock(&timer_desc.timer_list_mutex);
+  /*
+   * Allocate new timer element
+   */
+  timer_p = timer_alloc_elm();
 
   if (timer_p == NULL) {
+    pthread_mutex_unlock(&timer_desc.timer_list_mutex);
     OAILOG_ERROR(LOG_ITTI, "Failed to create new timer element\n");
     return -1;
   }
 
-  memset(&timer, 0, sizeof(timer_t));
-  memset(&se, 0, sizeof(struct sigevent));
   timer_p->task_id = task_id;
   timer_p->instance = instance;
   timer_p->type = type;
   timer_p->timer_arg = timer_arg;
-  /*
-   * Setting up alarm
-   */
-  /*
-   * Set and enable alarm
-   */
-  se.sigev_notify = SIGEV_SIGNAL;
-  se.sigev_signo = SIGTIMER;
-  se.sigev_value.sival_ptr = timer_p;
-
-  /*
-   * At the timer creation, the timer structure will be filled in with timer_id,
-   * * * which is unique for this process. This id is allocated by kernel and
-   * the
-   * * * value might be used to distinguish timers.
-   */
-  if (timer_create(CLOCK_REALTIME, &se, &timer) < 0) {
-    OAILOG_ERROR(LOG_ITTI, "Failed to create timer: (%s:%d)\n", strerror(errno),
-                 errno);
-    free_wrapper((void **)&timer_p);
-    return -1;
-  }
-
-  /*
-   * Fill in the first expiration value.
-   */
-  its.it_value.tv_sec = interval_sec;
-  its.it_value.tv_nsec = interval_us * 1000;
-
-  if (type == TIMER_PERIODIC) {
-    /*
-     * Asked for periodic timer. We set the interval time
-     */
-    its.it_interval.tv_sec = interval_sec;
-    its.it_interval.tv_nsec = interval_us * 1000;
-  } else {
-    /*
-     * Asked for one-shot timer. Do not set the interval field
-     */
-    its.it_interval.tv_sec = 0;
-    its.it_interval.tv_nsec = 0;
-  }
-
-  timer_settime(timer, 0, &its, NULL);
+  timer_p->period = ticks;
+  timer_p->expires = timer_desc.current_tick + ticks;
+  timer_wheel_add(timer_p);
+  timer_desc.nb_armed++;
   /*
    * Simply set the timer_id argument. so it can be used by caller
    */
-  *timer_id = (long)timer;
+  *timer_id = TIMER_ID_BUILD(timer_p->generation, timer_p->index);
+  pthread_mutex_unlock(&timer_desc.timer_list_mutex);
+
   OAILOG_TRACE(LOG_ITTI,
                "Requesting new %s timer with id 0x%lx that expires within "
                "%d sec and %d usec\n",
                type == TIMER_PERIODIC ? "periodic" : "single shot", *timer_id,
                interval_sec, interval_us);
-  timer_p->timer = timer;
-  /*
-   * Lock the queue and insert the timer at the tail
-   */
-  pthread_mutex_lock(&timer_desc.timer_list_mutex);
-  STAILQ_INSERT_TAIL(&timer_desc.timer_queue, timer_p, entries);
-  pthread_mutex_unlock(&timer_desc.timer_list_mutex);
   return 0;
 }
 
+//------------------------------------------------------------------------------
 int timer_remove(long timer_id, void **arg) {
-  int rc = 0;
-  struct timer_elm_s *timer_p;
+  struct timer_elm_s *timer_p = NULL;
+  uint32_t index = TIMER_ID_INDEX(timer_id);
 
   OAILOG_TRACE(LOG_ITTI, "Removing timer 0x%lx\n", timer_id);
   pthread_mutex_lock(&timer_desc.timer_list_mutex);
-  TIMER_SEARCH(timer_p, timer, ((timer_t)timer_id), &timer_desc.timer_queue);
+  if ((timer_id > 0) && (index < (timer_desc.nb_chunks << TIMER_CHUNK_BITS))) {
+    timer_p = timer_get_elm(index);
+    if ((!timer_p->armed) ||
+        (timer_p->generation != TIMER_ID_GENERATION(timer_id))) {
+      timer_p = NULL;
+    }
+  }
 
   /*
-   * We didn't find the timer in list
+   * We didn't find the timer (already expired or removed)
    */
   if (timer_p == NULL) {
     pthread_mutex_unlock(&timer_desc.timer_list_mutex);
@@ -234,31 +456,54 @@ int timer_remove(long timer_id, void **arg) {
     return -1;
   }
 
-  STAILQ_REMOVE(&timer_desc.timer_queue, timer_p, timer_elm_s, entries);
-  pthread_mutex_unlock(&timer_desc.timer_list_mutex);
-
+  LIST_REMOVE(timer_p, entries);
+  timer_desc.nb_armed--;
   // let user of API get back arg that can be an allocated memory (memory leak).
-
   if (arg) *arg = timer_p->timer_arg;
-  if (timer_delete(timer_p->timer) < 0) {
-    OAILOG_ERROR(LOG_ITTI, "Failed to delete timer 0x%lx\n",
-                 (long)timer_p->timer);
-    rc = -1;
-  }
-
-  OAILOG_TRACE(LOG_ITTI,
-               "REMOVED TIMER OBJECT %x (inner timer %x) with task_id %d. \n",
-               timer_p, timer_p->timer, timer_p->task_id);
-
-  free_wrapper((void **)&timer_p);
-  return rc;
+  OAILOG_TRACE(LOG_ITTI, "REMOVED TIMER OBJECT %p with task_id %d. \n",
+               timer_p, timer_p->task_id);
+  timer_release_elm(timer_p);
+  pthread_mutex_unlock(&timer_desc.timer_list_mutex);
+  return 0;
 }
 
+//------------------------------------------------------------------------------
 int timer_init(void) {
+  struct itimerspec its;
+
   OAILOG_DEBUG(LOG_ITTI, "Initializing TIMER task interface\n");
   memset(&timer_desc, 0, sizeof(timer_desc_t));
-  STAILQ_INIT(&timer_desc.timer_queue);
+  for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+    for (int index = 0; index < TIMER_WHEEL_SIZE; index++) {
+      LIST_INIT(&timer_desc.wheel[level][index]);
+    }
+  }
+  timer_desc.free_head = TIMER_INDEX_NONE;
+  timer_desc.start_ms = timer_monotonic_ms();
   pthread_mutex_init(&timer_desc.timer_list_mutex, NULL);
+
+  timer_desc.timer_fd =
+      timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (timer_desc.timer_fd < 0) {
+    OAILOG_ERROR(LOG_ITTI, "Failed to create timer fd: (%s:%d)\n",
+                 strerror(errno), errno);
+    return -1;
+  }
+  its.it_value.tv_sec = 0;
+  its.it_value.tv_nsec = TIMER_WHEEL_TICK_MS * 1000000;
+  its.it_interval = its.it_value;
+  if (timerfd_settime(timer_desc.timer_fd, 0, &its, NULL) < 0) {
+    OAILOG_ERROR(LOG_ITTI, "Failed to arm timer fd: (%s:%d)\n",
+                 strerror(errno), errno);
+    close(timer_desc.timer_fd);
+    return -1;
+  }
+  itti_subscribe_event_fd(TASK_TIMER, timer_desc.timer_fd);
+
+  if (itti_create_task(TASK_TIMER, &timer_task, NULL) < 0) {
+    OAILOG_ERROR(LOG_ITTI, "timer pthread_create (%s)\n", strerror(errno));
+    return -1;
+  }
   OAILOG_DEBUG(LOG_ITTI, "Initializing TIMER task interface: DONE\n");
   return 0;
 }
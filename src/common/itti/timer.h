@@ -28,8 +28,6 @@ typedef enum timer_type_s {
   TIMER_TYPE_MAX,
 } timer_type_t;
 
-int timer_handle_signal(siginfo_t* info);
-
 /** \brief Request a new timer
  *  \param interval_sec timer interval in seconds
  *  \param interval_us  timer interval in micro seconds
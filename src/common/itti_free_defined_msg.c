@@ -426,6 +426,7 @@ void itti_free_msg_content(MessageDef* const message_p) {
       bdestroy_wrapper(&message_p->ittiMsg.sctp_data_req.payload);
       AssertFatal(NULL == message_p->ittiMsg.sctp_data_req.payload,
                   "TODO clean pointer");
+      shared_bstring_unref(&message_p->ittiMsg.sctp_data_req.shared_payload);
       break;
 
     case SCTP_DATA_IND:
@@ -442,10 +443,13 @@ void itti_free_msg_content(MessageDef* const message_p) {
 
     case UDP_INIT:
     case UDP_DATA_REQ:
-    case UDP_DATA_IND:
       /** Changed to stacked buffer. */
       break;
 
+    case UDP_DATA_IND:
+      shared_buffer_unref(&message_p->ittiMsg.udp_data_ind.buffer);
+      break;
+
     case S1AP_PATH_SWITCH_REQUEST_ACKNOWLEDGE:
       /** Bearer Contexts to be switched. */
       if (message_p->ittiMsg.s1ap_path_switch_request_ack
@@ -578,3 +582,13 @@ void itti_free_msg_content(MessageDef* const message_p) {
       break;
   }
 }
+
+//------------------------------------------------------------------------------
+void itti_free_received_msgs(MessageDef** const received_msgs,
+                             const int first_msg, const int nb_msgs) {
+  for (int m = first_msg; m < nb_msgs; m++) {
+    itti_free_msg_content(received_msgs[m]);
+    itti_free(ITTI_MSG_ORIGIN_ID(received_msgs[m]), received_msgs[m]);
+    received_msgs[m] = NULL;
+  }
+}
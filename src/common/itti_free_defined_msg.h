@@ -27,4 +27,9 @@
 
 void itti_free_msg_content(MessageDef* const message_p);
 
+/* Frees the messages [first_msg, nb_msgs) of a batch of itti_receive_msgs, not
+ * handled by a task exiting on TERMINATE_MESSAGE */
+void itti_free_received_msgs(MessageDef** const received_msgs,
+                             const int first_msg, const int nb_msgs);
+
 #endif /* FILE_ITTI_FREE_DEFINED_MSG_SEEN */
@@ -47,6 +47,7 @@ typedef struct sctp_data_cnf_s {
 
 typedef struct sctp_data_req_s {
   bstring payload;
+  struct shared_bstring_s* shared_payload;  // sent if payload is NULL
   sctp_assoc_id_t assoc_id;
   sctp_stream_id_t stream;
   uint32_t mme_ue_s1ap_id;  // for helping data_rej
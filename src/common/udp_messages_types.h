@@ -45,7 +45,8 @@ typedef struct {
 } udp_data_req_t;
 
 typedef struct {
-  uint8_t msgBuf[UDP_DATA_MAX_MSG_LEN];
+  struct shared_buffer_s* buffer;  // receive buffer, released with the message
+  uint8_t* msgBuf;                 // datagram in buffer
   uint32_t buffer_length;
   uint16_t local_port;
   union {
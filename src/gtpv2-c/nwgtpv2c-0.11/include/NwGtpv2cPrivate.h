@@ -85,6 +85,36 @@ extern "C" {
     }                                                                      \
   } while (0)
 
+/*--------------------------------------------------------------------------*
+ *                   O B J E C T   P O O L   D E F I N I T I O N            *
+ *--------------------------------------------------------------------------*/
+
+#define NW_GTPV2C_POOL_DEFAULT_MAX_SIZE (1024)
+/* Messages and parsers are some 40 kB each, keep fewer of them */
+#define NW_GTPV2C_MSG_POOL_DEFAULT_MAX_SIZE (128)
+
+/**
+ * Free list of objects of one type, owned by a stack instance
+ */
+
+typedef struct nw_gtpv2c_pool_s {
+  void* pHead;
+  size_t nextOffset; /**< Offset of the free list link in the objects */
+  nw_gtpv2c_pool_stats_t stats;
+} nw_gtpv2c_pool_t;
+
+/* Expiries of the timerfd are rounded up to this, see nwGtpv2cSetTimerFd */
+#define NW_GTPV2C_TIMER_FD_RESOLUTION_USEC (10000)
+
+/**
+ * Request counters of a peer
+ */
+
+typedef struct nw_gtpv2c_peer_s {
+  nw_gtpv2c_peer_stats_t stats;
+  RB_ENTRY(nw_gtpv2c_peer_s) peerMapRbtNode;
+} nw_gtpv2c_peer_t;
+
 /*--------------------------------------------------------------------------*
  *  G T P V 2 C   S T A C K   O B J E C T   T Y P E    D E F I N I T I O N  *
  *--------------------------------------------------------------------------*/
@@ -114,7 +144,13 @@ typedef struct nw_gtpv2c_stack_s {
   RB_HEAD(NwGtpv2cOutstandingRxSeqNumTrxnMap, nw_gtpv2c_trxn_s)
   outstandingRxSeqNumMap;
   RB_HEAD(NwGtpv2cActiveTimerList, nw_gtpv2c_timeout_info_s) activeTimerList;
+  RB_HEAD(NwGtpv2cPeerMap, nw_gtpv2c_peer_s) peerMap;
   NwPtrT hTmrMinHeap;
+  int tmrFd;         /**< timerfd of the stack, -1 with a timer mgr entity */
+  void* pTmrFdArg;   /**< Timer armed on the timerfd                       */
+  nw_gtpv2c_pool_t pool[NW_GTPV2C_POOL_END];
+  struct shared_buffer_s*
+      pRxBuffer; /**< Buffer of the datagram being processed, if shared */
 } nw_gtpv2c_stack_t;
 
 /*--------------------------------------------------------------------------*
@@ -165,7 +201,19 @@ typedef struct nw_gtpv2c_msg_s {
 
   bool isIeValid[NW_GTPV2C_IE_TYPE_MAXIMUM][NW_GTPV2C_IE_INSTANCE_MAXIMUM];
   uint8_t* pIe[NW_GTPV2C_IE_TYPE_MAXIMUM][NW_GTPV2C_IE_INSTANCE_MAXIMUM];
-  uint8_t msgBuf[NW_GTPV2C_MAX_MSG_LEN];
+
+/* An IE takes at least 4 bytes of the message buffer */
+#define NW_GTPV2C_MAX_MSG_IE (NW_GTPV2C_MAX_MSG_LEN / 4)
+  /** Slots of pIe and isIeValid set since the last reset, the other slots
+      are all clear. */
+  uint16_t ieCount;
+  struct {
+    uint8_t type;
+    uint8_t instance;
+  } ieIndex[NW_GTPV2C_MAX_MSG_IE];
+  uint8_t* msgBuf; /**< msgBufLocal, or the datagram in pRxBuffer */
+  struct shared_buffer_s* pRxBuffer; /**< Receive buffer referenced */
+  uint8_t msgBufLocal[NW_GTPV2C_MAX_MSG_LEN];
   nw_gtpv2c_stack_handle_t hStack;
   struct nw_gtpv2c_msg_s* next;
 } nw_gtpv2c_msg_t;
@@ -225,6 +273,15 @@ RB_PROTOTYPE(NwGtpv2cOutstandingRxSeqNumTrxnMap, nw_gtpv2c_trxn_s,
              outstandingRxSeqNumMapRbtNode, nwGtpv2cCompareSeqNum)
 RB_PROTOTYPE(NwGtpv2cActiveTimerList, nw_gtpv2c_timeout_info_s,
              activeTimerListRbtNode, nwGtpv2cCompareOutstandingTxRexmitTime)
+RB_PROTOTYPE(NwGtpv2cPeerMap, nw_gtpv2c_peer_s, peerMapRbtNode,
+             nwGtpv2cComparePeer)
+
+/**
+ * Counters of a peer, created on first use
+ */
+
+nw_gtpv2c_peer_stats_t* nwGtpv2cPeerStats(nw_gtpv2c_stack_t* thiz,
+                                          struct sockaddr* peerIp);
 
 /**
  * Start Timer with ULP Timer Manager
@@ -243,6 +300,44 @@ nw_rc_t nwGtpv2cStartTimer(nw_gtpv2c_stack_t* thiz, uint32_t timeoutSec,
 nw_rc_t nwGtpv2cStopTimer(nw_gtpv2c_stack_t* thiz,
                           nw_gtpv2c_timer_handle_t hTimer);
 
+/**
+ * Take an object from a pool of the stack, NULL if the pool is empty
+ */
+
+void* nwGtpv2cPoolGet(nw_gtpv2c_stack_t* thiz, nw_gtpv2c_pool_type_t type);
+
+/**
+ * Give back an object to a pool of the stack, freed if the pool is full
+ */
+
+void nwGtpv2cPoolPut(nw_gtpv2c_stack_t* thiz, nw_gtpv2c_pool_type_t type,
+                     void* pObj);
+
+/**
+ * Copy the data of a message referencing a receive buffer in the message
+ */
+
+void nwGtpv2cMsgCopyRxBuffer(nw_gtpv2c_msg_t* pMsg);
+
+/**
+ * Clear the IEs found by the previous parsing of a message
+ */
+
+void nwGtpv2cMsgResetIes(nw_gtpv2c_msg_t* pMsg);
+
+/**
+ * Clear the IE pointers of a message, the IEs stay valid
+ */
+
+void nwGtpv2cMsgResetIePointers(nw_gtpv2c_msg_t* pMsg);
+
+/**
+ * Record an IE of a message being parsed
+ */
+
+void nwGtpv2cMsgSetIe(nw_gtpv2c_msg_t* pMsg, uint8_t type, uint8_t instance,
+                      uint8_t* pIe, bool isIeValid);
+
 #ifdef __cplusplus
 }
 #endif
@@ -476,6 +476,47 @@ typedef struct nw_gtpv2c_log_mgr_entity_s {
                             NW_IN uint32_t line, NW_IN char* logStr);
 } nw_gtpv2c_log_mgr_entity_t;
 
+/**
+ * Object pools of a stack instance
+ */
+
+typedef enum nw_gtpv2c_pool_type_e {
+  NW_GTPV2C_POOL_MSG = 0,
+  NW_GTPV2C_POOL_TRXN,
+  NW_GTPV2C_POOL_TIMEOUT_INFO,
+  NW_GTPV2C_POOL_TUNNEL,
+  NW_GTPV2C_POOL_MSG_PARSER,
+  NW_GTPV2C_POOL_END
+} nw_gtpv2c_pool_type_t;
+
+/**
+ * Statistics of an object pool
+ */
+
+typedef struct nw_gtpv2c_pool_stats_s {
+  uint32_t size;      /**< Objects kept for reuse                       */
+  uint32_t maxSize;   /**< Objects kept at most, the others are freed   */
+  uint32_t highWater; /**< Largest size reached                          */
+  uint64_t nbAllocs;  /**< Objects allocated, the pool being empty       */
+  uint64_t nbReuses;  /**< Objects taken from the pool                   */
+  uint64_t nbFrees;   /**< Objects freed, the pool being full            */
+} nw_gtpv2c_pool_stats_t;
+
+/**
+ * Request counters of a peer, the port is not part of the peer
+ */
+
+typedef struct nw_gtpv2c_peer_stats_s {
+  union {
+    struct sockaddr_in addrv4;
+    struct sockaddr_in6 addrv6;
+  } peerIp;
+  uint64_t nbRetransmissions; /**< Requests sent again on T3 expiry   */
+  uint64_t nbRspFailures;     /**< Requests unanswered after N3 tries */
+} nw_gtpv2c_peer_stats_t;
+
+struct shared_buffer_s;
+
 /*--------------------------------------------------------------------------*
  *                     P U B L I C   F U N C T I O N S                      *
  *--------------------------------------------------------------------------*/
@@ -603,6 +644,27 @@ nw_rc_t nwGtpv2cProcessUdpReq(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
                               NW_IN uint16_t localPort, NW_IN uint16_t peerPort,
                               NW_IN struct sockaddr* peerIp);
 
+/**
+ Process Data Request from UDP entity, without copying the data if the
+ receive buffer is given: the messages created from the data keep a
+ reference to the buffer until they are deleted.
+
+ @param[in] hGtpcStackHandle : Stack handle
+ @param[in] buffer : Receive buffer holding the UDP data, or NULL.
+ @param[in] udpData : Pointer to received UDP data, in the buffer.
+ @param[in] udpDataLen : Received data length.
+ @param[in] localPort : Received on local port.
+ @param[in] dstPort : Received on port.
+ @param[in] from : Received from peer information.
+ @return NW_OK on success.
+ */
+
+nw_rc_t nwGtpv2cProcessUdpBuffer(
+    NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+    NW_IN struct shared_buffer_s* buffer, NW_IN uint8_t* udpData,
+    NW_IN uint32_t udpDataLen, NW_IN uint16_t localPort,
+    NW_IN uint16_t peerPort, NW_IN struct sockaddr* peerIp);
+
 /**
  Process Request from ULP entity.
 
@@ -623,6 +685,88 @@ nw_rc_t nwGtpv2cProcessUlpReq(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
 
 nw_rc_t nwGtpv2cProcessTimeout(NW_IN void* timeoutArg);
 
+/**
+ Get the statistics of an object pool of the stack. The pools belong to
+ the stack instance: like the rest of the stack, they are not locked and
+ must only be used from the thread running the stack.
+
+ @param[in] hGtpcStackHandle : Stack handle
+ @param[in] type : Pool.
+ @param[out] pStats : Statistics of the pool.
+ @return NW_OK on success.
+ */
+
+nw_rc_t nwGtpv2cGetPoolStats(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+                             NW_IN nw_gtpv2c_pool_type_t type,
+                             NW_OUT nw_gtpv2c_pool_stats_t* pStats);
+
+/**
+ Set the number of objects an object pool of the stack keeps for reuse.
+
+ @param[in] hGtpcStackHandle : Stack handle
+ @param[in] type : Pool.
+ @param[in] maxSize : Objects kept at most, 0 to disable the pool.
+ @return NW_OK on success.
+ */
+
+nw_rc_t nwGtpv2cSetPoolMaxSize(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+                               NW_IN nw_gtpv2c_pool_type_t type,
+                               NW_IN uint32_t maxSize);
+
+/**
+ Replace the timer manager entity of the stack by a timerfd owned by the
+ stack. The stack only ever arms one timer, for the head of its timer heap:
+ the timerfd is armed for it and, when the fd is readable, every timer of
+ the heap that is due is expired in one batch by nwGtpv2cProcessTimerFd().
+ Expiries are rounded up to 10 ms so that the T3 timers of requests sent
+ together share a wake-up.
+
+ @param[in] hGtpcStackHandle : Stack handle
+ @param[out] pFd : timerfd to poll for reading, closed by nwGtpv2cFinalize.
+ @return NW_OK on success, NW_FAILURE if the timerfd cannot be created.
+ */
+
+nw_rc_t nwGtpv2cSetTimerFd(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+                           NW_OUT int* pFd);
+
+/**
+ Expire the due timers of a stack using a timerfd, to be called when the fd
+ returned by nwGtpv2cSetTimerFd() is readable.
+
+ @param[in] hGtpcStackHandle : Stack handle
+ @return NW_OK on success.
+ */
+
+nw_rc_t nwGtpv2cProcessTimerFd(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle);
+
+/**
+ Get the request counters of a peer. Like the pool statistics, they must
+ only be read from the thread running the stack.
+
+ @param[in] hGtpcStackHandle : Stack handle
+ @param[in] peerIp : Address of the peer.
+ @param[out] pStats : Counters of the peer.
+ @return NW_OK on success, NW_FAILURE if nothing was counted for the peer.
+ */
+
+nw_rc_t nwGtpv2cGetPeerStats(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+                             NW_IN struct sockaddr* peerIp,
+                             NW_OUT nw_gtpv2c_peer_stats_t* pStats);
+
+/**
+ Call a function for the request counters of each peer, in address order.
+
+ @param[in] hGtpcStackHandle : Stack handle
+ @param[in] callback : Function called for each peer.
+ @param[in] arg : Argument of the callback.
+ @return NW_OK on success.
+ */
+
+nw_rc_t nwGtpv2cForEachPeerStats(
+    NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+    NW_IN void (*callback)(const nw_gtpv2c_peer_stats_t* pStats, void* arg),
+    NW_IN void* arg);
+
 #ifdef __cplusplus
 }
 #endif
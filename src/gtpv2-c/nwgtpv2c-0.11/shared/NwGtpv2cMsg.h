@@ -251,6 +251,23 @@ nw_rc_t nwGtpv2cMsgFromBufferNew(
     NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle, NW_IN uint8_t* pBuf,
     NW_IN uint32_t bufLen, NW_OUT nw_gtpv2c_msg_handle_t* phMsg);
 
+/**
+ * Allocate a gtpv2c message referencing a data buffer, without copy.
+ * The message holds a reference to the shared buffer until it is deleted,
+ * the data is copied only if IEs are added to the message.
+ *
+ * @param[in] hGtpcStackHandle : gtpv2c stack handle.
+ * @param[in] buffer: Shared buffer holding the data.
+ * @param[in] pBuf: Data of this message, in the shared buffer.
+ * @param[in] bufLen: Data length.
+ * @param[out] phMsg : Pointer to message handle.
+ */
+
+nw_rc_t nwGtpv2cMsgFromSharedBufferNew(
+    NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+    NW_IN struct shared_buffer_s* buffer, NW_IN uint8_t* pBuf,
+    NW_IN uint32_t bufLen, NW_OUT nw_gtpv2c_msg_handle_t* phMsg);
+
 /**
  * Free a gtpv2c message.
  *
@@ -65,6 +65,22 @@ typedef struct nw_gtpv2c_msg_parser_s {
   } ieParseInfo[NW_GTPV2C_IE_TYPE_MAXIMUM][NW_GTPV2C_IE_INSTANCE_MAXIMUM];
 
   uint8_t* pIe[NW_GTPV2C_IE_TYPE_MAXIMUM][NW_GTPV2C_IE_INSTANCE_MAXIMUM];
+
+  uint16_t ieCount; /**< Slots of pIe set by the last run, cleared by the
+                         next one. */
+  struct {
+    uint8_t type;
+    uint8_t instance;
+  } ieIndex[NW_GTPV2C_IE_TYPE_MAXIMUM * NW_GTPV2C_IE_INSTANCE_MAXIMUM];
+
+  /** Slots of ieParseInfo set by nwGtpv2cMsgParserAddIe(), cleared when the
+      parser is reused. */
+  uint16_t ieInfoCount;
+  struct {
+    uint8_t type;
+    uint8_t instance;
+  } ieInfoIndex[NW_GTPV2C_IE_TYPE_MAXIMUM * NW_GTPV2C_IE_INSTANCE_MAXIMUM];
+  struct nw_gtpv2c_msg_parser_s* next;
 } nw_gtpv2c_msg_parser_t;
 
 #ifdef __cplusplus
@@ -31,11 +31,16 @@
    THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
   ----------------------------------------------------------------------------*/
 
+#include <errno.h>
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "bstrlib.h"
 
@@ -43,6 +48,7 @@
 #include "NwGtpv2c.h"
 #include "NwGtpv2cIe.h"
 #include "NwGtpv2cLog.h"
+#include "NwGtpv2cMsgParser.h"
 #include "NwGtpv2cPrivate.h"
 #include "NwGtpv2cTrxn.h"
 #include "NwTypes.h"
@@ -95,7 +101,69 @@
 extern "C" {
 #endif
 
-static nw_gtpv2c_timeout_info_t *gpGtpv2cTimeoutInfoPool = NULL;
+/*----------------------------------------------------------------------------*
+                            O B J E C T   P O O L S
+  ----------------------------------------------------------------------------*/
+
+#define NW_GTPV2C_POOL_NEXT(__pool, __obj) \
+  (*(void **)((uint8_t *)(__obj) + (__pool)->nextOffset))
+
+static void nwGtpv2cPoolInit(nw_gtpv2c_stack_t *thiz,
+                             nw_gtpv2c_pool_type_t type, size_t nextOffset,
+                             uint32_t maxSize) {
+  nw_gtpv2c_pool_t *pPool = &thiz->pool[type];
+
+  memset(pPool, 0, sizeof(nw_gtpv2c_pool_t));
+  pPool->nextOffset = nextOffset;
+  pPool->stats.maxSize = maxSize;
+}
+
+static void nwGtpv2cPoolFlush(nw_gtpv2c_stack_t *thiz,
+                              nw_gtpv2c_pool_type_t type, uint32_t size) {
+  nw_gtpv2c_pool_t *pPool = &thiz->pool[type];
+  void *pObj;
+
+  while ((pPool->stats.size > size) && (pObj = pPool->pHead)) {
+    pPool->pHead = NW_GTPV2C_POOL_NEXT(pPool, pObj);
+    pPool->stats.size--;
+    pPool->stats.nbFrees++;
+    NW_GTPV2C_FREE(thiz, pObj);
+  }
+}
+
+void *nwGtpv2cPoolGet(nw_gtpv2c_stack_t *thiz, nw_gtpv2c_pool_type_t type) {
+  nw_gtpv2c_pool_t *pPool = &thiz->pool[type];
+  void *pObj = pPool->pHead;
+
+  if (pObj) {
+    pPool->pHead = NW_GTPV2C_POOL_NEXT(pPool, pObj);
+    pPool->stats.size--;
+    pPool->stats.nbReuses++;
+  } else {
+    /*
+     * The caller allocates the object
+     */
+    pPool->stats.nbAllocs++;
+  }
+  return pObj;
+}
+
+void nwGtpv2cPoolPut(nw_gtpv2c_stack_t *thiz, nw_gtpv2c_pool_type_t type,
+                     void *pObj) {
+  nw_gtpv2c_pool_t *pPool = &thiz->pool[type];
+
+  if (pPool->stats.size < pPool->stats.maxSize) {
+    NW_GTPV2C_POOL_NEXT(pPool, pObj) = pPool->pHead;
+    pPool->pHead = pObj;
+    pPool->stats.size++;
+    if (pPool->stats.size > pPool->stats.highWater) {
+      pPool->stats.highWater = pPool->stats.size;
+    }
+  } else {
+    pPool->stats.nbFrees++;
+    NW_GTPV2C_FREE(thiz, pObj);
+  }
+}
 
 typedef struct {
   int currSize;
@@ -497,6 +565,108 @@ static inline int32_t nwGtpv2cCompareOutstandingTxRexmitTime(
 RB_GENERATE(NwGtpv2cActiveTimerList, nw_gtpv2c_timeout_info_s,
             activeTimerListRbtNode, nwGtpv2cCompareOutstandingTxRexmitTime)
 
+/*---------------------------------------------------------------------------
+   Peer RB-tree data structure.
+  --------------------------------------------------------------------------*/
+/**
+  Comparator funtion for comparing the addresses of two peers.
+
+  @param[in] a: Pointer to peer a.
+  @param[in] b: Pointer to peer b.
+  @return  An integer greater than, equal to or less than zero according to
+  whether the object pointed to by a is greater than, equal to or less than the
+  object pointed to by b.
+*/
+static inline int32_t nwGtpv2cComparePeer(struct nw_gtpv2c_peer_s *a,
+                                          struct nw_gtpv2c_peer_s *b) {
+  sa_family_t familyA = a->stats.peerIp.addrv4.sin_family;
+  sa_family_t familyB = b->stats.peerIp.addrv4.sin_family;
+
+  if (familyA > familyB) return 1;
+
+  if (familyA < familyB) return -1;
+
+  if (familyA == AF_INET) {
+    return memcmp(&a->stats.peerIp.addrv4.sin_addr,
+                  &b->stats.peerIp.addrv4.sin_addr, sizeof(struct in_addr));
+  }
+  return memcmp(&a->stats.peerIp.addrv6.sin6_addr,
+                &b->stats.peerIp.addrv6.sin6_addr, sizeof(struct in6_addr));
+}
+
+RB_GENERATE(NwGtpv2cPeerMap, nw_gtpv2c_peer_s, peerMapRbtNode,
+            nwGtpv2cComparePeer)
+
+nw_gtpv2c_peer_stats_t *nwGtpv2cPeerStats(nw_gtpv2c_stack_t *thiz,
+                                          struct sockaddr *peerIp) {
+  nw_gtpv2c_peer_t keyPeer = {0};
+  nw_gtpv2c_peer_t *pPeer = NULL;
+
+  if (peerIp->sa_family == AF_INET) {
+    keyPeer.stats.peerIp.addrv4.sin_family = AF_INET;
+    keyPeer.stats.peerIp.addrv4.sin_addr =
+        ((struct sockaddr_in *)peerIp)->sin_addr;
+  } else {
+    keyPeer.stats.peerIp.addrv6.sin6_family = AF_INET6;
+    keyPeer.stats.peerIp.addrv6.sin6_addr =
+        ((struct sockaddr_in6 *)peerIp)->sin6_addr;
+  }
+  pPeer = RB_FIND(NwGtpv2cPeerMap, &(thiz->peerMap), &keyPeer);
+  if (!pPeer) {
+    pPeer = (nw_gtpv2c_peer_t *)calloc(1, sizeof(nw_gtpv2c_peer_t));
+    NW_ASSERT(pPeer);
+    pPeer->stats.peerIp = keyPeer.stats.peerIp;
+    RB_INSERT(NwGtpv2cPeerMap, &(thiz->peerMap), pPeer);
+  }
+  return &pPeer->stats;
+}
+
+/*---------------------------------------------------------------------------
+   timerfd timer manager, the handle is the stack.
+  --------------------------------------------------------------------------*/
+
+static nw_rc_t nwGtpv2cTimerFdStart(nw_gtpv2c_timer_mgr_handle_t tmrMgrHandle,
+                                    uint32_t timeoutSec, uint32_t timeoutUsec,
+                                    uint32_t tmrType, void *tmrArg,
+                                    nw_gtpv2c_timer_handle_t *phTmr) {
+  nw_gtpv2c_stack_t *thiz = (nw_gtpv2c_stack_t *)tmrMgrHandle;
+  struct itimerspec its = {{0}};
+  uint64_t expiryUsec = 0;
+
+  NW_ASSERT(tmrType == NW_GTPV2C_TMR_TYPE_ONE_SHOT);
+  NW_ASSERT(clock_gettime(CLOCK_MONOTONIC, &its.it_value) == 0);
+  /*
+   * Round the expiry up so that the timers due in the same interval expire
+   * in one batch; this also never gives the 0 that would disarm the timer.
+   */
+  expiryUsec = ((uint64_t)its.it_value.tv_sec * 1000000) +
+               (its.it_value.tv_nsec / 1000) +
+               ((uint64_t)timeoutSec * 1000000) + timeoutUsec +
+               NW_GTPV2C_TIMER_FD_RESOLUTION_USEC;
+  expiryUsec -= expiryUsec % NW_GTPV2C_TIMER_FD_RESOLUTION_USEC;
+  its.it_value.tv_sec = expiryUsec / 1000000;
+  its.it_value.tv_nsec = (expiryUsec % 1000000) * 1000;
+  if (timerfd_settime(thiz->tmrFd, TFD_TIMER_ABSTIME, &its, NULL) < 0) {
+    OAILOG_ERROR(LOG_GTPV2C, "timerfd_settime failed: %s\n", strerror(errno));
+    return NW_FAILURE;
+  }
+  thiz->pTmrFdArg = tmrArg;
+  *phTmr = (nw_gtpv2c_timer_handle_t)tmrArg;
+  return NW_OK;
+}
+
+static nw_rc_t nwGtpv2cTimerFdStop(nw_gtpv2c_timer_mgr_handle_t tmrMgrHandle,
+                                   nw_gtpv2c_timer_handle_t hTmr) {
+  nw_gtpv2c_stack_t *thiz = (nw_gtpv2c_stack_t *)tmrMgrHandle;
+  struct itimerspec its = {{0}};
+
+  thiz->pTmrFdArg = NULL;
+  if (timerfd_settime(thiz->tmrFd, 0, &its, NULL) < 0) {
+    return NW_FAILURE;
+  }
+  return NW_OK;
+}
+
 /**
    Send msg to peer via data request to UDP Entity
 
@@ -518,6 +688,7 @@ static nw_rc_t nwGtpv2cCreateAndSendMsg(NW_IN nw_gtpv2c_stack_t *thiz,
 
   NW_ASSERT(thiz);
   NW_ASSERT(pMsg);
+  if (pMsg->pRxBuffer) nwGtpv2cMsgCopyRxBuffer(pMsg);
   msgHdr = pMsg->msgBuf;
   /*
    * Set flags in header
@@ -1211,6 +1382,27 @@ static nw_rc_t nwGtpv2cHandleUlpFindLocalTunnel(
   return RETURNok;
 }
 
+/**
+  Create a message from data received from a peer. The message references
+  the receive buffer of the datagram, if it is shared, else the data is
+  copied.
+
+  @param[in] thiz : Stack context
+  @return NW_OK on success.
+*/
+
+static nw_rc_t nwGtpv2cRxMsgNew(NW_IN nw_gtpv2c_stack_t *thiz,
+                                NW_IN uint8_t *msgBuf, NW_IN uint32_t msgBufLen,
+                                NW_OUT nw_gtpv2c_msg_handle_t *phMsg) {
+  if (thiz->pRxBuffer) {
+    return nwGtpv2cMsgFromSharedBufferNew((nw_gtpv2c_stack_handle_t)thiz,
+                                          thiz->pRxBuffer, msgBuf, msgBufLen,
+                                          phMsg);
+  }
+  return nwGtpv2cMsgFromBufferNew((nw_gtpv2c_stack_handle_t)thiz, msgBuf,
+                                  msgBufLen, phMsg);
+}
+
 /**
   Handle Echo Request from Peer Entity.
 
@@ -1311,8 +1503,7 @@ static nw_rc_t nwGtpv2cHandleInitialReq(NW_IN nw_gtpv2c_stack_t *thiz,
 
   if (pTrxn) {
     pTrxn->localPort = thiz->udp.gtpv2cStandardPort;
-    rc = nwGtpv2cMsgFromBufferNew((nw_gtpv2c_stack_handle_t)thiz, msgBuf,
-                                  msgBufLen, &(hMsg));
+    rc = nwGtpv2cRxMsgNew(thiz, msgBuf, msgBufLen, &(hMsg));
     NW_ASSERT(thiz->pGtpv2cMsgIeParseInfo[msgType]);
     rc = nwGtpv2cMsgIeParse(thiz->pGtpv2cMsgIeParseInfo[msgType], hMsg, &error);
 
@@ -1418,8 +1609,7 @@ static nw_rc_t nwGtpv2cHandleTriggeredReq(
 
   if (pTrxn) {
     pTrxn->localPort = localPort;
-    rc = nwGtpv2cMsgFromBufferNew((nw_gtpv2c_stack_handle_t)thiz, msgBuf,
-                                  msgBufLen, &(hMsg));
+    rc = nwGtpv2cRxMsgNew(thiz, msgBuf, msgBufLen, &(hMsg));
     NW_ASSERT(thiz->pGtpv2cMsgIeParseInfo[msgType]);
     rc = nwGtpv2cMsgIeParse(thiz->pGtpv2cMsgIeParseInfo[msgType], hMsg, &error);
 
@@ -1498,7 +1688,7 @@ static nw_rc_t                            nwGtpv2cHandleTriggeredRsp (
       }
 
       NW_ASSERT (msgBuf && msgBufLen);
-      rc = nwGtpv2cMsgFromBufferNew ((nw_gtpv2c_stack_handle_t) thiz, msgBuf, msgBufLen, &(hMsg));
+      rc = nwGtpv2cRxMsgNew (thiz, msgBuf, msgBufLen, &(hMsg));
       NW_ASSERT (thiz->pGtpv2cMsgIeParseInfo[msgType]);
       rc = nwGtpv2cMsgIeParse (thiz->pGtpv2cMsgIeParseInfo[msgType], hMsg, &error);
 
@@ -1544,9 +1734,25 @@ nw_rc_t nwGtpv2cInitialize(
     RB_INIT(&(thiz->outstandingTxSeqNumMap));
     RB_INIT(&(thiz->outstandingRxSeqNumMap));
     RB_INIT(&(thiz->activeTimerList));
+    RB_INIT(&(thiz->peerMap));
+    thiz->tmrFd = -1;
     OAI_GCC_DIAG_OFF(pointer - to - int - cast);
     thiz->hTmrMinHeap = (NwPtrT)nwGtpv2cTmrMinHeapNew(10000);
     OAI_GCC_DIAG_ON(pointer - to - int - cast);
+    nwGtpv2cPoolInit(thiz, NW_GTPV2C_POOL_MSG, offsetof(nw_gtpv2c_msg_t, next),
+                     NW_GTPV2C_MSG_POOL_DEFAULT_MAX_SIZE);
+    nwGtpv2cPoolInit(thiz, NW_GTPV2C_POOL_TRXN,
+                     offsetof(nw_gtpv2c_trxn_t, next),
+                     NW_GTPV2C_POOL_DEFAULT_MAX_SIZE);
+    nwGtpv2cPoolInit(thiz, NW_GTPV2C_POOL_TIMEOUT_INFO,
+                     offsetof(nw_gtpv2c_timeout_info_t, next),
+                     NW_GTPV2C_POOL_DEFAULT_MAX_SIZE);
+    nwGtpv2cPoolInit(thiz, NW_GTPV2C_POOL_TUNNEL,
+                     offsetof(nw_gtpv2c_tunnel_t, next),
+                     NW_GTPV2C_POOL_DEFAULT_MAX_SIZE);
+    nwGtpv2cPoolInit(thiz, NW_GTPV2C_POOL_MSG_PARSER,
+                     offsetof(nw_gtpv2c_msg_parser_t, next),
+                     NW_GTPV2C_MSG_POOL_DEFAULT_MAX_SIZE);
     NW_GTPV2C_INIT_MSG_IE_PARSE_INFO(thiz, NW_GTP_ECHO_RSP);
     /*
      * For S11 interface
@@ -1725,6 +1931,19 @@ nw_rc_t nwGtpv2cFinalize(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle) {
       ((nw_gtpv2c_stack_t *)hGtpcStackHandle)
           ->pGtpv2cMsgIeParseInfo[NW_GTP_IDENTIFICATION_RSP]);
 
+  for (int type = 0; type < NW_GTPV2C_POOL_END; type++) {
+    nwGtpv2cPoolFlush((nw_gtpv2c_stack_t *)hGtpcStackHandle, type, 0);
+  }
+  {
+    nw_gtpv2c_stack_t *thiz = (nw_gtpv2c_stack_t *)hGtpcStackHandle;
+    nw_gtpv2c_peer_t *pPeer = NULL;
+
+    while ((pPeer = RB_MIN(NwGtpv2cPeerMap, &(thiz->peerMap)))) {
+      RB_REMOVE(NwGtpv2cPeerMap, &(thiz->peerMap), pPeer);
+      free(pPeer);
+    }
+    if (thiz->tmrFd >= 0) close(thiz->tmrFd);
+  }
   OAI_GCC_DIAG_OFF(int - to - pointer - cast);
   nwGtpv2cTmrMinHeapDelete(
       (NwGtpv2cTmrMinHeapT *)((nw_gtpv2c_stack_t *)hGtpcStackHandle)
@@ -1819,6 +2038,131 @@ nw_rc_t nwGtpv2cSetLogLevel(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
   return NW_OK;
 }
 
+/**
+   Statistics of an object pool
+*/
+
+nw_rc_t nwGtpv2cGetPoolStats(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+                             NW_IN nw_gtpv2c_pool_type_t type,
+                             NW_OUT nw_gtpv2c_pool_stats_t *pStats) {
+  nw_gtpv2c_stack_t *thiz = (nw_gtpv2c_stack_t *)hGtpcStackHandle;
+
+  if ((!thiz) || (type >= NW_GTPV2C_POOL_END)) return NW_FAILURE;
+
+  *pStats = thiz->pool[type].stats;
+  return NW_OK;
+}
+
+/**
+   Set the maximum size of an object pool
+*/
+
+nw_rc_t nwGtpv2cSetPoolMaxSize(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+                               NW_IN nw_gtpv2c_pool_type_t type,
+                               NW_IN uint32_t maxSize) {
+  nw_gtpv2c_stack_t *thiz = (nw_gtpv2c_stack_t *)hGtpcStackHandle;
+
+  if ((!thiz) || (type >= NW_GTPV2C_POOL_END)) return NW_FAILURE;
+
+  thiz->pool[type].stats.maxSize = maxSize;
+  nwGtpv2cPoolFlush(thiz, type, maxSize);
+  return NW_OK;
+}
+
+/**
+   Drive the timers of the stack from a timerfd
+*/
+
+nw_rc_t nwGtpv2cSetTimerFd(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+                           NW_OUT int *pFd) {
+  nw_gtpv2c_stack_t *thiz = (nw_gtpv2c_stack_t *)hGtpcStackHandle;
+
+  if ((!thiz) || (thiz->activeTimerInfo)) return NW_FAILURE;
+
+  if (thiz->tmrFd < 0) {
+    thiz->tmrFd =
+        timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (thiz->tmrFd < 0) {
+      OAILOG_ERROR(LOG_GTPV2C, "timerfd_create failed: %s\n",
+                   strerror(errno));
+      return NW_FAILURE;
+    }
+  }
+  thiz->tmrMgr.tmrMgrHandle = (nw_gtpv2c_timer_mgr_handle_t)thiz;
+  thiz->tmrMgr.tmrStartCallback = nwGtpv2cTimerFdStart;
+  thiz->tmrMgr.tmrStopCallback = nwGtpv2cTimerFdStop;
+  *pFd = thiz->tmrFd;
+  return NW_OK;
+}
+
+/**
+   Process the expiry of the timerfd
+*/
+
+nw_rc_t nwGtpv2cProcessTimerFd(
+    NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle) {
+  nw_gtpv2c_stack_t *thiz = (nw_gtpv2c_stack_t *)hGtpcStackHandle;
+  uint64_t nbExpirations = 0;
+  void *timeoutArg = NULL;
+
+  /*
+   * Nothing to read if the timer was re-armed since the fd was polled
+   */
+  if (read(thiz->tmrFd, &nbExpirations, sizeof(nbExpirations)) !=
+      sizeof(nbExpirations)) {
+    return NW_OK;
+  }
+  timeoutArg = thiz->pTmrFdArg;
+  if (!timeoutArg) return NW_OK;
+
+  thiz->pTmrFdArg = NULL;
+  return nwGtpv2cProcessTimeout(timeoutArg);
+}
+
+/**
+   Request counters of a peer
+*/
+
+nw_rc_t nwGtpv2cGetPeerStats(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+                             NW_IN struct sockaddr *peerIp,
+                             NW_OUT nw_gtpv2c_peer_stats_t *pStats) {
+  nw_gtpv2c_stack_t *thiz = (nw_gtpv2c_stack_t *)hGtpcStackHandle;
+  nw_gtpv2c_peer_t keyPeer = {0};
+  nw_gtpv2c_peer_t *pPeer = NULL;
+
+  if ((!thiz) || (!peerIp)) return NW_FAILURE;
+
+  if (peerIp->sa_family == AF_INET) {
+    keyPeer.stats.peerIp.addrv4 = *(struct sockaddr_in *)peerIp;
+  } else {
+    keyPeer.stats.peerIp.addrv6 = *(struct sockaddr_in6 *)peerIp;
+  }
+  pPeer = RB_FIND(NwGtpv2cPeerMap, &(thiz->peerMap), &keyPeer);
+  if (!pPeer) return NW_FAILURE;
+
+  *pStats = pPeer->stats;
+  return NW_OK;
+}
+
+/**
+   Walk the request counters of the peers
+*/
+
+nw_rc_t nwGtpv2cForEachPeerStats(
+    NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+    NW_IN void (*callback)(const nw_gtpv2c_peer_stats_t *pStats, void *arg),
+    NW_IN void *arg) {
+  nw_gtpv2c_stack_t *thiz = (nw_gtpv2c_stack_t *)hGtpcStackHandle;
+  nw_gtpv2c_peer_t *pPeer = NULL;
+
+  if ((!thiz) || (!callback)) return NW_FAILURE;
+
+  RB_FOREACH(pPeer, NwGtpv2cPeerMap, &(thiz->peerMap)) {
+    callback(&pPeer->stats, arg);
+  }
+  return NW_OK;
+}
+
 /**
    Process Request from Udp Layer
 */
@@ -1976,6 +2320,26 @@ nw_rc_t nwGtpv2cProcessUdpReq(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
   OAILOG_FUNC_RETURN(LOG_GTPV2C, rc);
 }
 
+/**
+   Process Request from Udp Layer, the messages reference the receive buffer
+*/
+
+nw_rc_t nwGtpv2cProcessUdpBuffer(
+    NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+    NW_IN struct shared_buffer_s *buffer, NW_IN uint8_t *udpData,
+    NW_IN uint32_t udpDataLen, NW_IN uint16_t localPort,
+    NW_IN uint16_t peerPort, NW_IN struct sockaddr *peerIp) {
+  nw_gtpv2c_stack_t *thiz = (nw_gtpv2c_stack_t *)hGtpcStackHandle;
+  nw_rc_t rc = NW_FAILURE;
+
+  NW_ASSERT(thiz);
+  thiz->pRxBuffer = buffer;
+  rc = nwGtpv2cProcessUdpReq(hGtpcStackHandle, udpData, udpDataLen, localPort,
+                             peerPort, peerIp);
+  thiz->pRxBuffer = NULL;
+  return rc;
+}
+
 /*
    Process Request from Upper Layer
 */
@@ -2046,6 +2410,8 @@ nw_rc_t nwGtpv2cProcessTimeoutOld(void *arg) {
   nw_gtpv2c_timeout_info_t *timeoutInfo = (nw_gtpv2c_timeout_info_t *)arg;
   nw_gtpv2c_timeout_info_t *pNextTimeoutInfo = NULL;
   struct timeval tv = {0};
+  nw_rc_t (*timeoutCallbackFunc)(void *) = NULL;
+  void *timeoutArg = NULL;
 
   NW_ASSERT(timeoutInfo != NULL);
   thiz =
@@ -2056,9 +2422,10 @@ nw_rc_t nwGtpv2cProcessTimeoutOld(void *arg) {
   if (thiz->activeTimerInfo == timeoutInfo) {
     thiz->activeTimerInfo = NULL;
     RB_REMOVE(NwGtpv2cActiveTimerList, &(thiz->activeTimerList), timeoutInfo);
-    timeoutInfo->next = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = timeoutInfo;
-    rc = ((timeoutInfo)->timeoutCallbackFunc)(timeoutInfo->timeoutArg);
+    timeoutCallbackFunc = timeoutInfo->timeoutCallbackFunc;
+    timeoutArg = timeoutInfo->timeoutArg;
+    nwGtpv2cPoolPut(thiz, NW_GTPV2C_POOL_TIMEOUT_INFO, timeoutInfo);
+    rc = timeoutCallbackFunc(timeoutArg);
   } else {
     OAILOG_WARNING(LOG_GTPV2C,
                    "Received timeout event from ULP for non-existent "
@@ -2077,9 +2444,10 @@ nw_rc_t nwGtpv2cProcessTimeoutOld(void *arg) {
     pNextTimeoutInfo =
         RB_NEXT(NwGtpv2cActiveTimerList, &(thiz->activeTimerList), timeoutInfo);
     RB_REMOVE(NwGtpv2cActiveTimerList, &(thiz->activeTimerList), timeoutInfo);
-    timeoutInfo->next = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = timeoutInfo;
-    rc = ((timeoutInfo)->timeoutCallbackFunc)(timeoutInfo->timeoutArg);
+    timeoutCallbackFunc = timeoutInfo->timeoutCallbackFunc;
+    timeoutArg = timeoutInfo->timeoutArg;
+    nwGtpv2cPoolPut(thiz, NW_GTPV2C_POOL_TIMEOUT_INFO, timeoutInfo);
+    rc = timeoutCallbackFunc(timeoutArg);
     timeoutInfo = pNextTimeoutInfo;
   }
 
@@ -2107,6 +2475,8 @@ nw_rc_t nwGtpv2cProcessTimeout(void *arg) {
   nw_gtpv2c_stack_t *thiz = NULL;
   nw_gtpv2c_timeout_info_t *timeoutInfo = (nw_gtpv2c_timeout_info_t *)arg;
   struct timeval tv = {0};
+  nw_rc_t (*timeoutCallbackFunc)(void *) = NULL;
+  void *timeoutArg = NULL;
 
   NW_ASSERT(timeoutInfo != NULL);
   thiz = (nw_gtpv2c_stack_t *)(timeoutInfo->hStack);
@@ -2119,9 +2489,10 @@ nw_rc_t nwGtpv2cProcessTimeout(void *arg) {
     rc = nwGtpv2cTmrMinHeapRemove((NwGtpv2cTmrMinHeapT *)thiz->hTmrMinHeap,
                                   timeoutInfo->timerMinHeapIndex);
     OAI_GCC_DIAG_ON(int - to - pointer - cast);
-    timeoutInfo->next = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = timeoutInfo;
-    rc = ((timeoutInfo)->timeoutCallbackFunc)(timeoutInfo->timeoutArg);
+    timeoutCallbackFunc = timeoutInfo->timeoutCallbackFunc;
+    timeoutArg = timeoutInfo->timeoutArg;
+    nwGtpv2cPoolPut(thiz, NW_GTPV2C_POOL_TIMEOUT_INFO, timeoutInfo);
+    rc = timeoutCallbackFunc(timeoutArg);
   } else {
     OAILOG_WARNING(LOG_GTPV2C,
                    "Received timeout event from ULP for "
@@ -2144,9 +2515,10 @@ nw_rc_t nwGtpv2cProcessTimeout(void *arg) {
     rc = nwGtpv2cTmrMinHeapRemove((NwGtpv2cTmrMinHeapT *)thiz->hTmrMinHeap,
                                   timeoutInfo->timerMinHeapIndex);
     OAI_GCC_DIAG_ON(int - to - pointer - cast);
-    timeoutInfo->next = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = timeoutInfo;
-    rc = ((timeoutInfo)->timeoutCallbackFunc)(timeoutInfo->timeoutArg);
+    timeoutCallbackFunc = timeoutInfo->timeoutCallbackFunc;
+    timeoutArg = timeoutInfo->timeoutArg;
+    nwGtpv2cPoolPut(thiz, NW_GTPV2C_POOL_TIMEOUT_INFO, timeoutInfo);
+    rc = timeoutCallbackFunc(timeoutArg);
     OAI_GCC_DIAG_OFF(int - to - pointer - cast);
     timeoutInfo =
         nwGtpv2cTmrMinHeapPeek((NwGtpv2cTmrMinHeapT *)thiz->hTmrMinHeap);
@@ -2190,10 +2562,9 @@ nw_rc_t nwGtpv2cStartTimer(nw_gtpv2c_stack_t *thiz, uint32_t timeoutSec,
 
   OAILOG_FUNC_IN(LOG_GTPV2C);
 
-  if (gpGtpv2cTimeoutInfoPool) {
-    timeoutInfo = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = gpGtpv2cTimeoutInfoPool->next;
-  } else {
+  timeoutInfo = (nw_gtpv2c_timeout_info_t *)nwGtpv2cPoolGet(
+      thiz, NW_GTPV2C_POOL_TIMEOUT_INFO);
+  if (!timeoutInfo) {
     NW_GTPV2C_MALLOC(thiz, sizeof(nw_gtpv2c_timeout_info_t), timeoutInfo,
                      nw_gtpv2c_timeout_info_t *);
   }
@@ -2275,10 +2646,9 @@ nw_rc_t nwGtpv2cStartTimerOld(nw_gtpv2c_stack_t *thiz, uint32_t timeoutSec,
   NW_ASSERT(thiz != NULL);
   OAILOG_FUNC_IN(LOG_GTPV2C);
 
-  if (gpGtpv2cTimeoutInfoPool) {
-    timeoutInfo = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = gpGtpv2cTimeoutInfoPool->next;
-  } else {
+  timeoutInfo = (nw_gtpv2c_timeout_info_t *)nwGtpv2cPoolGet(
+      thiz, NW_GTPV2C_POOL_TIMEOUT_INFO);
+  if (!timeoutInfo) {
     NW_GTPV2C_MALLOC(thiz, sizeof(nw_gtpv2c_timeout_info_t), timeoutInfo,
                      nw_gtpv2c_timeout_info_t *);
   }
@@ -2357,8 +2727,6 @@ nw_rc_t nwGtpv2cStopTimer(nw_gtpv2c_stack_t *thiz,
   rc = nwGtpv2cTmrMinHeapRemove((NwGtpv2cTmrMinHeapT *)thiz->hTmrMinHeap,
                                 timeoutInfo->timerMinHeapIndex);
   OAI_GCC_DIAG_ON(int - to - pointer - cast);
-  timeoutInfo->next = gpGtpv2cTimeoutInfoPool;
-  gpGtpv2cTimeoutInfoPool = timeoutInfo;
   //    OAILOG_DEBUG (LOG_GTPV2C, "Stopping active timer 0x%" PRIxPTR " for info
   //    0x%p!\n", timeoutInfo->hTimer, timeoutInfo);
 
@@ -2378,6 +2746,7 @@ nw_rc_t nwGtpv2cStopTimer(nw_gtpv2c_stack_t *thiz,
       OAILOG_INFO(LOG_GTPV2C,
                   "Stopped active timer 0x%" PRIxPTR " for info 0x%p!\n",
                   timeoutInfo->hTimer, timeoutInfo);
+    nwGtpv2cPoolPut(thiz, NW_GTPV2C_POOL_TIMEOUT_INFO, timeoutInfo);
     OAI_GCC_DIAG_OFF(int - to - pointer - cast);
     timeoutInfo =
         nwGtpv2cTmrMinHeapPeek((NwGtpv2cTmrMinHeapT *)thiz->hTmrMinHeap);
@@ -2402,6 +2771,8 @@ nw_rc_t nwGtpv2cStopTimer(nw_gtpv2c_stack_t *thiz,
         thiz->activeTimerInfo = timeoutInfo;
       }
     }
+  } else {
+    nwGtpv2cPoolPut(thiz, NW_GTPV2C_POOL_TIMEOUT_INFO, timeoutInfo);
   }
 
   OAILOG_FUNC_RETURN(LOG_GTPV2C, rc);
@@ -2417,8 +2788,6 @@ nw_rc_t nwGtpv2cStopTimerOld(nw_gtpv2c_stack_t *thiz,
   OAILOG_FUNC_IN(LOG_GTPV2C);
   timeoutInfo = (nw_gtpv2c_timeout_info_t *)hTimer;
   RB_REMOVE(NwGtpv2cActiveTimerList, &(thiz->activeTimerList), timeoutInfo);
-  timeoutInfo->next = gpGtpv2cTimeoutInfoPool;
-  gpGtpv2cTimeoutInfoPool = timeoutInfo;
   OAILOG_DEBUG(LOG_GTPV2C,
                "Stopping active timer 0x%" PRIxPTR " for info 0x%p!\n",
                timeoutInfo->hTimer, timeoutInfo);
@@ -2431,6 +2800,7 @@ nw_rc_t nwGtpv2cStopTimerOld(nw_gtpv2c_stack_t *thiz,
                                       timeoutInfo->hTimer);
     thiz->activeTimerInfo = NULL;
     NW_ASSERT(NW_OK == rc);
+    nwGtpv2cPoolPut(thiz, NW_GTPV2C_POOL_TIMEOUT_INFO, timeoutInfo);
     timeoutInfo = RB_MIN(NwGtpv2cActiveTimerList, &(thiz->activeTimerList));
 
     if (timeoutInfo) {
@@ -2452,6 +2822,8 @@ nw_rc_t nwGtpv2cStopTimerOld(nw_gtpv2c_stack_t *thiz,
         thiz->activeTimerInfo = timeoutInfo;
       }
     }
+  } else {
+    nwGtpv2cPoolPut(thiz, NW_GTPV2C_POOL_TIMEOUT_INFO, timeoutInfo);
   }
 
   OAILOG_FUNC_RETURN(LOG_GTPV2C, rc);
@@ -47,6 +47,7 @@
 #include "NwLog.h"
 #include "NwTypes.h"
 #include "NwUtils.h"
+#include "dynamic_memory_check.h"
 #include "log.h"
 
 #ifdef __cplusplus
@@ -57,7 +58,48 @@ extern "C" {
                        P R I V A T E     F U N C T I O N S
   ----------------------------------------------------------------------------*/
 
-static nw_gtpv2c_msg_t *gpGtpv2cMsgPool = NULL;
+static nw_gtpv2c_msg_t *nwGtpv2cMsgAlloc(nw_gtpv2c_stack_t *pStack) {
+  nw_gtpv2c_msg_t *pMsg;
+
+  pMsg = (nw_gtpv2c_msg_t *)nwGtpv2cPoolGet(pStack, NW_GTPV2C_POOL_MSG);
+  if (pMsg) {
+    /*
+     * Only the IEs of the previous message need to be cleared
+     */
+    nwGtpv2cMsgResetIes(pMsg);
+  } else {
+    NW_GTPV2C_MALLOC(pStack, sizeof(nw_gtpv2c_msg_t), pMsg, nw_gtpv2c_msg_t *);
+    if (pMsg) {
+      memset(pMsg->isIeValid, 0, sizeof(pMsg->isIeValid));
+      memset(pMsg->pIe, 0, sizeof(pMsg->pIe));
+      pMsg->ieCount = 0;
+    }
+    OAILOG_DEBUG(LOG_GTPV2C, "ALLOCATED NEW MESSAGE %p!\n", pMsg);
+  }
+  if (pMsg) {
+    pMsg->msgBuf = pMsg->msgBufLocal;
+    pMsg->pRxBuffer = NULL;
+  }
+  return pMsg;
+}
+
+static void nwGtpv2cMsgSetHeader(nw_gtpv2c_msg_t *pMsg, uint8_t *pBuf,
+                                 uint32_t bufLen) {
+  pMsg->msgLen = bufLen;
+  pMsg->version = ((*pBuf) & 0xE0) >> 5;
+  pMsg->teidPresent = ((*pBuf) & 0x08) >> 3;
+  pBuf++;
+  pMsg->msgType = *(pBuf);
+  pBuf += 3;
+
+  if (pMsg->teidPresent) {
+    pMsg->teid = ntohl(*((uint32_t *)(pBuf)));
+    pBuf += 4;
+  }
+
+  memcpy(((uint8_t *)&pMsg->seqNum) + 1, pBuf, 3);
+  pMsg->seqNum = ntohl(pMsg->seqNum);
+}
 
 /*----------------------------------------------------------------------------*
                          P U B L I C   F U N C T I O N S
@@ -71,13 +113,7 @@ nw_rc_t nwGtpv2cMsgNew(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
   nw_gtpv2c_msg_t *pMsg;
   NW_ASSERT(pStack);
 
-  if (gpGtpv2cMsgPool) {
-    pMsg = gpGtpv2cMsgPool;
-    gpGtpv2cMsgPool = gpGtpv2cMsgPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(pStack, sizeof(nw_gtpv2c_msg_t), pMsg, nw_gtpv2c_msg_t *);
-    OAILOG_DEBUG(LOG_GTPV2C, "ALLOCATED NEW MESSAGE %p!\n", pMsg);
-  }
+  pMsg = nwGtpv2cMsgAlloc(pStack);
 
   if (pMsg) {
     pMsg->version = NW_GTP_VERSION;
@@ -104,30 +140,13 @@ nw_rc_t nwGtpv2cMsgFromBufferNew(
 
   NW_ASSERT(pStack);
 
-  if (gpGtpv2cMsgPool) {
-    pMsg = gpGtpv2cMsgPool;
-    gpGtpv2cMsgPool = gpGtpv2cMsgPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(pStack, sizeof(nw_gtpv2c_msg_t), pMsg, nw_gtpv2c_msg_t *);
-  }
+  pMsg = nwGtpv2cMsgAlloc(pStack);
 
   if (pMsg) {
     *phMsg = (nw_gtpv2c_msg_handle_t)pMsg;
+    NW_ASSERT(bufLen <= NW_GTPV2C_MAX_MSG_LEN);
     memcpy(pMsg->msgBuf, pBuf, bufLen);
-    pMsg->msgLen = bufLen;
-    pMsg->version = ((*pBuf) & 0xE0) >> 5;
-    pMsg->teidPresent = ((*pBuf) & 0x08) >> 3;
-    pBuf++;
-    pMsg->msgType = *(pBuf);
-    pBuf += 3;
-
-    if (pMsg->teidPresent) {
-      pMsg->teid = ntohl(*((uint32_t *)(pBuf)));
-      pBuf += 4;
-    }
-
-    memcpy(((uint8_t *)&pMsg->seqNum) + 1, pBuf, 3);
-    pMsg->seqNum = ntohl(pMsg->seqNum);
+    nwGtpv2cMsgSetHeader(pMsg, pBuf, bufLen);
     pMsg->hStack = hGtpcStackHandle;
     OAILOG_DEBUG(LOG_GTPV2C, "Created message %p!\n", pMsg);
     return NW_OK;
@@ -136,18 +155,42 @@ nw_rc_t nwGtpv2cMsgFromBufferNew(
   return NW_FAILURE;
 }
 
+nw_rc_t nwGtpv2cMsgFromSharedBufferNew(
+    NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
+    NW_IN struct shared_buffer_s *buffer, NW_IN uint8_t *pBuf,
+    NW_IN uint32_t bufLen, NW_OUT nw_gtpv2c_msg_handle_t *phMsg) {
+  nw_gtpv2c_stack_t *pStack = (nw_gtpv2c_stack_t *)hGtpcStackHandle;
+  nw_gtpv2c_msg_t *pMsg;
+
+  NW_ASSERT(pStack);
+  NW_ASSERT(buffer);
+
+  pMsg = nwGtpv2cMsgAlloc(pStack);
+
+  if (pMsg) {
+    *phMsg = (nw_gtpv2c_msg_handle_t)pMsg;
+    pMsg->pRxBuffer = shared_buffer_ref(buffer);
+    pMsg->msgBuf = pBuf;
+    nwGtpv2cMsgSetHeader(pMsg, pBuf, bufLen);
+    pMsg->hStack = hGtpcStackHandle;
+    OAILOG_DEBUG(LOG_GTPV2C, "Created message %p on buffer %p!\n", pMsg,
+                 buffer);
+    return NW_OK;
+  }
+
+  return NW_FAILURE;
+}
+
 nw_rc_t nwGtpv2cMsgDelete(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
                           NW_IN nw_gtpv2c_msg_handle_t hMsg) {
-  // warning: unused variable ‘pStack’ [-Wunused-variable]: NwGtpv2cStackT
-  // *pStack = (NwGtpv2cStackT *) hGtpcStackHandle;
+  nw_gtpv2c_msg_t *pMsg = (nw_gtpv2c_msg_t *)hMsg;
 
   OAILOG_DEBUG(LOG_GTPV2C, "Purging message 0x%" PRIxPTR "!\n", hMsg);
-  ((nw_gtpv2c_msg_t *)hMsg)->next = gpGtpv2cMsgPool;
-  gpGtpv2cMsgPool = (nw_gtpv2c_msg_t *)hMsg;
-  OAILOG_DEBUG(LOG_GTPV2C,
-               "Message pool %" PRIxPTR "! Next element %" PRIxPTR "! \n",
-               gpGtpv2cMsgPool, gpGtpv2cMsgPool->next);
-
+  /*
+   * Back to the pool of the stack which created the message
+   */
+  shared_buffer_unref(&pMsg->pRxBuffer);
+  nwGtpv2cPoolPut((nw_gtpv2c_stack_t *)pMsg->hStack, NW_GTPV2C_POOL_MSG, pMsg);
   return NW_OK;
 }
 
@@ -261,6 +304,7 @@ nw_rc_t nwGtpv2cMsgAddIeTV1(NW_IN nw_gtpv2c_msg_handle_t hMsg,
   nw_gtpv2c_msg_t *pMsg = (nw_gtpv2c_msg_t *)hMsg;
   nw_gtpv2c_ie_tv1_t *pIe;
 
+  if (pMsg->pRxBuffer) nwGtpv2cMsgCopyRxBuffer(pMsg);
   pIe = (nw_gtpv2c_ie_tv1_t *)(pMsg->msgBuf + pMsg->msgLen);
   pIe->t = type;
   pIe->l = htons(0x0001);
@@ -276,6 +320,7 @@ nw_rc_t nwGtpv2cMsgAddIeTV2(NW_IN nw_gtpv2c_msg_handle_t hMsg,
   nw_gtpv2c_msg_t *pMsg = (nw_gtpv2c_msg_t *)hMsg;
   nw_gtpv2c_ie_tv2_t *pIe;
 
+  if (pMsg->pRxBuffer) nwGtpv2cMsgCopyRxBuffer(pMsg);
   pIe = (nw_gtpv2c_ie_tv2_t *)(pMsg->msgBuf + pMsg->msgLen);
   pIe->t = type;
   pIe->l = htons(0x0002);
@@ -291,6 +336,7 @@ nw_rc_t nwGtpv2cMsgAddIeTV4(NW_IN nw_gtpv2c_msg_handle_t hMsg,
   nw_gtpv2c_msg_t *pMsg = (nw_gtpv2c_msg_t *)hMsg;
   nw_gtpv2c_ie_tv4_t *pIe;
 
+  if (pMsg->pRxBuffer) nwGtpv2cMsgCopyRxBuffer(pMsg);
   pIe = (nw_gtpv2c_ie_tv4_t *)(pMsg->msgBuf + pMsg->msgLen);
   pIe->t = type;
   pIe->l = htons(0x0004);
@@ -306,6 +352,7 @@ nw_rc_t nwGtpv2cMsgAddIe(NW_IN nw_gtpv2c_msg_handle_t hMsg, NW_IN uint8_t type,
   nw_gtpv2c_msg_t *pMsg = (nw_gtpv2c_msg_t *)hMsg;
   nw_gtpv2c_ie_tlv_t *pIe;
 
+  if (pMsg->pRxBuffer) nwGtpv2cMsgCopyRxBuffer(pMsg);
   pIe = (nw_gtpv2c_ie_tlv_t *)(pMsg->msgBuf + pMsg->msgLen);
   pIe->t = type;
   pIe->l = htons(length);
@@ -320,6 +367,7 @@ nw_rc_t nwGtpv2cMsgGroupedIeStart(NW_IN nw_gtpv2c_msg_handle_t hMsg,
   nw_gtpv2c_msg_t *pMsg = (nw_gtpv2c_msg_t *)hMsg;
   nw_gtpv2c_ie_tlv_t *pIe;
 
+  if (pMsg->pRxBuffer) nwGtpv2cMsgCopyRxBuffer(pMsg);
   pIe = (nw_gtpv2c_ie_tlv_t *)(pMsg->msgBuf + pMsg->msgLen);
   pIe->t = type;
   pIe->i = instance & 0x00ff;
@@ -430,6 +478,62 @@ nw_rc_t nwGtpv2cMsgAddIeCompleteRequestMessage(
                            request_size, instance, requestBuf));
 }
 
+void nwGtpv2cMsgCopyRxBuffer(nw_gtpv2c_msg_t *pMsg) {
+  uint8_t *pRxBuf = pMsg->msgBuf;
+
+  NW_ASSERT(pMsg->msgLen <= NW_GTPV2C_MAX_MSG_LEN);
+  memcpy(pMsg->msgBufLocal, pRxBuf, pMsg->msgLen);
+  pMsg->msgBuf = pMsg->msgBufLocal;
+  /*
+   * The IEs found by the parsing move with the data
+   */
+  for (uint16_t n = 0; n < pMsg->ieCount; n++) {
+    uint8_t **ppIe =
+        &pMsg->pIe[pMsg->ieIndex[n].type][pMsg->ieIndex[n].instance];
+
+    if (*ppIe) *ppIe = pMsg->msgBufLocal + (*ppIe - pRxBuf);
+  }
+  shared_buffer_unref(&pMsg->pRxBuffer);
+}
+
+void nwGtpv2cMsgResetIes(nw_gtpv2c_msg_t *pMsg) {
+  for (uint16_t n = 0; n < pMsg->ieCount; n++) {
+    pMsg->pIe[pMsg->ieIndex[n].type][pMsg->ieIndex[n].instance] = NULL;
+    pMsg->isIeValid[pMsg->ieIndex[n].type][pMsg->ieIndex[n].instance] = false;
+  }
+  pMsg->ieCount = 0;
+}
+
+void nwGtpv2cMsgResetIePointers(nw_gtpv2c_msg_t *pMsg) {
+  uint16_t count = 0;
+
+  for (uint16_t n = 0; n < pMsg->ieCount; n++) {
+    uint8_t type = pMsg->ieIndex[n].type;
+    uint8_t instance = pMsg->ieIndex[n].instance;
+
+    pMsg->pIe[type][instance] = NULL;
+    if (pMsg->isIeValid[type][instance]) {
+      pMsg->ieIndex[count++] = pMsg->ieIndex[n];
+    }
+  }
+  pMsg->ieCount = count;
+}
+
+void nwGtpv2cMsgSetIe(nw_gtpv2c_msg_t *pMsg, uint8_t type, uint8_t instance,
+                      uint8_t *pIe, bool isIeValid) {
+  if ((pMsg->pIe[type][instance] == NULL) &&
+      (!pMsg->isIeValid[type][instance])) {
+    NW_ASSERT(pMsg->ieCount < NW_GTPV2C_MAX_MSG_IE);
+    pMsg->ieIndex[pMsg->ieCount].type = type;
+    pMsg->ieIndex[pMsg->ieCount].instance = instance;
+    pMsg->ieCount++;
+  }
+  pMsg->pIe[type][instance] = pIe;
+  if (isIeValid) {
+    pMsg->isIeValid[type][instance] = true;
+  }
+}
+
 bool nwGtpv2cMsgIsIePresent(NW_IN nw_gtpv2c_msg_handle_t hMsg,
                             NW_IN uint8_t type, NW_IN uint8_t instance) {
   nw_gtpv2c_msg_t *thiz = (nw_gtpv2c_msg_t *)hMsg;
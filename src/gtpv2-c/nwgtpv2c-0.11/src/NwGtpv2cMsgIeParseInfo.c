@@ -1296,11 +1296,7 @@ nw_rc_t nwGtpv2cMsgIeParse(NW_IN nw_gtpv2c_msg_ie_parse_info_t *thiz,
 
   pIeBufStart = (uint8_t *)(pMsg->msgBuf + (flags & 0x08 ? 12 : 8));
   pIeBufEnd = (uint8_t *)(pMsg->msgBuf + pMsg->msgLen);
-  // memset(pMsg->pIe, 0, sizeof(uint8_t*) * (NW_GTPV2C_IE_TYPE_MAXIMUM) *
-  // (NW_GTPV2C_IE_INSTANCE_MAXIMUM));
-  memset(pMsg->isIeValid, (false),
-         sizeof(uint8_t) * (NW_GTPV2C_IE_TYPE_MAXIMUM) *
-             (NW_GTPV2C_IE_INSTANCE_MAXIMUM));
+  nwGtpv2cMsgResetIes(pMsg);
 
   while (pIeBufStart < pIeBufEnd) {
     pIe = (nw_gtpv2c_ie_tlv_t *)pIeBufStart;
@@ -1356,8 +1352,7 @@ nw_rc_t nwGtpv2cMsgIeParse(NW_IN nw_gtpv2c_msg_ie_parse_info_t *thiz,
         continue;
       }
 
-      pMsg->pIe[ieType][ieInstance] = (uint8_t *)pIeBufStart;
-      pMsg->isIeValid[ieType][ieInstance] = true;
+      nwGtpv2cMsgSetIe(pMsg, ieType, ieInstance, pIeBufStart, true);
 
       if (thiz->ieParseInfo[ieType][ieInstance].pGroupedIeInfo) {
         /*
@@ -63,13 +63,37 @@ nw_rc_t nwGtpv2cMsgParserNew(
                                     uint8_t ieInstance, uint8_t *ieValue,
                                     void *ieReadCallbackArg),
     NW_IN void *ieReadCallbackArg, NW_IN nw_gtpv2c_msg_parser_t **pthiz) {
+  nw_gtpv2c_stack_t *pStack = (nw_gtpv2c_stack_t *)hGtpcStackHandle;
   nw_gtpv2c_msg_parser_t *thiz;
-  //  NW_GTPV2C_MALLOC(hGtpcStackHandle, sizeof(NwGtpv2cMsgParserT), thiz,
-  //  NwGtpv2cMsgParserT*);
-  thiz = (nw_gtpv2c_msg_parser_t *)malloc(sizeof(nw_gtpv2c_msg_parser_t));
+
+  NW_ASSERT(pStack);
+  thiz = (nw_gtpv2c_msg_parser_t *)nwGtpv2cPoolGet(pStack,
+                                                   NW_GTPV2C_POOL_MSG_PARSER);
+  if (thiz) {
+    /*
+     * Clear what the previous user has set, instead of the whole parser
+     */
+    for (uint16_t n = 0; n < thiz->ieInfoCount; n++) {
+      uint8_t t = thiz->ieInfoIndex[n].type;
+      uint8_t i = thiz->ieInfoIndex[n].instance;
+
+      memset(&thiz->ieParseInfo[t][i], 0, sizeof(thiz->ieParseInfo[t][i]));
+    }
+    for (uint16_t n = 0; n < thiz->ieCount; n++) {
+      thiz->pIe[thiz->ieIndex[n].type][thiz->ieIndex[n].instance] = NULL;
+    }
+    thiz->ieInfoCount = 0;
+    thiz->ieCount = 0;
+    thiz->mandatoryIeCount = 0;
+    thiz->next = NULL;
+  } else {
+    thiz = (nw_gtpv2c_msg_parser_t *)malloc(sizeof(nw_gtpv2c_msg_parser_t));
+    if (thiz) {
+      memset(thiz, 0, sizeof(nw_gtpv2c_msg_parser_t));
+    }
+  }
 
   if (thiz) {
-    memset(thiz, 0, sizeof(nw_gtpv2c_msg_parser_t));
     thiz->msgType = msgType;
     thiz->hStack = hGtpcStackHandle;
     *pthiz = thiz;
@@ -90,7 +114,10 @@ nw_rc_t nwGtpv2cMsgParserNew(
 
 nw_rc_t nwGtpv2cMsgParserDelete(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
                                 NW_IN nw_gtpv2c_msg_parser_t *thiz) {
-  NW_GTPV2C_FREE(hGtpcStackHandle, thiz);
+  nw_gtpv2c_stack_t *pStack = (nw_gtpv2c_stack_t *)hGtpcStackHandle;
+
+  NW_ASSERT(pStack);
+  nwGtpv2cPoolPut(pStack, NW_GTPV2C_POOL_MSG_PARSER, thiz);
   return NW_OK;
 }
 
@@ -128,6 +155,9 @@ nw_rc_t nwGtpv2cMsgParserAddIe(
 
   if (thiz->ieParseInfo[ieType][ieInstance].iePresence == 0) {
     NW_ASSERT(ieInstance <= NW_GTPV2C_IE_INSTANCE_MAXIMUM);
+    thiz->ieInfoIndex[thiz->ieInfoCount].type = ieType;
+    thiz->ieInfoIndex[thiz->ieInfoCount].instance = ieInstance;
+    thiz->ieInfoCount++;
     thiz->ieParseInfo[ieType][ieInstance].ieReadCallback = ieReadCallback;
     thiz->ieParseInfo[ieType][ieInstance].ieReadCallbackArg = ieReadCallbackArg;
     thiz->ieParseInfo[ieType][ieInstance].iePresence = iePresence;
@@ -186,12 +216,20 @@ nw_rc_t nwGtpv2cMsgParserRun(NW_IN nw_gtpv2c_msg_parser_t *thiz,
   flags = *((uint8_t *)(pMsg->msgBuf));
   pIeStart = (uint8_t *)(pMsg->msgBuf + (flags & 0x08 ? 12 : 8));
   pIeEnd = (uint8_t *)(pMsg->msgBuf + pMsg->msgLen);
-  memset(thiz->pIe, 0,
-         sizeof(uint8_t *) * (NW_GTPV2C_IE_TYPE_MAXIMUM) *
-             (NW_GTPV2C_IE_INSTANCE_MAXIMUM));
-  memset(pMsg->pIe, 0,
-         sizeof(uint8_t *) * (NW_GTPV2C_IE_TYPE_MAXIMUM) *
-             (NW_GTPV2C_IE_INSTANCE_MAXIMUM));
+
+  /*
+   * Only the slots set by the previous run are cleared, a message carries a
+   * few IEs out of the whole type x instance space.
+   */
+  for (uint16_t n = 0; n < thiz->ieCount; n++) {
+    uint8_t t = thiz->ieIndex[n].type;
+    uint8_t i = thiz->ieIndex[n].instance;
+
+    thiz->pIe[t][i] = NULL;
+    thiz->ieParseInfo[t][i].firstInstanceOccurred = false;
+  }
+  thiz->ieCount = 0;
+  nwGtpv2cMsgResetIePointers(pMsg);
 
   while (pIeStart < pIeEnd) {
     pIe = (nw_gtpv2c_ie_tlv_t *)pIeStart;
@@ -204,9 +242,15 @@ nw_rc_t nwGtpv2cMsgParserRun(NW_IN nw_gtpv2c_msg_parser_t *thiz,
       return NW_GTPV2C_MSG_MALFORMED;
     }
 
-    if ((thiz->ieParseInfo[pIe->t][pIe->i].iePresence)) {
+    if ((pIe->i < NW_GTPV2C_IE_INSTANCE_MAXIMUM) &&
+        (thiz->ieParseInfo[pIe->t][pIe->i].iePresence)) {
+      if (thiz->pIe[pIe->t][pIe->i] == NULL) {
+        thiz->ieIndex[thiz->ieCount].type = pIe->t;
+        thiz->ieIndex[thiz->ieCount].instance = pIe->i;
+        thiz->ieCount++;
+      }
       thiz->pIe[pIe->t][pIe->i] = (uint8_t *)pIeStart;
-      pMsg->pIe[pIe->t][pIe->i] = (uint8_t *)pIeStart;
+      nwGtpv2cMsgSetIe(pMsg, pIe->t, pIe->i, pIeStart, false);
       OAILOG_DEBUG(LOG_GTPV2C, "Received IE %u of length %u!\n", pIe->t,
                    ieLength);
 
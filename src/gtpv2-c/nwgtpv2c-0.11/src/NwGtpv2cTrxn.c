@@ -54,8 +54,6 @@
 extern "C" {
 #endif
 
-static nw_gtpv2c_trxn_t *gpGtpv2cTrxnPool = NULL;
-
 /*--------------------------------------------------------------------------*
                      P R I V A T E      F U N C T I O N S
   --------------------------------------------------------------------------*/
@@ -72,6 +70,8 @@ static nw_rc_t nwGtpv2cTrxnSendMsgRetransmission(nw_gtpv2c_trxn_t *thiz) {
       thiz->pStack->udp.hUdp, thiz->pMsg->msgBuf, thiz->pMsg->msgLen,
       thiz->localPort, &thiz->peer_ip, thiz->peerPort);
   thiz->maxRetries--;
+  nwGtpv2cPeerStats(thiz->pStack, (struct sockaddr *)&thiz->peer_ip)
+      ->nbRetransmissions++;
   return rc;
 }
 
@@ -139,6 +139,8 @@ static nw_rc_t nwGtpv2cTrxnPeerRspWaitTimeout(void *arg) {
     /** Set the flags. */
     ulpApi.u_api_info.rspFailureInfo.trx_flags = thiz->trx_flags;
     OAILOG_ERROR(LOG_GTPV2C, "N3 retries expired for transaction %p\n", thiz);
+    nwGtpv2cPeerStats(pStack, (struct sockaddr *)&thiz->peer_ip)
+        ->nbRspFailures++;
     RB_REMOVE(NwGtpv2cOutstandingTxSeqNumTrxnMap,
               &(pStack->outstandingTxSeqNumMap), thiz);
     rc = nwGtpv2cTrxnDelete(&thiz);
@@ -233,19 +235,16 @@ static nw_rc_t nwGtpv2cTrxnStopPeerRspTimer(nw_gtpv2c_trxn_t *thiz) {
 nw_gtpv2c_trxn_t *nwGtpv2cTrxnNew(NW_IN nw_gtpv2c_stack_t *thiz) {
   nw_gtpv2c_trxn_t *pTrxn;
 
-  if (gpGtpv2cTrxnPool) {
-    pTrxn = gpGtpv2cTrxnPool;
-    gpGtpv2cTrxnPool = gpGtpv2cTrxnPool->next;
-  } else {
+  pTrxn = (nw_gtpv2c_trxn_t *)nwGtpv2cPoolGet(thiz, NW_GTPV2C_POOL_TRXN);
+  if (!pTrxn) {
     NW_GTPV2C_MALLOC(thiz, sizeof(nw_gtpv2c_trxn_t), pTrxn, nw_gtpv2c_trxn_t *);
   }
 
   if (pTrxn) {
-    OAILOG_DEBUG(
-        LOG_GTPV2C,
-        "Created not trx without seqNum as transaction %p. Head %p, Next %p\n",
-        pTrxn, gpGtpv2cTrxnPool,
-        (gpGtpv2cTrxnPool) ? gpGtpv2cTrxnPool->next : "null");
+    OAILOG_DEBUG(LOG_GTPV2C,
+                 "Created not trx without seqNum as transaction %p. Pool size "
+                 "%u\n",
+                 pTrxn, thiz->pool[NW_GTPV2C_POOL_TRXN].stats.size);
 
     pTrxn->pStack = thiz;
     pTrxn->pMsg = NULL;
@@ -276,19 +275,16 @@ nw_gtpv2c_trxn_t *nwGtpv2cTrxnWithSeqNumNew(NW_IN nw_gtpv2c_stack_t *thiz,
                                             NW_IN uint32_t seqNum) {
   nw_gtpv2c_trxn_t *pTrxn;
 
-  if (gpGtpv2cTrxnPool) {
-    pTrxn = gpGtpv2cTrxnPool;
-    gpGtpv2cTrxnPool = gpGtpv2cTrxnPool->next;
-  } else {
+  pTrxn = (nw_gtpv2c_trxn_t *)nwGtpv2cPoolGet(thiz, NW_GTPV2C_POOL_TRXN);
+  if (!pTrxn) {
     NW_GTPV2C_MALLOC(thiz, sizeof(nw_gtpv2c_trxn_t), pTrxn, nw_gtpv2c_trxn_t *);
   }
 
   if (pTrxn) {
-    OAILOG_DEBUG(
-        LOG_GTPV2C,
-        "Created new trx with seqNum %d as transaction %p. Head %p, Next %p\n",
-        pTrxn, seqNum, gpGtpv2cTrxnPool,
-        (gpGtpv2cTrxnPool) ? gpGtpv2cTrxnPool->next : "null");
+    OAILOG_DEBUG(LOG_GTPV2C,
+                 "Created new trx with seqNum %d as transaction %p. Pool size "
+                 "%u\n",
+                 seqNum, pTrxn, thiz->pool[NW_GTPV2C_POOL_TRXN].stats.size);
 
     pTrxn->pStack = thiz;
     pTrxn->pMsg = NULL;
@@ -324,17 +320,14 @@ nw_gtpv2c_trxn_t *nwGtpv2cTrxnOutstandingRxNew(NW_IN nw_gtpv2c_stack_t *thiz,
 
   // todo: ipv6 for retransmission1
 
-  if (gpGtpv2cTrxnPool) {
-    pTrxn = gpGtpv2cTrxnPool;
-    gpGtpv2cTrxnPool = gpGtpv2cTrxnPool->next;
-  } else {
+  pTrxn = (nw_gtpv2c_trxn_t *)nwGtpv2cPoolGet(thiz, NW_GTPV2C_POOL_TRXN);
+  if (!pTrxn) {
     NW_GTPV2C_MALLOC(thiz, sizeof(nw_gtpv2c_trxn_t), pTrxn, nw_gtpv2c_trxn_t *);
   }
 
   if (pTrxn) {
-    OAILOG_DEBUG(
-        LOG_GTPV2C, "Received new Rx transaction %p, Head %p, Next %p\n", pTrxn,
-        gpGtpv2cTrxnPool, (gpGtpv2cTrxnPool) ? gpGtpv2cTrxnPool->next : "null");
+    OAILOG_DEBUG(LOG_GTPV2C, "Received new Rx transaction %p, Pool size %u\n",
+                 pTrxn, thiz->pool[NW_GTPV2C_POOL_TRXN].stats.size);
 
     pTrxn->pStack = thiz;
     pTrxn->maxRetries = 2;
@@ -415,18 +408,13 @@ nw_rc_t nwGtpv2cTrxnDelete(NW_INOUT nw_gtpv2c_trxn_t **pthiz) {
     NW_ASSERT(NW_OK == rc);
   }
 
-  OAILOG_DEBUG(
-      LOG_GTPV2C,
-      "Purging  transaction %p with seqNum %d. (before) Head %p, Next %p. \n",
-      thiz, thiz->seqNum, gpGtpv2cTrxnPool,
-      (gpGtpv2cTrxnPool) ? gpGtpv2cTrxnPool->next : 0);
-  thiz->next = gpGtpv2cTrxnPool;
-  gpGtpv2cTrxnPool = thiz;
+  OAILOG_DEBUG(LOG_GTPV2C, "Purging  transaction %p with seqNum %d.\n", thiz,
+               thiz->seqNum);
+  nwGtpv2cPoolPut(pStack, NW_GTPV2C_POOL_TRXN, thiz);
   *pthiz = NULL;
 
-  OAILOG_DEBUG(LOG_GTPV2C, "After purging  transaction %p, Head %p, Next %p\n",
-               thiz, gpGtpv2cTrxnPool,
-               (gpGtpv2cTrxnPool) ? gpGtpv2cTrxnPool->next : "null");
+  OAILOG_DEBUG(LOG_GTPV2C, "After purging  transaction %p, Pool size %u\n",
+               thiz, pStack->pool[NW_GTPV2C_POOL_TRXN].stats.size);
 
   return rc;
 }
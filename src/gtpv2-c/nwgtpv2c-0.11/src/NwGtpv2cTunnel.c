@@ -46,18 +46,14 @@
 extern "C" {
 #endif
 
-static nw_gtpv2c_tunnel_t *gpGtpv2cTunnelPool = NULL;
-
 //------------------------------------------------------------------------------
 nw_gtpv2c_tunnel_t *nwGtpv2cTunnelNew(
     struct nw_gtpv2c_stack_s *pStack, uint32_t teid,
     struct sockaddr *ipAddrRemote, nw_gtpv2c_ulp_tunnel_handle_t hUlpTunnel) {
   nw_gtpv2c_tunnel_t *thiz;
 
-  if (gpGtpv2cTunnelPool) {
-    thiz = gpGtpv2cTunnelPool;
-    gpGtpv2cTunnelPool = gpGtpv2cTunnelPool->next;
-  } else {
+  thiz = (nw_gtpv2c_tunnel_t *)nwGtpv2cPoolGet(pStack, NW_GTPV2C_POOL_TUNNEL);
+  if (!thiz) {
     NW_GTPV2C_MALLOC(pStack, sizeof(nw_gtpv2c_tunnel_t), thiz,
                      nw_gtpv2c_tunnel_t *);
   }
@@ -74,11 +70,9 @@ nw_gtpv2c_tunnel_t *nwGtpv2cTunnelNew(
 }
 
 //------------------------------------------------------------------------------
-nw_rc_t nwGtpv2cTunnelDelete(
-    __attribute__((unused)) struct nw_gtpv2c_stack_s *pStack,
-    nw_gtpv2c_tunnel_t *thiz) {
-  thiz->next = gpGtpv2cTunnelPool;
-  gpGtpv2cTunnelPool = thiz;
+nw_rc_t nwGtpv2cTunnelDelete(struct nw_gtpv2c_stack_s *pStack,
+                             nw_gtpv2c_tunnel_t *thiz) {
+  nwGtpv2cPoolPut(pStack, NW_GTPV2C_POOL_TUNNEL, thiz);
   return NW_OK;
 }
 
@@ -143,28 +143,18 @@ ue_context_t *get_new_ue_context() {
         "MME_APP_INITIAL_UE_MESSAGE. MME_UE_S1AP_ID allocation Failed.\n");
     OAILOG_FUNC_RETURN(LOG_MME_APP, NULL);
   }
-  /** Check the first element in the list. If it is not empty, reject. */
-  ue_context_t *ue_context = STAILQ_FIRST(&mme_app_desc.mme_ue_contexts_list);
-  DevAssert(ue_context); /**< todo: with locks, it should be guaranteed, that
-                            this should exist. */
-  if (ue_context->privates.mme_ue_s1ap_id != INVALID_MME_UE_S1AP_ID) {
+  ue_context_t *ue_context = obj_slab_alloc(mme_app_desc.ue_context_slab);
+  if (!ue_context) {
     OAILOG_ERROR(LOG_MME_APP,
                  "No free UE context left. Cannot allocate a new one.\n");
     OAILOG_FUNC_RETURN(LOG_MME_APP, NULL);
   }
   // todo: lock the UE_context!!
-  /** Found a free pool: Remove it from the head, add the ue_id and set it to
-   * the end. */
-  STAILQ_REMOVE_HEAD(&mme_app_desc.mme_ue_contexts_list,
-                     entries); /**< free_sp is removed. */
-
   OAILOG_INFO(LOG_MME_APP, "Clearing received current ue_context %p.\n",
               ue_context);
   clear_ue_context(ue_context);
   ue_context->privates.mme_ue_s1ap_id = ue_id;
   // todo: unlock the UE_context
-  /** Add it to the back of the list. */
-  STAILQ_INSERT_TAIL(&mme_app_desc.mme_ue_contexts_list, ue_context, entries);
 
   /** Add the UE context. */
   /** Since the NAS and MME_APP contexts are split again, we assign a new
@@ -4137,16 +4127,9 @@ static void release_ue_context(ue_context_t **ue_context) {
               *ue_context, (*ue_context)->privates.mme_ue_s1ap_id);
 
   mme_ue_s1ap_id_t ue_id = (*ue_context)->privates.mme_ue_s1ap_id;
-  // todo: lock the mme_desc (ue_context should already be locked)
-  /** Remove the ue_session pool from the list (probably at the back - must not
-   * be at the very end. */
-  STAILQ_REMOVE(&mme_app_desc.mme_ue_contexts_list, (*ue_context), ue_context_s,
-                entries);
   clear_ue_context(*ue_context);
-  /** Put it into the head. */
-  STAILQ_INSERT_HEAD(&mme_app_desc.mme_ue_contexts_list, (*ue_context),
-                     entries);
+  /** Give it back to the slab, it keeps its mutex. */
+  obj_slab_free(mme_app_desc.ue_context_slab, *ue_context);
   *ue_context = NULL;
-  // todo: unlock the mme_desc
   OAILOG_FUNC_OUT(LOG_MME_APP);
 }
@@ -32,7 +32,11 @@
 #include "intertask_interface.h"
 #include "mme_app_session_context.h"
 #include "mme_app_ue_context.h"
-#define CHANGEABLE_VALUE 4096
+#include "obj_slab.h"
+
+// UE context and session pool slabs grow by max_ues / MME_APP_SLAB_CHUNKS
+#define MME_APP_SLAB_CHUNKS 16
+#define MME_APP_SLAB_MIN_CHUNK_OBJECTS 256
 
 #define MAX_UE_BEARER mme_config.max_ues
 typedef struct mme_app_desc_s {
@@ -43,14 +47,9 @@ typedef struct mme_app_desc_s {
   long statistic_timer_id;
   uint32_t statistic_timer_period;
 
-  /** Create an array of UE session pools. */
-  ue_context_t ue_contexts[CHANGEABLE_VALUE];
-  STAILQ_HEAD(ue_contexts_list_s, ue_context_s) mme_ue_contexts_list;
-
-  /** Create an array of UE session pools. */
-  ue_session_pool_t ue_session_pools[CHANGEABLE_VALUE];
-  STAILQ_HEAD(ue_session_pools_list_s, ue_session_pool_s)
-  mme_ue_session_pools_list;
+  /** Free UE contexts and UE session pools. */
+  obj_slab_t* ue_context_slab;
+  obj_slab_t* ue_session_pool_slab;
 
   uint32_t mme_mobility_management_timer_period;
   /* Reader/writer lock */
@@ -26,105 +26,315 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "bstrlib.h"
 
+#include "assertions.h"
 #include "common_defs.h"
 #include "dynamic_memory_check.h"
+#include "hashtable.h"
 #include "log.h"
 #include "mme_app_edns_emulation.h"
 #include "mme_config.h"
-#include "obj_hashtable.h"
 
-static obj_hash_table_t *sgw_e_dns_entries = NULL;
-static obj_hash_table_t *mme_e_dns_entries = NULL;
+/*
+ * Service selection of TS 29.303 emulated from the WRR_LIST_SELECTION of the
+ * configuration. The entries with the same TAI (FQDN) and interface are the
+ * candidates of that TAI, grouped by priority (lowest value first). Each
+ * priority group has a smooth weighted round robin schedule computed at init,
+ * a selection takes the next slot of the schedule with an atomic counter, so
+ * that the table is read without lock nor allocation once built.
+ */
+#define EDNS_MAX_CANDIDATES 8
+#define EDNS_MAX_WEIGHT 100
+
+typedef struct edns_service_s {
+  interface_type_t interface_type;
+  union {
+    struct sockaddr sa;
+    struct sockaddr_in v4;
+    struct sockaddr_in6 v6;
+  } addr;
+  uint64_t nb_rsp_failures;  // last reported by the GTPv2-C stack
+  uint8_t health;            // mme_app_edns_health_t, atomic
+} edns_service_t;
+
+typedef struct edns_tai_entry_s {
+  uint8_t nb_candidates;
+  struct {
+    uint8_t service;
+    uint16_t weight;
+    uint16_t priority;
+  } candidate[EDNS_MAX_CANDIDATES];
+  // priority groups, candidates sorted by priority
+  uint8_t nb_groups;
+  struct {
+    uint16_t schedule_first;
+    uint16_t schedule_length;
+  } group[EDNS_MAX_CANDIDATES];
+  uint8_t *schedule;  // candidate indexes
+  uint32_t next;      // atomic
+} edns_tai_entry_t;
+
+static edns_service_t edns_services[MME_CONFIG_MAX_SERVICE];
+static int edns_nb_services = 0;
+static edns_tai_entry_t edns_tai_entries[MME_CONFIG_MAX_SERVICE];
+static int edns_nb_tai_entries = 0;
+// (interface type, TAI) -> edns_tai_entries index
+static hash_table_uint64_ts_t *edns_tai_map = NULL;
+
+//------------------------------------------------------------------------------
+static inline hash_key_t edns_tai_key(const interface_type_t interface_type,
+                                      const uint16_t mcc, const uint16_t mnc,
+                                      const tac_t tac) {
+  return ((hash_key_t)interface_type << 36) | ((hash_key_t)mcc << 26) |
+         ((hash_key_t)mnc << 16) | tac;
+}
 
 //------------------------------------------------------------------------------
-void mme_app_edns_get_wrr_entry(bstring id,
+static bool edns_same_address(const struct sockaddr *a,
+                              const struct sockaddr *b) {
+  if (a->sa_family != b->sa_family) {
+    return false;
+  }
+  if (a->sa_family == AF_INET) {
+    return ((const struct sockaddr_in *)a)->sin_addr.s_addr ==
+           ((const struct sockaddr_in *)b)->sin_addr.s_addr;
+  }
+  return memcmp(&((const struct sockaddr_in6 *)a)->sin6_addr,
+                &((const struct sockaddr_in6 *)b)->sin6_addr,
+                sizeof(struct in6_addr)) == 0;
+}
+
+//------------------------------------------------------------------------------
+static int edns_service_index(const struct sockaddr *sockaddr,
+                              const interface_type_t interface_type) {
+  for (int i = 0; i < edns_nb_services; i++) {
+    if ((edns_services[i].interface_type == interface_type) &&
+        (edns_same_address(&edns_services[i].addr.sa, sockaddr))) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+void mme_app_edns_get_wrr_entry(const tai_t *const tai,
                                 const interface_type_t interface_type,
-                                struct sockaddr **sockaddr) {
-  switch (interface_type) {
-    case S10_MME_GTP_C:
-      obj_hashtable_get(mme_e_dns_entries, bdata(id), blength(id),
-                        (void **)sockaddr);
-      return;
-    case S11_SGW_GTP_C:
-      obj_hashtable_get(sgw_e_dns_entries, bdata(id), blength(id),
-                        (void **)sockaddr);
-      return;
-    default:
-      return;
+                                const bool rotate, struct sockaddr **sockaddr) {
+  uint16_t mcc = (tai->plmn.mcc_digit1 * 100) + (tai->plmn.mcc_digit2 * 10) +
+                 tai->plmn.mcc_digit3;
+  uint16_t mnc = (tai->plmn.mnc_digit1 * 10) + tai->plmn.mnc_digit2;
+  uint64_t index = 0;
+
+  if (10 > tai->plmn.mnc_digit3) {
+    mnc = (mnc * 10) + tai->plmn.mnc_digit3;
+  }
+  *sockaddr = NULL;
+  if ((!edns_tai_map) ||
+      (HASH_TABLE_OK !=
+       hashtable_uint64_ts_get(
+           edns_tai_map, edns_tai_key(interface_type, mcc, mnc, tai->tac),
+           &index))) {
+    return;
+  }
+
+  edns_tai_entry_t *entry = &edns_tai_entries[index];
+  const uint32_t next =
+      (rotate) ? __atomic_fetch_add(&entry->next, 1, __ATOMIC_RELAXED) : 0;
+
+  /*
+   * First candidate in service, by priority then schedule order
+   */
+  for (int g = 0; g < entry->nb_groups; g++) {
+    const uint8_t *schedule =
+        &entry->schedule[entry->group[g].schedule_first];
+    const uint16_t length = entry->group[g].schedule_length;
+
+    for (uint16_t i = 0; i < length; i++) {
+      edns_service_t *service =
+          &edns_services[entry->candidate[schedule[(next + i) % length]]
+                             .service];
+
+      if (MME_APP_EDNS_SERVICE_UP ==
+          __atomic_load_n(&service->health, __ATOMIC_RELAXED)) {
+        *sockaddr = &service->addr.sa;
+        return;
+      }
+    }
   }
+  /*
+   * None in service, the schedule of the first priority regardless
+   */
+  *sockaddr =
+      &edns_services[entry->candidate[entry->schedule[next %
+                                                      entry->group[0]
+                                                          .schedule_length]]
+                         .service]
+           .addr.sa;
 }
 
 //------------------------------------------------------------------------------
-int mme_app_edns_add_wrr_entry(bstring id, struct sockaddr *edns_ip_addr,
-                               const interface_type_t interface_type) {
-  char *cid = calloc(1, blength(id) + 1);
-  if (cid) {
-    strncpy(cid, (const char *)id->data, blength(id));
-
-    struct sockaddr_in *data;
-    if (edns_ip_addr->sa_family == AF_INET) {
-      data = malloc(sizeof(struct sockaddr_in));
-      memcpy((void *)data, (struct sockaddr_in *)edns_ip_addr,
-             sizeof(struct sockaddr_in));
-    } else if (edns_ip_addr->sa_family == AF_INET6) {
-      data = malloc(sizeof(struct sockaddr_in6));
-      memcpy((void *)data, (struct sockaddr_in6 *)edns_ip_addr,
-             sizeof(struct sockaddr_in6));
-    } else {
-      OAILOG_DEBUG(LOG_MME_APP, "Unknown socket address family %d",
-                   edns_ip_addr->sa_family);
-      free_wrapper(&cid);
+void mme_app_edns_update_service_health(const interface_type_t interface_type,
+                                        const struct sockaddr *sockaddr,
+                                        const uint64_t nb_rsp_failures) {
+  const int i = edns_service_index(sockaddr, interface_type);
+  uint8_t health = MME_APP_EDNS_SERVICE_UP;
+
+  if (0 > i) {
+    return;
+  }
+  // Requests left without response since the previous report
+  if (nb_rsp_failures > edns_services[i].nb_rsp_failures) {
+    health = MME_APP_EDNS_SERVICE_DEGRADED;
+  }
+  edns_services[i].nb_rsp_failures = nb_rsp_failures;
+  if (health != __atomic_exchange_n(&edns_services[i].health, health,
+                                    __ATOMIC_RELAXED)) {
+    OAILOG_WARNING(LOG_MME_APP, "Service %d (interface type %d) %s\n", i,
+                   interface_type,
+                   (MME_APP_EDNS_SERVICE_UP == health) ? "back in service"
+                                                       : "degraded");
+  }
+}
+
+//------------------------------------------------------------------------------
+static int mme_app_edns_add_wrr_entry(bstring id, struct sockaddr *edns_ip_addr,
+                                      const interface_type_t interface_type,
+                                      uint16_t weight,
+                                      const uint16_t priority) {
+  unsigned int tac_lb = 0;
+  unsigned int tac_hb = 0;
+  unsigned int mnc = 0;
+  unsigned int mcc = 0;
+  int consumed = 0;
+  uint64_t index = 0;
+  edns_tai_entry_t *entry = NULL;
+
+  if ((4 != sscanf(bdata(id),
+                   "tac-lb%2x.tac-hb%2x.tac.epc.mnc%3u.mcc%3u"
+                   ".3gppnetwork.org%n",
+                   &tac_lb, &tac_hb, &mnc, &mcc, &consumed)) ||
+      (consumed != blength(id))) {
+    OAILOG_ERROR(LOG_MME_APP, "Bad service ID %s\n", bdata(id));
+    return RETURNerror;
+  }
+  if ((edns_ip_addr->sa_family != AF_INET) &&
+      (edns_ip_addr->sa_family != AF_INET6)) {
+    OAILOG_DEBUG(LOG_MME_APP, "Unknown socket address family %d",
+                 edns_ip_addr->sa_family);
+    return RETURNerror;
+  }
+  weight = (0 == weight) ? 1 : min(weight, EDNS_MAX_WEIGHT);
+
+  int service = edns_service_index(edns_ip_addr, interface_type);
+  if (0 > service) {
+    service = edns_nb_services++;
+    edns_services[service].interface_type = interface_type;
+    memcpy(&edns_services[service].addr, edns_ip_addr,
+           (edns_ip_addr->sa_family == AF_INET) ? sizeof(struct sockaddr_in)
+                                                : sizeof(struct sockaddr_in6));
+    edns_services[service].health = MME_APP_EDNS_SERVICE_UP;
+  }
+
+  const hash_key_t key =
+      edns_tai_key(interface_type, mcc, mnc, (tac_hb << 8) | tac_lb);
+  if (HASH_TABLE_OK == hashtable_uint64_ts_get(edns_tai_map, key, &index)) {
+    entry = &edns_tai_entries[index];
+  } else {
+    index = edns_nb_tai_entries++;
+    entry = &edns_tai_entries[index];
+    if (HASH_TABLE_OK != hashtable_uint64_ts_insert(edns_tai_map, key, index)) {
       return RETURNerror;
     }
-    if (data) {
-      hashtable_rc_t rc;
-      switch (interface_type) {
-        case S10_MME_GTP_C:
-          rc = obj_hashtable_insert(mme_e_dns_entries, cid, strlen(cid), data);
-          break;
-        case S11_SGW_GTP_C:
-          rc = obj_hashtable_insert(sgw_e_dns_entries, cid, strlen(cid), data);
-          break;
-        default:
-          OAILOG_DEBUG(LOG_MME_APP, "Unknown interface type %d",
-                       interface_type);
-          return RETURNerror;
+  }
+  if (EDNS_MAX_CANDIDATES == entry->nb_candidates) {
+    OAILOG_ERROR(LOG_MME_APP, "Too many candidates for service ID %s\n",
+                 bdata(id));
+    return RETURNerror;
+  }
+  // Insertion sort by priority, configuration order within a priority
+  int c = entry->nb_candidates++;
+  while ((c > 0) && (entry->candidate[c - 1].priority > priority)) {
+    entry->candidate[c] = entry->candidate[c - 1];
+    c--;
+  }
+  entry->candidate[c].service = service;
+  entry->candidate[c].weight = weight;
+  entry->candidate[c].priority = priority;
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+static void mme_app_edns_build_schedule(edns_tai_entry_t *entry) {
+  int schedule_length = 0;
+  int first = 0;
+
+  for (int c = 0; c < entry->nb_candidates; c++) {
+    schedule_length += entry->candidate[c].weight;
+  }
+  entry->schedule = calloc(schedule_length, sizeof(uint8_t));
+  entry->nb_groups = 0;
+  schedule_length = 0;
+
+  while (first < entry->nb_candidates) {
+    int last = first;
+    int total = 0;
+    int current[EDNS_MAX_CANDIDATES] = {0};
+
+    while ((last < entry->nb_candidates) &&
+           (entry->candidate[last].priority ==
+            entry->candidate[first].priority)) {
+      total += entry->candidate[last].weight;
+      last++;
+    }
+    entry->group[entry->nb_groups].schedule_first = schedule_length;
+    entry->group[entry->nb_groups].schedule_length = total;
+    entry->nb_groups++;
+    /*
+     * Smooth weighted round robin: each slot goes to the candidate with the
+     * highest current weight, which is then decreased by the total weight
+     */
+    for (int slot = 0; slot < total; slot++) {
+      int best = first;
+
+      for (int c = first; c < last; c++) {
+        current[c - first] += entry->candidate[c].weight;
+        if (current[c - first] > current[best - first]) {
+          best = c;
+        }
       }
-      /** Key is copied inside. */
-      free_wrapper(&cid);
-      if (HASH_TABLE_OK == rc) return RETURNok;
+      current[best - first] -= total;
+      entry->schedule[schedule_length++] = best;
     }
-    if (cid) free_wrapper(&cid);
+    first = last;
   }
-  return RETURNerror;
 }
 
 //------------------------------------------------------------------------------
 int mme_app_edns_init(const mme_config_t *mme_config_p) {
   int rc = RETURNok;
-  sgw_e_dns_entries = obj_hashtable_create(
-      min(64, MME_CONFIG_MAX_SERVICE), NULL, free_wrapper, free_wrapper, NULL);
-  mme_e_dns_entries = obj_hashtable_create(
-      min(64, MME_CONFIG_MAX_SERVICE), NULL, free_wrapper, free_wrapper, NULL);
-  if (sgw_e_dns_entries && mme_e_dns_entries) {
+  bstring b = bfromcstr("edns_tai_map");
+
+  edns_tai_map = hashtable_uint64_ts_create(MME_CONFIG_MAX_SERVICE, NULL, b);
+  bdestroy_wrapper(&b);
+  if (edns_tai_map) {
     /** Add the service (s10 or s11). */
     for (int i = 0; i < mme_config_p->e_dns_emulation.nb_service_entries; i++) {
       rc |= mme_app_edns_add_wrr_entry(
           mme_config_p->e_dns_emulation.service_id[i],
-          &mme_config_p->e_dns_emulation.sockaddr[i],
-          mme_config_p->e_dns_emulation.interface_type[i]);
+          (struct sockaddr *)&mme_config_p->e_dns_emulation.sockaddr[i],
+          mme_config_p->e_dns_emulation.interface_type[i],
+          mme_config_p->e_dns_emulation.weight[i],
+          mme_config_p->e_dns_emulation.priority[i]);
+    }
+    for (int i = 0; i < edns_nb_tai_entries; i++) {
+      mme_app_edns_build_schedule(&edns_tai_entries[i]);
+    }
+    if (rc) {
+      OAILOG_DEBUG(LOG_MME_APP, "Failed to populate eDNS");
     }
-    //    /** Add the neighboring MMEs. */
-    //    for (int i = 0; i < mme_config_p->e_dns_emulation.nb_mme_entries; i++)
-    //    {
-    //      rc |=
-    //      mme_app_edns_add_mme_entry(mme_config_p->e_dns_emulation.mme_id[i],
-    //      mme_config_p->e_dns_emulation.mme_ip_addr[i]);
-    //    }
-    OAILOG_DEBUG(LOG_MME_APP, "Failed to populate eDNS");
     return rc;
   }
   OAILOG_DEBUG(LOG_MME_APP, "Failed to create eDNS hashtables");
@@ -133,6 +343,12 @@ int mme_app_edns_init(const mme_config_t *mme_config_p) {
 
 //------------------------------------------------------------------------------
 void mme_app_edns_exit(void) {
-  obj_hashtable_destroy(sgw_e_dns_entries);
-  obj_hashtable_destroy(mme_e_dns_entries);
+  hashtable_uint64_ts_destroy(edns_tai_map);
+  edns_tai_map = NULL;
+  for (int i = 0; i < edns_nb_tai_entries; i++) {
+    free_wrapper((void **)&edns_tai_entries[i].schedule);
+  }
+  memset(edns_tai_entries, 0, sizeof(edns_tai_entries));
+  edns_nb_tai_entries = 0;
+  edns_nb_services = 0;
 }
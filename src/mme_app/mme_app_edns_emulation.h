@@ -33,12 +33,28 @@
 // int mme_app_edns_add_sgw_entry(bstring id, struct in_addr in_addr);
 // int mme_app_edns_add_mme_entry(bstring id, struct in_addr in_addr);
 
-void mme_app_edns_get_wrr_entry(bstring id,
+typedef enum {
+  MME_APP_EDNS_SERVICE_UP = 0,
+  MME_APP_EDNS_SERVICE_DEGRADED,
+} mme_app_edns_health_t;
+
+/*
+ * Next service of the TAI by weighted round robin, among the services in
+ * service of the lowest priority, *sockaddr set to NULL if none is configured
+ * for the TAI. Without rotate, always the first service of the schedule in
+ * service. Lock-free, callable from any task.
+ */
+void mme_app_edns_get_wrr_entry(const tai_t* const tai,
                                 const interface_type_t interface_type,
-                                struct sockaddr** sockaddr);
+                                const bool rotate, struct sockaddr** sockaddr);
 
-int mme_app_edns_add_wrr_entry(bstring id, struct sockaddr* edns_ip_addr,
-                               const interface_type_t interface_type);
+/*
+ * Health of a service from the response failure counter of its GTPv2-C peer,
+ * degraded while the counter increases between two reports.
+ */
+void mme_app_edns_update_service_health(const interface_type_t interface_type,
+                                        const struct sockaddr* sockaddr,
+                                        const uint64_t nb_rsp_failures);
 
 int mme_app_edns_init(const mme_config_t* mme_config_p);
 void mme_app_edns_exit(void);
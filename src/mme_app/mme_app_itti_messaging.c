@@ -330,10 +330,21 @@ int mme_app_send_s11_create_session_req(
   // Actually, since S and P GW are bundled together, there is no PGW selection
   // (based on PGW id in ULA, or DNS query based on FQDN)
   struct sockaddr *edns_peer_ip = NULL;
-  if (1) {
-    // TODO prototype may change
+  pdn_context_t *registered_pdn_ctx = NULL;
+  /*
+   * All the PDN connections of the UE go through one SGW: select it for the
+   * first PDN connection only, the selection rotates among the SGWs
+   */
+  RB_FOREACH(registered_pdn_ctx, PdnContexts, &ue_session_pool->pdn_contexts) {
+    if ((registered_pdn_ctx != pdn_context) &&
+        (((struct sockaddr *)&registered_pdn_ctx->s_gw_addr_s11_s4)
+             ->sa_family != 0)) {
+      edns_peer_ip = (struct sockaddr *)&registered_pdn_ctx->s_gw_addr_s11_s4;
+      break;
+    }
+  }
+  if (!edns_peer_ip) {
     mme_app_select_service(serving_tai, &edns_peer_ip, S11_SGW_GTP_C);
-    //    session_request_p->peer_ip.in_addr = mme_config.ipv4.
   }
   if (!edns_peer_ip) {
     OAILOG_ERROR(LOG_MME_APP,
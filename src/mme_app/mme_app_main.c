@@ -56,18 +56,29 @@ void *mme_app_thread(void *args) {
   struct ue_context_s *ue_context = NULL;
   mme_app_s10_proc_mme_handover_t *s10_handover_proc = NULL;
 
+  MessageDef *received_messages[ITTI_RECEIVE_MSGS_BATCH_SIZE] = {NULL};
+  int nb_received_messages = 0;
+  int next_received_message = 0;
+
   itti_mark_task_ready(TASK_MME_APP);
+  itti_set_task_wake_if_sleeping(TASK_MME_APP);
   MSC_START_USE();
 
   while (1) {
     MessageDef *received_message_p = NULL;
 
     /*
-     * Trying to fetch a message from the message queue.
+     * Trying to fetch messages from the message queue.
      * If the queue is empty, this function will block till a
      * message is sent to the task.
      */
-    itti_receive_msg(TASK_MME_APP, &received_message_p);
+    if (next_received_message == nb_received_messages) {
+      next_received_message = 0;
+      nb_received_messages = itti_receive_msgs(
+          TASK_MME_APP, received_messages, ITTI_RECEIVE_MSGS_BATCH_SIZE);
+      if (!nb_received_messages) continue;
+    }
+    received_message_p = received_messages[next_received_message++];
     DevAssert(received_message_p);
 
     switch (ITTI_MSG_ID(received_message_p)) {
@@ -432,6 +443,8 @@ void *mme_app_thread(void *args) {
         mme_app_exit();
         itti_free_msg_content(received_message_p);
         itti_free(ITTI_MSG_ORIGIN_ID(received_message_p), received_message_p);
+        itti_free_received_msgs(received_messages, next_received_message,
+                                nb_received_messages);
 
         OAI_FPRINTF_INFO("TASK_MME_APP terminated\n");
         itti_exit_task();
@@ -513,6 +526,52 @@ void *mme_app_thread(void *args) {
   return NULL;
 }
 
+//------------------------------------------------------------------------------
+static int mme_app_init_recmutex(pthread_mutex_t *const mutex) {
+  pthread_mutexattr_t mutexattr = {0};
+  int rc = pthread_mutexattr_init(&mutexattr);
+  if (rc) {
+    OAILOG_ERROR(LOG_MME_APP, "Failed to init mutex attribute: %s\n",
+                 strerror(rc));
+    return rc;
+  }
+  rc = pthread_mutexattr_settype(&mutexattr, PTHREAD_MUTEX_RECURSIVE);
+  if (rc) {
+    OAILOG_ERROR(LOG_MME_APP, "Failed to set mutex attribute type: %s\n",
+                 strerror(rc));
+  } else if ((rc = pthread_mutex_init(mutex, &mutexattr))) {
+    OAILOG_ERROR(LOG_MME_APP, "Failed to init mutex: %s\n", strerror(rc));
+  }
+  pthread_mutexattr_destroy(&mutexattr);
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+// Called once per UE context, when the slab chunk holding it is allocated
+static int mme_app_ue_context_ctor(void *object) {
+  ue_context_t *ue_context = (ue_context_t *)object;
+
+  memset(ue_context, 0, sizeof(*ue_context));
+  ue_context->privates.mme_ue_s1ap_id = INVALID_MME_UE_S1AP_ID;
+  ue_context->privates.enb_s1ap_id_key = INVALID_ENB_UE_S1AP_ID_KEY;
+  ue_context->privates.mobile_reachability_timer.id =
+      MME_APP_TIMER_INACTIVE_ID;
+  ue_context->privates.implicit_detach_timer.id = MME_APP_TIMER_INACTIVE_ID;
+  ue_context->privates.initial_context_setup_rsp_timer.id =
+      MME_APP_TIMER_INACTIVE_ID;
+  return mme_app_init_recmutex(&ue_context->privates.recmutex);
+}
+
+//------------------------------------------------------------------------------
+// Called once per UE session pool, when the slab chunk holding it is allocated
+static int mme_app_ue_session_pool_ctor(void *object) {
+  ue_session_pool_t *ue_session_pool = (ue_session_pool_t *)object;
+
+  memset(ue_session_pool, 0, sizeof(*ue_session_pool));
+  ue_session_pool->privates.mme_ue_s1ap_id = INVALID_MME_UE_S1AP_ID;
+  return mme_app_init_recmutex(&ue_session_pool->privates.recmutex);
+}
+
 //------------------------------------------------------------------------------
 int mme_app_init(const mme_config_t *mme_config_p) {
   OAILOG_FUNC_IN(LOG_MME_APP);
@@ -575,105 +634,26 @@ int mme_app_init(const mme_config_t *mme_config_p) {
   }
 
   /**
-   * Initialize the UE contexts.
+   * Initialize the UE contexts and session pools. The slabs grow by chunks up
+   * to the configured maximum number of UEs, objects never move.
    */
-  STAILQ_INIT(&mme_app_desc.mme_ue_contexts_list);
-  /** Iterate through the list of ue contexts. */
-  for (int num_sp = 0; num_sp < CHANGEABLE_VALUE; num_sp++) {
-    mme_app_desc.ue_contexts[num_sp].privates.mme_ue_s1ap_id =
-        INVALID_MME_UE_S1AP_ID;
-    mme_app_desc.ue_contexts[num_sp].privates.enb_s1ap_id_key =
-        INVALID_ENB_UE_S1AP_ID_KEY;
-
-    /** Create a new mutex for each and put them into the list. */
-    ue_context_t *ue_context = &mme_app_desc.ue_contexts[num_sp];
-    pthread_mutexattr_t mutexattr = {0};
-    int rc = pthread_mutexattr_init(&mutexattr);
-    if (rc) {
-      OAILOG_ERROR(
-          LOG_MME_APP,
-          "Cannot create UE context, failed to init mutex attribute: %s\n",
-          strerror(rc));
-      OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
-    }
-    rc = pthread_mutexattr_settype(&mutexattr, PTHREAD_MUTEX_RECURSIVE);
-    if (rc) {
-      OAILOG_ERROR(
-          LOG_MME_APP,
-          "Cannot create UE context, failed to set mutex attribute type: %s\n",
-          strerror(rc));
-      OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
-    }
-    rc = pthread_mutex_init(&ue_context->privates.recmutex, &mutexattr);
-    if (rc) {
-      OAILOG_ERROR(LOG_MME_APP,
-                   "Cannot create UE context, failed to init mutex: %s\n",
-                   strerror(rc));
-      OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
-    }
-    //  rc = lock_ue_contexts(new_p);
-    if (rc) {
-      OAILOG_ERROR(LOG_MME_APP,
-                   "Cannot create UE context, failed to lock mutex: %s\n",
-                   strerror(rc));
-      OAILOG_FUNC_RETURN(LOG_MME_APP, NULL);
-    }
-    STAILQ_INSERT_TAIL(&mme_app_desc.mme_ue_contexts_list,
-                       &mme_app_desc.ue_contexts[num_sp], entries);
-
-    /** Reset the timers. */
-    ue_context->privates.mobile_reachability_timer.id =
-        MME_APP_TIMER_INACTIVE_ID;
-    ue_context->privates.implicit_detach_timer.id = MME_APP_TIMER_INACTIVE_ID;
-    ue_context->privates.initial_context_setup_rsp_timer.id =
-        MME_APP_TIMER_INACTIVE_ID;
-
-    // todo: unlocking the ue_context?!
+  uint32_t objects_per_chunk = mme_config_p->max_ues / MME_APP_SLAB_CHUNKS;
+  if (objects_per_chunk < MME_APP_SLAB_MIN_CHUNK_OBJECTS) {
+    objects_per_chunk = MME_APP_SLAB_MIN_CHUNK_OBJECTS;
   }
-
-  /**
-   * Initialize the UE session pools.
-   */
-  STAILQ_INIT(&mme_app_desc.mme_ue_session_pools_list);
-  /** Iterate through the list of ue session pools. */
-  for (int num_sp = 0; num_sp < CHANGEABLE_VALUE; num_sp++) {
-    mme_app_desc.ue_session_pools[num_sp].privates.mme_ue_s1ap_id =
-        INVALID_MME_UE_S1AP_ID;
-    /** Create a new mutex for each and put them into the list. */
-    ue_session_pool_t *ue_session_pool = &mme_app_desc.ue_session_pools[num_sp];
-    pthread_mutexattr_t mutexattr = {0};
-    int rc = pthread_mutexattr_init(&mutexattr);
-    if (rc) {
-      OAILOG_ERROR(
-          LOG_MME_APP,
-          "Cannot create UE session pool, failed to init mutex attribute: %s\n",
-          strerror(rc));
-      OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
-    }
-    rc = pthread_mutexattr_settype(&mutexattr, PTHREAD_MUTEX_RECURSIVE);
-    if (rc) {
-      OAILOG_ERROR(LOG_MME_APP,
-                   "Cannot create UE session pool, failed to set mutex "
-                   "attribute type: %s\n",
-                   strerror(rc));
-      OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
-    }
-    rc = pthread_mutex_init(&ue_session_pool->privates.recmutex, &mutexattr);
-    if (rc) {
-      OAILOG_ERROR(LOG_MME_APP,
-                   "Cannot create UE session pool, failed to init mutex: %s\n",
-                   strerror(rc));
-      OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
-    }
-    //  rc = lock_ue_contexts(new_p);
-    if (rc) {
-      OAILOG_ERROR(LOG_MME_APP,
-                   "Cannot create UE session pool, failed to lock mutex: %s\n",
-                   strerror(rc));
-      OAILOG_FUNC_RETURN(LOG_MME_APP, NULL);
-    }
-    STAILQ_INSERT_TAIL(&mme_app_desc.mme_ue_session_pools_list,
-                       &mme_app_desc.ue_session_pools[num_sp], entries);
+  mme_app_desc.ue_context_slab = obj_slab_create(
+      "mme_app_ue_contexts", sizeof(ue_context_t), objects_per_chunk,
+      mme_config_p->max_ues, mme_app_ue_context_ctor, NULL);
+  if (!mme_app_desc.ue_context_slab) {
+    OAILOG_ERROR(LOG_MME_APP, "Cannot create the UE context slab\n");
+    OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
+  }
+  mme_app_desc.ue_session_pool_slab = obj_slab_create(
+      "mme_app_ue_session_pools", sizeof(ue_session_pool_t), objects_per_chunk,
+      mme_config_p->max_ues, mme_app_ue_session_pool_ctor, NULL);
+  if (!mme_app_desc.ue_session_pool_slab) {
+    OAILOG_ERROR(LOG_MME_APP, "Cannot create the UE session pool slab\n");
+    OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
   }
 
   /*
@@ -734,5 +714,8 @@ void mme_app_exit(void) {
   hashtable_ts_destroy(
       mme_app_desc.mme_ue_session_pools.mme_ue_s1ap_id_ue_session_pool_htbl);
 
+  obj_slab_destroy(&mme_app_desc.ue_session_pool_slab);
+  obj_slab_destroy(&mme_app_desc.ue_context_slab);
+
   mme_config_exit();
 }
@@ -267,20 +267,13 @@ ue_session_pool_t *get_new_session_pool(mme_ue_s1ap_id_t ue_id) {
   OAILOG_FUNC_IN(LOG_MME_APP);
   // todo: lock the mme_desc
 
-  /** Check the first element in the list. If it is not empty, reject. */
   ue_session_pool_t *ue_session_pool =
-      STAILQ_FIRST(&mme_app_desc.mme_ue_session_pools_list);
-  DevAssert(ue_session_pool); /**< todo: with locks, it should be guaranteed,
-                                 that this should exist. */
-  if (ue_session_pool->privates.mme_ue_s1ap_id != INVALID_MME_UE_S1AP_ID) {
+      obj_slab_alloc(mme_app_desc.ue_session_pool_slab);
+  if (!ue_session_pool) {
     OAILOG_ERROR(LOG_MME_APP,
                  "No free ue session pool left. Cannot allocate a new one.\n");
     OAILOG_FUNC_RETURN(LOG_MME_APP, NULL);
   }
-  /** Found a free pool: Remove it from the head, add the ue_id and set it to
-   * the end. */
-  STAILQ_REMOVE_HEAD(&mme_app_desc.mme_ue_session_pools_list,
-                     entries); /**< free_sp is removed. */
 
   /** Initialize the bearers in the pool. */
   /** Remove the EMS-EBR context of the bearer-context. */
@@ -288,9 +281,6 @@ ue_session_pool_t *get_new_session_pool(mme_ue_s1ap_id_t ue_id) {
               ue_session_pool);
   clear_session_pool(ue_session_pool);
   ue_session_pool->privates.mme_ue_s1ap_id = ue_id;
-  /** Add it to the back of the list. */
-  STAILQ_INSERT_TAIL(&mme_app_desc.mme_ue_session_pools_list, ue_session_pool,
-                     entries);
   DevAssert(mme_insert_ue_session_pool(&mme_app_desc.mme_ue_session_pools,
                                        ue_session_pool) == 0);
   // todo: unlock!
@@ -307,17 +297,10 @@ void release_session_pool(ue_session_pool_t **ue_session_pool) {
               "Releasing session pool %p of UE " MME_UE_S1AP_ID_FMT ".\n",
               *ue_session_pool, (*ue_session_pool)->privates.mme_ue_s1ap_id);
 
-  // todo: lock the mme_desc (ue_context should already be locked)
-  /** Remove the ue_session pool from the list (probably at the back - must not
-   * be at the very end. */
-  STAILQ_REMOVE(&mme_app_desc.mme_ue_session_pools_list, (*ue_session_pool),
-                ue_session_pool_s, entries);
   clear_session_pool(*ue_session_pool);
-  /** Put it into the head. */
-  STAILQ_INSERT_HEAD(&mme_app_desc.mme_ue_session_pools_list,
-                     (*ue_session_pool), entries);
+  /** Give it back to the slab, it keeps its mutex. */
+  obj_slab_free(mme_app_desc.ue_session_pool_slab, *ue_session_pool);
   *ue_session_pool = NULL;
-  // todo: unlock the mme_desc
   OAILOG_FUNC_OUT(LOG_MME_APP);
 }
 
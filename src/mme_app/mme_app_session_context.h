@@ -228,9 +228,6 @@ typedef struct ue_session_pool_s {
   STAILQ_HEAD(free_pdn_s, pdn_context_s) free_pdn_contexts;
   LIST_HEAD(s11_procedures_s, mme_app_s11_proc_s) s11_procedures;
   LIST_HEAD(s1ap_procedures_s, mme_app_s1ap_proc_s) s1ap_procedures;
-
-  /** Point to the next free session pool. */
-  STAILQ_ENTRY(ue_session_pool_s) entries;
 } ue_session_pool_t;
 
 /* Declaration (prototype) of the function to store pdn and bearer contexts. */
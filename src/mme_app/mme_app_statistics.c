@@ -32,6 +32,7 @@
 #include "mme_app_defs.h"
 #include "mme_app_statistics.h"
 #include "mme_app_ue_context.h"
+#include "s1ap_mme.h"
 
 int mme_app_statistics_display(void) {
   OAILOG_DEBUG(LOG_MME_APP,
@@ -70,6 +71,7 @@ int mme_app_statistics_display(void) {
                mme_app_desc.nb_s1u_bearers,
                mme_app_desc.nb_s1u_bearers_established_since_last_stat,
                mme_app_desc.nb_s1u_bearers_released_since_last_stat);
+  s1ap_display_tac_paging_stats();
   OAILOG_DEBUG(LOG_MME_APP,
                "======================================= STATISTICS "
                "============================================\n\n");
@@ -278,8 +278,6 @@ typedef struct ue_context_s {
       me_identity_t me_identity;  // not set/read except read by display utility
     } fields;
   } privates;
-  /** Entries for UE context pool. */
-  STAILQ_ENTRY(ue_context_s) entries;
 } ue_context_t;
 
 typedef struct mme_ue_context_s {
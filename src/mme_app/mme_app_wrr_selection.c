@@ -49,65 +49,25 @@ void mme_app_select_service(const tai_t* const tai,
   // ="x-3gpp-mme:x-s10/s11" )
   // ....
 
-  // do it the simplest way for now
-  //
-  char tmp[8];
-  bstring application_unique_string = bfromcstr("tac-lb");
-  if (0 < snprintf(tmp, 8, "%02x", tai->tac & 0x00FF)) {
-    bcatcstr(application_unique_string, tmp);
-  } else {
-    memset((void*)*service_ip_addr, 0, sizeof(struct sockaddr));
-    return;
-  }
-  bcatcstr(application_unique_string, ".tac-hb");
-  if (0 < snprintf(tmp, 8, "%02x", tai->tac >> 8)) {
-    bcatcstr(application_unique_string, tmp);
-  } else {
-    goto lookup_error;
-  }
-  bcatcstr(application_unique_string, ".tac.epc.mnc");
-  uint16_t mnc = (tai->plmn.mnc_digit1 * 10) + tai->plmn.mnc_digit2;
-  if (10 > tai->plmn.mnc_digit3) {
-    mnc = (mnc * 10) + tai->plmn.mnc_digit3;
-  }
-  if (0 < snprintf(tmp, 8, "%03u", mnc)) {
-    bcatcstr(application_unique_string, tmp);
-  } else {
-    goto lookup_error;
-  }
-  bcatcstr(application_unique_string, ".mcc");
-  if (0 < snprintf(tmp, 8, "%u%u%u", tai->plmn.mcc_digit1, tai->plmn.mcc_digit2,
-                   tai->plmn.mcc_digit3)) {
-    bcatcstr(application_unique_string, tmp);
-  } else {
-    goto lookup_error;
-  }
-  bcatcstr(application_unique_string, ".3gppnetwork.org");
-
-  mme_app_edns_get_wrr_entry(application_unique_string, interface_type,
+  // The S10 messages of a UE must all reach the MME serving its TAI
+  mme_app_edns_get_wrr_entry(tai, interface_type,
+                             (S10_MME_GTP_C != interface_type),
                              service_ip_addr);
 
-  if (*service_ip_addr) {
-    if ((*service_ip_addr)->sa_family == AF_INET) {
-      OAILOG_DEBUG(
-          LOG_MME_APP, "Service lookup %s returned %s\n",
-          application_unique_string->data,
-          inet_ntoa(((struct sockaddr_in*)*service_ip_addr)->sin_addr));
-    } else {
-      char ipv6[INET6_ADDRSTRLEN];
-      inet_ntop(AF_INET6, (void*)*service_ip_addr, ipv6, INET6_ADDRSTRLEN);
-      OAILOG_DEBUG(LOG_MME_APP, "Service lookup %s returned %s\n",
-                   application_unique_string->data, ipv6);
-    }
+  if (!*service_ip_addr) {
+    OAILOG_WARNING(LOG_MME_APP, "Failed service lookup for TAI " TAI_FMT "\n",
+                   TAI_ARG(tai));
+  } else if ((*service_ip_addr)->sa_family == AF_INET) {
+    OAILOG_DEBUG(LOG_MME_APP,
+                 "Service lookup for TAI " TAI_FMT " returned %s\n",
+                 TAI_ARG(tai),
+                 inet_ntoa(((struct sockaddr_in*)*service_ip_addr)->sin_addr));
+  } else {
+    char ipv6[INET6_ADDRSTRLEN];
+    inet_ntop(AF_INET6, &((struct sockaddr_in6*)*service_ip_addr)->sin6_addr,
+              ipv6, INET6_ADDRSTRLEN);
+    OAILOG_DEBUG(LOG_MME_APP,
+                 "Service lookup for TAI " TAI_FMT " returned %s\n",
+                 TAI_ARG(tai), ipv6);
   }
-
-  bdestroy_wrapper(&application_unique_string);
-  return;
-
-lookup_error:
-  OAILOG_WARNING(LOG_MME_APP, "Failed service lookup for TAI " TAI_FMT "\n",
-                 TAI_ARG(tai));
-  memset((void*)service_ip_addr, 0, sizeof(struct sockaddr));
-  bdestroy_wrapper(&application_unique_string);
-  return;
 }
@@ -25,6 +25,10 @@
   \email: lionel.gauthier@eurecom.fr
 */
 
+/*
+ * SGWs (S11) of the TAI in weighted round robin, the neighbour MME (S10) of
+ * the TAI is always the same while it is in service.
+ */
 void mme_app_select_service(const tai_t* const tai,
                             struct sockaddr** const service_ip_addr,
                             const interface_type_t interface_type);
@@ -27,6 +27,7 @@
 #endif
 
 #include <pthread.h>
+#include <sched.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -52,6 +53,112 @@
 
 struct mme_config_s mme_config = {.rw_lock = PTHREAD_RWLOCK_INITIALIZER, 0};
 
+/*
+ * Current snapshot, the configuration holds one reference on it. A reader
+ * loads it and takes its own reference while counted in
+ * g_snapshot_readers[epoch]: a publisher swaps the pointer, flips the epoch
+ * and waits for the readers of the previous epoch before dropping the
+ * reference of the configuration, the last reader frees the old snapshot.
+ */
+static mme_config_snapshot_t *g_snapshot = NULL;
+static uint32_t g_snapshot_epoch = 0;
+static uint32_t g_snapshot_readers[2] = {0};
+static pthread_mutex_t g_snapshot_publish_lock = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+static mme_config_snapshot_t *mme_config_snapshot_new(
+    const mme_config_t *config_pP) {
+  mme_config_snapshot_t *snapshot = calloc(1, sizeof(*snapshot));
+
+  snapshot->ref_count = 1;
+  for (int i = 0; i < config_pP->served_tai.nb_tai; i++) {
+    const uint16_t mcc = config_pP->served_tai.plmn_mcc[i];
+    const uint16_t mnc = config_pP->served_tai.plmn_mnc[i];
+    const uint16_t mnc_len = config_pP->served_tai.plmn_mnc_len[i];
+    const uint16_t tac = config_pP->served_tai.tac[i];
+
+    if (!mme_config_snapshot_has_plmn(snapshot, mcc, mnc, mnc_len)) {
+      snapshot->plmn[snapshot->nb_plmn].mcc = mcc;
+      snapshot->plmn[snapshot->nb_plmn].mnc = mnc;
+      snapshot->plmn[snapshot->nb_plmn].mnc_len = mnc_len;
+      snapshot->nb_plmn++;
+    }
+    snapshot->tac_bitmap[tac / 64] |= UINT64_C(1) << (tac % 64);
+  }
+
+  snapshot->realm = bstrcpy(config_pP->realm);
+  if (config_pP->s6a_config.hss_host_name) {
+    snapshot->s6a_destination_host =
+        bstrcpy(config_pP->s6a_config.hss_host_name);
+    bconchar(snapshot->s6a_destination_host, '.');
+    bconcat(snapshot->s6a_destination_host, config_pP->realm);
+  }
+  return snapshot;
+}
+
+//------------------------------------------------------------------------------
+static void mme_config_snapshot_publish(const mme_config_t *config_pP) {
+  mme_config_snapshot_t *snapshot = mme_config_snapshot_new(config_pP);
+  mme_config_snapshot_t *old = NULL;
+  uint32_t epoch = 0;
+
+  pthread_mutex_lock(&g_snapshot_publish_lock);
+  old = __atomic_exchange_n(&g_snapshot, snapshot, __ATOMIC_SEQ_CST);
+  epoch = __atomic_fetch_add(&g_snapshot_epoch, 1, __ATOMIC_SEQ_CST) & 1;
+  // Readers which may still see old without holding a reference on it
+  while (__atomic_load_n(&g_snapshot_readers[epoch], __ATOMIC_SEQ_CST)) {
+    sched_yield();
+  }
+  pthread_mutex_unlock(&g_snapshot_publish_lock);
+  if (old) {
+    mme_config_snapshot_put(old);
+  }
+}
+
+//------------------------------------------------------------------------------
+mme_config_snapshot_t *mme_config_snapshot_get(void) {
+  const uint32_t epoch =
+      __atomic_load_n(&g_snapshot_epoch, __ATOMIC_SEQ_CST) & 1;
+  mme_config_snapshot_t *snapshot = NULL;
+
+  __atomic_add_fetch(&g_snapshot_readers[epoch], 1, __ATOMIC_SEQ_CST);
+  snapshot = __atomic_load_n(&g_snapshot, __ATOMIC_SEQ_CST);
+  if (snapshot) {
+    __atomic_add_fetch(&snapshot->ref_count, 1, __ATOMIC_RELAXED);
+  }
+  __atomic_sub_fetch(&g_snapshot_readers[epoch], 1, __ATOMIC_SEQ_CST);
+  DevAssert(snapshot != NULL);
+  return snapshot;
+}
+
+//------------------------------------------------------------------------------
+void mme_config_snapshot_put(mme_config_snapshot_t *snapshot) {
+  if (__atomic_sub_fetch(&snapshot->ref_count, 1, __ATOMIC_ACQ_REL) == 0) {
+    bdestroy_wrapper(&snapshot->realm);
+    bdestroy_wrapper(&snapshot->s6a_destination_host);
+    free_wrapper((void **)&snapshot);
+  }
+}
+
+//------------------------------------------------------------------------------
+bool mme_config_snapshot_has_plmn(const mme_config_snapshot_t *snapshot,
+                                  const uint16_t mcc, const uint16_t mnc,
+                                  const uint16_t mnc_len) {
+  for (int i = 0; i < snapshot->nb_plmn; i++) {
+    if ((snapshot->plmn[i].mcc == mcc) && (snapshot->plmn[i].mnc == mnc) &&
+        (snapshot->plmn[i].mnc_len == mnc_len)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+bool mme_config_snapshot_has_tac(const mme_config_snapshot_t *snapshot,
+                                 const uint16_t tac) {
+  return (snapshot->tac_bitmap[tac / 64] >> (tac % 64)) & 1;
+}
+
 //------------------------------------------------------------------------------
 int mme_config_find_mnc_length(const char mcc_digit1P, const char mcc_digit2P,
                                const char mcc_digit3P, const char mnc_digit1P,
@@ -59,7 +166,8 @@ int mme_config_find_mnc_length(const char mcc_digit1P, const char mcc_digit2P,
   uint16_t mcc = 100 * mcc_digit1P + 10 * mcc_digit2P + mcc_digit3P;
   uint16_t mnc3 = 100 * mnc_digit1P + 10 * mnc_digit2P + mnc_digit3P;
   uint16_t mnc2 = 10 * mnc_digit1P + mnc_digit2P;
-  int plmn_index = 0;
+  mme_config_snapshot_t *snapshot = NULL;
+  int mnc_length = 0;
 
   AssertFatal(
       (mcc_digit1P >= 0) && (mcc_digit1P <= 9) && (mcc_digit2P >= 0) &&
@@ -70,95 +178,46 @@ int mme_config_find_mnc_length(const char mcc_digit1P, const char mcc_digit2P,
               "BAD MNC PARAMETER (%d.%d.%d)!\n", mnc_digit1P, mnc_digit2P,
               mnc_digit3P);
 
-  while (plmn_index < mme_config.served_tai.nb_tai) {
-    if (mme_config.served_tai.plmn_mcc[plmn_index] == mcc) {
-      if ((mme_config.served_tai.plmn_mnc[plmn_index] == mnc2) &&
-          (mme_config.served_tai.plmn_mnc_len[plmn_index] == 2)) {
-        return 2;
-      } else if ((mme_config.served_tai.plmn_mnc[plmn_index] == mnc3) &&
-                 (mme_config.served_tai.plmn_mnc_len[plmn_index] == 3)) {
-        return 3;
-      }
-    }
-    plmn_index += 1;
+  snapshot = mme_config_snapshot_get();
+  if (mme_config_snapshot_has_plmn(snapshot, mcc, mnc2, 2)) {
+    mnc_length = 2;
+  } else if (mme_config_snapshot_has_plmn(snapshot, mcc, mnc3, 3)) {
+    mnc_length = 3;
   }
-
-  return 0;
+  mme_config_snapshot_put(snapshot);
+  return mnc_length;
 }
 
 //------------------------------------------------------------------------------
-static int mme_app_compare_plmn(const plmn_t *const plmn) {
-  int i = 0;
+bool mme_app_check_ta_local(const plmn_t *target_plmn, const tac_t target_tac) {
+  mme_config_snapshot_t *snapshot = NULL;
   uint16_t mcc = 0;
   uint16_t mnc = 0;
   uint16_t mnc_len = 0;
-
-  DevAssert(plmn != NULL);
-  /** Get the integer values from the PLMN. */
-  PLMN_T_TO_MCC_MNC((*plmn), mcc, mnc, mnc_len);
-
-  mme_config_read_lock(&mme_config);
-
-  for (i = 0; i < mme_config.served_tai.nb_tai; i++) {
-    OAILOG_TRACE(
-        LOG_MME_APP,
-        "Comparing plmn_mcc %d/%d, plmn_mnc %d/%d plmn_mnc_len %d/%d\n",
-        mme_config.served_tai.plmn_mcc[i], mcc,
-        mme_config.served_tai.plmn_mnc[i], mnc,
-        mme_config.served_tai.plmn_mnc_len[i], mnc_len);
-
-    if ((mme_config.served_tai.plmn_mcc[i] == mcc) &&
-        (mme_config.served_tai.plmn_mnc[i] == mnc) &&
-        (mme_config.served_tai.plmn_mnc_len[i] == mnc_len))
-      /*
-       * There is a matching plmn
-       */
-      return TA_LIST_AT_LEAST_ONE_MATCH;
-  }
-
-  mme_config_unlock(&mme_config);
-  return TA_LIST_NO_MATCH;
-}
-
-//------------------------------------------------------------------------------
-/* @brief compare a TAC
- */
-static int mme_app_compare_tac(uint16_t tac_value) {
-  int i = 0;
-
-  mme_config_read_lock(&mme_config);
-
-  for (i = 0; i < mme_config.served_tai.nb_tai; i++) {
-    OAILOG_TRACE(LOG_MME_APP, "Comparing config tac %d, received tac = %d\n",
-                 mme_config.served_tai.tac[i], tac_value);
-
-    if (mme_config.served_tai.tac[i] == tac_value)
-      return TA_LIST_AT_LEAST_ONE_MATCH;
-  }
-
-  mme_config_unlock(&mme_config);
-  return TA_LIST_NO_MATCH;
-}
-
-//------------------------------------------------------------------------------
-bool mme_app_check_ta_local(const plmn_t *target_plmn, const tac_t target_tac) {
-  if (TA_LIST_AT_LEAST_ONE_MATCH == mme_app_compare_plmn(target_plmn)) {
-    if (TA_LIST_AT_LEAST_ONE_MATCH == mme_app_compare_tac(target_tac)) {
-      OAILOG_DEBUG(LOG_MME_APP, "TAC and PLMN are matching. \n");
-      return true;
-    }
+  bool is_local = false;
+
+  DevAssert(target_plmn != NULL);
+  PLMN_T_TO_MCC_MNC((*target_plmn), mcc, mnc, mnc_len);
+  snapshot = mme_config_snapshot_get();
+  is_local = mme_config_snapshot_has_plmn(snapshot, mcc, mnc, mnc_len) &&
+             mme_config_snapshot_has_tac(snapshot, target_tac);
+  mme_config_snapshot_put(snapshot);
+  if (is_local) {
+    OAILOG_DEBUG(LOG_MME_APP, "TAC and PLMN are matching. \n");
+  } else {
+    OAILOG_DEBUG(LOG_MME_APP, "TAC or PLMN are not matching. \n");
   }
-  OAILOG_DEBUG(LOG_MME_APP, "TAC or PLMN are not matching. \n");
-  return false;
+  return is_local;
 }
 
 //------------------------------------------------------------------------------
 static void mme_config_init(mme_config_t *config_pP) {
-  memset(&mme_config, 0, sizeof(mme_config));
+  memset(config_pP, 0, sizeof(*config_pP));
   pthread_rwlock_init(&config_pP->rw_lock, NULL);
   config_pP->log_config.output = NULL;
   config_pP->log_config.is_output_thread_safe = false;
   config_pP->log_config.color = false;
+  config_pP->log_config.deferred_mode = LOG_DEFERRED_NONE;
   config_pP->log_config.udp_log_level = MAX_LOG_LEVEL;  // Means invalid
   config_pP->log_config.gtpv1u_log_level =
       MAX_LOG_LEVEL;  // will not overwrite existing log levels if MME and S-GW
@@ -187,6 +246,7 @@ static void mme_config_init(mme_config_t *config_pP) {
   config_pP->max_ues = 2;
   config_pP->unauthenticated_imsi_supported = 0;
   config_pP->dummy_handover_forwarding_enabled = 1;
+  config_pP->gtpv2c_timerfd_enabled = 1;
   config_pP->run_mode = RUN_MODE_BASIC;
 
   /*
@@ -217,10 +277,13 @@ static void mme_config_init(mme_config_t *config_pP) {
   config_pP->ip.port_s10 = 2123;
 
   config_pP->s6a_config.conf_file = bfromcstr(S6A_CONF_FILE);
+  config_pP->s6a_config.hss_emulation_file = NULL;
+  config_pP->s6a_config.hss_emulation_vectors = 0;
   config_pP->itti_config.queue_size = ITTI_QUEUE_MAX_ELEMENTS;
   config_pP->itti_config.log_file = NULL;
   config_pP->sctp_config.in_streams = SCTP_IN_STREAMS;
   config_pP->sctp_config.out_streams = SCTP_OUT_STREAMS;
+  config_pP->sctp_config.receiver_threads = SCTP_RECEIVER_THREADS;
   config_pP->relative_capacity = RELATIVE_CAPACITY;
   config_pP->mme_statistic_timer = MME_STATISTIC_TIMER_S;
 
@@ -281,35 +344,155 @@ static void mme_config_init(mme_config_t *config_pP) {
 }
 
 //------------------------------------------------------------------------------
-void mme_config_exit(void) {
-  pthread_rwlock_destroy(&mme_config.rw_lock);
-  bdestroy_wrapper(&mme_config.log_config.output);
-  bdestroy_wrapper(&mme_config.realm);
-  bdestroy_wrapper(&mme_config.config_file);
+static void mme_config_free(mme_config_t *config_pP) {
+  pthread_rwlock_destroy(&config_pP->rw_lock);
+  bdestroy_wrapper(&config_pP->log_config.output);
+  bdestroy_wrapper(&config_pP->realm);
+  bdestroy_wrapper(&config_pP->config_file);
 
   /*
    * IP configuration
    */
-  bdestroy_wrapper(&mme_config.ip.if_name_s1_mme);
-  bdestroy_wrapper(&mme_config.ip.if_name_s11);
-  bdestroy_wrapper(&mme_config.ip.if_name_s10);
-  bdestroy_wrapper(&mme_config.s6a_config.conf_file);
-  bdestroy_wrapper(&mme_config.s6a_config.hss_host_name);
-  bdestroy_wrapper(&mme_config.itti_config.log_file);
-
-  free_wrapper((void **)&mme_config.served_tai.plmn_mcc);
-  free_wrapper((void **)&mme_config.served_tai.plmn_mnc);
-  free_wrapper((void **)&mme_config.served_tai.plmn_mnc_len);
-  free_wrapper((void **)&mme_config.served_tai.tac);
-
-  for (int i = 0; i < mme_config.e_dns_emulation.nb_service_entries; i++) {
-    bdestroy_wrapper(&mme_config.e_dns_emulation.service_id[i]);
+  bdestroy_wrapper(&config_pP->ip.if_name_s1_mme);
+  bdestroy_wrapper(&config_pP->ip.if_name_s11);
+  bdestroy_wrapper(&config_pP->ip.if_name_s10);
+  bdestroy_wrapper(&config_pP->s6a_config.conf_file);
+  bdestroy_wrapper(&config_pP->s6a_config.hss_host_name);
+  bdestroy_wrapper(&config_pP->s6a_config.hss_emulation_file);
+  bdestroy_wrapper(&config_pP->itti_config.log_file);
+
+  free_wrapper((void **)&config_pP->served_tai.plmn_mcc);
+  free_wrapper((void **)&config_pP->served_tai.plmn_mnc);
+  free_wrapper((void **)&config_pP->served_tai.plmn_mnc_len);
+  free_wrapper((void **)&config_pP->served_tai.tac);
+
+  for (int i = 0; i < config_pP->e_dns_emulation.nb_service_entries; i++) {
+    bdestroy_wrapper(&config_pP->e_dns_emulation.service_id[i]);
   }
 
 #if TRACE_XML
-  bdestroy_wrapper(&mme_config.scenario_player_config.scenario_file);
+  bdestroy_wrapper(&config_pP->scenario_player_config.scenario_file);
 #endif
 }
+
+//------------------------------------------------------------------------------
+void mme_config_exit(void) {
+  mme_config_snapshot_t *snapshot =
+      __atomic_exchange_n(&g_snapshot, NULL, __ATOMIC_SEQ_CST);
+
+  if (snapshot) {
+    mme_config_snapshot_put(snapshot);
+  }
+  mme_config_free(&mme_config);
+}
+
+//------------------------------------------------------------------------------
+/*
+ * Sort the served TAIs in ascending order, remove the duplicates and set the
+ * list type
+ */
+static void mme_config_sort_served_tai(mme_config_t *config_pP) {
+  int i = 0, n = 0, stop_index = 0;
+  bool swap = false;
+
+  n = config_pP->served_tai.nb_tai;
+  do {
+    stop_index = 0;
+    for (i = 1; i < n; i++) {
+      swap = false;
+      if (config_pP->served_tai.plmn_mcc[i - 1] >
+          config_pP->served_tai.plmn_mcc[i]) {
+        swap = true;
+      } else if (config_pP->served_tai.plmn_mcc[i - 1] ==
+                 config_pP->served_tai.plmn_mcc[i]) {
+        if (config_pP->served_tai.plmn_mnc[i - 1] >
+            config_pP->served_tai.plmn_mnc[i]) {
+          swap = true;
+        } else if (config_pP->served_tai.plmn_mnc[i - 1] ==
+                   config_pP->served_tai.plmn_mnc[i]) {
+          if (config_pP->served_tai.tac[i - 1] > config_pP->served_tai.tac[i]) {
+            swap = true;
+          }
+        }
+      }
+      if (true == swap) {
+        uint16_t swap16;
+        swap16 = config_pP->served_tai.plmn_mcc[i - 1];
+        config_pP->served_tai.plmn_mcc[i - 1] =
+            config_pP->served_tai.plmn_mcc[i];
+        config_pP->served_tai.plmn_mcc[i] = swap16;
+
+        swap16 = config_pP->served_tai.plmn_mnc[i - 1];
+        config_pP->served_tai.plmn_mnc[i - 1] =
+            config_pP->served_tai.plmn_mnc[i];
+        config_pP->served_tai.plmn_mnc[i] = swap16;
+
+        swap16 = config_pP->served_tai.plmn_mnc_len[i - 1];
+        config_pP->served_tai.plmn_mnc_len[i - 1] =
+            config_pP->served_tai.plmn_mnc_len[i];
+        config_pP->served_tai.plmn_mnc_len[i] = swap16;
+
+        swap16 = config_pP->served_tai.tac[i - 1];
+        config_pP->served_tai.tac[i - 1] = config_pP->served_tai.tac[i];
+        config_pP->served_tai.tac[i] = swap16;
+
+        stop_index = i;
+      }
+    }
+    n = stop_index;
+  } while (0 != n);
+
+  for (i = 1; i < config_pP->served_tai.nb_tai; i++) {
+    if ((config_pP->served_tai.plmn_mcc[i - 1] ==
+         config_pP->served_tai.plmn_mcc[i]) &&
+        (config_pP->served_tai.plmn_mnc[i - 1] ==
+         config_pP->served_tai.plmn_mnc[i]) &&
+        (config_pP->served_tai.tac[i - 1] == config_pP->served_tai.tac[i])) {
+      for (int j = i + 1; j < config_pP->served_tai.nb_tai; j++) {
+        config_pP->served_tai.plmn_mcc[j - 1] =
+            config_pP->served_tai.plmn_mcc[j];
+        config_pP->served_tai.plmn_mnc[j - 1] =
+            config_pP->served_tai.plmn_mnc[j];
+        config_pP->served_tai.plmn_mnc_len[j - 1] =
+            config_pP->served_tai.plmn_mnc_len[j];
+        config_pP->served_tai.tac[j - 1] = config_pP->served_tai.tac[j];
+      }
+      config_pP->served_tai.plmn_mcc[config_pP->served_tai.nb_tai - 1] = 0;
+      config_pP->served_tai.plmn_mnc[config_pP->served_tai.nb_tai - 1] = 0;
+      config_pP->served_tai.plmn_mnc_len[config_pP->served_tai.nb_tai - 1] = 0;
+      config_pP->served_tai.tac[config_pP->served_tai.nb_tai - 1] = 0;
+      config_pP->served_tai.nb_tai--;
+      i--;  // tricky
+    }
+  }
+  // helper for determination of list type (global view), we could make
+  // sublists with different types, but keep things simple for now
+  config_pP->served_tai.list_type =
+      TRACKING_AREA_IDENTITY_LIST_TYPE_ONE_PLMN_CONSECUTIVE_TACS;
+  for (i = 1; i < config_pP->served_tai.nb_tai; i++) {
+    if ((config_pP->served_tai.plmn_mcc[i] !=
+         config_pP->served_tai.plmn_mcc[0]) ||
+        (config_pP->served_tai.plmn_mnc[i] !=
+         config_pP->served_tai.plmn_mnc[0])) {
+      config_pP->served_tai.list_type =
+          TRACKING_AREA_IDENTITY_LIST_TYPE_MANY_PLMNS;
+      break;
+    } else if ((config_pP->served_tai.plmn_mcc[i] !=
+                config_pP->served_tai.plmn_mcc[i - 1]) ||
+               (config_pP->served_tai.plmn_mnc[i] !=
+                config_pP->served_tai.plmn_mnc[i - 1])) {
+      config_pP->served_tai.list_type =
+          TRACKING_AREA_IDENTITY_LIST_TYPE_MANY_PLMNS;
+      break;
+    }
+    if (config_pP->served_tai.tac[i] !=
+        (config_pP->served_tai.tac[i - 1] + 1)) {
+      config_pP->served_tai.list_type =
+          TRACKING_AREA_IDENTITY_LIST_TYPE_ONE_PLMN_NON_CONSECUTIVE_TACS;
+    }
+  }
+}
+
 //------------------------------------------------------------------------------
 static int mme_config_parse_file(mme_config_t *config_pP) {
   config_t cfg = {0};
@@ -323,7 +506,7 @@ static int mme_config_parse_file(mme_config_t *config_pP) {
   int aint_s11 = 0;
   int aint_mc = 0;
 
-  int i = 0, n = 0, stop_index = 0, num = 0;
+  int i = 0, num = 0;
   const char *astring = NULL;
   const char *tac = NULL;
   const char *mcc = NULL;
@@ -346,7 +529,6 @@ static int mme_config_parse_file(mme_config_t *config_pP) {
   char *mc_mme_v4 = NULL;
   char *mc_mme_v6 = NULL;
 
-  bool swap = false;
   bstring address = NULL;
   bstring cidr = NULL;
   bstring mask = NULL;
@@ -409,6 +591,16 @@ static int mme_config_parse_file(mme_config_t *config_pP) {
           config_pP->log_config.color = false;
       }
 
+      if (config_setting_lookup_string(setting, LOG_CONFIG_STRING_DEFERRED,
+                                       (const char **)&astring)) {
+        if (0 == strcasecmp(LOG_CONFIG_STRING_DEFERRED_TEXT, astring))
+          config_pP->log_config.deferred_mode = LOG_DEFERRED_TEXT;
+        else if (0 == strcasecmp(LOG_CONFIG_STRING_DEFERRED_BINARY, astring))
+          config_pP->log_config.deferred_mode = LOG_DEFERRED_BINARY;
+        else
+          config_pP->log_config.deferred_mode = LOG_DEFERRED_NONE;
+      }
+
       if (config_setting_lookup_string(setting,
                                        LOG_CONFIG_STRING_SCTP_LOG_LEVEL,
                                        (const char **)&astring))
@@ -613,6 +805,15 @@ static int mme_config_parse_file(mme_config_t *config_pP) {
         config_pP->dummy_handover_forwarding_enabled = 0;
     }
 
+    if ((config_setting_lookup_string(
+            setting_mme, MME_CONFIG_STRING_GTPV2C_TIMERFD_ENABLED,
+            (const char **)&astring))) {
+      if (strcasecmp(astring, "yes") == 0)
+        config_pP->gtpv2c_timerfd_enabled = 1;
+      else
+        config_pP->gtpv2c_timerfd_enabled = 0;
+    }
+
     // ITTI SETTING
     setting = config_setting_get_member(
         setting_mme, MME_CONFIG_STRING_INTERTASK_INTERFACE_CONFIG);
@@ -671,6 +872,23 @@ static int mme_config_parse_file(mme_config_t *config_pP) {
                       "You have to provide a valid MME hostname %s=...\n",
                       MME_CONFIG_STRING_S6A_MME_HOSTNAME);
       }
+
+      if ((config_setting_lookup_string(
+              setting, MME_CONFIG_STRING_S6A_HSS_EMULATION_SUBSCRIBERS,
+              (const char **)&astring))) {
+        if ((astring != NULL) && (astring[0])) {
+          if (config_pP->s6a_config.hss_emulation_file) {
+            bassigncstr(config_pP->s6a_config.hss_emulation_file, astring);
+          } else {
+            config_pP->s6a_config.hss_emulation_file = bfromcstr(astring);
+          }
+        }
+      }
+
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_S6A_HSS_EMULATION_VECTORS, &aint))) {
+        config_pP->s6a_config.hss_emulation_vectors = (uint32_t)aint;
+      }
     }
     // SCTP SETTING
     setting =
@@ -686,6 +904,13 @@ static int mme_config_parse_file(mme_config_t *config_pP) {
                                      &aint))) {
         config_pP->sctp_config.out_streams = (uint16_t)aint;
       }
+
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_SCTP_RECEIVER_THREADS, &aint))) {
+        AssertFatal((aint > 0) && (aint <= UINT8_MAX),
+                    "Bad SCTP receiver threads %d\n", aint);
+        config_pP->sctp_config.receiver_threads = (uint8_t)aint;
+      }
     }
     // S1AP SETTING
     setting =
@@ -732,7 +957,8 @@ static int mme_config_parse_file(mme_config_t *config_pP) {
       }
 
       config_pP->served_tai.nb_tai = num;
-      AssertFatal(64 >= num, "Too many TAIs configured %d", num);
+      AssertFatal(MME_CONFIG_MAX_SERVED_TAI >= num,
+                  "Too many TAIs configured %d", num);
 
       for (i = 0; i < num; i++) {
         sub2setting = config_setting_get_elem(setting, i);
@@ -762,97 +988,7 @@ static int mme_config_parse_file(mme_config_t *config_pP) {
           }
         }
       }
-      // sort TAI list
-      n = config_pP->served_tai.nb_tai;
-      do {
-        stop_index = 0;
-        for (i = 1; i < n; i++) {
-          swap = false;
-          if (config_pP->served_tai.plmn_mcc[i - 1] >
-              config_pP->served_tai.plmn_mcc[i]) {
-            swap = true;
-          } else if (config_pP->served_tai.plmn_mcc[i - 1] ==
-                     config_pP->served_tai.plmn_mcc[i]) {
-            if (config_pP->served_tai.plmn_mnc[i - 1] >
-                config_pP->served_tai.plmn_mnc[i]) {
-              swap = true;
-            } else if (config_pP->served_tai.plmn_mnc[i - 1] ==
-                       config_pP->served_tai.plmn_mnc[i]) {
-              if (config_pP->served_tai.tac[i - 1] >
-                  config_pP->served_tai.tac[i]) {
-                swap = true;
-              }
-            }
-          }
-          if (true == swap) {
-            uint16_t swap16;
-            swap16 = config_pP->served_tai.plmn_mcc[i - 1];
-            config_pP->served_tai.plmn_mcc[i - 1] =
-                config_pP->served_tai.plmn_mcc[i];
-            config_pP->served_tai.plmn_mcc[i] = swap16;
-
-            swap16 = config_pP->served_tai.plmn_mnc[i - 1];
-            config_pP->served_tai.plmn_mnc[i - 1] =
-                config_pP->served_tai.plmn_mnc[i];
-            config_pP->served_tai.plmn_mnc[i] = swap16;
-
-            swap16 = config_pP->served_tai.tac[i - 1];
-            config_pP->served_tai.tac[i - 1] = config_pP->served_tai.tac[i];
-            config_pP->served_tai.tac[i] = swap16;
-
-            stop_index = i;
-          }
-        }
-        n = stop_index;
-      } while (0 != n);
-
-      for (i = 1; i < config_pP->served_tai.nb_tai; i++) {
-        if ((config_pP->served_tai.plmn_mcc[i - 1] ==
-             config_pP->served_tai.plmn_mcc[i]) &&
-            (config_pP->served_tai.plmn_mnc[i - 1] ==
-             config_pP->served_tai.plmn_mnc[i]) &&
-            (config_pP->served_tai.tac[i - 1] ==
-             config_pP->served_tai.tac[i])) {
-          for (int j = i + 1; j < config_pP->served_tai.nb_tai; j++) {
-            config_pP->served_tai.plmn_mcc[j - 1] =
-                config_pP->served_tai.plmn_mcc[j];
-            config_pP->served_tai.plmn_mnc[j - 1] =
-                config_pP->served_tai.plmn_mnc[j];
-            config_pP->served_tai.tac[j - 1] = config_pP->served_tai.tac[j];
-          }
-          config_pP->served_tai.plmn_mcc[config_pP->served_tai.nb_tai - 1] = 0;
-          config_pP->served_tai.plmn_mnc[config_pP->served_tai.nb_tai - 1] = 0;
-          config_pP->served_tai.tac[config_pP->served_tai.nb_tai - 1] = 0;
-          config_pP->served_tai.nb_tai--;
-          i--;  // tricky
-        }
-      }
-      // helper for determination of list type (global view), we could make
-      // sublists with different types, but keep things simple for now
-      config_pP->served_tai.list_type =
-          TRACKING_AREA_IDENTITY_LIST_TYPE_ONE_PLMN_CONSECUTIVE_TACS;
-      for (i = 1; i < config_pP->served_tai.nb_tai; i++) {
-        if ((config_pP->served_tai.plmn_mcc[i] !=
-             config_pP->served_tai.plmn_mcc[0]) ||
-            (config_pP->served_tai.plmn_mnc[i] !=
-             config_pP->served_tai.plmn_mnc[0])) {
-          config_pP->served_tai.list_type =
-              TRACKING_AREA_IDENTITY_LIST_TYPE_MANY_PLMNS;
-          break;
-        } else if ((config_pP->served_tai.plmn_mcc[i] !=
-                    config_pP->served_tai.plmn_mcc[i - 1]) ||
-                   (config_pP->served_tai.plmn_mnc[i] !=
-                    config_pP->served_tai.plmn_mnc[i - 1])) {
-          config_pP->served_tai.list_type =
-              TRACKING_AREA_IDENTITY_LIST_TYPE_MANY_PLMNS;
-          break;
-        }
-        if (config_pP->served_tai.tac[i] !=
-            (config_pP->served_tai.tac[i - 1] + 1)) {
-          config_pP->served_tai.list_type =
-              TRACKING_AREA_IDENTITY_LIST_TYPE_ONE_PLMN_NON_CONSECUTIVE_TACS;
-        }
-      }
+      mme_config_sort_served_tai(config_pP);
     }
 
     // GUMMEI SETTING
@@ -1260,6 +1396,17 @@ static int mme_config_parse_file(mme_config_t *config_pP) {
           break;
         }
         config_pP->e_dns_emulation.service_id[e] = bfromcstr(id);
+        /** Optional, as the weight and priority of a DNS SRV record. */
+        config_pP->e_dns_emulation.weight[e] = 1;
+        if (config_setting_lookup_int(sub2setting, MME_CONFIG_STRING_WEIGHT,
+                                      &aint)) {
+          config_pP->e_dns_emulation.weight[e] = (uint16_t)aint;
+        }
+        config_pP->e_dns_emulation.priority[e] = 0;
+        if (config_setting_lookup_int(sub2setting, MME_CONFIG_STRING_PRIORITY,
+                                      &aint)) {
+          config_pP->e_dns_emulation.priority[e] = (uint16_t)aint;
+        }
 
         /** Check S11 Endpoint (service="x-3gpp-sgw:x-s11"). */
         if ((config_setting_lookup_string(
@@ -1460,6 +1607,9 @@ static void mme_config_display(mme_config_t *config_pP) {
   OAILOG_INFO(
       LOG_CONFIG, "- Unauth IMSI support ..................: %s\n",
       config_pP->unauthenticated_imsi_supported == 0 ? "false" : "true");
+  OAILOG_INFO(
+      LOG_CONFIG, "- GTPv2-C timers on a timerfd ..........: %s\n",
+      config_pP->gtpv2c_timerfd_enabled == 0 ? "false" : "true");
   OAILOG_INFO(LOG_CONFIG, "- Relative capa ........................: %u\n",
               config_pP->relative_capacity);
   OAILOG_INFO(LOG_CONFIG,
@@ -1492,6 +1642,9 @@ static void mme_config_display(mme_config_t *config_pP) {
                 bdata(config_pP->e_dns_emulation.service_id[j]));
     OAILOG_INFO(LOG_CONFIG, "            Interface Type %d\n",
                 config_pP->e_dns_emulation.interface_type[j]);
+    OAILOG_INFO(LOG_CONFIG, "            Weight %u Priority %u\n",
+                config_pP->e_dns_emulation.weight[j],
+                config_pP->e_dns_emulation.priority[j]);
     // Could use     struct sockaddr_in *;
     if (config_pP->e_dns_emulation.sockaddr[j].v4.sin_family == AF_INET) {
       OAILOG_INFO(
@@ -1521,6 +1674,8 @@ static void mme_config_display(mme_config_t *config_pP) {
               config_pP->sctp_config.in_streams);
   OAILOG_INFO(LOG_CONFIG, "    out streams ......: %u\n",
               config_pP->sctp_config.out_streams);
+  OAILOG_INFO(LOG_CONFIG, "    receiver threads .: %u\n",
+              config_pP->sctp_config.receiver_threads);
   OAILOG_INFO(LOG_CONFIG, "- GUMMEIs (PLMN|MMEGI|MMEC):\n");
   for (j = 0; j < config_pP->gummei.nb; j++) {
     OAILOG_INFO(LOG_CONFIG, "            " PLMN_FMT "|%u|%u \n",
@@ -1609,6 +1764,12 @@ static void mme_config_display(mme_config_t *config_pP) {
   OAILOG_INFO(LOG_CONFIG, "- S6A:\n");
   OAILOG_INFO(LOG_CONFIG, "    conf file ........: %s\n",
               bdata(config_pP->s6a_config.conf_file));
+  if (config_pP->s6a_config.hss_emulation_file) {
+    OAILOG_INFO(LOG_CONFIG, "    HSS emulation ....: %s\n",
+                bdata(config_pP->s6a_config.hss_emulation_file));
+    OAILOG_INFO(LOG_CONFIG, "    Vectors in advance: %u\n",
+                config_pP->s6a_config.hss_emulation_vectors);
+  }
   OAILOG_INFO(LOG_CONFIG, "- Logging:\n");
   OAILOG_INFO(LOG_CONFIG, "    Output ..............: %s\n",
               bdata(config_pP->log_config.output));
@@ -1616,6 +1777,12 @@ static void mme_config_display(mme_config_t *config_pP) {
               (config_pP->log_config.is_output_thread_safe) ? "true" : "false");
   OAILOG_INFO(LOG_CONFIG, "    Output with color ...: %s\n",
               (config_pP->log_config.color) ? "true" : "false");
+  OAILOG_INFO(LOG_CONFIG, "    Deferred formatting .: %s\n",
+              (LOG_DEFERRED_BINARY == config_pP->log_config.deferred_mode)
+                  ? LOG_CONFIG_STRING_DEFERRED_BINARY
+                  : (LOG_DEFERRED_TEXT == config_pP->log_config.deferred_mode)
+                        ? LOG_CONFIG_STRING_DEFERRED_TEXT
+                        : LOG_CONFIG_STRING_DEFERRED_NO);
   OAILOG_INFO(LOG_CONFIG, "    UDP log level........: %s\n",
               OAILOG_LEVEL_INT2STR(config_pP->log_config.udp_log_level));
   OAILOG_INFO(LOG_CONFIG, "    GTPV2-C log level....: %s\n",
@@ -1772,5 +1939,145 @@ int mme_config_parse_opt_line(int argc, char *argv[], mme_config_t *config_pP) {
    * Display the configuration
    */
   mme_config_display(config_pP);
+  mme_config_snapshot_publish(config_pP);
   return 0;
 }
+
+//------------------------------------------------------------------------------
+/*
+ * Served TAIs and HSS host name of the configuration file, the only parameters
+ * taken on reload. Errors are reported, not asserted: a bad file must leave
+ * the running MME as it is.
+ */
+static int mme_config_parse_reloadable(mme_config_t *config_pP) {
+  config_t cfg = {0};
+  config_setting_t *setting_mme = NULL;
+  config_setting_t *setting = NULL;
+  config_setting_t *sub2setting = NULL;
+  const char *astring = NULL;
+  const char *tac = NULL;
+  const char *mcc = NULL;
+  const char *mnc = NULL;
+  int num = 0;
+  int rc = RETURNerror;
+
+  config_init(&cfg);
+  if (!config_read_file(&cfg, bdata(config_pP->config_file))) {
+    OAILOG_ERROR(LOG_CONFIG, ": %s:%d - %s\n", bdata(config_pP->config_file),
+                 config_error_line(&cfg), config_error_text(&cfg));
+    config_destroy(&cfg);
+    return RETURNerror;
+  }
+
+  setting_mme = config_lookup(&cfg, MME_CONFIG_STRING_MME_CONFIG);
+  if (setting_mme == NULL) {
+    OAILOG_ERROR(LOG_CONFIG, "No %s section\n", MME_CONFIG_STRING_MME_CONFIG);
+    goto done;
+  }
+
+  // S6A SETTING
+  setting =
+      config_setting_get_member(setting_mme, MME_CONFIG_STRING_S6A_CONFIG);
+  if ((setting != NULL) &&
+      (config_setting_lookup_string(setting, MME_CONFIG_STRING_S6A_HSS_HOSTNAME,
+                                    (const char **)&astring)) &&
+      (astring != NULL)) {
+    bdestroy_wrapper(&config_pP->s6a_config.hss_host_name);
+    config_pP->s6a_config.hss_host_name = bfromcstr(astring);
+  }
+
+  // TAI list setting
+  setting = config_setting_get_member(setting_mme, MME_CONFIG_STRING_TAI_LIST);
+  num = (setting != NULL) ? config_setting_length(setting) : 0;
+  if ((num < 1) || (num > MME_CONFIG_MAX_SERVED_TAI)) {
+    OAILOG_ERROR(LOG_CONFIG, "Bad number of TAIs %d (1..%d)\n", num,
+                 MME_CONFIG_MAX_SERVED_TAI);
+    goto done;
+  }
+  free_wrapper((void **)&config_pP->served_tai.plmn_mcc);
+  free_wrapper((void **)&config_pP->served_tai.plmn_mnc);
+  free_wrapper((void **)&config_pP->served_tai.plmn_mnc_len);
+  free_wrapper((void **)&config_pP->served_tai.tac);
+  config_pP->served_tai.plmn_mcc =
+      calloc(num, sizeof(*config_pP->served_tai.plmn_mcc));
+  config_pP->served_tai.plmn_mnc =
+      calloc(num, sizeof(*config_pP->served_tai.plmn_mnc));
+  config_pP->served_tai.plmn_mnc_len =
+      calloc(num, sizeof(*config_pP->served_tai.plmn_mnc_len));
+  config_pP->served_tai.tac = calloc(num, sizeof(*config_pP->served_tai.tac));
+  config_pP->served_tai.nb_tai = num;
+
+  for (int i = 0; i < num; i++) {
+    sub2setting = config_setting_get_elem(setting, i);
+
+    if ((sub2setting == NULL) ||
+        (!config_setting_lookup_string(sub2setting, MME_CONFIG_STRING_MCC,
+                                       &mcc)) ||
+        (!config_setting_lookup_string(sub2setting, MME_CONFIG_STRING_MNC,
+                                       &mnc)) ||
+        (!config_setting_lookup_string(sub2setting, MME_CONFIG_STRING_TAC,
+                                       &tac))) {
+      OAILOG_ERROR(LOG_CONFIG, "Incomplete TAI %d\n", i);
+      goto done;
+    }
+    config_pP->served_tai.plmn_mcc[i] = (uint16_t)atoi(mcc);
+    config_pP->served_tai.plmn_mnc[i] = (uint16_t)atoi(mnc);
+    config_pP->served_tai.plmn_mnc_len[i] = strlen(mnc);
+    config_pP->served_tai.tac[i] = (uint16_t)atoi(tac);
+    if ((config_pP->served_tai.plmn_mnc_len[i] != 2) &&
+        (config_pP->served_tai.plmn_mnc_len[i] != 3)) {
+      OAILOG_ERROR(LOG_CONFIG, "Bad MNC length %u, must be 2 or 3\n",
+                   config_pP->served_tai.plmn_mnc_len[i]);
+      goto done;
+    }
+    if (!TAC_IS_VALID(config_pP->served_tai.tac[i])) {
+      OAILOG_ERROR(LOG_CONFIG, "Invalid TAC value " TAC_FMT "\n",
+                   config_pP->served_tai.tac[i]);
+      goto done;
+    }
+  }
+  mme_config_sort_served_tai(config_pP);
+  rc = RETURNok;
+
+done:
+  config_destroy(&cfg);
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+int mme_config_reload(void) {
+  mme_config_t *config = calloc(1, sizeof(*config));
+  int rc = RETURNerror;
+
+  /*
+   * Only the served TAIs and the HSS host name are replaced, with the
+   * snapshot. Other parameters need a restart.
+   */
+  mme_config_init(config);
+  config->config_file = bstrcpy(mme_config.config_file);
+  if (mme_config_parse_reloadable(config) == RETURNok) {
+    uint8_t served_tai[sizeof(mme_config.served_tai)];
+
+    mme_config_write_lock(&mme_config);
+    // Swap: the previous values are freed with config
+    memcpy(served_tai, &mme_config.served_tai, sizeof(served_tai));
+    memcpy(&mme_config.served_tai, &config->served_tai, sizeof(served_tai));
+    memcpy(&config->served_tai, served_tai, sizeof(served_tai));
+    if (config->s6a_config.hss_host_name) {
+      bstring hss_host_name = mme_config.s6a_config.hss_host_name;
+      mme_config.s6a_config.hss_host_name = config->s6a_config.hss_host_name;
+      config->s6a_config.hss_host_name = hss_host_name;
+    }
+    mme_config_snapshot_publish(&mme_config);
+    mme_config_unlock(&mme_config);
+    OAILOG_INFO(LOG_CONFIG, "Reloaded served TAIs and S6A peer from %s\n",
+                bdata(config->config_file));
+    rc = RETURNok;
+  } else {
+    OAILOG_ERROR(LOG_CONFIG, "Could not reload %s, configuration unchanged\n",
+                 bdata(mme_config.config_file));
+  }
+  mme_config_free(config);
+  free_wrapper((void **)&config);
+  return rc;
+}
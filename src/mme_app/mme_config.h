@@ -59,6 +59,7 @@
   "UNAUTHENTICATED_IMSI_SUPPORTED"
 #define MME_CONFIG_STRING_DUMMY_HANDOVER_FORWARDING_ENABLED \
   "DUMMY_HANDOVER_FORWARDING_ENABLED"
+#define MME_CONFIG_STRING_GTPV2C_TIMERFD_ENABLED "GTPV2C_TIMERFD_ENABLED"
 
 #define EPS_NETWORK_FEATURE_SUPPORT_IMS_VOICE_OVER_PS_SESSION_IN_S1 \
   "EPS_NETWORK_FEATURE_SUPPORT_IMS_VOICE_OVER_PS_SESSION_IN_S1"
@@ -76,10 +77,15 @@
 #define MME_CONFIG_STRING_S6A_CONF_FILE_PATH "S6A_CONF"
 #define MME_CONFIG_STRING_S6A_HSS_HOSTNAME "HSS_HOSTNAME"
 #define MME_CONFIG_STRING_S6A_MME_HOSTNAME "MME_HOSTNAME"
+#define MME_CONFIG_STRING_S6A_HSS_EMULATION_SUBSCRIBERS \
+  "HSS_EMULATION_SUBSCRIBERS"
+#define MME_CONFIG_STRING_S6A_HSS_EMULATION_VECTORS \
+  "HSS_EMULATION_PREGENERATED_VECTORS"
 
 #define MME_CONFIG_STRING_SCTP_CONFIG "SCTP"
 #define MME_CONFIG_STRING_SCTP_INSTREAMS "SCTP_INSTREAMS"
 #define MME_CONFIG_STRING_SCTP_OUTSTREAMS "SCTP_OUTSTREAMS"
+#define MME_CONFIG_STRING_SCTP_RECEIVER_THREADS "SCTP_RECEIVER_THREADS"
 
 #define MME_CONFIG_STRING_S1AP_CONFIG "S1AP"
 #define MME_CONFIG_STRING_S1AP_OUTCOME_TIMER "S1AP_OUTCOME_TIMER"
@@ -142,6 +148,8 @@
 
 #define MME_CONFIG_STRING_WRR_LIST_SELECTION "WRR_LIST_SELECTION"
 #define MME_CONFIG_STRING_PEER_MME_IP_ADDRESS_FOR_S10 "MME_IP_ADDRESS_FOR_S10"
+#define MME_CONFIG_STRING_WEIGHT "WEIGHT"
+#define MME_CONFIG_STRING_PRIORITY "PRIORITY"
 
 ///** MME S10 List --> todo: later FULL WRR : Finding MME via eNB. */
 //#define MME_CONFIG_STRING_MME_LIST_SELECTION             "MME_LIST_SELECTION"
@@ -178,6 +186,7 @@ typedef struct mme_config_s {
 
   uint8_t unauthenticated_imsi_supported;
   uint8_t dummy_handover_forwarding_enabled;
+  uint8_t gtpv2c_timerfd_enabled;
 
   struct {
     uint8_t ims_voice_over_ps_session_in_s1;
@@ -206,6 +215,7 @@ typedef struct mme_config_s {
   struct {
     uint16_t in_streams;
     uint16_t out_streams;
+    uint8_t receiver_threads;
   } sctp_config;
 
   struct {
@@ -240,6 +250,10 @@ typedef struct mme_config_s {
     bstring conf_file;
     bstring hss_host_name;
     bstring mme_host_name;
+    // Subscriber file of the built-in HSS, no Diameter peer if set
+    bstring hss_emulation_file;
+    // Vectors generated in advance per subscriber of the built-in HSS
+    uint32_t hss_emulation_vectors;
   } s6a_config;
 
   struct {
@@ -281,6 +295,8 @@ typedef struct mme_config_s {
       struct sockaddr_in6
           v6;  //; /**< Just allocating sockaddr was not enough. */
     } sockaddr[MME_CONFIG_MAX_SERVICE];
+    uint16_t weight[MME_CONFIG_MAX_SERVICE];    // WRR weight, 1 by default
+    uint16_t priority[MME_CONFIG_MAX_SERVICE];  // lowest preferred, 0 default
     /** MME entries. */
   } e_dns_emulation;
 
@@ -296,6 +312,44 @@ typedef struct mme_config_s {
 
 extern mme_config_t mme_config;
 
+#define MME_CONFIG_MAX_SERVED_TAI 64
+
+/*! \struct  mme_config_snapshot_t
+ * \brief Immutable view of the configuration read on every procedure (TA
+ * checks, Diameter destination), with its lookup structures precomputed.
+ * Read without lock through mme_config_snapshot_get()/_put(), replaced as a
+ * whole on reload.
+ */
+typedef struct mme_config_snapshot_s {
+  uint32_t ref_count;
+  /* Distinct PLMNs of the served TAIs, in the order of the TAI list */
+  uint8_t nb_plmn;
+  struct {
+    uint16_t mcc;
+    uint16_t mnc;
+    uint16_t mnc_len;
+  } plmn[MME_CONFIG_MAX_SERVED_TAI];
+  /* Served TACs, one bit per TAC value */
+  uint64_t tac_bitmap[(UINT16_MAX + 1) / 64];
+  bstring realm;
+  /* S6A Destination-Host: HSS host name.realm */
+  bstring s6a_destination_host;
+} mme_config_snapshot_t;
+
+mme_config_snapshot_t* mme_config_snapshot_get(void);
+void mme_config_snapshot_put(mme_config_snapshot_t* snapshot);
+bool mme_config_snapshot_has_plmn(const mme_config_snapshot_t* snapshot,
+                                  const uint16_t mcc, const uint16_t mnc,
+                                  const uint16_t mnc_len);
+bool mme_config_snapshot_has_tac(const mme_config_snapshot_t* snapshot,
+                                 const uint16_t tac);
+
+/*
+ * Re-reads the served TAIs and the HSS host name of the configuration file and
+ * publishes a new snapshot (SIGHUP). A bad file is reported, nothing changes.
+ */
+int mme_config_reload(void);
+
 bool mme_app_check_ta_local(const plmn_t* target_plmn, const tac_t target_tac);
 
 int mme_config_find_mnc_length(const char mcc_digit1P, const char mcc_digit2P,
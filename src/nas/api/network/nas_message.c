@@ -67,6 +67,21 @@
 
 #define SR_MAC_SIZE_BYTES 2
 
+/*
+ * Plaintext of the ciphered NAS messages decoded or encoded by the thread;
+ * plain and integrity protected only messages are decoded from and encoded
+ * in the message buffer. The EEA1 cipher writes whole 32 bits words.
+ */
+#define NAS_MESSAGE_SCRATCH_SIZE 4096
+static __thread unsigned char
+    _nas_message_scratch[NAS_MESSAGE_SCRATCH_SIZE + sizeof(uint32_t)];
+
+static unsigned char *_nas_message_scratch_get(size_t length);
+static void _nas_message_scratch_release(unsigned char *scratch);
+static uint8_t _nas_message_cipher_algorithm(
+    uint8_t security_header_type,
+    const emm_security_context_t *const emm_security_context);
+
 /* Functions used to decode layer 3 NAS messages */
 
 static int _nas_message_plain_decode(
@@ -826,7 +841,18 @@ static int _nas_message_protected_decode(
     nas_message_decode_status_t *const status) {
   OAILOG_FUNC_IN(LOG_NAS);
   int bytes = TLV_BUFFER_TOO_SHORT;
-  unsigned char *const plain_msg = (unsigned char *)calloc(1, length);
+  uint8_t algorithm = _nas_message_cipher_algorithm(
+      header->security_header_type, emm_security_context);
+  unsigned char *plain_msg = buffer;
+
+  /*
+   * Only a ciphered message needs a buffer for its plaintext, the others
+   * are decoded from the input buffer
+   */
+  if ((NAS_SECURITY_ALGORITHMS_EEA1 == algorithm) ||
+      (NAS_SECURITY_ALGORITHMS_EEA2 == algorithm)) {
+    plain_msg = _nas_message_scratch_get(length);
+  }
 
   if (plain_msg) {
     /*
@@ -840,7 +866,10 @@ static int _nas_message_protected_decode(
      * Decode the decrypted message as plain NAS message
      */
     bytes = _nas_message_plain_decode(plain_msg, header, msg, length);
-    free_wrapper((void **)&plain_msg);
+
+    if (plain_msg != buffer) {
+      _nas_message_scratch_release(plain_msg);
+    }
   }
 
   OAILOG_FUNC_RETURN(LOG_NAS, bytes);
@@ -988,7 +1017,17 @@ static int _nas_message_protected_encode(
   emm_security_context_t *emm_security_context =
       (emm_security_context_t *)security;
   int bytes = TLV_BUFFER_TOO_SHORT;
-  unsigned char *plain_msg = (unsigned char *)calloc(1, length);
+  unsigned char *plain_msg = buffer;
+
+  /*
+   * The message is encrypted in the output buffer, but for EEA1 that
+   * ciphers its input buffer
+   */
+  if (NAS_SECURITY_ALGORITHMS_EEA1 ==
+      _nas_message_cipher_algorithm(msg->header.security_header_type,
+                                    emm_security_context)) {
+    plain_msg = _nas_message_scratch_get(length);
+  }
 
   if (plain_msg) {
     /*
@@ -1010,12 +1049,73 @@ static int _nas_message_protected_encode(
       // seq ++;
     }
 
-    free_wrapper((void **)&plain_msg);
+    if (plain_msg != buffer) {
+      _nas_message_scratch_release(plain_msg);
+    }
   }
 
   OAILOG_FUNC_RETURN(LOG_NAS, bytes);
 }
 
+/****************************************************************************
+ **                                                                        **
+ ** Name:  _nas_message_scratch_get()                                  **
+ **                                                                        **
+ ** Description: Get a buffer for the plaintext of a ciphered NAS message  **
+ **                                                                        **
+ ** Inputs   length:  Length of the NAS message                        **
+ **    Others:  _nas_message_scratch                               **
+ **                                                                        **
+ ** Outputs:   None                                                      **
+ **      Return:  The scratch buffer of the thread, or an      **
+ **       allocated buffer if the message does not fit **
+ **       in it; NULL if the allocation failed.        **
+ **    Others:  None                                                   **
+ **                                                                        **
+ ***************************************************************************/
+static unsigned char *_nas_message_scratch_get(size_t length) {
+  if (length <= NAS_MESSAGE_SCRATCH_SIZE) {
+    return _nas_message_scratch;
+  }
+  return (unsigned char *)calloc(1, length + sizeof(uint32_t));
+}
+
+static void _nas_message_scratch_release(unsigned char *scratch) {
+  if (scratch != _nas_message_scratch) {
+    free_wrapper((void **)&scratch);
+  }
+}
+
+/****************************************************************************
+ **                                                                        **
+ ** Name:  _nas_message_cipher_algorithm()                             **
+ **                                                                        **
+ ** Description: Return the ciphering algorithm applied to a NAS message   **
+ **                                                                        **
+ ** Inputs   security_header_type:    The security header type         **
+ **    emm_security_context: security context                       **
+ **    Others:  None                                                   **
+ **                                                                        **
+ ** Outputs:   None                                                      **
+ **      Return:  The selected EEA algorithm if the message is **
+ **       ciphered; NAS_SECURITY_ALGORITHMS_EEA0       **
+ **       otherwise.                                   **
+ **    Others:  None                                                   **
+ **                                                                        **
+ ***************************************************************************/
+static uint8_t _nas_message_cipher_algorithm(
+    uint8_t security_header_type,
+    const emm_security_context_t *const emm_security_context) {
+  if ((emm_security_context) &&
+      ((SECURITY_HEADER_TYPE_INTEGRITY_PROTECTED_CYPHERED ==
+        security_header_type) ||
+       (SECURITY_HEADER_TYPE_INTEGRITY_PROTECTED_CYPHERED_NEW ==
+        security_header_type))) {
+    return emm_security_context->selected_algorithms.encryption;
+  }
+  return NAS_SECURITY_ALGORITHMS_EEA0;
+}
+
 /*
    -----------------------------------------------------------------------------
         Functions used to decrypt and encrypt layer 3 NAS messages
@@ -1035,7 +1135,8 @@ static int _nas_message_protected_encode(
  **    length:  Maximal capacity of the output buffer      **
  **    Others:  None                                       **
  **                                                                        **
- ** Outputs:   dest:    Pointer to the decrypted data buffer       **
+ ** Outputs:   dest:    Pointer to the decrypted data buffer, may  **
+ **       be src if the message is not ciphered      **
  **      Return:  The protocol discriminator of the message  **
  **       that has been decrypted;                   **
  **    Others:  None                                       **
@@ -1064,7 +1165,9 @@ static int _nas_message_decrypt(
                    "No decryption of message length %lu according to security "
                    "header type 0x%02x\n",
                    length, security_header_type);
-      memcpy(dest, src, length);
+      if (dest != src) {
+        memcpy(dest, src, length);
+      }
       DECODE_U8(dest, *(uint8_t *)(&header), size);
       OAILOG_FUNC_RETURN(LOG_NAS, header.protocol_discriminator);
       // LOG_FUNC_RETURN (LOG_NAS, length);
@@ -1157,7 +1260,12 @@ static int _nas_message_decrypt(
              * length in bits
              */
             stream_cipher.blength = length << 3;
-            nas_stream_encrypt_eea2(&stream_cipher, (uint8_t *)dest);
+            if (emm_security_context->knas_enc_key.is_set) {
+              nas_stream_encrypt_eea2_key(&emm_security_context->knas_enc_key,
+                                          &stream_cipher, (uint8_t *)dest);
+            } else {
+              nas_stream_encrypt_eea2(&stream_cipher, (uint8_t *)dest);
+            }
             /*
              * Decode the first octet (security header type or EPS bearer
              * identity,
@@ -1173,7 +1281,9 @@ static int _nas_message_decrypt(
                          "%d dl_count.seq_num %d\n",
                          direction, emm_security_context->ul_count.seq_num,
                          emm_security_context->dl_count.seq_num);
-            memcpy(dest, src, length);
+            if (dest != src) {
+              memcpy(dest, src, length);
+            }
             /*
              * Decode the first octet (security header type or EPS bearer
              * identity,
@@ -1186,7 +1296,9 @@ static int _nas_message_decrypt(
           default:
             OAILOG_ERROR(LOG_NAS, "Unknown Cyphering protection algorithm %d\n",
                          emm_security_context->selected_algorithms.encryption);
-            memcpy(dest, src, length);
+            if (dest != src) {
+              memcpy(dest, src, length);
+            }
             /*
              * Decode the first octet (security header type or EPS bearer
              * identity,
@@ -1224,7 +1336,8 @@ static int _nas_message_decrypt(
  **    length:  Maximal capacity of the output buffer      **
  **    Others:  None                                       **
  **                                                                        **
- ** Outputs:   dest:    Pointer to the encrypted data buffer       **
+ ** Outputs:   dest:    Pointer to the encrypted data buffer, may  **
+ **       be src unless the message is ciphered with EEA1  **
  **      Return:  The number of bytes in the output buffer   **
  **       if data have been successfully encrypted;  **
  **       RETURNerror otherwise.                     **
@@ -1256,7 +1369,9 @@ static int _nas_message_encrypt(
           LOG_NAS,
           "No encryption of message according to security header type 0x%02x\n",
           security_header_type);
-      memcpy(dest, src, length);
+      if (dest != src) {
+        memcpy(dest, src, length);
+      }
       OAILOG_FUNC_RETURN(LOG_NAS, length);
       break;
 
@@ -1329,7 +1444,12 @@ static int _nas_message_encrypt(
            * length in bits
            */
           stream_cipher.blength = length << 3;
-          nas_stream_encrypt_eea2(&stream_cipher, (uint8_t *)dest);
+          if (emm_security_context->knas_enc_key.is_set) {
+            nas_stream_encrypt_eea2_key(&emm_security_context->knas_enc_key,
+                                        &stream_cipher, (uint8_t *)dest);
+          } else {
+            nas_stream_encrypt_eea2(&stream_cipher, (uint8_t *)dest);
+          }
           OAILOG_FUNC_RETURN(LOG_NAS, length);
         } break;
 
@@ -1339,7 +1459,9 @@ static int _nas_message_encrypt(
                        "%d dl_count.seq_num %d\n",
                        direction, emm_security_context->ul_count.seq_num,
                        emm_security_context->dl_count.seq_num);
-          memcpy(dest, src, length);
+          if (dest != src) {
+            memcpy(dest, src, length);
+          }
           OAILOG_FUNC_RETURN(LOG_NAS, length);
           break;
 
@@ -1477,7 +1599,12 @@ static uint32_t _nas_message_get_mac(
        * length in bits
        */
       stream_cipher.blength = length << 3;
-      nas_stream_encrypt_eia2(&stream_cipher, mac);
+      if (emm_security_context->knas_int_key.is_set) {
+        nas_stream_encrypt_eia2_key(&emm_security_context->knas_int_key,
+                                    &stream_cipher, mac);
+      } else {
+        nas_stream_encrypt_eia2(&stream_cipher, mac);
+      }
       OAILOG_DEBUG(LOG_NAS,
                    "NAS_SECURITY_ALGORITHMS_EIA2 returned MAC %x.%x.%x.%x(%u) "
                    "for length %lu direction %d, count %d\n",
@@ -236,16 +236,18 @@ int emm_proc_security_mode_control(
       emm_ctx_set_security_type(emm_ctx, SECURITY_CTX_TYPE_FULL_NATIVE);
       AssertFatal(KSI_NO_KEY_AVAILABLE > emm_ctx->_security.eksi,
                   "eksi not valid");
-      derive_key_nas(
-          NAS_INT_ALG, emm_ctx->_security.selected_algorithms.integrity,
+      const kdf_key_t *kasme = kdf_key_update(
+          &emm_ctx->_security.kasme_key,
           emm_ctx->_vector[emm_ctx->_security.eksi % MAX_EPS_AUTH_VECTORS]
               .kasme,
-          emm_ctx->_security.knas_int);
-      derive_key_nas(
-          NAS_ENC_ALG, emm_ctx->_security.selected_algorithms.encryption,
-          emm_ctx->_vector[emm_ctx->_security.eksi % MAX_EPS_AUTH_VECTORS]
-              .kasme,
-          emm_ctx->_security.knas_enc);
+          AUTH_KASME_SIZE);
+      derive_key_nas_key(NAS_INT_ALG,
+                         emm_ctx->_security.selected_algorithms.integrity,
+                         kasme, emm_ctx->_security.knas_int);
+      derive_key_nas_key(NAS_ENC_ALG,
+                         emm_ctx->_security.selected_algorithms.encryption,
+                         kasme, emm_ctx->_security.knas_enc);
+      emm_ctx_expand_nas_keys(&emm_ctx->_security);
       /*
        * Set new security context indicator
        */
@@ -3113,6 +3113,7 @@ void free_emm_tau_request_ies(emm_tau_request_ies_t **const ies) {
     free_wrapper((void **)&((*ies)->mobile_station_classmark3));
   }
   if ((*ies)->supported_codecs) {
+    bdestroy_wrapper((*ies)->supported_codecs);
     free_wrapper((void **)&((*ies)->supported_codecs));
   }
   if ((*ies)->additional_updatetype) {
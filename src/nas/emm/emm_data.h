@@ -42,6 +42,7 @@ Description Defines internal private data handled by EPS Mobility
 #include "hashtable.h"
 #include "obj_hashtable.h"
 #include "queue.h"
+#include "secu_defs.h"
 #include "securityDef.h"
 
 #include "AdditionalUpdateType.h"
@@ -103,6 +104,9 @@ typedef struct emm_security_context_s {
   int vector_index;                     /* Pointer on vector */
   uint8_t knas_enc[AUTH_KNAS_ENC_SIZE]; /* NAS cyphering key               */
   uint8_t knas_int[AUTH_KNAS_INT_SIZE]; /* NAS integrity key               */
+  nas_stream_key_t knas_enc_key;        /* knas_enc expanded for EEA2      */
+  nas_stream_key_t knas_int_key;        /* knas_int expanded for EIA2      */
+  kdf_key_t kasme_key;                  /* KDF state of the K_ASME in use  */
   uint8_t ncc : 3;               /* next hop chaining counter for handover. */
   uint8_t nh_conj[AUTH_NH_SIZE]; /* nh */
 
@@ -435,6 +439,8 @@ void emm_ctx_clear_non_current_security_vector_index(
     emm_data_context_t* const ctxt) __attribute__((nonnull));
 void emm_ctx_set_non_current_security_vector_index(
     emm_data_context_t* const ctxt, int vector_index) __attribute__((nonnull));
+void emm_ctx_expand_nas_keys(emm_security_context_t* const sc)
+    __attribute__((nonnull));
 
 void emm_ctx_clear_ue_nw_cap(emm_data_context_t* const ctxt)
     __attribute__((nonnull));
@@ -377,6 +377,14 @@ inline void emm_ctx_set_security_eksi(emm_data_context_t *const ctxt,
                ctxt->ue_id, eksi);
 }
 
+//------------------------------------------------------------------------------
+/* Expand the NAS keys once, for EEA2/EIA2, each time they are derived.
+ */
+void emm_ctx_expand_nas_keys(emm_security_context_t *const sc) {
+  nas_stream_key_setup(&sc->knas_enc_key, sc->knas_enc);
+  nas_stream_key_setup(&sc->knas_int_key, sc->knas_int);
+}
+
 //------------------------------------------------------------------------------
 inline void emm_ctx_clear_security_vector_index(
     emm_data_context_t *const ctxt) {
@@ -763,14 +771,17 @@ inline void emm_ctx_update_from_mm_eps_context(
   AssertFatal(MAX_EPS_AUTH_VECTORS > emm_ctx_p->_security.vector_index,
               "Vector index outbound value %d/%d",
               emm_ctx_p->_security.vector_index, MAX_EPS_AUTH_VECTORS);
-  derive_key_nas(NAS_INT_ALG,
-                 emm_ctx_p->_security.selected_algorithms.integrity,
-                 emm_ctx_p->_vector[emm_ctx_p->_security.vector_index].kasme,
-                 emm_ctx_p->_security.knas_int);
-  derive_key_nas(NAS_ENC_ALG,
-                 emm_ctx_p->_security.selected_algorithms.encryption,
-                 emm_ctx_p->_vector[emm_ctx_p->_security.vector_index].kasme,
-                 emm_ctx_p->_security.knas_enc);
+  const kdf_key_t *kasme = kdf_key_update(
+      &emm_ctx_p->_security.kasme_key,
+      emm_ctx_p->_vector[emm_ctx_p->_security.vector_index].kasme,
+      AUTH_KASME_SIZE);
+  derive_key_nas_key(NAS_INT_ALG,
+                     emm_ctx_p->_security.selected_algorithms.integrity, kasme,
+                     emm_ctx_p->_security.knas_int);
+  derive_key_nas_key(NAS_ENC_ALG,
+                     emm_ctx_p->_security.selected_algorithms.encryption,
+                     kasme, emm_ctx_p->_security.knas_enc);
+  emm_ctx_expand_nas_keys(&emm_ctx_p->_security);
 
   memcpy(emm_ctx_p->_vector[emm_ctx_p->_security.vector_index].kasme,
          mm_eps_ctxt->k_asme, 32);
@@ -848,10 +859,14 @@ inline void temp_sec_ctx_from_mm_eps_context(
   emm_sec_ctx_p->selected_algorithms.encryption = mm_eps_ctxt->nas_cipher_alg;
   emm_sec_ctx_p->selected_algorithms.integrity = mm_eps_ctxt->nas_int_alg;
   emm_sec_ctx_p->sc_type = SECURITY_CTX_TYPE_FULL_NATIVE;
-  derive_key_nas(NAS_INT_ALG, emm_sec_ctx_p->selected_algorithms.integrity,
-                 k_asme_temp, emm_sec_ctx_p->knas_int);
-  derive_key_nas(NAS_ENC_ALG, emm_sec_ctx_p->selected_algorithms.encryption,
-                 k_asme_temp, emm_sec_ctx_p->knas_enc);
+  const kdf_key_t *kasme = kdf_key_update(&emm_sec_ctx_p->kasme_key,
+                                          k_asme_temp, AUTH_KASME_SIZE);
+  derive_key_nas_key(NAS_INT_ALG, emm_sec_ctx_p->selected_algorithms.integrity,
+                     kasme, emm_sec_ctx_p->knas_int);
+  derive_key_nas_key(NAS_ENC_ALG,
+                     emm_sec_ctx_p->selected_algorithms.encryption, kasme,
+                     emm_sec_ctx_p->knas_enc);
+  emm_ctx_expand_nas_keys(emm_sec_ctx_p);
   emm_sec_ctx_p->ncc = mm_eps_ctxt->ncc;
   memcpy(emm_sec_ctx_p->nh_conj, mm_eps_ctxt->nh, 32);
   /** All remaining capabilities should be set with the TAC/Attach Request. */
@@ -1123,8 +1138,11 @@ int emm_data_context_update_security_parameters(
 
   //  LOCK_EMM_CONTEXT(emm_ctx);
   /** Derive the next hop. */
-  derive_nh(emm_ctx->_vector[emm_ctx->_security.vector_index].kasme,
-            emm_ctx->_vector[emm_ctx->_security.vector_index].nh_conj);
+  derive_nh_key(kdf_key_update(
+                    &emm_ctx->_security.kasme_key,
+                    emm_ctx->_vector[emm_ctx->_security.vector_index].kasme,
+                    AUTH_KASME_SIZE),
+                emm_ctx->_vector[emm_ctx->_security.vector_index].nh_conj);
 
   /** Increase the next hop counter. */
   emm_ctx->_security.ncc++;
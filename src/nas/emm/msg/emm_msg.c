@@ -507,6 +507,7 @@ void emm_msg_free(EMM_msg *msg) {
 
     case ATTACH_REQUEST:
       bdestroy_wrapper(&msg->attach_request.esmmessagecontainer);
+      bdestroy_wrapper(&msg->attach_request.supportedcodecs);
       break;
 
     case AUTHENTICATION_REQUEST:
@@ -47,12 +47,23 @@ static void nas_emm_exit(void);
 
 //------------------------------------------------------------------------------
 static void *nas_emm_intertask_interface(void *args_p) {
+  MessageDef *received_messages[ITTI_RECEIVE_MSGS_BATCH_SIZE] = {NULL};
+  int nb_received_messages = 0;
+  int next_received_message = 0;
+
   itti_mark_task_ready(TASK_NAS_EMM);
+  itti_set_task_wake_if_sleeping(TASK_NAS_EMM);
 
   while (1) {
     MessageDef *received_message_p = NULL;
 
-    itti_receive_msg(TASK_NAS_EMM, &received_message_p);
+    if (next_received_message == nb_received_messages) {
+      next_received_message = 0;
+      nb_received_messages = itti_receive_msgs(
+          TASK_NAS_EMM, received_messages, ITTI_RECEIVE_MSGS_BATCH_SIZE);
+      if (!nb_received_messages) continue;
+    }
+    received_message_p = received_messages[next_received_message++];
 
     switch (ITTI_MSG_ID(received_message_p)) {
       case MESSAGE_TEST: {
@@ -133,6 +144,8 @@ static void *nas_emm_intertask_interface(void *args_p) {
         OAI_FPRINTF_INFO("TASK_NAS_EMM terminated\n");
         itti_free_msg_content(received_message_p);
         itti_free(ITTI_MSG_ORIGIN_ID(received_message_p), received_message_p);
+        itti_free_received_msgs(received_messages, next_received_message,
+                                nb_received_messages);
         itti_exit_task();
       } break;
 
@@ -753,8 +753,8 @@ int emm_recv_tracking_area_update_request(
   if (msg->presencemask &
       TRACKING_AREA_UPDATE_REQUEST_SUPPORTED_CODECS_PRESENT) {
     ies->supported_codecs = calloc(1, sizeof(*ies->supported_codecs));
-    memcpy(ies->supported_codecs, &msg->supportedcodecs,
-           sizeof(*ies->supported_codecs));
+    *ies->supported_codecs = msg->supportedcodecs;
+    msg->supportedcodecs = NULL;
   }
   if (msg->presencemask &
       TRACKING_AREA_UPDATE_REQUEST_ADDITIONAL_UPDATE_TYPE_PRESENT) {
@@ -615,8 +615,11 @@ void nas_itti_establish_cnf(const mme_ue_s1ap_id_t ue_idP,
                ". \n",
                nas_count, emm_ctx->ue_id);
 
-  derive_keNB(emm_ctx->_vector[emm_ctx->_security.vector_index].kasme,
-              nas_count, NAS_CONNECTION_ESTABLISHMENT_CNF(message_p).kenb);
+  derive_keNB_key(
+      kdf_key_update(&emm_ctx->_security.kasme_key,
+                     emm_ctx->_vector[emm_ctx->_security.vector_index].kasme,
+                     AUTH_KASME_SIZE),
+      nas_count, NAS_CONNECTION_ESTABLISHMENT_CNF(message_p).kenb);
 
   uint8_t zero[32];
   memset(zero, 0, 32);
@@ -66,6 +66,7 @@
 #include "s11_mme.h"
 #include "s1ap_mme.h"
 #include "sctp_primitives_server.h"
+#include "signals.h"
 #include "timer.h"
 #include "udp_primitives_server.h"
 
@@ -170,8 +171,9 @@ int main(int argc, char *argv[]) {
                "MME app initialization of optional interfaces complete. \n");
 
   /*
-   * Handle signals here
+   * Handle signals here, SIGHUP reloads the configuration snapshot
    */
+  signal_set_reload_cb(mme_config_reload);
   itti_wait_tasks_end();
   pid_file_unlock();
   free_wrapper((void **)&pid_file_name);
@@ -30,6 +30,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <sys/epoll.h>
 
 #include "bstrlib.h"
 
@@ -42,6 +43,7 @@
 #include "intertask_interface.h"
 #include "itti_free_defined_msg.h"
 #include "log.h"
+#include "mme_app_edns_emulation.h"
 #include "mme_config.h"
 #include "msc.h"
 #include "s10_mme.h"
@@ -49,6 +51,9 @@
 #include "timer.h"
 
 static nw_gtpv2c_stack_handle_t s10_mme_stack_handle = 0;
+// timerfd of the stack, -1 when the stack uses ITTI timers
+static int s10_mme_timer_fd = -1;
+static long s10_mme_statistic_timer_id = 0;
 // Store the GTPv2-C teid handle
 hash_table_ts_t *s10_mme_teid_2_gtv2c_teid_handle = NULL;
 static void s10_exit(void);
@@ -217,6 +222,43 @@ static nw_rc_t s10_mme_stop_timer_wrapper(
   return ((timer_remove(timer_id, &timeoutArg) == 0) ? NW_OK : NW_FAILURE);
 }
 
+//------------------------------------------------------------------------------
+// Peer counters, logged and reported to the service selection as health
+static void s10_mme_handle_peer_stats(const nw_gtpv2c_peer_stats_t *stats,
+                                      void *arg) {
+  char ip[INET6_ADDRSTRLEN];
+
+  if (stats->peerIp.addrv4.sin_family == AF_INET) {
+    inet_ntop(AF_INET, &stats->peerIp.addrv4.sin_addr, ip, sizeof(ip));
+  } else {
+    inet_ntop(AF_INET6, &stats->peerIp.addrv6.sin6_addr, ip, sizeof(ip));
+  }
+  OAILOG_DEBUG(LOG_S10,
+               "Peer %-39s | %10" PRIu64 " retransmissions | %10" PRIu64
+               " failures\n",
+               ip, stats->nbRetransmissions, stats->nbRspFailures);
+  mme_app_edns_update_service_health(S10_MME_GTP_C,
+                                     (const struct sockaddr *)&stats->peerIp,
+                                     stats->nbRspFailures);
+}
+
+//------------------------------------------------------------------------------
+static void s10_mme_process_events(void) {
+  struct epoll_event *events = NULL;
+  int nb_events = itti_get_events(TASK_S10, &events);
+
+  for (int i = 0; (events) && (i < nb_events); i++) {
+    if ((events[i].events & EPOLLIN) &&
+        (events[i].data.fd == s10_mme_timer_fd)) {
+      /*
+       * Expires all the due timers of the stack
+       */
+      DevAssert(nwGtpv2cProcessTimerFd(s10_mme_stack_handle) == NW_OK);
+      events[i].events &= ~EPOLLIN;
+    }
+  }
+}
+
 static void *s10_mme_thread(void *args) {
   itti_mark_task_ready(TASK_S10);
   //  OAILOG_START_USE ();
@@ -226,7 +268,11 @@ static void *s10_mme_thread(void *args) {
     MessageDef *received_message_p = NULL;
 
     itti_receive_msg(TASK_S10, &received_message_p);
-    assert(received_message_p);
+    if (received_message_p == NULL) {
+      // Woken up for the timerfd
+      s10_mme_process_events();
+      continue;
+    }
 
     switch (ITTI_MSG_ID(received_message_p)) {
       /** Only the signals to send. */
@@ -322,14 +368,24 @@ static void *s10_mme_thread(void *args) {
         udp_data_ind_t *udp_data_ind;
 
         udp_data_ind = &received_message_p->ittiMsg.udp_data_ind;
-        rc = nwGtpv2cProcessUdpReq(
-            s10_mme_stack_handle, udp_data_ind->msgBuf,
+        /*
+         * The messages reference the receive buffer instead of a copy
+         */
+        rc = nwGtpv2cProcessUdpBuffer(
+            s10_mme_stack_handle, udp_data_ind->buffer, udp_data_ind->msgBuf,
             udp_data_ind->buffer_length, udp_data_ind->local_port,
             udp_data_ind->peer_port, &udp_data_ind->sock_addr);
         DevAssert(rc == NW_OK);
       } break;
 
       case TIMER_HAS_EXPIRED: {
+        if ((s10_mme_statistic_timer_id) &&
+            (received_message_p->ittiMsg.timer_has_expired.timer_id ==
+             s10_mme_statistic_timer_id)) {
+          nwGtpv2cForEachPeerStats(s10_mme_stack_handle,
+                                   s10_mme_handle_peer_stats, NULL);
+          break;
+        }
         OAILOG_DEBUG(LOG_S10,
                      "Processing timeout for timer_id 0x%lx and arg %p\n",
                      received_message_p->ittiMsg.timer_has_expired.timer_id,
@@ -353,6 +409,7 @@ static void *s10_mme_thread(void *args) {
     itti_free_msg_content(received_message_p);
     itti_free(ITTI_MSG_ORIGIN_ID(received_message_p), received_message_p);
     received_message_p = NULL;
+    s10_mme_process_events();
   }
 
   return NULL;
@@ -418,16 +475,27 @@ int s10_mme_init(const mme_config_t *mme_config_p) {
   udp.udpDataReqCallback = s10_mme_send_udp_msg;
   DevAssert(NW_OK == nwGtpv2cSetUdpEntity(s10_mme_stack_handle, &udp));
   /*
-   * Set Timer entity
+   * Set Timer entity: the stack arms a timerfd polled by the task with its
+   * ITTI queue, or ITTI timers
    */
-  tmrMgr.tmrMgrHandle = (nw_gtpv2c_timer_mgr_handle_t)NULL;
-  tmrMgr.tmrStartCallback = s10_mme_start_timer_wrapper;
-  tmrMgr.tmrStopCallback = s10_mme_stop_timer_wrapper;
-  DevAssert(NW_OK == nwGtpv2cSetTimerMgrEntity(s10_mme_stack_handle, &tmrMgr));
+  if ((mme_config_p->gtpv2c_timerfd_enabled) &&
+      (NW_OK == nwGtpv2cSetTimerFd(s10_mme_stack_handle, &s10_mme_timer_fd))) {
+    itti_subscribe_event_fd(TASK_S10, s10_mme_timer_fd);
+  } else {
+    tmrMgr.tmrMgrHandle = (nw_gtpv2c_timer_mgr_handle_t)NULL;
+    tmrMgr.tmrStartCallback = s10_mme_start_timer_wrapper;
+    tmrMgr.tmrStopCallback = s10_mme_stop_timer_wrapper;
+    DevAssert(NW_OK ==
+              nwGtpv2cSetTimerMgrEntity(s10_mme_stack_handle, &tmrMgr));
+  }
   logMgr.logMgrHandle = 0;
   logMgr.logReqCallback = s10_mme_log_wrapper;
   DevAssert(NW_OK == nwGtpv2cSetLogMgrEntity(s10_mme_stack_handle, &logMgr));
 
+  // GTPv2-C peers retransmit the dropped requests, don't stall the UDP task
+  // serving the other sockets
+  itti_set_task_queue_full_policy(TASK_S10, UDP_DATA_IND, ITTI_QUEUE_FULL_REJECT,
+                                  0);
   if (itti_create_task(TASK_S10, &s10_mme_thread, NULL) < 0) {
     OAILOG_ERROR(LOG_S10, "gtpv2c phtread_create: %s\n", strerror(errno));
     goto fail;
@@ -447,6 +515,19 @@ int s10_mme_init(const mme_config_t *mme_config_p) {
                           hash_free_int_func, b);
   bdestroy_wrapper(&b);
 
+  /*
+   * Periodic display of the retransmission counters of the peers
+   */
+  if (timer_setup(mme_config_p->mme_statistic_timer, 0, TASK_S10,
+                  INSTANCE_DEFAULT, TIMER_PERIODIC, NULL,
+                  &s10_mme_statistic_timer_id) < 0) {
+    OAILOG_ERROR(LOG_S10,
+                 "Failed to request new timer for statistics with %ds "
+                 "of periodicity\n",
+                 mme_config_p->mme_statistic_timer);
+    s10_mme_statistic_timer_id = 0;
+  }
+
   OAILOG_DEBUG(LOG_S10, "Initializing S10 interface: DONE\n");
   return ret;
 fail:
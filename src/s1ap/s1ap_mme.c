@@ -26,6 +26,7 @@
 #include "config.h"
 #endif
 
+#include <inttypes.h>
 #include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -73,8 +74,31 @@ hash_table_ts_t g_s1ap_enb_coll = {.mutex = PTHREAD_MUTEX_INITIALIZER,
 hash_table_ts_t g_s1ap_mme_id2assoc_id_coll = {
     .mutex = PTHREAD_MUTEX_INITIALIZER,
     0};  // contains sctp association id, key is mme_ue_s1ap_id;
+/*
+ * Secondary indexes on the UE and eNB descriptions, they do not own the
+ * referenced descriptions (owned by g_s1ap_enb_coll and enb ue_coll).
+ */
+hash_table_ts_t g_s1ap_mme_ue_id_coll = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    0};  // contains ue_description_s, key is mme_ue_s1ap_id;
+hash_table_ts_t g_s1ap_enb_id_coll = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    0};  // contains eNB_description_s, key is enb_id;
+hash_table_ts_t g_s1ap_tac_coll = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    0};  // contains s1ap_tac_enbs_t, key is tac;
+
+/* eNBs serving a TAC, entries are kept until exit for the paging counters */
+typedef struct s1ap_tac_enbs_s {
+  uint32_t num_enbs;
+  uint32_t max_enbs;
+  enb_description_t **enbs;
+  uint32_t nb_paging_since_last_stat;
+  uint64_t nb_paging;
+} s1ap_tac_enbs_t;
 
 static int indent = 0;
+static long s1ap_overload_timer_id = 0;
 extern struct mme_config_s mme_config;
 void *s1ap_mme_thread(void *args);
 
@@ -114,12 +138,130 @@ static int s1ap_send_init_sctp(void) {
   return RETURNerror;
 }
 
+//------------------------------------------------------------------------------
+// Remove keyP from an index only if it still references elementP
+static void s1ap_unindex(hash_table_ts_t *const htbl, const hash_key_t keyP,
+                         const void *const elementP) {
+  void *indexed = NULL;
+
+  if ((HASH_TABLE_OK == hashtable_ts_get(htbl, keyP, &indexed)) &&
+      (indexed == elementP)) {
+    hashtable_ts_free(htbl, keyP);
+  }
+}
+
+//------------------------------------------------------------------------------
+/*
+ * The UE descriptions sharing a mme_ue_s1ap_id (source and target of a S1
+ * handover) are chained from the indexed one, so that removing one of them
+ * leaves the other indexed.
+ */
+static void s1ap_unindex_ue_mme_ue_s1ap_id(ue_description_t *const ue_ref) {
+  ue_description_t *indexed = NULL;
+  const hash_key_t key = (const hash_key_t)ue_ref->mme_ue_s1ap_id;
+
+  if (HASH_TABLE_OK ==
+      hashtable_ts_get(&g_s1ap_mme_ue_id_coll, key, (void **)&indexed)) {
+    if (indexed == ue_ref) {
+      if (ue_ref->next_same_mme_ue_s1ap_id) {
+        hashtable_ts_insert(&g_s1ap_mme_ue_id_coll, key,
+                            (void *)ue_ref->next_same_mme_ue_s1ap_id);
+      } else {
+        hashtable_ts_free(&g_s1ap_mme_ue_id_coll, key);
+      }
+    } else {
+      while ((indexed) && (indexed->next_same_mme_ue_s1ap_id != ue_ref)) {
+        indexed = indexed->next_same_mme_ue_s1ap_id;
+      }
+      if (indexed) {
+        indexed->next_same_mme_ue_s1ap_id = ue_ref->next_same_mme_ue_s1ap_id;
+      }
+    }
+  }
+  ue_ref->next_same_mme_ue_s1ap_id = NULL;
+}
+
+//------------------------------------------------------------------------------
+static void s1ap_unindex_ue(ue_description_t *const ue_ref) {
+  s1ap_unindex_ue_mme_ue_s1ap_id(ue_ref);
+}
+
+//------------------------------------------------------------------------------
+static bool s1ap_unindex_ue_cb(__attribute__((unused)) const hash_key_t keyP,
+                               void *const elementP,
+                               void __attribute__((unused)) * parameterP,
+                               void __attribute__((unused)) * *resultP) {
+  s1ap_unindex_ue((ue_description_t *)elementP);
+  return false;
+}
+
+//------------------------------------------------------------------------------
+static void s1ap_free_tac_enbs(void **tac_enbs) {
+  if (*tac_enbs) {
+    free_wrapper((void **)&((s1ap_tac_enbs_t *)(*tac_enbs))->enbs);
+    free_wrapper(tac_enbs);
+  }
+}
+
+//------------------------------------------------------------------------------
+static void s1ap_index_enb_tac(enb_description_t *enb_ref, const tac_t tac) {
+  s1ap_tac_enbs_t *tac_enbs = NULL;
+
+  if (HASH_TABLE_OK !=
+      hashtable_ts_get(&g_s1ap_tac_coll, (const hash_key_t)tac,
+                       (void **)&tac_enbs)) {
+    tac_enbs = calloc(1, sizeof(s1ap_tac_enbs_t));
+    DevAssert(tac_enbs != NULL);
+    hashtable_ts_insert(&g_s1ap_tac_coll, (const hash_key_t)tac,
+                        (void *)tac_enbs);
+  }
+  for (uint32_t i = 0; i < tac_enbs->num_enbs; i++) {
+    if (tac_enbs->enbs[i] == enb_ref) return;
+  }
+  if (tac_enbs->num_enbs == tac_enbs->max_enbs) {
+    tac_enbs->max_enbs = (tac_enbs->max_enbs) ? tac_enbs->max_enbs * 2 : 4;
+    tac_enbs->enbs = realloc(tac_enbs->enbs, tac_enbs->max_enbs *
+                                                 sizeof(enb_description_t *));
+    DevAssert(tac_enbs->enbs != NULL);
+  }
+  tac_enbs->enbs[tac_enbs->num_enbs++] = enb_ref;
+}
+
+//------------------------------------------------------------------------------
+static void s1ap_unindex_enb_tacs(enb_description_t *enb_ref) {
+  s1ap_tac_enbs_t *tac_enbs = NULL;
+  const partial_tai_list_t *const tai_list =
+      &enb_ref->tai_list.partial_tai_list[0];
+
+  for (int t = 0; t < tai_list->numberofelements; t++) {
+    if (HASH_TABLE_OK !=
+        hashtable_ts_get(
+            &g_s1ap_tac_coll,
+            (const hash_key_t)tai_list->u.tai_one_plmn_non_consecutive_tacs.tac[t],
+            (void **)&tac_enbs)) {
+      continue;
+    }
+    for (uint32_t i = 0; i < tac_enbs->num_enbs; i++) {
+      if (tac_enbs->enbs[i] == enb_ref) {
+        tac_enbs->enbs[i] = tac_enbs->enbs[--tac_enbs->num_enbs];
+        break;
+      }
+    }
+  }
+}
+
 //------------------------------------------------------------------------------
 static void s1ap_remove_enb(void **enb_ref) {
   enb_description_t *enb_description = NULL;
 
   if (*enb_ref) {
     enb_description = (enb_description_t *)(*enb_ref);
+    // UE descriptions are released with ue_coll, drop their index entries
+    hashtable_ts_apply_callback_on_elements(
+        &enb_description->ue_coll, s1ap_unindex_ue_cb, NULL, NULL);
+    s1ap_unindex(&g_s1ap_enb_id_coll, (const hash_key_t)enb_description->enb_id,
+                 enb_description);
+    s1ap_unindex_enb_tacs(enb_description);
     hashtable_ts_destroy(&enb_description->ue_coll);
     free_wrapper(enb_ref);
     nb_enb_associated--;
@@ -127,24 +269,14 @@ static void s1ap_remove_enb(void **enb_ref) {
   return;
 }
 
-//------------------------------------------------------------------------------
-static bool s1ap_enb_compare_by_tac_cb(__attribute__((unused))
-                                       const hash_key_t keyP,
-                                       void *const elementP, void *parameterP,
-                                       void **resultP) {
-  const tac_t *const tac_p = (const tac_t *const)parameterP;
-  enb_description_t *enb_ref = (enb_description_t *)elementP;
-  if (*tac_p == enb_ref->tai_list.partial_tai_list[0]
-                    .u.tai_one_plmn_consecutive_tacs.tac) {
-    *resultP = elementP;
-    return true;
-  }
-  return false;
-}
-
 //------------------------------------------------------------------------------
 void *s1ap_mme_thread(__attribute__((unused)) void *args) {
+  MessageDef *received_messages[ITTI_RECEIVE_MSGS_BATCH_SIZE] = {NULL};
+  int nb_received_messages = 0;
+  int next_received_message = 0;
+
   itti_mark_task_ready(TASK_S1AP);
+  itti_set_task_wake_if_sleeping(TASK_S1AP);
   //  OAILOG_START_USE ();
   //  MSC_START_USE ();
 
@@ -152,11 +284,17 @@ void *s1ap_mme_thread(__attribute__((unused)) void *args) {
     MessageDef *received_message_p = NULL;
     MessagesIds message_id = MESSAGES_ID_MAX;
     /*
-     * Trying to fetch a message from the message queue.
+     * Trying to fetch messages from the message queue.
      * * * * If the queue is empty, this function will block till a
      * * * * message is sent to the task.
      */
-    itti_receive_msg(TASK_S1AP, &received_message_p);
+    if (next_received_message == nb_received_messages) {
+      next_received_message = 0;
+      nb_received_messages = itti_receive_msgs(
+          TASK_S1AP, received_messages, ITTI_RECEIVE_MSGS_BATCH_SIZE);
+      if (!nb_received_messages) continue;
+    }
+    received_message_p = received_messages[next_received_message++];
     DevAssert(received_message_p != NULL);
 
     switch (ITTI_MSG_ID(received_message_p)) {
@@ -315,6 +453,12 @@ void *s1ap_mme_thread(__attribute__((unused)) void *args) {
 
       case TIMER_HAS_EXPIRED: {
         ue_description_t *ue_ref_p = NULL;
+        if ((s1ap_overload_timer_id) &&
+            (received_message_p->ittiMsg.timer_has_expired.timer_id ==
+             s1ap_overload_timer_id)) {
+          // Overload re-checked below, the queues may drain without traffic
+          break;
+        }
         if (received_message_p->ittiMsg.timer_has_expired.arg != NULL) {
           enb_s1ap_id_key_t enb_s1ap_id_key = (enb_s1ap_id_key_t)(
               received_message_p->ittiMsg.timer_has_expired.arg);
@@ -365,6 +509,8 @@ void *s1ap_mme_thread(__attribute__((unused)) void *args) {
         s1ap_mme_exit();
         itti_free_msg_content(received_message_p);
         itti_free(ITTI_MSG_ORIGIN_ID(received_message_p), received_message_p);
+        itti_free_received_msgs(received_messages, next_received_message,
+                                nb_received_messages);
         OAI_FPRINTF_INFO("TASK_S1AP terminated\n");
         itti_exit_task();
       } break;
@@ -379,6 +525,7 @@ void *s1ap_mme_thread(__attribute__((unused)) void *args) {
     itti_free_msg_content(received_message_p);
     itti_free(ITTI_MSG_ORIGIN_ID(received_message_p), received_message_p);
     received_message_p = NULL;
+    s1ap_mme_check_overload();
   }
 
   return NULL;
@@ -412,11 +559,60 @@ int s1ap_mme_init(void) {
   bdestroy_wrapper(&bs2);
   if (!h) return RETURNerror;
 
+  bstring bs3 = bfromcstr("s1ap_mme_ue_id_coll");
+  h = hashtable_ts_init(&g_s1ap_mme_ue_id_coll, mme_config.max_ues, NULL,
+                        hash_free_int_func, bs3);
+  bdestroy_wrapper(&bs3);
+  if (!h) return RETURNerror;
+
+  bstring bs4 = bfromcstr("s1ap_enb_id_coll");
+  h = hashtable_ts_init(&g_s1ap_enb_id_coll, mme_config.max_s1_enbs, NULL,
+                        hash_free_int_func, bs4);
+  bdestroy_wrapper(&bs4);
+  if (!h) return RETURNerror;
+
+  bstring bs5 = bfromcstr("s1ap_tac_coll");
+  h = hashtable_ts_init(&g_s1ap_tac_coll, mme_config.max_s1_enbs, NULL,
+                        s1ap_free_tac_enbs, bs5);
+  bdestroy_wrapper(&bs5);
+  if (!h) return RETURNerror;
+
+  /*
+   * Tasks on the signalling path of the UEs: ask the eNBs to reject new mobile
+   * originated signalling when their queues fill up
+   */
+  itti_set_task_overload_watermarks(TASK_S1AP, S1AP_OVERLOAD_START_PERCENT,
+                                    S1AP_OVERLOAD_STOP_PERCENT);
+  itti_set_task_overload_watermarks(TASK_MME_APP, S1AP_OVERLOAD_START_PERCENT,
+                                    S1AP_OVERLOAD_STOP_PERCENT);
+  itti_set_task_overload_watermarks(TASK_S6A, S1AP_OVERLOAD_START_PERCENT,
+                                    S1AP_OVERLOAD_STOP_PERCENT);
+  itti_set_task_overload_watermarks(TASK_S11, S1AP_OVERLOAD_START_PERCENT,
+                                    S1AP_OVERLOAD_STOP_PERCENT);
+  // Backpressure on the eNBs, the other messages to S1AP overflow
+  itti_set_task_queue_full_policy(TASK_S1AP, SCTP_DATA_IND,
+                                  ITTI_QUEUE_FULL_BLOCK,
+                                  S1AP_SCTP_DATA_IND_BLOCK_TIMEOUT_MS);
+
   if (itti_create_task(TASK_S1AP, &s1ap_mme_thread, NULL) < 0) {
     OAILOG_ERROR(LOG_S1AP, "Error while creating S1AP task\n");
     return RETURNerror;
   }
 
+  /*
+   * The overload is checked after each message handled by S1AP: also check it
+   * periodically, the Overload Stop is otherwise delayed until the next S1AP
+   * message
+   */
+  if (timer_setup(S1AP_OVERLOAD_CHECK_TIMER, 0, TASK_S1AP, INSTANCE_DEFAULT,
+                  TIMER_PERIODIC, NULL, &s1ap_overload_timer_id) < 0) {
+    OAILOG_ERROR(LOG_S1AP,
+                 "Failed to request new timer for overload check with %ds "
+                 "of periodicity\n",
+                 S1AP_OVERLOAD_CHECK_TIMER);
+    s1ap_overload_timer_id = 0;
+  }
+
   OAILOG_DEBUG(LOG_S1AP,
                "Initializing S1AP interface: DONE, but not reachable yet (wait "
                "for MME<->HSS CER procedure)\n");
@@ -426,6 +622,11 @@ int s1ap_mme_init(void) {
 void s1ap_mme_exit(void) {
   OAILOG_DEBUG(LOG_S1AP, "Cleaning S1AP\n");
 
+  if (s1ap_overload_timer_id) {
+    timer_remove(s1ap_overload_timer_id, NULL);
+    s1ap_overload_timer_id = 0;
+  }
+
   if (hashtable_ts_destroy(&g_s1ap_enb_coll) != HASH_TABLE_OK) {
     OAILOG_ERROR(LOG_S1AP,
                  "An error occured while destroying s1 eNB hash table. \n");
@@ -434,6 +635,13 @@ void s1ap_mme_exit(void) {
     OAILOG_ERROR(LOG_S1AP,
                  "An error occured while destroying assoc_id hash table. \n");
   }
+  // Indexes last, eNB removal updates them
+  if ((hashtable_ts_destroy(&g_s1ap_mme_ue_id_coll) != HASH_TABLE_OK) ||
+      (hashtable_ts_destroy(&g_s1ap_enb_id_coll) != HASH_TABLE_OK) ||
+      (hashtable_ts_destroy(&g_s1ap_tac_coll) != HASH_TABLE_OK)) {
+    OAILOG_ERROR(LOG_S1AP,
+                 "An error occured while destroying S1AP index hash tables. \n");
+  }
   OAILOG_DEBUG(LOG_S1AP, "Cleaning S1AP: DONE\n");
 }
 
@@ -528,33 +736,68 @@ bool s1ap_enb_compare_by_enb_id_cb(__attribute__((unused))
 //------------------------------------------------------------------------------
 enb_description_t *s1ap_is_enb_id_in_list(const uint32_t enb_id) {
   enb_description_t *enb_ref = NULL;
-  uint32_t *enb_id_p = (uint32_t *)&enb_id;
-  hashtable_ts_apply_callback_on_elements(
-      (hash_table_ts_t *const) & g_s1ap_enb_coll, s1ap_enb_compare_by_enb_id_cb,
-      (void *)enb_id_p, (void **)&enb_ref);
+  hashtable_ts_get(&g_s1ap_enb_id_coll, (const hash_key_t)enb_id,
+                   (void **)&enb_ref);
   return enb_ref;
 }
 
 //------------------------------------------------------------------------------
 void s1ap_is_tac_in_list(const tac_t tac, int *num_enbs,
                          enb_description_t **enbs) {
-  enb_description_t *enb_ref = NULL;
-  tac_t *tac_p = (tac_t *)&tac;
+  s1ap_tac_enbs_t *tac_enbs = NULL;
 
   /** Collect all eNBs for the given TAC. */
-  hashtable_element_array_t ea;
-  memset(&ea, 0, sizeof(hashtable_element_array_t));
-  ea.elements = enbs;
-
-  hashtable_ts_apply_list_callback_on_elements(
-      (hash_table_ts_t *const) & g_s1ap_enb_coll, s1ap_enb_compare_by_tac_cb,
-      (void *)tac_p, &ea);
+  *num_enbs = 0;
+  if (HASH_TABLE_OK == hashtable_ts_get(&g_s1ap_tac_coll,
+                                        (const hash_key_t)tac,
+                                        (void **)&tac_enbs)) {
+    for (uint32_t i = 0;
+         (i < tac_enbs->num_enbs) && (*num_enbs < mme_config.max_s1_enbs);
+         i++) {
+      enbs[(*num_enbs)++] = tac_enbs->enbs[i];
+    }
+  }
   OAILOG_DEBUG(
       LOG_S1AP,
       "Found %d matching enb references based on the received tac " TAC_FMT
       ". \n",
-      ea.num_elements, tac);
-  *num_enbs = ea.num_elements;
+      *num_enbs, tac);
+}
+
+//------------------------------------------------------------------------------
+void s1ap_update_tac_paging_stats(const tac_t tac) {
+  s1ap_tac_enbs_t *tac_enbs = NULL;
+
+  if (HASH_TABLE_OK == hashtable_ts_get(&g_s1ap_tac_coll,
+                                        (const hash_key_t)tac,
+                                        (void **)&tac_enbs)) {
+    __sync_fetch_and_add(&tac_enbs->nb_paging, 1);
+    __sync_fetch_and_add(&tac_enbs->nb_paging_since_last_stat, 1);
+  }
+}
+
+//------------------------------------------------------------------------------
+static bool s1ap_display_tac_paging_stats_cb(const hash_key_t keyP,
+                                             void *const elementP,
+                                             void __attribute__((unused)) *
+                                                 parameterP,
+                                             void __attribute__((unused)) *
+                                                 *resultP) {
+  s1ap_tac_enbs_t *tac_enbs = (s1ap_tac_enbs_t *)elementP;
+
+  OAILOG_DEBUG(LOG_S1AP,
+               "TAC " TAC_FMT " | %4u eNBs | %10u pagings since last display "
+               "| %10" PRIu64 " pagings\n",
+               (tac_t)keyP, tac_enbs->num_enbs,
+               __sync_fetch_and_and(&tac_enbs->nb_paging_since_last_stat, 0),
+               tac_enbs->nb_paging);
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void s1ap_display_tac_paging_stats(void) {
+  hashtable_ts_apply_callback_on_elements(
+      &g_s1ap_tac_coll, s1ap_display_tac_paging_stats_cb, NULL, NULL);
 }
 
 //------------------------------------------------------------------------------
@@ -603,95 +846,46 @@ ue_description_t *s1ap_is_enb_ue_s1ap_id_in_list_per_enb(
   return s1ap_is_ue_enb_id_in_list(enb_ref, enb_ue_s1ap_id);
 }
 
-//------------------------------------------------------------------------------
-bool s1ap_ue_compare_by_mme_ue_id_cb(__attribute__((unused))
-                                     const hash_key_t keyP,
-                                     void *const elementP, void *parameterP,
-                                     void **resultP) {
-  mme_ue_s1ap_id_t *mme_ue_s1ap_id_p = (mme_ue_s1ap_id_t *)parameterP;
-  ue_description_t *ue_ref = (ue_description_t *)elementP;
-  if (*mme_ue_s1ap_id_p == ue_ref->mme_ue_s1ap_id) {
-    *resultP = elementP;
-    OAILOG_TRACE(LOG_S1AP,
-                 "Found ue_ref %p mme_ue_s1ap_id " MME_UE_S1AP_ID_FMT "\n",
-                 ue_ref, ue_ref->mme_ue_s1ap_id);
-    return true;
-  }
-  return false;
-}
-
-//------------------------------------------------------------------------------
-bool s1ap_enb_find_ue_by_mme_ue_id_cb(__attribute__((unused))
-                                      const hash_key_t keyP,
-                                      void *const elementP, void *parameterP,
-                                      void **resultP) {
-  enb_description_t *enb_ref = (enb_description_t *)elementP;
-
-  hashtable_ts_apply_callback_on_elements(
-      (hash_table_ts_t *const) & enb_ref->ue_coll,
-      s1ap_ue_compare_by_mme_ue_id_cb, parameterP, resultP);
-  if (*resultP) {
-    OAILOG_TRACE(LOG_S1AP,
-                 "Found ue_ref %p mme_ue_s1ap_id " MME_UE_S1AP_ID_FMT "\n",
-                 *resultP, ((ue_description_t *)(*resultP))->mme_ue_s1ap_id);
-    return true;
-  }
-  return false;
-}
-
-//------------------------------------------------------------------------------
-bool s1ap_ue_compare_by_s11_sgw_teid_cb(__attribute__((unused))
-                                        const hash_key_t keyP,
-                                        void *const elementP, void *parameterP,
-                                        void **resultP) {
-  s11_teid_t *s11_sgw_teid_p = (s11_teid_t *)parameterP;
-  ue_description_t *ue_ref = (ue_description_t *)elementP;
-  if (*s11_sgw_teid_p == ue_ref->s11_sgw_teid) {
-    *resultP = elementP;
-    return true;
-  }
-  return false;
-}
-
-//------------------------------------------------------------------------------
-bool s1ap_enb_find_ue_by_s11_sgw_teid_cb(__attribute((unused))
-                                         const hash_key_t keyP,
-                                         void *const elementP, void *parameterP,
-                                         void **resultP) {
-  enb_description_t *enb_ref = (enb_description_t *)elementP;
-
-  hashtable_ts_apply_callback_on_elements(
-      (hash_table_ts_t *const) & enb_ref->ue_coll,
-      s1ap_ue_compare_by_s11_sgw_teid_cb, parameterP, resultP);
-  if (*resultP) {
-    return true;
-  }
-  return false;
-}
-
 //------------------------------------------------------------------------------
 ue_description_t *s1ap_is_ue_mme_id_in_list(
     const mme_ue_s1ap_id_t mme_ue_s1ap_id) {
   ue_description_t *ue_ref = NULL;
-  mme_ue_s1ap_id_t *mme_ue_s1ap_id_p = (mme_ue_s1ap_id_t *)&mme_ue_s1ap_id;
 
-  hashtable_ts_apply_callback_on_elements(
-      &g_s1ap_enb_coll, s1ap_enb_find_ue_by_mme_ue_id_cb,
-      (void *)mme_ue_s1ap_id_p, (void **)&ue_ref);
+  hashtable_ts_get(&g_s1ap_mme_ue_id_coll, (const hash_key_t)mme_ue_s1ap_id,
+                   (void **)&ue_ref);
   //  OAILOG_TRACE(LOG_S1AP, "Return ue_ref %p \n", ue_ref);
   return ue_ref;
 }
 
 //------------------------------------------------------------------------------
-// TODO(amar) unused function check with OAI.
-ue_description_t *s1ap_is_s11_sgw_teid_in_list(const s11_teid_t teid) {
-  ue_description_t *ue_ref = NULL;
-  s11_teid_t *teid_id_p = (s11_teid_t *)&teid;
+void s1ap_set_enb_id(enb_description_t *enb_ref, const uint32_t enb_id) {
+  s1ap_unindex(&g_s1ap_enb_id_coll, (const hash_key_t)enb_ref->enb_id,
+               enb_ref);
+  enb_ref->enb_id = enb_id;
+  hashtable_ts_insert(&g_s1ap_enb_id_coll, (const hash_key_t)enb_id,
+                      (void *)enb_ref);
+}
 
-  hashtable_ts_apply_callback_on_elements(&g_s1ap_enb_coll,
-                                          s1ap_enb_find_ue_by_s11_sgw_teid_cb,
-                                          (void *)teid_id_p, (void **)&ue_ref);
-  return ue_ref;
+//------------------------------------------------------------------------------
+void s1ap_set_ue_mme_ue_s1ap_id(ue_description_t *ue_ref,
+                                const mme_ue_s1ap_id_t mme_ue_s1ap_id) {
+  ue_description_t *indexed = NULL;
+
+  s1ap_unindex_ue_mme_ue_s1ap_id(ue_ref);
+  ue_ref->mme_ue_s1ap_id = mme_ue_s1ap_id;
+  if (INVALID_MME_UE_S1AP_ID != mme_ue_s1ap_id) {
+    /*
+     * During S1 handover the source and target UE descriptions share the
+     * mme_ue_s1ap_id, the last associated one is referenced.
+     */
+    if (HASH_TABLE_OK == hashtable_ts_get(&g_s1ap_mme_ue_id_coll,
+                                          (const hash_key_t)mme_ue_s1ap_id,
+                                          (void **)&indexed)) {
+      ue_ref->next_same_mme_ue_s1ap_id = indexed;
+    }
+    hashtable_ts_insert(&g_s1ap_mme_ue_id_coll,
+                        (const hash_key_t)mme_ue_s1ap_id, (void *)ue_ref);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -706,7 +900,7 @@ void s1ap_notified_new_ue_mme_s1ap_id_association(
     ue_description_t *ue_ref =
         s1ap_is_ue_enb_id_in_list(enb_ref, enb_ue_s1ap_id);
     if (ue_ref) {
-      ue_ref->mme_ue_s1ap_id = mme_ue_s1ap_id;
+      s1ap_set_ue_mme_ue_s1ap_id(ue_ref, mme_ue_s1ap_id);
       hashtable_rc_t h_rc = hashtable_ts_insert(
           &g_s1ap_mme_id2assoc_id_coll, (const hash_key_t)mme_ue_s1ap_id,
           (void *)(uintptr_t)sctp_assoc_id);
@@ -794,8 +988,11 @@ void s1ap_set_tai(enb_description_t *enb_ref, S1AP_SupportedTAs_t *ta_list) {
   S1AP_PLMNidentity_t *plmn_i = NULL;
   tac_t tac_value = 0;
 
+  // The TACs of a previous S1 Setup are replaced
+  s1ap_unindex_enb_tacs(enb_ref);
+  enb_ref->tai_list.partial_tai_list[0].numberofelements = 0;
+
   /** Get the PLMN. */
-  ta = ta_list->list.array[0];
   plmn_i = ta_list->list.array[0]->broadcastPLMNs.list.array[0];
   enb_ref->tai_list.partial_tai_list[0].typeoflist =
       TRACKING_AREA_IDENTITY_LIST_ONE_PLMN_NON_CONSECUTIVE_TACS;
@@ -803,10 +1000,12 @@ void s1ap_set_tai(enb_description_t *enb_ref, S1AP_SupportedTAs_t *ta_list) {
                               .u.tai_one_plmn_non_consecutive_tacs.plmn);
 
   for (int i = 0; i < ta_list->list.count && i < 3; i++) {
+    ta = ta_list->list.array[i];
     OCTET_STRING_TO_TAC(&ta->tAC, tac_value);
     enb_ref->tai_list.partial_tai_list[0]
         .u.tai_one_plmn_non_consecutive_tacs.tac[i] = tac_value;
     enb_ref->tai_list.partial_tai_list[0].numberofelements++;
+    s1ap_index_enb_tac(enb_ref, tac_value);
   }
 }
 
@@ -860,6 +1059,7 @@ void s1ap_remove_ue(ue_description_t *ue_ref) {
                ue_ref->enb_ue_s1ap_id, ue_ref->mme_ue_s1ap_id, enb_ref->enb_id);
 
   ue_ref->s1_ue_state = S1AP_UE_INVALID_STATE;
+  s1ap_unindex_ue(ue_ref);
   hashtable_ts_free(&enb_ref->ue_coll, ue_ref->enb_ue_s1ap_id);
 
   /** We will try to remove the SCTP association too, but it will anyways be set
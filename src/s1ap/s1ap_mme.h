@@ -38,6 +38,15 @@ struct enb_description_s;
 #define S1AP_UE_CONTEXT_REL_COMP_TIMER 1  // in seconds
 #define S1AP_HANDOVER_COMPLETION_TIMER 2  // in seconds
 
+// ITTI queue depths (percent of queue size) driving S1AP Overload Start/Stop
+#define S1AP_OVERLOAD_START_PERCENT 75
+#define S1AP_OVERLOAD_STOP_PERCENT 50
+// Max wait of the SCTP task for room in the S1AP queue, then the message is
+// dropped; SCTP stops reading the eNB associations meanwhile
+#define S1AP_SCTP_DATA_IND_BLOCK_TIMEOUT_MS 100
+// Period of the overload re-check while S1AP has no message to handle
+#define S1AP_OVERLOAD_CHECK_TIMER 1  // in seconds
+
 /* Timer structure */
 struct s1ap_timer_t {
   long id;  /* The timer identifier                 */
@@ -89,6 +98,10 @@ typedef struct ue_description_s {
 
   s11_teid_t s11_sgw_teid;
 
+  /* Older UE description with the same mme_ue_s1ap_id (S1 handover source),
+   * chained from the indexed one */
+  struct ue_description_s* next_same_mme_ue_s1ap_id;
+
   /* Timer for procedure outcome issued by MME that should be answered */
   long outcome_response_timer_id;
 
@@ -158,6 +171,14 @@ enb_description_t* s1ap_is_enb_id_in_list(const uint32_t enb_id);
 void s1ap_is_tac_in_list(const tac_t tac, int* num_enbs,
                          enb_description_t** enbs);
 
+/** \brief Count a paging request sent to the eNBs of the given TAC.
+ **/
+void s1ap_update_tac_paging_stats(const tac_t tac);
+
+/** \brief Display (and reset) the per TAC paging counters.
+ **/
+void s1ap_display_tac_paging_stats(void);
+
 /** \brief Look for given eNB SCTP assoc id in the list
  * \param enb_id The unique sctp assoc id to search in list
  * @returns NULL if no eNB matchs the sctp assoc id, or reference to the eNB
@@ -180,7 +201,20 @@ ue_description_t* s1ap_is_ue_enb_id_in_list(
  *in list if matches
  **/
 ue_description_t* s1ap_is_ue_mme_id_in_list(const mme_ue_s1ap_id_t ue_mme_id);
-ue_description_t* s1ap_is_s11_sgw_teid_in_list(const s11_teid_t teid);
+
+/** \brief Set the eNB id of an eNB description and index it
+ * \param enb_ref eNB structure reference
+ * \param enb_id The unique eNB id signaled in S1 Setup Request
+ **/
+void s1ap_set_enb_id(enb_description_t* enb_ref, const uint32_t enb_id);
+
+/** \brief Set the mme_ue_s1ap_id of an UE description and index it
+ * (INVALID_MME_UE_S1AP_ID is not indexed). The last UE description associated
+ * to an mme_ue_s1ap_id is the one looked up, the others sharing it take over
+ * when it is removed.
+ **/
+void s1ap_set_ue_mme_ue_s1ap_id(ue_description_t* ue_ref,
+                                const mme_ue_s1ap_id_t mme_ue_s1ap_id);
 
 /** \brief Look for given ue enb s1ap id in the list of UEs for a particular
  *enb. \param enb_id The unique ue_enb_id to search in list
@@ -56,6 +56,9 @@ extern hash_table_ts_t g_s1ap_enb_coll;  // contains eNB_description_s, key is
 static const char *const s1_enb_state_str[] = {"S1AP_INIT", "S1AP_RESETTING",
                                                "S1AP_READY", "S1AP_SHUTDOWN"};
 
+// Overload Start sent to the eNBs, only accessed by the S1AP task
+static bool s1ap_overload_started = false;
+
 static int s1ap_generate_s1_setup_response(enb_description_t *enb_association);
 
 static int s1ap_mme_generate_ue_context_release_command(
@@ -275,6 +278,119 @@ int s1ap_mme_generate_s1_setup_failure(const sctp_assoc_id_t assoc_id,
   OAILOG_FUNC_RETURN(LOG_S1AP, rc);
 }
 
+//------------------------------------------------------------------------------
+int s1ap_mme_generate_overload_start(const sctp_assoc_id_t assoc_id) {
+  uint8_t *buffer_p = 0;
+  uint32_t length = 0;
+  S1AP_S1AP_PDU_t pdu;
+  S1AP_OverloadStart_t *out;
+  S1AP_OverloadStartIEs_t *ie = NULL;
+  int rc = RETURNok;
+
+  OAILOG_FUNC_IN(LOG_S1AP);
+
+  memset(&pdu, 0, sizeof(pdu));
+  pdu.present = S1AP_S1AP_PDU_PR_initiatingMessage;
+  pdu.choice.initiatingMessage.procedureCode =
+      S1AP_ProcedureCode_id_OverloadStart;
+  pdu.choice.initiatingMessage.criticality = S1AP_Criticality_ignore;
+  pdu.choice.initiatingMessage.value.present =
+      S1AP_InitiatingMessage__value_PR_OverloadStart;
+  out = &pdu.choice.initiatingMessage.value.choice.OverloadStart;
+
+  /*
+   * Only non emergency mobile originated data transfers are rejected, the
+   * eNB still forwards emergency calls and mobile terminated traffic
+   */
+  ie = (S1AP_OverloadStartIEs_t *)calloc(1, sizeof(S1AP_OverloadStartIEs_t));
+  ie->id = S1AP_ProtocolIE_ID_id_OverloadResponse;
+  ie->criticality = S1AP_Criticality_reject;
+  ie->value.present = S1AP_OverloadStartIEs__value_PR_OverloadResponse;
+  ie->value.choice.OverloadResponse.present =
+      S1AP_OverloadResponse_PR_overloadAction;
+  ie->value.choice.OverloadResponse.choice.overloadAction =
+      S1AP_OverloadAction_reject_non_emergency_mo_dt;
+  ASN_SEQUENCE_ADD(&out->protocolIEs.list, ie);
+
+  if (s1ap_mme_encode_pdu(&pdu, &buffer_p, &length) < 0) {
+    OAILOG_ERROR(LOG_S1AP, "Failed to encode overload start\n");
+    OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
+  }
+
+  /*
+   * Non-UE signalling -> stream 0
+   */
+  bstring b = blk2bstr(buffer_p, length);
+  free(buffer_p);
+  rc = s1ap_mme_itti_send_sctp_request(&b, assoc_id, 0, INVALID_MME_UE_S1AP_ID);
+  OAILOG_FUNC_RETURN(LOG_S1AP, rc);
+}
+
+//------------------------------------------------------------------------------
+int s1ap_mme_generate_overload_stop(const sctp_assoc_id_t assoc_id) {
+  uint8_t *buffer_p = 0;
+  uint32_t length = 0;
+  S1AP_S1AP_PDU_t pdu;
+  int rc = RETURNok;
+
+  OAILOG_FUNC_IN(LOG_S1AP);
+
+  /*
+   * No IE: the overload stops for all the GUMMEIs of the MME
+   */
+  memset(&pdu, 0, sizeof(pdu));
+  pdu.present = S1AP_S1AP_PDU_PR_initiatingMessage;
+  pdu.choice.initiatingMessage.procedureCode =
+      S1AP_ProcedureCode_id_OverloadStop;
+  pdu.choice.initiatingMessage.criticality = S1AP_Criticality_reject;
+  pdu.choice.initiatingMessage.value.present =
+      S1AP_InitiatingMessage__value_PR_OverloadStop;
+
+  if (s1ap_mme_encode_pdu(&pdu, &buffer_p, &length) < 0) {
+    OAILOG_ERROR(LOG_S1AP, "Failed to encode overload stop\n");
+    OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
+  }
+
+  bstring b = blk2bstr(buffer_p, length);
+  free(buffer_p);
+  rc = s1ap_mme_itti_send_sctp_request(&b, assoc_id, 0, INVALID_MME_UE_S1AP_ID);
+  OAILOG_FUNC_RETURN(LOG_S1AP, rc);
+}
+
+//------------------------------------------------------------------------------
+static bool s1ap_send_enb_overload(__attribute__((unused))
+                                   const hash_key_t keyP,
+                                   void *const dataP, void *argP,
+                                   __attribute__((unused)) void **resultP) {
+  enb_description_t *enb_ref = (enb_description_t *)dataP;
+  bool is_overloaded = *(bool *)argP;
+
+  if ((enb_ref) && (S1AP_READY == enb_ref->s1_state)) {
+    if (is_overloaded) {
+      s1ap_mme_generate_overload_start(enb_ref->sctp_assoc_id);
+    } else {
+      s1ap_mme_generate_overload_stop(enb_ref->sctp_assoc_id);
+    }
+  }
+  // Go through all the eNBs
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void s1ap_mme_check_overload(void) {
+  bool is_overloaded = itti_is_overloaded();
+
+  if (is_overloaded == s1ap_overload_started) {
+    return;
+  }
+  s1ap_overload_started = is_overloaded;
+  OAILOG_WARNING(LOG_S1AP, "MME overload %s, notifying the eNBs\n",
+                 (is_overloaded) ? "started" : "stopped");
+  hashtable_ts_apply_callback_on_elements(&g_s1ap_enb_coll,
+                                          s1ap_send_enb_overload,
+                                          (void *)&is_overloaded, NULL);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //************************** Management procedures ***************************//
 ////////////////////////////////////////////////////////////////////////////////
@@ -436,7 +552,7 @@ int s1ap_mme_handle_s1_setup_request(const sctp_assoc_id_t assoc_id,
         enb_association->s1_state = S1AP_RESETING;
         OAILOG_DEBUG(LOG_S1AP, "Adding eNB id %u to the list of served eNBs\n",
                      enb_id);
-        enb_association->enb_id = enb_id;
+        s1ap_set_enb_id(enb_association, enb_id);
 
         S1AP_FIND_PROTOCOLIE_BY_ID(S1AP_S1SetupRequestIEs_t, ie, container,
                                    S1AP_ProtocolIE_ID_id_DefaultPagingDRX,
@@ -516,7 +632,7 @@ int s1ap_mme_handle_s1_setup_request(const sctp_assoc_id_t assoc_id,
 }
 //------------------------------------------------------------------------------
 static int s1ap_generate_s1_setup_response(enb_description_t *enb_association) {
-  int i, j;
+  int i;
   S1AP_S1AP_PDU_t pdu;
   S1AP_S1SetupResponse_t *out;
   S1AP_S1SetupResponseIEs_t *ie = NULL;
@@ -552,30 +668,20 @@ static int s1ap_generate_s1_setup_response(enb_description_t *enb_association) {
    * Use the gummei parameters provided by configuration
    * that should be sorted
    */
-  for (i = 0; i < mme_config.served_tai.nb_tai; i++) {
-    bool plmn_added = false;
-    for (j = 0; j < i; j++) {
-      if ((mme_config.served_tai.plmn_mcc[j] ==
-           mme_config.served_tai.plmn_mcc[i]) &&
-          (mme_config.served_tai.plmn_mnc[j] ==
-           mme_config.served_tai.plmn_mnc[i]) &&
-          (mme_config.served_tai.plmn_mnc_len[j] ==
-           mme_config.served_tai.plmn_mnc_len[i])) {
-        plmn_added = true;
-        break;
-      }
-    }
-    if (false == plmn_added) {
+  {
+    mme_config_snapshot_t *snapshot = mme_config_snapshot_get();
+
+    for (i = 0; i < snapshot->nb_plmn; i++) {
       S1AP_PLMNidentity_t *plmn = NULL;
       /*
        * FIXME: free object from list once encoded
        */
       plmn = calloc(1, sizeof(*plmn));
-      MCC_MNC_TO_PLMNID(mme_config.served_tai.plmn_mcc[i],
-                        mme_config.served_tai.plmn_mnc[i],
-                        mme_config.served_tai.plmn_mnc_len[i], plmn);
+      MCC_MNC_TO_PLMNID(snapshot->plmn[i].mcc, snapshot->plmn[i].mnc,
+                        snapshot->plmn[i].mnc_len, plmn);
       ASN_SEQUENCE_ADD(&servedGUMMEI->servedPLMNs.list, plmn);
     }
+    mme_config_snapshot_put(snapshot);
   }
 
   for (i = 0; i < mme_config.gummei.nb; i++) {
@@ -630,6 +736,11 @@ static int s1ap_generate_s1_setup_response(enb_description_t *enb_association) {
   free(buffer);
   rc = s1ap_mme_itti_send_sctp_request(&b, enb_association->sctp_assoc_id, 0,
                                        INVALID_MME_UE_S1AP_ID);
+  if ((RETURNok == rc) && (s1ap_overload_started) &&
+      (S1AP_READY == enb_association->s1_state)) {
+    // The eNB missed the overload start sent to the other eNBs
+    s1ap_mme_generate_overload_start(enb_association->sctp_assoc_id);
+  }
   OAILOG_FUNC_RETURN(LOG_S1AP, rc);
 }
 
@@ -1581,7 +1692,7 @@ int s1ap_mme_handle_path_switch_request(__attribute__((unused))
 
     ue_ref_p->enb_ue_s1ap_id = enb_ue_s1ap_id;
     // Will be allocated by NAS
-    ue_ref_p->mme_ue_s1ap_id = mme_ue_s1ap_id;
+    s1ap_set_ue_mme_ue_s1ap_id(ue_ref_p, mme_ue_s1ap_id);
 
     ue_ref_p->s1ap_ue_context_rel_timer.id = S1AP_TIMER_INACTIVE_ID;
     ue_ref_p->s1ap_ue_context_rel_timer.sec = S1AP_UE_CONTEXT_REL_COMP_TIMER;
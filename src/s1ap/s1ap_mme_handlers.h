@@ -90,6 +90,15 @@ int s1ap_mme_generate_s1_setup_failure(const sctp_assoc_id_t assoc_id,
                                        const long cause_value,
                                        const long time_to_wait);
 
+int s1ap_mme_generate_overload_start(const sctp_assoc_id_t assoc_id);
+
+int s1ap_mme_generate_overload_stop(const sctp_assoc_id_t assoc_id);
+
+/** \brief Send Overload Start/Stop to the ready eNBs when the ITTI queues of
+ * the MME tasks cross their overload watermarks.
+ **/
+void s1ap_mme_check_overload(void);
+
 /*** HANDLING EXPIRED TIMERS. */
 void s1ap_mme_handle_ue_context_rel_comp_timer_expiry(void* ue_ref_p);
 
@@ -30,6 +30,7 @@
 #include "bstrlib.h"
 
 #include "assertions.h"
+#include "dynamic_memory_check.h"
 #include "intertask_interface.h"
 #include "log.h"
 #include "s1ap_common.h"
@@ -52,6 +53,23 @@ int s1ap_mme_itti_send_sctp_request(STOLEN_REF bstring *payload,
   return itti_send_msg_to_task(TASK_SCTP, INSTANCE_DEFAULT, message_p);
 }
 
+//------------------------------------------------------------------------------
+int s1ap_mme_itti_send_sctp_request_shared(shared_bstring_t *payload,
+                                           const sctp_assoc_id_t assoc_id,
+                                           const sctp_stream_id_t stream,
+                                           const mme_ue_s1ap_id_t ue_id) {
+  MessageDef *message_p = NULL;
+
+  message_p = itti_alloc_new_message(TASK_S1AP, SCTP_DATA_REQ);
+
+  SCTP_DATA_REQ(message_p).payload = NULL;
+  SCTP_DATA_REQ(message_p).shared_payload = shared_bstring_ref(payload);
+  SCTP_DATA_REQ(message_p).assoc_id = assoc_id;
+  SCTP_DATA_REQ(message_p).stream = stream;
+  SCTP_DATA_REQ(message_p).mme_ue_s1ap_id = ue_id;
+  return itti_send_msg_to_task(TASK_SCTP, INSTANCE_DEFAULT, message_p);
+}
+
 //------------------------------------------------------------------------------
 int s1ap_mme_itti_nas_uplink_ind(const mme_ue_s1ap_id_t ue_id,
                                  STOLEN_REF bstring *payload,
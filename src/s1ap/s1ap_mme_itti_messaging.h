@@ -26,12 +26,19 @@
 #define FILE_S1AP_MME_ITTI_MESSAGING_SEEN
 
 #include "common_defs.h"
+#include "dynamic_memory_check.h"
 
 int s1ap_mme_itti_send_sctp_request(STOLEN_REF bstring* payload,
                                     const uint32_t sctp_assoc_id_t,
                                     const sctp_stream_id_t stream,
                                     const mme_ue_s1ap_id_t ue_id);
 
+/* Send a payload shared with other SCTP requests, takes a new reference */
+int s1ap_mme_itti_send_sctp_request_shared(shared_bstring_t* payload,
+                                           const sctp_assoc_id_t assoc_id,
+                                           const sctp_stream_id_t stream,
+                                           const mme_ue_s1ap_id_t ue_id);
+
 int s1ap_mme_itti_nas_uplink_ind(const mme_ue_s1ap_id_t ue_id,
                                  STOLEN_REF bstring* payload,
                                  const tai_t* const tai,
@@ -2684,137 +2684,122 @@ void s1ap_handle_paging(const itti_s1ap_paging_t *const s1ap_paging_pP) {
     OAILOG_FUNC_OUT(LOG_S1AP);
   }
 
-  for (int i = 0; i < num_enbs; i++) {
-    if ((eNB_ref = enb_p_elements[i])) {
-      /** Trigger a paging signal to the target eNB. */
-      /** Just create the message and send it without creating a S1AP UE
-       * reference. */
-
-      S1AP_S1AP_PDU_t pdu = {0};
-      S1AP_Paging_t *out = NULL;
-      S1AP_PagingIEs_t *ie = NULL;
-
-      memset(&pdu, 0, sizeof(pdu));
-      pdu.present = S1AP_S1AP_PDU_PR_initiatingMessage;
-      pdu.choice.initiatingMessage.procedureCode = S1AP_ProcedureCode_id_Paging;
-      pdu.choice.initiatingMessage.criticality = S1AP_Criticality_ignore;
-      pdu.choice.initiatingMessage.value.present =
-          S1AP_InitiatingMessage__value_PR_Paging;
-      out = &pdu.choice.initiatingMessage.value.choice.Paging;
-
-      /** Encode and set the UE Identity Index Value. */
-      ie = (S1AP_PagingIEs_t *)calloc(1, sizeof(S1AP_PagingIEs_t));
-      ie->id = S1AP_ProtocolIE_ID_id_UEIdentityIndexValue;
-      ie->criticality = S1AP_Criticality_ignore;
-      ie->value.present = S1AP_PagingIEs__value_PR_UEIdentityIndexValue;
-      ie->value.choice.UEIdentityIndexValue.buf = calloc(2, sizeof(uint8_t));
-      uint16_t index_val = htons(s1ap_paging_pP->ue_identity_index << 6);
-      memcpy(ie->value.choice.UEIdentityIndexValue.buf, (uint8_t *)&index_val,
-             2);
-      ie->value.choice.UEIdentityIndexValue.size = 2;
-      ie->value.choice.UEIdentityIndexValue.bits_unused = 6;
-      ASN_SEQUENCE_ADD(&out->protocolIEs.list, ie);
+  /*
+   * The Paging PDU is the same for all eNBs of the TAC, encode it once and
+   * share the buffer between the SCTP requests.
+   */
+  eNB_ref = enb_p_elements[0];
+  S1AP_S1AP_PDU_t pdu = {0};
+  S1AP_Paging_t *out = NULL;
+  S1AP_PagingIEs_t *ie = NULL;
 
-      /** Set the UE Paging Identity . */
-      ie = (S1AP_PagingIEs_t *)calloc(1, sizeof(S1AP_PagingIEs_t));
-      ie->id = S1AP_ProtocolIE_ID_id_UEPagingID;
-      ie->criticality = S1AP_Criticality_ignore;
-      ie->value.present = S1AP_PagingIEs__value_PR_UEPagingID;
-      ie->value.choice.UEPagingID.present = S1AP_UEPagingID_PR_s_TMSI;
-      INT32_TO_OCTET_STRING(s1ap_paging_pP->tmsi,
-                            &ie->value.choice.UEPagingID.choice.s_TMSI.m_TMSI);
-      // todo: chose the right gummei or get it from the request!
-      INT8_TO_OCTET_STRING(mme_config.gummei.gummei[0].mme_code,
-                           &ie->value.choice.UEPagingID.choice.s_TMSI.mMEC);
-      ASN_SEQUENCE_ADD(&out->protocolIEs.list, ie);
+  memset(&pdu, 0, sizeof(pdu));
+  pdu.present = S1AP_S1AP_PDU_PR_initiatingMessage;
+  pdu.choice.initiatingMessage.procedureCode = S1AP_ProcedureCode_id_Paging;
+  pdu.choice.initiatingMessage.criticality = S1AP_Criticality_ignore;
+  pdu.choice.initiatingMessage.value.present =
+      S1AP_InitiatingMessage__value_PR_Paging;
+  out = &pdu.choice.initiatingMessage.value.choice.Paging;
 
-      /** Encode the CN Domain. */
-      ie = (S1AP_PagingIEs_t *)calloc(1, sizeof(S1AP_PagingIEs_t));
-      ie->id = S1AP_ProtocolIE_ID_id_CNDomain;
-      ie->criticality = S1AP_Criticality_ignore;
-      ie->value.present = S1AP_PagingIEs__value_PR_CNDomain;
-      ie->value.choice.CNDomain = S1AP_CNDomain_ps;
-      ASN_SEQUENCE_ADD(&out->protocolIEs.list, ie);
+  /** Encode and set the UE Identity Index Value. */
+  ie = (S1AP_PagingIEs_t *)calloc(1, sizeof(S1AP_PagingIEs_t));
+  ie->id = S1AP_ProtocolIE_ID_id_UEIdentityIndexValue;
+  ie->criticality = S1AP_Criticality_ignore;
+  ie->value.present = S1AP_PagingIEs__value_PR_UEIdentityIndexValue;
+  ie->value.choice.UEIdentityIndexValue.buf = calloc(2, sizeof(uint8_t));
+  uint16_t index_val = htons(s1ap_paging_pP->ue_identity_index << 6);
+  memcpy(ie->value.choice.UEIdentityIndexValue.buf, (uint8_t *)&index_val, 2);
+  ie->value.choice.UEIdentityIndexValue.size = 2;
+  ie->value.choice.UEIdentityIndexValue.bits_unused = 6;
+  ASN_SEQUENCE_ADD(&out->protocolIEs.list, ie);
 
-      /** Set the TAI-List. */
-      uint8_t plmn[3] = {0x00, 0x00, 0x00};  //{ 0x02, 0xF8, 0x29 };
-      ie = (S1AP_PagingIEs_t *)calloc(1, sizeof(S1AP_PagingIEs_t));
-      ie->id = S1AP_ProtocolIE_ID_id_TAIList;
-      ie->criticality = S1AP_Criticality_ignore;
-      ie->value.present = S1AP_PagingIEs__value_PR_TAIList;
-      ASN_SEQUENCE_ADD(&out->protocolIEs.list, ie);
-      S1AP_TAIList_t *const tai_list = &ie->value.choice.TAIList;
-      PLMN_T_TO_TBCD(
+  /** Set the UE Paging Identity . */
+  ie = (S1AP_PagingIEs_t *)calloc(1, sizeof(S1AP_PagingIEs_t));
+  ie->id = S1AP_ProtocolIE_ID_id_UEPagingID;
+  ie->criticality = S1AP_Criticality_ignore;
+  ie->value.present = S1AP_PagingIEs__value_PR_UEPagingID;
+  ie->value.choice.UEPagingID.present = S1AP_UEPagingID_PR_s_TMSI;
+  INT32_TO_OCTET_STRING(s1ap_paging_pP->tmsi,
+                        &ie->value.choice.UEPagingID.choice.s_TMSI.m_TMSI);
+  // todo: chose the right gummei or get it from the request!
+  INT8_TO_OCTET_STRING(mme_config.gummei.gummei[0].mme_code,
+                       &ie->value.choice.UEPagingID.choice.s_TMSI.mMEC);
+  ASN_SEQUENCE_ADD(&out->protocolIEs.list, ie);
+
+  /** Encode the CN Domain. */
+  ie = (S1AP_PagingIEs_t *)calloc(1, sizeof(S1AP_PagingIEs_t));
+  ie->id = S1AP_ProtocolIE_ID_id_CNDomain;
+  ie->criticality = S1AP_Criticality_ignore;
+  ie->value.present = S1AP_PagingIEs__value_PR_CNDomain;
+  ie->value.choice.CNDomain = S1AP_CNDomain_ps;
+  ASN_SEQUENCE_ADD(&out->protocolIEs.list, ie);
+
+  /** Set the TAI-List: the paged TAC, served by all the target eNBs. */
+  uint8_t plmn[3] = {0x00, 0x00, 0x00};  //{ 0x02, 0xF8, 0x29 };
+  ie = (S1AP_PagingIEs_t *)calloc(1, sizeof(S1AP_PagingIEs_t));
+  ie->id = S1AP_ProtocolIE_ID_id_TAIList;
+  ie->criticality = S1AP_Criticality_ignore;
+  ie->value.present = S1AP_PagingIEs__value_PR_TAIList;
+  ASN_SEQUENCE_ADD(&out->protocolIEs.list, ie);
+  S1AP_TAIList_t *const tai_list = &ie->value.choice.TAIList;
+  PLMN_T_TO_TBCD(
+      eNB_ref->tai_list.partial_tai_list[0]
+          .u.tai_one_plmn_non_consecutive_tacs.plmn,
+      plmn,
+      mme_config_find_mnc_length(
           eNB_ref->tai_list.partial_tai_list[0]
-              .u.tai_one_plmn_non_consecutive_tacs.plmn,
-          plmn,
-          mme_config_find_mnc_length(
-              eNB_ref->tai_list.partial_tai_list[0]
-                  .u.tai_one_plmn_non_consecutive_tacs.plmn.mcc_digit1,
-              eNB_ref->tai_list.partial_tai_list[0]
-                  .u.tai_one_plmn_non_consecutive_tacs.plmn.mcc_digit2,
-              eNB_ref->tai_list.partial_tai_list[0]
-                  .u.tai_one_plmn_non_consecutive_tacs.plmn.mcc_digit3,
-              eNB_ref->tai_list.partial_tai_list[0]
-                  .u.tai_one_plmn_non_consecutive_tacs.plmn.mnc_digit1,
-              eNB_ref->tai_list.partial_tai_list[0]
-                  .u.tai_one_plmn_non_consecutive_tacs.plmn.mnc_digit2,
-              eNB_ref->tai_list.partial_tai_list[0]
-                  .u.tai_one_plmn_non_consecutive_tacs.plmn.mnc_digit3));
-
-      S1AP_TAIItemIEs_t *tai_item_ies = calloc(1, sizeof(S1AP_TAIItemIEs_t));
-      tai_item_ies->id = S1AP_ProtocolIE_ID_id_TAIItem;
-      tai_item_ies->criticality = S1AP_Criticality_ignore;
-      tai_item_ies->value.present = S1AP_TAIItemIEs__value_PR_TAIItem;
-      S1AP_TAIItem_t *tai_item = &tai_item_ies->value.choice.TAIItem;
-
-      OCTET_STRING_fromBuf(&tai_item->tAI.pLMNidentity, (const char *)plmn, 3);
-      INT16_TO_OCTET_STRING(eNB_ref->tai_list.partial_tai_list[0]
-                                .u.tai_one_plmn_non_consecutive_tacs.tac[0],
-                            &tai_item->tAI.tAC);
-      /** Set the TAI. */
-      ASN_SEQUENCE_ADD(&tai_list->list, tai_item_ies);
-
-      for (int ntac = 1;
-           ntac < eNB_ref->tai_list.partial_tai_list[0].numberofelements;
-           ntac++) {
-        tai_item_ies->id = S1AP_ProtocolIE_ID_id_TAIItem;
-        ie->criticality = S1AP_Criticality_ignore;
-        ie->value.present = S1AP_TAIItemIEs__value_PR_TAIItem;
-        S1AP_TAIItem_t *tai_item = &tai_item_ies->value.choice.TAIItem;
-
-        INT16_TO_OCTET_STRING(
-            eNB_ref->tai_list.partial_tai_list[0]
-                .u.tai_one_plmn_non_consecutive_tacs.tac[ntac],
-            &tai_item->tAI.tAC);
-        /** Set the TAI. */
-        ASN_SEQUENCE_ADD(&tai_list->list, tai_item);
-      }
+              .u.tai_one_plmn_non_consecutive_tacs.plmn.mcc_digit1,
+          eNB_ref->tai_list.partial_tai_list[0]
+              .u.tai_one_plmn_non_consecutive_tacs.plmn.mcc_digit2,
+          eNB_ref->tai_list.partial_tai_list[0]
+              .u.tai_one_plmn_non_consecutive_tacs.plmn.mcc_digit3,
+          eNB_ref->tai_list.partial_tai_list[0]
+              .u.tai_one_plmn_non_consecutive_tacs.plmn.mnc_digit1,
+          eNB_ref->tai_list.partial_tai_list[0]
+              .u.tai_one_plmn_non_consecutive_tacs.plmn.mnc_digit2,
+          eNB_ref->tai_list.partial_tai_list[0]
+              .u.tai_one_plmn_non_consecutive_tacs.plmn.mnc_digit3));
 
-      /** Encoding without allocating? */
-      if (s1ap_mme_encode_pdu(&pdu, &buffer_p, &length) < 0) {
-        OAILOG_ERROR(
-            LOG_S1AP,
-            "Failed to encode S1AP paging for enb# %d with tac " TAC_FMT
-            " for UE " MME_UE_S1AP_ID_FMT ".\n",
-            i, s1ap_paging_pP->tac, s1ap_paging_pP->mme_ue_s1ap_id);
-        // todo: in this case we will ignore this. no UE contex modification
-        // should occure
-        OAILOG_FUNC_OUT(LOG_S1AP);
-      }
+  S1AP_TAIItemIEs_t *tai_item_ies = calloc(1, sizeof(S1AP_TAIItemIEs_t));
+  tai_item_ies->id = S1AP_ProtocolIE_ID_id_TAIItem;
+  tai_item_ies->criticality = S1AP_Criticality_ignore;
+  tai_item_ies->value.present = S1AP_TAIItemIEs__value_PR_TAIItem;
+  S1AP_TAIItem_t *tai_item = &tai_item_ies->value.choice.TAIItem;
 
-      OAILOG_NOTICE(
-          LOG_S1AP,
-          "Send S1AP_PAGING message MME_UE_S1AP_ID = " MME_UE_S1AP_ID_FMT " \n",
-          (mme_ue_s1ap_id_t)s1ap_paging_pP->mme_ue_s1ap_id);
-
-      bstring b = blk2bstr(buffer_p, length);
-      free(buffer_p);
-      s1ap_mme_itti_send_sctp_request(&b, eNB_ref->sctp_assoc_id,
-                                      eNB_ref->next_sctp_stream,
-                                      s1ap_paging_pP->mme_ue_s1ap_id);
+  OCTET_STRING_fromBuf(&tai_item->tAI.pLMNidentity, (const char *)plmn, 3);
+  INT16_TO_OCTET_STRING(s1ap_paging_pP->tac, &tai_item->tAI.tAC);
+  /** Set the TAI. */
+  ASN_SEQUENCE_ADD(&tai_list->list, tai_item_ies);
+
+  if (s1ap_mme_encode_pdu(&pdu, &buffer_p, &length) < 0) {
+    OAILOG_ERROR(LOG_S1AP,
+                 "Failed to encode S1AP paging with tac " TAC_FMT
+                 " for UE " MME_UE_S1AP_ID_FMT ".\n",
+                 s1ap_paging_pP->tac, s1ap_paging_pP->mme_ue_s1ap_id);
+    // todo: in this case we will ignore this. no UE contex modification
+    // should occure
+    OAILOG_FUNC_OUT(LOG_S1AP);
+  }
+  bstring b = blk2bstr(buffer_p, length);
+  free(buffer_p);
+  shared_bstring_t *paging_payload = shared_bstring_create(&b);
+
+  s1ap_update_tac_paging_stats(s1ap_paging_pP->tac);
+  OAILOG_NOTICE(LOG_S1AP,
+                "Send S1AP_PAGING message MME_UE_S1AP_ID = " MME_UE_S1AP_ID_FMT
+                " to %d eNBs\n",
+                (mme_ue_s1ap_id_t)s1ap_paging_pP->mme_ue_s1ap_id, num_enbs);
+
+  for (int i = 0; i < num_enbs; i++) {
+    if ((eNB_ref = enb_p_elements[i])) {
+      /** Trigger a paging signal to the target eNB. */
+      /** Just send the message without creating a S1AP UE reference. */
+      s1ap_mme_itti_send_sctp_request_shared(
+          paging_payload, eNB_ref->sctp_assoc_id, eNB_ref->next_sctp_stream,
+          s1ap_paging_pP->mme_ue_s1ap_id);
     }
   }
+  shared_bstring_unref(&paging_payload);
   OAILOG_FUNC_OUT(LOG_S1AP);
 }
 
@@ -38,34 +38,20 @@
 #include "s1ap_mme_ta.h"
 
 static int s1ap_mme_compare_plmn(const S1AP_PLMNidentity_t *const plmn) {
-  int i = 0;
+  mme_config_snapshot_t *snapshot = NULL;
   uint16_t mcc = 0;
   uint16_t mnc = 0;
   uint16_t mnc_len = 0;
+  bool match = false;
 
   DevAssert(plmn != NULL);
   TBCD_TO_MCC_MNC(plmn, mcc, mnc, mnc_len);
-  mme_config_read_lock(&mme_config);
-
-  for (i = 0; i < mme_config.served_tai.nb_tai; i++) {
-    OAILOG_TRACE(
-        LOG_S1AP,
-        "Comparing plmn_mcc %d/%d, plmn_mnc %d/%d plmn_mnc_len %d/%d\n",
-        mme_config.served_tai.plmn_mcc[i], mcc,
-        mme_config.served_tai.plmn_mnc[i], mnc,
-        mme_config.served_tai.plmn_mnc_len[i], mnc_len);
-
-    if ((mme_config.served_tai.plmn_mcc[i] == mcc) &&
-        (mme_config.served_tai.plmn_mnc[i] == mnc) &&
-        (mme_config.served_tai.plmn_mnc_len[i] == mnc_len))
-      /*
-       * There is a matching plmn
-       */
-      return TA_LIST_AT_LEAST_ONE_MATCH;
-  }
-
-  mme_config_unlock(&mme_config);
-  return TA_LIST_NO_MATCH;
+  snapshot = mme_config_snapshot_get();
+  match = mme_config_snapshot_has_plmn(snapshot, mcc, mnc, mnc_len);
+  mme_config_snapshot_put(snapshot);
+  OAILOG_TRACE(LOG_S1AP, "plmn_mcc %d plmn_mnc %d plmn_mnc_len %d %s\n", mcc,
+               mnc, mnc_len, match ? "served" : "not served");
+  return match ? TA_LIST_AT_LEAST_ONE_MATCH : TA_LIST_NO_MATCH;
 }
 
 /* @brief compare a list of broadcasted plmns against the MME configured.
@@ -93,23 +79,18 @@ static int s1ap_mme_compare_plmns(S1AP_BPLMNs_t *b_plmns) {
 /* @brief compare a TAC
  */
 static int s1ap_mme_compare_tac(const S1AP_TAC_t *const tac) {
-  int i = 0;
+  mme_config_snapshot_t *snapshot = NULL;
   uint16_t tac_value = 0;
+  bool match = false;
 
   DevAssert(tac != NULL);
   OCTET_STRING_TO_TAC(tac, tac_value);
-  mme_config_read_lock(&mme_config);
-
-  for (i = 0; i < mme_config.served_tai.nb_tai; i++) {
-    OAILOG_TRACE(LOG_S1AP, "Comparing config tac %d, received tac = %d\n",
-                 mme_config.served_tai.tac[i], tac_value);
-
-    if (mme_config.served_tai.tac[i] == tac_value)
-      return TA_LIST_AT_LEAST_ONE_MATCH;
-  }
-
-  mme_config_unlock(&mme_config);
-  return TA_LIST_NO_MATCH;
+  snapshot = mme_config_snapshot_get();
+  match = mme_config_snapshot_has_tac(snapshot, tac_value);
+  mme_config_snapshot_put(snapshot);
+  OAILOG_TRACE(LOG_S1AP, "tac %d %s\n", tac_value,
+               match ? "served" : "not served");
+  return match ? TA_LIST_AT_LEAST_ONE_MATCH : TA_LIST_NO_MATCH;
 }
 
 /* @brief compare a given ta list against the one provided by mme configuration.
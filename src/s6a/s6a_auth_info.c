@@ -293,72 +293,22 @@ err:
   return RETURNok;
 }
 
-int s6a_generate_authentication_info_req(s6a_auth_info_req_t *air_p) {
+int s6a_build_authentication_info_req(const s6a_auth_info_req_t *const air_p,
+                                      struct msg **msg_p) {
   struct avp *avp;
   struct msg *msg;
-  struct session *sess;
   union avp_value value;
 
   DevAssert(air_p);
   /*
-   * Create the new update location request message
+   * Create the new authentication information request message
    */
   CHECK_FCT(fd_msg_new(s6a_fd_cnf.dataobj_s6a_air, 0, &msg));
+  *msg_p = msg;
   /*
-   * Create a new session
-   */
-  CHECK_FCT(fd_sess_new(&sess, fd_g_config->cnf_diamid,
-                        fd_g_config->cnf_diamid_len, (os0_t) "apps6a", 6));
-  {
-    os0_t sid;
-    size_t sidlen;
-
-    CHECK_FCT(fd_sess_getsid(sess, &sid, &sidlen));
-    CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_session_id, 0, &avp));
-    value.os.data = sid;
-    value.os.len = sidlen;
-    CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
-    CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_FIRST_CHILD, avp));
-  }
-  CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_auth_session_state, 0, &avp));
-  /*
-   * No State maintained
+   * Session-Id, Auth-Session-State, Origin and Destination Host & Realm
    */
-  value.i32 = 1;
-  CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
-  CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
-  /*
-   * Add Origin_Host & Origin_Realm
-   */
-  CHECK_FCT(fd_msg_add_origin(msg, 0));
-  mme_config_read_lock(&mme_config);
-  /*
-   * Destination Host
-   */
-  {
-    bstring host = bstrcpy(mme_config.s6a_config.hss_host_name);
-
-    bconchar(host, '.');
-    bconcat(host, mme_config.realm);
-    CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_destination_host, 0, &avp));
-    value.os.data = (unsigned char *)bdata(host);
-    value.os.len = blength(host);
-    CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
-    CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
-    bdestroy_wrapper(&host);
-  }
-  /*
-   * Destination_Realm
-   */
-  {
-    CHECK_FCT(
-        fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_destination_realm, 0, &avp));
-    value.os.data = (unsigned char *)bdata(mme_config.realm);
-    value.os.len = blength(mme_config.realm);
-    CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
-    CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
-  }
-  mme_config_unlock(&mme_config);
+  CHECK_FCT(s6a_add_request_avps(msg));
   /*
    * Adding the User-Name (IMSI)
    */
@@ -370,24 +320,7 @@ int s6a_generate_authentication_info_req(s6a_auth_info_req_t *air_p) {
   /*
    * Adding the visited plmn id
    */
-  {
-    uint8_t plmn[3] = {0x00, 0x00, 0x00};  //{ 0x02, 0xF8, 0x29 };
-    CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_visited_plmn_id, 0, &avp));
-    PLMN_T_TO_TBCD(
-        air_p->visited_plmn, plmn,
-        mme_config_find_mnc_length(
-            air_p->visited_plmn.mcc_digit1, air_p->visited_plmn.mcc_digit2,
-            air_p->visited_plmn.mcc_digit3, air_p->visited_plmn.mnc_digit1,
-            air_p->visited_plmn.mnc_digit2, air_p->visited_plmn.mnc_digit3));
-    value.os.data = plmn;
-    value.os.len = 3;
-    CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
-    CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
-    OAILOG_DEBUG(LOG_S6A, "%s plmn: %02X%02X%02X\n", __FUNCTION__, plmn[0],
-                 plmn[1], plmn[2]);
-    OAILOG_DEBUG(LOG_S6A, "%s visited_plmn: %02X%02X%02X\n", __FUNCTION__,
-                 value.os.data[0], value.os.data[1], value.os.data[2]);
-  }
+  CHECK_FCT(s6a_add_visited_plmn_id(msg, &air_p->visited_plmn));
   /*
    * Adding the requested E-UTRAN authentication info AVP
    */
@@ -423,13 +356,24 @@ int s6a_generate_authentication_info_req(s6a_auth_info_req_t *air_p) {
       CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_re_synchronization_info,
                                0, &child_avp));
       value.os.len = RESYNC_PARAM_LENGTH;
-      value.os.data = air_p->auts;
+      value.os.data = (uint8_t *)air_p->auts;
       CHECK_FCT(fd_msg_avp_setvalue(child_avp, &value));
       CHECK_FCT(fd_msg_avp_add(avp, MSG_BRW_LAST_CHILD, child_avp));
     }
 
     CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
   }
+  return RETURNok;
+}
+
+int s6a_generate_authentication_info_req(s6a_auth_info_req_t *air_p) {
+  struct msg *msg = NULL;
+  int rc = s6a_build_authentication_info_req(air_p, &msg);
+
+  if (rc) {
+    if (msg) fd_msg_free(msg);
+    return rc;
+  }
   CHECK_FCT(fd_msg_send(&msg, NULL, NULL));
   return RETURNok;
 }
@@ -15,7 +15,13 @@
  *      contact@openairinterface.org
  */
 
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
 #include "assertions.h"
+#include "common_defs.h"
 #include "conversions.h"
 #include "intertask_interface.h"
 #include "log.h"
@@ -24,6 +30,36 @@
 #include "s6a_defs.h"
 #include "s6a_messages.h"
 
+#define S6A_SESSION_ID_MAX_LENGTH 256
+
+/*
+ * Values shared by the requests of the MME, set up once the dictionary is
+ * loaded. The MME keeps no state on its S6A sessions: the Session-Id
+ * (RFC 6733 8.8, <DiameterIdentity>;<high 32 bits>;<low 32 bits>;apps6a) is
+ * generated here rather than registering a freeDiameter session per request.
+ */
+typedef struct s6a_request_template_s {
+  uint32_t session_id_high;
+  uint32_t session_id_low;
+  /* Visited-PLMN-Id of the MME (first GUMMEI) */
+  uint8_t mme_visited_plmn[3];
+} s6a_request_template_t;
+
+static s6a_request_template_t s6a_template = {0};
+
+int s6a_fd_init_templates(void) {
+  plmn_t plmn_mme = mme_config.gummei.gummei[0].plmn;
+
+  s6a_template.session_id_high = (uint32_t)time(NULL);
+  s6a_template.session_id_low = 0;
+  PLMN_T_TO_TBCD(
+      plmn_mme, s6a_template.mme_visited_plmn,
+      mme_config_find_mnc_length(plmn_mme.mcc_digit1, plmn_mme.mcc_digit2,
+                                 plmn_mme.mcc_digit3, plmn_mme.mnc_digit1,
+                                 plmn_mme.mnc_digit2, plmn_mme.mnc_digit3));
+  return RETURNok;
+}
+
 int s6a_add_result_code_mme(struct msg *ans, struct avp *failed_avp,
                             int result_code, int experimental) {
   struct avp *avp;
@@ -59,3 +95,93 @@ int s6a_add_result_code_mme(struct msg *ans, struct avp *failed_avp,
 
   return 0;
 }
+
+/*
+ * Destination-Host and Destination-Realm of the HSS, taken from the
+ * configuration snapshot where the host name is already built.
+ */
+int s6a_add_destination(struct msg *msg) {
+  mme_config_snapshot_t *snapshot = mme_config_snapshot_get();
+  struct avp *avp = NULL;
+  union avp_value value;
+  int rc = 0;
+
+  if (snapshot->s6a_destination_host) {
+    rc = fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_destination_host, 0, &avp);
+    if (!rc) {
+      value.os.data = (unsigned char *)bdata(snapshot->s6a_destination_host);
+      value.os.len = blength(snapshot->s6a_destination_host);
+      rc = fd_msg_avp_setvalue(avp, &value);
+    }
+    if (!rc) rc = fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp);
+  }
+  if (!rc) {
+    rc = fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_destination_realm, 0, &avp);
+  }
+  if (!rc) {
+    value.os.data = (unsigned char *)bdata(snapshot->realm);
+    value.os.len = blength(snapshot->realm);
+    rc = fd_msg_avp_setvalue(avp, &value);
+  }
+  if (!rc) rc = fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp);
+  mme_config_snapshot_put(snapshot);
+  return rc;
+}
+
+/*
+ * AVPs every request of the MME starts with: Session-Id, Auth-Session-State,
+ * Origin-Host/Realm and Destination-Host/Realm.
+ */
+int s6a_add_request_avps(struct msg *msg) {
+  struct avp *avp = NULL;
+  union avp_value value;
+  char sid[S6A_SESSION_ID_MAX_LENGTH];
+  int sid_len = 0;
+
+  sid_len = snprintf(
+      sid, sizeof(sid), "%.*s;%u;%u;apps6a", (int)fd_g_config->cnf_diamid_len,
+      fd_g_config->cnf_diamid, s6a_template.session_id_high,
+      __atomic_add_fetch(&s6a_template.session_id_low, 1, __ATOMIC_RELAXED));
+  if ((sid_len < 0) || ((size_t)sid_len >= sizeof(sid))) {
+    return ENAMETOOLONG;
+  }
+  CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_session_id, 0, &avp));
+  value.os.data = (unsigned char *)sid;
+  value.os.len = sid_len;
+  CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
+  CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_FIRST_CHILD, avp));
+  /*
+   * No State maintained
+   */
+  CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_auth_session_state, 0, &avp));
+  value.i32 = 1;
+  CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
+  CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
+  CHECK_FCT(fd_msg_add_origin(msg, 0));
+  return s6a_add_destination(msg);
+}
+
+/* Visited-PLMN-Id of plmn, or of the MME if plmn is NULL */
+int s6a_add_visited_plmn_id(struct msg *msg, const plmn_t *const plmn) {
+  struct avp *avp = NULL;
+  union avp_value value;
+  uint8_t tbcd[3] = {0};
+
+  if (plmn) {
+    PLMN_T_TO_TBCD(
+        (*plmn), tbcd,
+        mme_config_find_mnc_length(plmn->mcc_digit1, plmn->mcc_digit2,
+                                   plmn->mcc_digit3, plmn->mnc_digit1,
+                                   plmn->mnc_digit2, plmn->mnc_digit3));
+    value.os.data = tbcd;
+  } else {
+    value.os.data = s6a_template.mme_visited_plmn;
+  }
+  value.os.len = 3;
+  CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_visited_plmn_id, 0, &avp));
+  CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
+  CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
+  OAILOG_DEBUG(LOG_S6A, "visited plmn: %02X%02X%02X\n", value.os.data[0],
+               value.os.data[1], value.os.data[2]);
+  return 0;
+}
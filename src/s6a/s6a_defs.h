@@ -243,6 +243,8 @@ void s6a_peer_connected_cb(struct peer_info* info, void* arg);
 
 int s6a_fd_init_dict_objs(void);
 
+int s6a_fd_init_templates(void);
+
 int s6a_parse_subscription_data(struct avp* avp_subscription_data,
                                 subscription_data_t* subscription_data);
 
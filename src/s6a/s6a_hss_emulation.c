@@ -0,0 +1,383 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file s6a_hss_emulation.c
+ * \brief Built-in HSS for load testing the MME without Diameter peer: the
+ * S6A task answers the AIR and ULR itself for the subscribers of a file.
+ * Vectors are computed with the MILENAGE engine, a batch of them in advance
+ * per subscriber if HSS_EMULATION_PREGENERATED_VECTORS is set.
+ *
+ * Subscriber file, one line per subscriber, '#' starts a comment:
+ *   IMSI K OPc SQN AMF [APN]
+ * K, OPc (32 digits) and AMF (4 digits) in hexadecimal, SQN in decimal or
+ * hexadecimal with 0x, SQN is the next one to be used.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+
+#include "bstrlib.h"
+
+#include "assertions.h"
+#include "common_defs.h"
+#include "common_types.h"
+#include "conversions.h"
+#include "dynamic_memory_check.h"
+#include "hashtable.h"
+#include "intertask_interface.h"
+#include "log.h"
+#include "milenage.h"
+#include "mme_config.h"
+#include "msc.h"
+#include "s6a_defs.h"
+#include "s6a_messages.h"
+
+/* SEQ is incremented per vector, IND on 5 bits (33.102 C.3.2) */
+#define HSS_EMULATION_SQN_STEP 32
+#define HSS_EMULATION_DEFAULT_APN "oai.ipv4"
+#define HSS_EMULATION_LINE_MAX 256
+
+typedef struct hss_emulation_subscriber_s {
+  imsi64_t imsi64;
+  milenage_ctx_t milenage;
+  uint8_t amf[MILENAGE_AMF_LENGTH];
+  uint64_t sqn; /* SQN of the next vector generated */
+  char apn[SERVICE_SELECTION_MAX_LENGTH];
+  /* Vectors generated in advance, vectors[next_vector] is the next one */
+  milenage_vector_t *vectors;
+  unsigned nb_vectors;
+  unsigned next_vector;
+} hss_emulation_subscriber_t;
+
+static hash_table_t *g_hss_emulation_subscribers = NULL;
+static unsigned g_hss_emulation_pregenerated = 0;
+
+//------------------------------------------------------------------------------
+static void s6a_hss_emulation_free_subscriber(void **data) {
+  hss_emulation_subscriber_t *subscriber = (hss_emulation_subscriber_t *)*data;
+
+  if (subscriber) {
+    free_wrapper((void **)&subscriber->vectors);
+  }
+  free_wrapper(data);
+}
+
+//------------------------------------------------------------------------------
+static void s6a_hss_emulation_rand(uint8_t *buf, size_t len) {
+  while (len) {
+    ssize_t n = getrandom(buf, len, 0);
+
+    if (n < 0) {
+      if (EINTR == errno) continue;
+      // No entropy source, a load test does not need more than random()
+      for (size_t i = 0; i < len; i++) buf[i] = (uint8_t)random();
+      return;
+    }
+    buf += n;
+    len -= n;
+  }
+}
+
+//------------------------------------------------------------------------------
+static void s6a_hss_emulation_generate(
+    hss_emulation_subscriber_t *const subscriber,
+    milenage_vector_t *const vectors, const unsigned nb_vectors) {
+  for (unsigned v = 0; v < nb_vectors; v++) {
+    s6a_hss_emulation_rand(vectors[v].rand, MILENAGE_RAND_LENGTH);
+  }
+  milenage_generate_vectors(&subscriber->milenage, subscriber->amf,
+                            subscriber->sqn, HSS_EMULATION_SQN_STEP, vectors,
+                            nb_vectors);
+  subscriber->sqn = (subscriber->sqn + nb_vectors * HSS_EMULATION_SQN_STEP) &
+                    MILENAGE_SQN_MAX;
+}
+
+//------------------------------------------------------------------------------
+static void s6a_hss_emulation_next_vector(
+    hss_emulation_subscriber_t *const subscriber,
+    milenage_vector_t *const vector) {
+  if (!g_hss_emulation_pregenerated) {
+    s6a_hss_emulation_generate(subscriber, vector, 1);
+    return;
+  }
+  if (!subscriber->nb_vectors) {
+    s6a_hss_emulation_generate(subscriber, subscriber->vectors,
+                               g_hss_emulation_pregenerated);
+    subscriber->nb_vectors = g_hss_emulation_pregenerated;
+    subscriber->next_vector = 0;
+  }
+  *vector = subscriber->vectors[subscriber->next_vector++];
+  subscriber->nb_vectors--;
+}
+
+//------------------------------------------------------------------------------
+static hss_emulation_subscriber_t *s6a_hss_emulation_parse_subscriber(
+    const char *const line) {
+  char imsi[IMSI_BCD_DIGITS_MAX + 2] = {0};
+  char k[2 * MILENAGE_KEY_LENGTH + 2] = {0};
+  char opc[2 * MILENAGE_KEY_LENGTH + 2] = {0};
+  char sqn[24] = {0};
+  char amf[2 * MILENAGE_AMF_LENGTH + 2] = {0};
+  char apn[SERVICE_SELECTION_MAX_LENGTH] = {0};
+  uint8_t k_bin[MILENAGE_KEY_LENGTH];
+  uint8_t opc_bin[MILENAGE_KEY_LENGTH];
+  hss_emulation_subscriber_t *subscriber = NULL;
+  char *end = NULL;
+  int nb_fields = sscanf(line, "%16s %33s %33s %23s %5s %99s", imsi, k, opc,
+                         sqn, amf, apn);
+
+  if ((nb_fields < 5) || (strlen(imsi) > IMSI_BCD_DIGITS_MAX) ||
+      (strlen(k) != 2 * MILENAGE_KEY_LENGTH) ||
+      (strlen(opc) != 2 * MILENAGE_KEY_LENGTH) ||
+      (strlen(amf) != 2 * MILENAGE_AMF_LENGTH) || (!ascii_to_hex(k_bin, k)) ||
+      (!ascii_to_hex(opc_bin, opc))) {
+    return NULL;
+  }
+  subscriber = calloc(1, sizeof(hss_emulation_subscriber_t));
+  if ((!ascii_to_hex(subscriber->amf, amf)) ||
+      (1 != IMSI_STRING_TO_IMSI64(imsi, &subscriber->imsi64))) {
+    free_wrapper((void **)&subscriber);
+    return NULL;
+  }
+  subscriber->sqn = strtoull(sqn, &end, 0) & MILENAGE_SQN_MAX;
+  if (*end) {
+    free_wrapper((void **)&subscriber);
+    return NULL;
+  }
+  milenage_ctx_setup(&subscriber->milenage, k_bin, opc_bin);
+  strcpy(subscriber->apn, (nb_fields > 5) ? apn : HSS_EMULATION_DEFAULT_APN);
+  if (g_hss_emulation_pregenerated) {
+    subscriber->vectors =
+        calloc(g_hss_emulation_pregenerated, sizeof(milenage_vector_t));
+    s6a_hss_emulation_generate(subscriber, subscriber->vectors,
+                               g_hss_emulation_pregenerated);
+    subscriber->nb_vectors = g_hss_emulation_pregenerated;
+  }
+  return subscriber;
+}
+
+//------------------------------------------------------------------------------
+int s6a_hss_emulation_init(const mme_config_t *const mme_config_p) {
+  char line[HSS_EMULATION_LINE_MAX];
+  unsigned line_number = 0;
+  unsigned nb_subscribers = 0;
+  bstring name = NULL;
+  FILE *fp = fopen(bdata(mme_config_p->s6a_config.hss_emulation_file), "r");
+
+  if (!fp) {
+    OAILOG_ERROR(LOG_S6A, "Cannot open HSS emulation subscriber file %s\n",
+                 bdata(mme_config_p->s6a_config.hss_emulation_file));
+    return RETURNerror;
+  }
+  g_hss_emulation_pregenerated =
+      mme_config_p->s6a_config.hss_emulation_vectors;
+  name = bfromcstr("s6a_hss_emulation_subscribers");
+  g_hss_emulation_subscribers = hashtable_create(
+      mme_config_p->max_ues, NULL, s6a_hss_emulation_free_subscriber, name);
+  bdestroy_wrapper(&name);
+
+  while (fgets(line, sizeof(line), fp)) {
+    hss_emulation_subscriber_t *subscriber = NULL;
+    char *comment = strchr(line, '#');
+    char *first = line;
+
+    line_number++;
+    if (comment) *comment = '\0';
+    while ((' ' == *first) || ('\t' == *first)) first++;
+    if (('\0' == *first) || ('\n' == *first) || ('\r' == *first)) continue;
+
+    if (!(subscriber = s6a_hss_emulation_parse_subscriber(first))) {
+      OAILOG_ERROR(LOG_S6A, "HSS emulation subscriber file %s line %u: %s",
+                   bdata(mme_config_p->s6a_config.hss_emulation_file),
+                   line_number, line);
+      fclose(fp);
+      return RETURNerror;
+    }
+    if (HASH_TABLE_OK !=
+        hashtable_insert(g_hss_emulation_subscribers,
+                         (hash_key_t)subscriber->imsi64, subscriber)) {
+      OAILOG_WARNING(LOG_S6A,
+                     "HSS emulation: IMSI " IMSI_64_FMT
+                     " already defined, line %u ignored\n",
+                     subscriber->imsi64, line_number);
+      s6a_hss_emulation_free_subscriber((void **)&subscriber);
+      continue;
+    }
+    nb_subscribers++;
+  }
+  fclose(fp);
+  OAILOG_INFO(LOG_S6A,
+              "HSS emulation: %u subscribers, %u vectors generated in advance "
+              "per subscriber\n",
+              nb_subscribers, g_hss_emulation_pregenerated);
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+void s6a_hss_emulation_exit(void) {
+  if (g_hss_emulation_subscribers) {
+    hashtable_destroy(g_hss_emulation_subscribers);
+    g_hss_emulation_subscribers = NULL;
+  }
+}
+
+//------------------------------------------------------------------------------
+static hss_emulation_subscriber_t *s6a_hss_emulation_get_subscriber(
+    const char *const imsi) {
+  hss_emulation_subscriber_t *subscriber = NULL;
+  imsi64_t imsi64 = INVALID_IMSI64;
+
+  IMSI_STRING_TO_IMSI64(imsi, &imsi64);
+  hashtable_get(g_hss_emulation_subscribers, (hash_key_t)imsi64,
+                (void **)&subscriber);
+  return subscriber;
+}
+
+//------------------------------------------------------------------------------
+int s6a_hss_emulation_auth_info_req(const s6a_auth_info_req_t *const air_p) {
+  MessageDef *message_p = NULL;
+  s6a_auth_info_ans_t *aia_p = NULL;
+  hss_emulation_subscriber_t *subscriber = NULL;
+
+  DevAssert(air_p);
+  message_p = itti_alloc_new_message(TASK_S6A, S6A_AUTH_INFO_ANS);
+  aia_p = &message_p->ittiMsg.s6a_auth_info_ans;
+  strncpy(aia_p->imsi, air_p->imsi, IMSI_BCD_DIGITS_MAX);
+  aia_p->imsi_length = strlen(aia_p->imsi);
+
+  if (!(subscriber = s6a_hss_emulation_get_subscriber(air_p->imsi))) {
+    OAILOG_WARNING(LOG_S6A, "HSS emulation: unknown IMSI %s in AIR\n",
+                   air_p->imsi);
+    aia_p->result.present = S6A_RESULT_EXPERIMENTAL;
+    aia_p->result.choice.experimental = DIAMETER_ERROR_USER_UNKNOWN;
+  } else {
+    uint8_t sn_id[3] = {0};
+    unsigned nb_vectors = air_p->nb_of_vectors;
+
+    if (air_p->re_synchronization) {
+      uint64_t sqn_ms = 0;
+
+      // auts holds RAND || AUTS
+      if (milenage_resync(&subscriber->milenage, air_p->auts,
+                          &air_p->auts[RAND_LENGTH_OCTETS], &sqn_ms)) {
+        OAILOG_WARNING(LOG_S6A,
+                       "HSS emulation: wrong MAC-S in AUTS for IMSI %s\n",
+                       air_p->imsi);
+      } else {
+        OAILOG_DEBUG(LOG_S6A,
+                     "HSS emulation: IMSI %s re-synchronised on SQN_MS "
+                     "0x%012" PRIx64 "\n",
+                     air_p->imsi, sqn_ms);
+        subscriber->sqn = (sqn_ms + HSS_EMULATION_SQN_STEP) & MILENAGE_SQN_MAX;
+        // Vectors generated in advance are not fresh any more
+        subscriber->nb_vectors = 0;
+      }
+    }
+    PLMN_T_TO_TBCD(
+        air_p->visited_plmn, sn_id,
+        mme_config_find_mnc_length(
+            air_p->visited_plmn.mcc_digit1, air_p->visited_plmn.mcc_digit2,
+            air_p->visited_plmn.mcc_digit3, air_p->visited_plmn.mnc_digit1,
+            air_p->visited_plmn.mnc_digit2, air_p->visited_plmn.mnc_digit3));
+    if ((!nb_vectors) || (nb_vectors > MAX_EPS_AUTH_VECTORS)) {
+      nb_vectors = MAX_EPS_AUTH_VECTORS;
+    }
+    for (unsigned v = 0; v < nb_vectors; v++) {
+      eutran_vector_t *eutran_vector = &aia_p->auth_info.eutran_vector[v];
+      milenage_vector_t vector;
+
+      s6a_hss_emulation_next_vector(subscriber, &vector);
+      memcpy(eutran_vector->rand, vector.rand, RAND_LENGTH_OCTETS);
+      memcpy(eutran_vector->xres.data, vector.xres, MILENAGE_RES_LENGTH);
+      eutran_vector->xres.size = MILENAGE_RES_LENGTH;
+      memcpy(eutran_vector->autn, vector.autn, AUTN_LENGTH_OCTETS);
+      milenage_derive_kasme(&vector, sn_id, eutran_vector->kasme);
+    }
+    aia_p->auth_info.nb_of_vectors = nb_vectors;
+    aia_p->result.present = S6A_RESULT_BASE;
+    aia_p->result.choice.base = DIAMETER_SUCCESS;
+  }
+  MSC_LOG_TX_MESSAGE(MSC_S6A_MME, MSC_NAS_MME, NULL, 0,
+                     "0 S6A_AUTH_INFO_ANS imsi %s (HSS emulation)",
+                     aia_p->imsi);
+  return itti_send_msg_to_task(TASK_NAS_EMM, INSTANCE_DEFAULT, message_p);
+}
+
+//------------------------------------------------------------------------------
+int s6a_hss_emulation_update_location(
+    const s6a_update_location_req_t *const ulr_p) {
+  MessageDef *message_p = NULL;
+  s6a_update_location_ans_t *ula_p = NULL;
+  hss_emulation_subscriber_t *subscriber = NULL;
+
+  DevAssert(ulr_p);
+  message_p = itti_alloc_new_message(TASK_S6A, S6A_UPDATE_LOCATION_ANS);
+  ula_p = &message_p->ittiMsg.s6a_update_location_ans;
+  ula_p->ue_id = ulr_p->ue_id;
+  strncpy(ula_p->imsi, ulr_p->imsi, IMSI_BCD_DIGITS_MAX);
+  ula_p->imsi_length = strlen(ula_p->imsi);
+
+  if (!(subscriber = s6a_hss_emulation_get_subscriber(ulr_p->imsi))) {
+    OAILOG_WARNING(LOG_S6A, "HSS emulation: unknown IMSI %s in ULR\n",
+                   ulr_p->imsi);
+    ula_p->result.present = S6A_RESULT_EXPERIMENTAL;
+    ula_p->result.choice.experimental = DIAMETER_ERROR_USER_UNKNOWN;
+  } else {
+    ula_p->result.present = S6A_RESULT_BASE;
+    ula_p->result.choice.base = DIAMETER_SUCCESS;
+    if (!ulr_p->skip_subscriber_data) {
+      // One APN, dynamic IPv4 address, QCI 9
+      subscription_data_t *subscription_data =
+          calloc(1, sizeof(subscription_data_t));
+      apn_configuration_t *apn_configuration =
+          &subscription_data->apn_config_profile.apn_configuration[0];
+
+      subscription_data->subscriber_status = SS_SERVICE_GRANTED;
+      subscription_data->access_mode = NAM_ONLY_PACKET;
+      subscription_data->subscribed_ambr.br_ul = 50000000;
+      subscription_data->subscribed_ambr.br_dl = 100000000;
+      subscription_data->apn_config_profile.context_identifier = 1;
+      subscription_data->apn_config_profile.all_apn_conf_ind =
+          ALL_APN_CONFIGURATIONS_INCLUDED;
+      subscription_data->apn_config_profile.nb_apns = 1;
+      apn_configuration->context_identifier = 1;
+      apn_configuration->pdn_type = IPv4;
+      apn_configuration->service_selection_length =
+          strlen(subscriber->apn);
+      memcpy(apn_configuration->service_selection, subscriber->apn,
+             apn_configuration->service_selection_length);
+      apn_configuration->subscribed_qos.qci = QCI_9;
+      apn_configuration->subscribed_qos.allocation_retention_priority
+          .priority_level = 15;
+      apn_configuration->subscribed_qos.allocation_retention_priority
+          .pre_emp_vulnerability = PRE_EMPTION_VULNERABILITY_DISABLED;
+      apn_configuration->subscribed_qos.allocation_retention_priority
+          .pre_emp_capability = PRE_EMPTION_CAPABILITY_DISABLED;
+      apn_configuration->ambr = subscription_data->subscribed_ambr;
+      ula_p->subscription_data = subscription_data;
+    }
+  }
+  MSC_LOG_TX_MESSAGE(MSC_S6A_MME, MSC_MMEAPP_MME, NULL, 0,
+                     "0 S6A_UPDATE_LOCATION_ANS imsi %s (HSS emulation)",
+                     ula_p->imsi);
+  return itti_send_msg_to_task(TASK_MME_APP, INSTANCE_DEFAULT, message_p);
+}
@@ -22,6 +22,12 @@ int s6a_generate_update_location(s6a_update_location_req_t* ulr_p);
 int s6a_generate_authentication_info_req(s6a_auth_info_req_t* uar_p);
 int s6a_generate_notify_req(s6a_notify_req_t* uar_p);
 
+/* Request ready to be sent, freed by the caller on error */
+int s6a_build_update_location(const s6a_update_location_req_t* const ulr_p,
+                              struct msg** msg);
+int s6a_build_authentication_info_req(const s6a_auth_info_req_t* const air_p,
+                                      struct msg** msg);
+
 int s6a_ula_cb(struct msg** msg, struct avp* paramavp, struct session* sess,
                void* opaque, enum disp_action* act);
 int s6a_aia_cb(struct msg** msg, struct avp* paramavp, struct session* sess,
@@ -35,6 +41,16 @@ int s6a_na_cb(struct msg** msg, struct avp* paramavp, struct session* sess,
 
 int s6a_add_result_code_mme(struct msg* ans, struct avp* failed_avp,
                             int result_code, int experimental);
+int s6a_add_destination(struct msg* msg);
+int s6a_add_request_avps(struct msg* msg);
+int s6a_add_visited_plmn_id(struct msg* msg, const plmn_t* const plmn);
+
+/* Built-in HSS (S6A HSS_EMULATION_SUBSCRIBERS), no Diameter peer */
+int s6a_hss_emulation_init(const mme_config_t* const mme_config_p);
+void s6a_hss_emulation_exit(void);
+int s6a_hss_emulation_auth_info_req(const s6a_auth_info_req_t* const air_p);
+int s6a_hss_emulation_update_location(
+    const s6a_update_location_req_t* const ulr_p);
 
 int s6a_parse_subscription_data(struct avp* avp_subscription_data,
                                 subscription_data_t* subscription_data);
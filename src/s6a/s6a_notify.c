@@ -133,7 +133,6 @@ err:
 int s6a_generate_notify_req(s6a_notify_req_t *nr_p) {
   struct avp *avp;
   struct msg *msg;
-  struct session *sess;
   union avp_value value;
 
   DevAssert(nr_p);
@@ -142,60 +141,9 @@ int s6a_generate_notify_req(s6a_notify_req_t *nr_p) {
    */
   CHECK_FCT(fd_msg_new(s6a_fd_cnf.dataobj_s6a_nr, 0, &msg));
   /*
-   * Create a new session
+   * Session-Id, Auth-Session-State, Origin and Destination Host & Realm
    */
-  CHECK_FCT(fd_sess_new(&sess, fd_g_config->cnf_diamid,
-                        fd_g_config->cnf_diamid_len, (os0_t) "apps6a", 6));
-  {
-    os0_t sid;
-    size_t sidlen;
-
-    CHECK_FCT(fd_sess_getsid(sess, &sid, &sidlen));
-    CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_session_id, 0, &avp));
-    value.os.data = sid;
-    value.os.len = sidlen;
-    CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
-    CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_FIRST_CHILD, avp));
-  }
-  CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_auth_session_state, 0, &avp));
-  /*
-   * No State maintained
-   */
-  value.i32 = 1;
-  CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
-  CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
-  /*
-   * Add Origin_Host & Origin_Realm
-   */
-  CHECK_FCT(fd_msg_add_origin(msg, 0));
-  mme_config_read_lock(&mme_config);
-  /*
-   * Destination Host
-   */
-  {
-    bstring host = bstrcpy(mme_config.s6a_config.hss_host_name);
-
-    bconchar(host, '.');
-    bconcat(host, mme_config.realm);
-    CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_destination_host, 0, &avp));
-    value.os.data = (unsigned char *)bdata(host);
-    value.os.len = blength(host);
-    CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
-    CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
-    bdestroy_wrapper(&host);
-  }
-  /*
-   * Destination_Realm
-   */
-  {
-    CHECK_FCT(
-        fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_destination_realm, 0, &avp));
-    value.os.data = (unsigned char *)bdata(mme_config.realm);
-    value.os.len = blength(mme_config.realm);
-    CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
-    CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
-  }
-  mme_config_unlock(&mme_config);
+  CHECK_FCT(s6a_add_request_avps(msg));
   /*
    * Adding the User-Name (IMSI)
    */
@@ -206,30 +154,9 @@ int s6a_generate_notify_req(s6a_notify_req_t *nr_p) {
   CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
 
   /*
-   * Adding the visited plmn id
+   * Adding the visited plmn id, the one of the MME
    */
-  {
-    uint8_t plmn[3] = {0x00, 0x00, 0x00};  //{ 0x02, 0xF8, 0x29 };
-    plmn_t plmn_mme;
-
-    plmn_mme = mme_config.gummei.gummei[0].plmn;
-    CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_visited_plmn_id, 0, &avp));
-    PLMN_T_TO_TBCD(
-        plmn_mme, plmn,
-        mme_config_find_mnc_length(
-            nr_p->visited_plmn.mcc_digit1, nr_p->visited_plmn.mcc_digit2,
-            nr_p->visited_plmn.mcc_digit3, nr_p->visited_plmn.mnc_digit1,
-            nr_p->visited_plmn.mnc_digit2, nr_p->visited_plmn.mnc_digit3));
-    value.os.data = plmn;
-    value.os.len = 3;
-    CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
-    CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
-    OAILOG_DEBUG(LOG_S6A, "%s NR- new plmn: %02X%02X%02X\n", __FUNCTION__,
-                 plmn[0], plmn[1], plmn[2]);
-    OAILOG_DEBUG(LOG_S6A, "%s NR- new visited_plmn: %02X%02X%02X\n",
-                 __FUNCTION__, value.os.data[0], value.os.data[1],
-                 value.os.data[2]);
-  }
+  CHECK_FCT(s6a_add_visited_plmn_id(msg, NULL));
 
   /*
    * NOR Flags
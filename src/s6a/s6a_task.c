@@ -17,6 +17,7 @@
 
 #include <pthread.h>
 #include <signal.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -43,6 +44,8 @@
 
 static int gnutls_log_level = 9;
 static long timer_id = 0;
+// Requests answered by the built-in HSS, freeDiameter is not started
+static bool hss_emulation = false;
 struct session_handler *ts_sess_hdl;
 
 s6a_fd_cnf_t s6a_fd_cnf;
@@ -98,15 +101,28 @@ void *s6a_thread(void *args) {
 
     switch (ITTI_MSG_ID(received_message_p)) {
       case S6A_UPDATE_LOCATION_REQ: {
-        s6a_generate_update_location(
-            &received_message_p->ittiMsg.s6a_update_location_req);
+        if (hss_emulation) {
+          s6a_hss_emulation_update_location(
+              &received_message_p->ittiMsg.s6a_update_location_req);
+        } else {
+          s6a_generate_update_location(
+              &received_message_p->ittiMsg.s6a_update_location_req);
+        }
       } break;
       case S6A_AUTH_INFO_REQ: {
-        s6a_generate_authentication_info_req(
-            &received_message_p->ittiMsg.s6a_auth_info_req);
+        if (hss_emulation) {
+          s6a_hss_emulation_auth_info_req(
+              &received_message_p->ittiMsg.s6a_auth_info_req);
+        } else {
+          s6a_generate_authentication_info_req(
+              &received_message_p->ittiMsg.s6a_auth_info_req);
+        }
       } break;
       case S6A_NOTIFY_REQ: {
-        s6a_generate_notify_req(&received_message_p->ittiMsg.s6a_notify_req);
+        // No answer is expected by the MME
+        if (!hss_emulation) {
+          s6a_generate_notify_req(&received_message_p->ittiMsg.s6a_notify_req);
+        }
       } break;
       case TIMER_HAS_EXPIRED: {
         /*
@@ -152,6 +168,25 @@ int s6a_init(const mme_config_t *mme_config_p) {
 
   memset(&s6a_fd_cnf, 0, sizeof(s6a_fd_cnf_t));
 
+  if (mme_config_p->s6a_config.hss_emulation_file) {
+    MessageDef *message_p = NULL;
+
+    OAILOG_WARNING(LOG_S6A,
+                   "HSS emulation: S6a requests are answered by the MME\n");
+    if (RETURNok != s6a_hss_emulation_init(mme_config_p)) {
+      return RETURNerror;
+    }
+    hss_emulation = true;
+    if (itti_create_task(TASK_S6A, &s6a_thread, NULL) < 0) {
+      OAILOG_ERROR(LOG_S6A, "s6a create task\n");
+      return RETURNerror;
+    }
+    // As if the HSS peer were connected
+    message_p = itti_alloc_new_message(TASK_S6A, ACTIVATE_MESSAGE);
+    itti_send_msg_to_task(TASK_S1AP, INSTANCE_DEFAULT, message_p);
+    return RETURNok;
+  }
+
   /*
    * if (strcmp(fd_core_version(), free_wrapper_DIAMETER_MINIMUM_VERSION) ) {
    * S6A_ERROR("Freediameter version %s found, expecting %s\n",
@@ -241,6 +276,12 @@ int s6a_init(const mme_config_t *mme_config_p) {
     OAILOG_DEBUG(LOG_S6A, "s6a_fd_init_dict_objs done\n");
   }
 
+  ret = s6a_fd_init_templates();
+  if (ret) {
+    OAILOG_ERROR(LOG_S6A, "An error occurred during s6a_fd_init_templates.\n");
+    return ret;
+  }
+
   if (itti_create_task(TASK_S6A, &s6a_thread, NULL) < 0) {
     OAILOG_ERROR(LOG_S6A, "s6a create task\n");
     return RETURNerror;
@@ -256,6 +297,10 @@ int s6a_init(const mme_config_t *mme_config_p) {
 
 //------------------------------------------------------------------------------
 static void s6a_exit(void) {
+  if (hss_emulation) {
+    s6a_hss_emulation_exit();
+    return;
+  }
   if (timer_id) {
     timer_remove(timer_id, NULL);
   }
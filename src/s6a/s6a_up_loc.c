@@ -179,10 +179,10 @@ err:
   return RETURNok;
 }
 
-int s6a_generate_update_location(s6a_update_location_req_t *ulr_pP) {
+int s6a_build_update_location(const s6a_update_location_req_t *const ulr_pP,
+                              struct msg **msg_pP) {
   struct avp *avp_p = NULL;
   struct msg *msg_p = NULL;
-  struct session *sess_p = NULL;
   union avp_value value;
 
   DevAssert(ulr_pP);
@@ -190,64 +190,11 @@ int s6a_generate_update_location(s6a_update_location_req_t *ulr_pP) {
    * Create the new update location request message
    */
   CHECK_FCT(fd_msg_new(s6a_fd_cnf.dataobj_s6a_ulr, 0, &msg_p));
+  *msg_pP = msg_p;
   /*
-   * Create a new session
-   */
-  CHECK_FCT(fd_sess_new(&sess_p, fd_g_config->cnf_diamid,
-                        fd_g_config->cnf_diamid_len, (os0_t) "apps6a", 6));
-  {
-    os0_t sid;
-    size_t sidlen;
-
-    CHECK_FCT(fd_sess_getsid(sess_p, &sid, &sidlen));
-    CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_session_id, 0, &avp_p));
-    value.os.data = sid;
-    value.os.len = sidlen;
-    CHECK_FCT(fd_msg_avp_setvalue(avp_p, &value));
-    CHECK_FCT(fd_msg_avp_add(msg_p, MSG_BRW_FIRST_CHILD, avp_p));
-  }
-  CHECK_FCT(
-      fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_auth_session_state, 0, &avp_p));
-  /*
-   * No State maintained
-   */
-  value.i32 = 1;
-  CHECK_FCT(fd_msg_avp_setvalue(avp_p, &value));
-  CHECK_FCT(fd_msg_avp_add(msg_p, MSG_BRW_LAST_CHILD, avp_p));
-  /*
-   * Add Origin_Host & Origin_Realm
-   */
-  CHECK_FCT(fd_msg_add_origin(msg_p, 0));
-  mme_config_read_lock(&mme_config);
-  /*
-   * Destination Host
-   */
-  {
-    bstring host = bstrcpy(mme_config.s6a_config.hss_host_name);
-
-    bconchar(host, '.');
-    bconcat(host, mme_config.realm);
-
-    CHECK_FCT(
-        fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_destination_host, 0, &avp_p));
-    value.os.data = (unsigned char *)bdata(host);
-    value.os.len = blength(host);
-    CHECK_FCT(fd_msg_avp_setvalue(avp_p, &value));
-    CHECK_FCT(fd_msg_avp_add(msg_p, MSG_BRW_LAST_CHILD, avp_p));
-    bdestroy_wrapper(&host);
-  }
-  /*
-   * Destination_Realm
+   * Session-Id, Auth-Session-State, Origin and Destination Host & Realm
    */
-  {
-    CHECK_FCT(
-        fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_destination_realm, 0, &avp_p));
-    value.os.data = (unsigned char *)bdata(mme_config.realm);
-    value.os.len = blength(mme_config.realm);
-    CHECK_FCT(fd_msg_avp_setvalue(avp_p, &value));
-    CHECK_FCT(fd_msg_avp_add(msg_p, MSG_BRW_LAST_CHILD, avp_p));
-  }
-  mme_config_unlock(&mme_config);
+  CHECK_FCT(s6a_add_request_avps(msg_p));
   /*
    * Adding the User-Name (IMSI)
    */
@@ -257,25 +204,9 @@ int s6a_generate_update_location(s6a_update_location_req_t *ulr_pP) {
   CHECK_FCT(fd_msg_avp_setvalue(avp_p, &value));
   CHECK_FCT(fd_msg_avp_add(msg_p, MSG_BRW_LAST_CHILD, avp_p));
   /*
-   * Adding the visited plmn id
+   * Adding the visited plmn id, the one of the MME
    */
-  {
-    uint8_t plmn[3];
-    plmn_t plmn_mme;
-
-    plmn_mme = mme_config.gummei.gummei[0].plmn;
-    CHECK_FCT(
-        fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_visited_plmn_id, 0, &avp_p));
-    PLMN_T_TO_TBCD(
-        plmn_mme, plmn,
-        mme_config_find_mnc_length(plmn_mme.mcc_digit1, plmn_mme.mcc_digit2,
-                                   plmn_mme.mcc_digit3, plmn_mme.mnc_digit1,
-                                   plmn_mme.mnc_digit2, plmn_mme.mnc_digit3));
-    value.os.data = plmn;
-    value.os.len = 3;
-    CHECK_FCT(fd_msg_avp_setvalue(avp_p, &value));
-    CHECK_FCT(fd_msg_avp_add(msg_p, MSG_BRW_LAST_CHILD, avp_p));
-  }
+  CHECK_FCT(s6a_add_visited_plmn_id(msg_p, NULL));
   /*
    * Adding the RAT-Type
    */
@@ -307,11 +238,17 @@ int s6a_generate_update_location(s6a_update_location_req_t *ulr_pP) {
 
   CHECK_FCT(fd_msg_avp_setvalue(avp_p, &value));
   CHECK_FCT(fd_msg_avp_add(msg_p, MSG_BRW_LAST_CHILD, avp_p));
+  return RETURNok;
+}
 
-  struct avp *avp1_p = NULL;
-  CHECK_FCT(
-      fd_msg_search_avp(msg_p, s6a_fd_cnf.dataobj_s6a_ulr_flags, &avp1_p));
+int s6a_generate_update_location(s6a_update_location_req_t *ulr_pP) {
+  struct msg *msg_p = NULL;
+  int rc = s6a_build_update_location(ulr_pP, &msg_p);
 
+  if (rc) {
+    if (msg_p) fd_msg_free(msg_p);
+    return rc;
+  }
   CHECK_FCT(fd_msg_send(&msg_p, NULL, NULL));
   OAILOG_DEBUG(LOG_S6A, "Sending s6a ulr for imsi=%s\n", ulr_pP->imsi);
   return RETURNok;
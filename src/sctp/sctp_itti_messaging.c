@@ -25,6 +25,9 @@
 #include <stdbool.h>
 #include <string.h>
 
+#include "bstrlib.h"
+
+#include "dynamic_memory_check.h"
 #include "intertask_interface.h"
 #include "sctp_itti_messaging.h"
 
@@ -75,7 +78,13 @@ int sctp_itti_send_new_message_ind(STOLEN_REF bstring *payload,
     SCTP_DATA_IND(message_p).assoc_id = assoc_id;
     SCTP_DATA_IND(message_p).instreams = instreams;
     SCTP_DATA_IND(message_p).outstreams = outstreams;
-    return itti_send_msg_to_task(TASK_S1AP, INSTANCE_DEFAULT, message_p);
+    if (itti_send_msg_to_task(TASK_S1AP, INSTANCE_DEFAULT, message_p)) {
+      // S1AP queue full and not overflowing: the message is still ours
+      bdestroy_wrapper(&SCTP_DATA_IND(message_p).payload);
+      itti_free(ITTI_MSG_ORIGIN_ID(message_p), message_p);
+      return RETURNerror;
+    }
+    return RETURNok;
   }
   return RETURNerror;
 }
@@ -23,8 +23,11 @@
     @ingroup _sctp
 */
 
+#define _GNU_SOURCE  // recvmmsg, accept4
 #include <arpa/inet.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
 #include <netinet/in.h>
 #include <netinet/sctp.h>
 #include <pthread.h>
@@ -32,6 +35,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
@@ -41,6 +45,7 @@
 #include "common_defs.h"
 #include "conversions.h"
 #include "dynamic_memory_check.h"
+#include "hashtable.h"
 #include "intertask_interface.h"
 #include "itti_free_defined_msg.h"
 #include "log.h"
@@ -53,10 +58,32 @@
 #define SCTP_RC_NORMAL_READ 0
 #define SCTP_RC_DISCONNECT 1
 
+// Messages read by one recvmmsg() call on a socket
+#define SCTP_RECV_BATCH_SIZE 16
+// Payloads up to this size are received in the bstring handed to S1AP
+#define SCTP_RECV_INLINE_SIZE 4096
+#define SCTP_RECV_EPOLL_EVENTS 64
+#define SCTP_ASSOC_HTBL_SIZE 256
+
+// Messages written by one sendmmsg() call on a socket
+#define SCTP_SEND_BATCH_SIZE 16
+#define SCTP_SEND_QUEUE_INITIAL_SIZE 16  // power of 2
+/*
+ * Backpressure: SCTP_DATA_REQ are rejected with a failed SCTP_DATA_CNF when
+ * the send queue of their association reaches one of these
+ */
+#define SCTP_SEND_QUEUE_MAX_MSGS 1024  // power of 2
+#define SCTP_SEND_QUEUE_HIGH_WATERMARK (512 * 1024)  // bytes
+#define SCTP_SEND_EPOLL_EVENTS 64
+
+// Counters of an output stream of an association
+typedef struct sctp_stream_stats_s {
+  uint32_t messages_sent;
+  uint64_t bytes_sent;
+  uint32_t queue_depth;  ///< messages left in the send queue by last flush
+} sctp_stream_stats_t;
+
 typedef struct sctp_association_s {
-  struct sctp_association_s *next_assoc;  ///< Next association in the list
-  struct sctp_association_s
-      *previous_assoc;  ///< Previous association in the list
   int sd;               ///< Socket descriptor
   uint32_t ppid;        ///< Payload protocol Identifier
   uint16_t
@@ -66,46 +93,106 @@ typedef struct sctp_association_s {
   sctp_assoc_id_t assoc_id;  ///< SCTP association id for the connection
   uint32_t messages_recv;    ///< Number of messages received on this connection
   uint32_t messages_sent;    ///< Number of messages sent on this connection
+  uint64_t bytes_recv;       ///< Number of bytes received on this connection
+  uint64_t bytes_sent;       ///< Number of bytes sent on this connection
+  sctp_stream_stats_t *out_streams_stats;  ///< outstreams counters
 
   struct sockaddr *peer_addresses;  ///< A list of peer addresses
   int nb_peer_addresses;
 } sctp_association_t;
 
+// Socket monitored by a receiver thread
+typedef struct sctp_receiver_socket_s {
+  int sd;
+  uint32_t ppid;
+  bool is_listener;
+  sctp_assoc_id_t assoc_id;  ///< -1 until the association is up
+} sctp_receiver_socket_t;
+
+typedef struct sctp_receiver_s {
+  pthread_t thread;
+  int epoll_fd;
+
+  /*
+   * One recvmmsg() batch. The first iovec of a message is the data of a
+   * bstring passed to S1AP as it is, the second one receives the end of the
+   * rare payloads bigger than SCTP_RECV_INLINE_SIZE.
+   */
+  struct mmsghdr msgs[SCTP_RECV_BATCH_SIZE];
+  struct iovec iovs[SCTP_RECV_BATCH_SIZE][2];
+  struct sockaddr_in6 addrs[SCTP_RECV_BATCH_SIZE];
+  uint8_t cmsgs[SCTP_RECV_BATCH_SIZE]
+               [CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))];
+  bstring payloads[SCTP_RECV_BATCH_SIZE];
+  uint8_t *overflows[SCTP_RECV_BATCH_SIZE];
+} sctp_receiver_t;
+
+// SCTP_DATA_REQ waiting to be sent on an association
+typedef struct sctp_send_queue_s {
+  sctp_assoc_id_t assoc_id;
+  MessageDef **msgs;  ///< ring of SCTP_DATA_REQ, size is a power of 2
+  uint32_t size;
+  uint32_t head;
+  uint32_t count;
+  uint32_t bytes;
+  bool is_pending;  ///< in the list of queues flushed after the ITTI batch
+  bool is_polled;   ///< socket buffer full, flushed on EPOLLOUT
+  struct sctp_send_queue_s *next_pending;
+} sctp_send_queue_t;
+
+// Send side, only used by TASK_SCTP
+typedef struct sctp_sender_s {
+  int epoll_fd;          ///< sockets waiting for EPOLLOUT, monitored by ITTI
+  hash_table_t *queues;  ///< sctp_send_queue_t by assoc_id
+  sctp_send_queue_t *pending_head;
+
+  // One sendmmsg() batch
+  struct mmsghdr msgs[SCTP_SEND_BATCH_SIZE];
+  struct iovec iovs[SCTP_SEND_BATCH_SIZE];
+  uint8_t cmsgs[SCTP_SEND_BATCH_SIZE]
+               [CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))];
+} sctp_sender_t;
+
 typedef struct sctp_descriptor_s {
-  // List of connected peers
-  struct sctp_association_s *available_connections_head;
-  struct sctp_association_s *available_connections_tail;
+  /*
+   * Connected peers indexed by assoc_id, written by the receivers. Writers
+   * hold the lock only to link or unlink an association.
+   */
+  pthread_rwlock_t assoc_lock;
+  hash_table_t *associations;
 
   uint32_t number_of_connections;
   uint16_t nb_instreams;
   uint16_t nb_outstreams;
-} sctp_descriptor_t;
 
-typedef struct sctp_arg_s {
-  int sd;
-  uint32_t ppid;
-} sctp_arg_t;
+  // Associations are spread over the receivers, listeners are on the first
+  sctp_receiver_t *receivers;
+  uint32_t nb_receivers;
+  uint32_t next_receiver;
 
-static struct sctp_descriptor_s sctp_desc;
+  sctp_sender_t sender;
+} sctp_descriptor_t;
 
-// Thread used to handle sctp messages
-static pthread_t assoc_thread;
+static struct sctp_descriptor_s sctp_desc;
 
 // LOCAL FUNCTIONS prototypes
 void *sctp_receiver_thread(void *args_p);
-static int sctp_send_msg(sctp_assoc_id_t sctp_assoc_id, uint16_t stream,
-                         STOLEN_REF bstring *payload);
 
 // Association list related local functions prototypes
 static struct sctp_association_s *sctp_is_assoc_in_list(
     sctp_assoc_id_t assoc_id);
-static struct sctp_association_s *sctp_add_new_peer(void);
+static struct sctp_association_s *sctp_new_peer(sctp_assoc_id_t assoc_id,
+                                                uint16_t outstreams);
+static int sctp_add_peer(struct sctp_association_s *assoc_desc);
 static int sctp_handle_com_down(sctp_assoc_id_t assoc_id);
+static int sctp_receiver_add_socket(sctp_receiver_t *receiver,
+                                    sctp_receiver_socket_t *socket_p);
 static void sctp_dump_list(void);
 static void sctp_exit(void);
 
 //------------------------------------------------------------------------------
-static struct sctp_association_s *sctp_add_new_peer(void) {
+static struct sctp_association_s *sctp_new_peer(sctp_assoc_id_t assoc_id,
+                                                uint16_t outstreams) {
   struct sctp_association_s *new_sctp_descriptor =
       calloc(1, sizeof(struct sctp_association_s));
 
@@ -115,24 +202,55 @@ static struct sctp_association_s *sctp_add_new_peer(void) {
     return NULL;
   }
 
-  new_sctp_descriptor->next_assoc = NULL;
-  new_sctp_descriptor->previous_assoc = NULL;
+  new_sctp_descriptor->assoc_id = assoc_id;
+  new_sctp_descriptor->outstreams = outstreams;
+  new_sctp_descriptor->out_streams_stats =
+      calloc(outstreams ? outstreams : 1, sizeof(sctp_stream_stats_t));
+  if (new_sctp_descriptor->out_streams_stats == NULL) {
+    free_wrapper((void **)&new_sctp_descriptor);
+    return NULL;
+  }
+  return new_sctp_descriptor;
+}
+
+//------------------------------------------------------------------------------
+static void sctp_free_peer(void **assoc) {
+  struct sctp_association_s *assoc_desc = (struct sctp_association_s *)*assoc;
+
+  if (assoc_desc->peer_addresses) {
+    int rv = sctp_freepaddrs(assoc_desc->peer_addresses);
+    if (rv)
+      OAILOG_DEBUG(LOG_SCTP, "sctp_freepaddrs(%p) failed\n",
+                   assoc_desc->peer_addresses);
+  }
+  free_wrapper((void **)&assoc_desc->out_streams_stats);
+  free_wrapper(assoc);
+}
 
-  if (sctp_desc.available_connections_tail == NULL) {
-    sctp_desc.available_connections_head = new_sctp_descriptor;
-    sctp_desc.available_connections_tail = sctp_desc.available_connections_head;
-  } else {
-    new_sctp_descriptor->previous_assoc = sctp_desc.available_connections_tail;
-    sctp_desc.available_connections_tail->next_assoc = new_sctp_descriptor;
-    sctp_desc.available_connections_tail = new_sctp_descriptor;
+//------------------------------------------------------------------------------
+// The association must be complete, it is visible to the senders on return
+static int sctp_add_peer(struct sctp_association_s *assoc_desc) {
+  hashtable_rc_t hash_rc = HASH_TABLE_OK;
+
+  pthread_rwlock_wrlock(&sctp_desc.assoc_lock);
+  hash_rc = hashtable_insert(sctp_desc.associations,
+                             (hash_key_t)assoc_desc->assoc_id, assoc_desc);
+  if (HASH_TABLE_OK == hash_rc) {
+    sctp_desc.number_of_connections++;
   }
+  pthread_rwlock_unlock(&sctp_desc.assoc_lock);
 
-  sctp_desc.number_of_connections++;
+  if (HASH_TABLE_OK != hash_rc) {
+    OAILOG_ERROR(LOG_SCTP, "Failed to add association %d: %s\n",
+                 assoc_desc->assoc_id, hashtable_rc_code2string(hash_rc));
+    return -1;
+  }
   sctp_dump_list();
-  return new_sctp_descriptor;
+  return 0;
 }
 
 //------------------------------------------------------------------------------
+// Must be called with the association lock held
 static struct sctp_association_s *sctp_is_assoc_in_list(
     sctp_assoc_id_t assoc_id) {
   struct sctp_association_s *assoc_desc = NULL;
@@ -141,13 +259,8 @@ static struct sctp_association_s *sctp_is_assoc_in_list(
     return NULL;
   }
 
-  for (assoc_desc = sctp_desc.available_connections_head; assoc_desc;
-       assoc_desc = assoc_desc->next_assoc) {
-    if (assoc_desc->assoc_id == assoc_id) {
-      break;
-    }
-  }
-
+  hashtable_get(sctp_desc.associations, (hash_key_t)assoc_id,
+                (void **)&assoc_desc);
   return assoc_desc;
 }
 
@@ -155,51 +268,25 @@ static struct sctp_association_s *sctp_is_assoc_in_list(
 static int sctp_remove_assoc_from_list(sctp_assoc_id_t assoc_id) {
   struct sctp_association_s *assoc_desc = NULL;
 
-  /*
-   * Association not in the list
-   */
-  if ((assoc_desc = sctp_is_assoc_in_list(assoc_id)) == NULL) {
+  if (assoc_id < 0) {
     return -1;
   }
 
-  if (assoc_desc->next_assoc == NULL) {
-    if (assoc_desc->previous_assoc == NULL) {
-      /*
-       * Head and tail
-       */
-      sctp_desc.available_connections_head =
-          sctp_desc.available_connections_tail = NULL;
-    } else {
-      /*
-       * Not head but tail
-       */
-      sctp_desc.available_connections_tail = assoc_desc->previous_assoc;
-      assoc_desc->previous_assoc->next_assoc = NULL;
-    }
-  } else {
-    if (assoc_desc->previous_assoc == NULL) {
-      /*
-       * Head but not tail
-       */
-      sctp_desc.available_connections_head = assoc_desc->next_assoc;
-      assoc_desc->next_assoc->previous_assoc = NULL;
-    } else {
-      /*
-       * Not head and not tail
-       */
-      assoc_desc->previous_assoc->next_assoc = assoc_desc->next_assoc;
-      assoc_desc->next_assoc->previous_assoc = assoc_desc->previous_assoc;
-    }
-  }
-
-  if (assoc_desc->peer_addresses) {
-    int rv = sctp_freepaddrs(assoc_desc->peer_addresses);
-    if (rv)
-      OAILOG_DEBUG(LOG_SCTP, "sctp_freepaddrs(%p) failed\n",
-                   assoc_desc->peer_addresses);
+  pthread_rwlock_wrlock(&sctp_desc.assoc_lock);
+  if (HASH_TABLE_OK != hashtable_remove(sctp_desc.associations,
+                                        (hash_key_t)assoc_id,
+                                        (void **)&assoc_desc)) {
+    /*
+     * Association not in the list
+     */
+    pthread_rwlock_unlock(&sctp_desc.assoc_lock);
+    return -1;
   }
-  free_wrapper((void **)&assoc_desc);
   sctp_desc.number_of_connections--;
+  pthread_rwlock_unlock(&sctp_desc.assoc_lock);
+
+  // No sender can reference it anymore
+  sctp_free_peer((void **)&assoc_desc);
   return 0;
 }
 
@@ -216,6 +303,18 @@ static void sctp_dump_assoc(struct sctp_association_s *sctp_assoc_p) {
   OAILOG_DEBUG(LOG_SCTP, "input streams: %d\n", sctp_assoc_p->instreams);
   OAILOG_DEBUG(LOG_SCTP, "out streams  : %d\n", sctp_assoc_p->outstreams);
   OAILOG_DEBUG(LOG_SCTP, "assoc_id     : %d\n", sctp_assoc_p->assoc_id);
+  OAILOG_DEBUG(LOG_SCTP, "received     : %u msgs %" PRIu64 " bytes\n",
+               sctp_assoc_p->messages_recv, sctp_assoc_p->bytes_recv);
+  OAILOG_DEBUG(LOG_SCTP, "sent         : %u msgs %" PRIu64 " bytes\n",
+               sctp_assoc_p->messages_sent, sctp_assoc_p->bytes_sent);
+
+  for (i = 0; i < sctp_assoc_p->outstreams; i++) {
+    if (sctp_assoc_p->out_streams_stats[i].messages_sent) {
+      OAILOG_DEBUG(LOG_SCTP, "  stream %3d : %u msgs %" PRIu64 " bytes\n", i,
+                   sctp_assoc_p->out_streams_stats[i].messages_sent,
+                   sctp_assoc_p->out_streams_stats[i].bytes_sent);
+    }
+  }
   OAILOG_DEBUG(LOG_SCTP, "peer address :\n");
 
   for (i = 0; i < sctp_assoc_p->nb_peer_addresses; i++) {
@@ -235,76 +334,332 @@ static void sctp_dump_assoc(struct sctp_association_s *sctp_assoc_p) {
 #endif
 }
 
+//------------------------------------------------------------------------------
+#if SCTP_DUMP_LIST
+static bool sctp_dump_assoc_cb(const hash_key_t keyP, void *const elementP,
+                               void *parameterP, void **resultP) {
+  sctp_dump_assoc((struct sctp_association_s *)elementP);
+  return false;
+}
+#endif
+
 //------------------------------------------------------------------------------
 static void sctp_dump_list(void) {
 #if SCTP_DUMP_LIST
-  struct sctp_association_s *sctp_assoc_p =
-      sctp_desc.available_connections_head;
+  pthread_rwlock_rdlock(&sctp_desc.assoc_lock);
   OAILOG_DEBUG(LOG_SCTP, "SCTP list contains %d associations\n",
                sctp_desc.number_of_connections);
-
-  while (sctp_assoc_p != NULL) {
-    sctp_dump_assoc(sctp_assoc_p);
-    sctp_assoc_p = sctp_assoc_p->next_assoc;
-  }
-
+  hashtable_apply_callback_on_elements(sctp_desc.associations,
+                                       sctp_dump_assoc_cb, NULL, NULL);
+  pthread_rwlock_unlock(&sctp_desc.assoc_lock);
 #else
   sctp_dump_assoc(NULL);
 #endif
 }
 
 //------------------------------------------------------------------------------
-static int sctp_send_msg(sctp_assoc_id_t sctp_assoc_id, uint16_t stream,
-                         STOLEN_REF bstring *payload) {
-  struct sctp_association_s *assoc_desc = NULL;
+static const_bstring sctp_data_req_payload(MessageDef *message_p) {
+  // Payloads are released with the message content
+  return (SCTP_DATA_REQ(message_p).payload)
+             ? SCTP_DATA_REQ(message_p).payload
+             : SCTP_DATA_REQ(message_p).shared_payload->b;
+}
 
-  DevAssert(*payload);
+//------------------------------------------------------------------------------
+static void sctp_free_data_req(MessageDef *message_p, bool is_success) {
+  if (!is_success) {
+    sctp_itti_send_lower_layer_conf(message_p->ittiMsgHeader.originTaskId,
+                                    SCTP_DATA_REQ(message_p).assoc_id,
+                                    SCTP_DATA_REQ(message_p).stream,
+                                    SCTP_DATA_REQ(message_p).mme_ue_s1ap_id,
+                                    false);
+  } /* NO NEED FOR CONFIRM success yet else {
+    if (INVALID_MME_UE_S1AP_ID != SCTP_DATA_REQ (message_p).mme_ue_s1ap_id) {
+      sctp_itti_send_lower_layer_conf(message_p->ittiMsgHeader.originTaskId,
+          SCTP_DATA_REQ (message_p).assoc_id,
+          SCTP_DATA_REQ (message_p).stream,
+          SCTP_DATA_REQ (message_p).mme_ue_s1ap_id,
+          true);
+    }
+  }*/
+  itti_free_msg_content(message_p);
+  itti_free(ITTI_MSG_ORIGIN_ID(message_p), message_p);
+}
 
-  if ((assoc_desc = sctp_is_assoc_in_list(sctp_assoc_id)) == NULL) {
-    OAILOG_DEBUG(LOG_SCTP, "This assoc id has not been fount in list (%d)\n",
-                 sctp_assoc_id);
-    return -1;
+//------------------------------------------------------------------------------
+static MessageDef *sctp_send_queue_pop(sctp_send_queue_t *queue) {
+  MessageDef *message_p = queue->msgs[queue->head];
+
+  queue->msgs[queue->head] = NULL;
+  queue->head = (queue->head + 1) & (queue->size - 1);
+  queue->count--;
+  queue->bytes -= blength(sctp_data_req_payload(message_p));
+  return message_p;
+}
+
+//------------------------------------------------------------------------------
+static void sctp_free_send_queue(void **queue_pp) {
+  sctp_send_queue_t *queue = (sctp_send_queue_t *)*queue_pp;
+
+  while (queue->count) {
+    sctp_free_data_req(sctp_send_queue_pop(queue), false);
   }
+  free_wrapper((void **)&queue->msgs);
+  free_wrapper(queue_pp);
+}
+
+//------------------------------------------------------------------------------
+static void sctp_remove_send_queue(sctp_assoc_id_t assoc_id) {
+  sctp_sender_t *sender = &sctp_desc.sender;
+  sctp_send_queue_t **queue_pp = &sender->pending_head;
+
+  while (*queue_pp) {
+    if ((*queue_pp)->assoc_id == assoc_id) {
+      *queue_pp = (*queue_pp)->next_pending;
+      break;
+    }
+    queue_pp = &(*queue_pp)->next_pending;
+  }
+  // Rejects the messages left
+  hashtable_free(sender->queues, (hash_key_t)assoc_id);
+}
+
+//------------------------------------------------------------------------------
+static void sctp_queue_data_req(MessageDef *message_p) {
+  sctp_sender_t *sender = &sctp_desc.sender;
+  sctp_assoc_id_t assoc_id = SCTP_DATA_REQ(message_p).assoc_id;
+  uint32_t length = blength(sctp_data_req_payload(message_p));
+  sctp_send_queue_t *queue = NULL;
+
+  if (HASH_TABLE_OK !=
+      hashtable_get(sender->queues, (hash_key_t)assoc_id, (void **)&queue)) {
+    bool is_known = false;
+
+    if (assoc_id >= 0) {
+      pthread_rwlock_rdlock(&sctp_desc.assoc_lock);
+      is_known = (sctp_is_assoc_in_list(assoc_id) != NULL);
+      pthread_rwlock_unlock(&sctp_desc.assoc_lock);
+    }
+    if (!is_known) {
+      OAILOG_DEBUG(LOG_SCTP, "This assoc id has not been fount in list (%d)\n",
+                   assoc_id);
+      sctp_free_data_req(message_p, false);
+      return;
+    }
+    if (((queue = calloc(1, sizeof(sctp_send_queue_t))) == NULL) ||
+        ((queue->msgs = calloc(SCTP_SEND_QUEUE_INITIAL_SIZE,
+                               sizeof(MessageDef *))) == NULL)) {
+      free_wrapper((void **)&queue);
+      sctp_free_data_req(message_p, false);
+      return;
+    }
+    queue->assoc_id = assoc_id;
+    queue->size = SCTP_SEND_QUEUE_INITIAL_SIZE;
+    hashtable_insert(sender->queues, (hash_key_t)assoc_id, queue);
+  }
+
+  if ((SCTP_SEND_QUEUE_MAX_MSGS == queue->count) ||
+      (queue->bytes + length > SCTP_SEND_QUEUE_HIGH_WATERMARK)) {
+    OAILOG_WARNING(LOG_SCTP,
+                   "[%d] Send queue full (%u msgs, %u bytes), rejecting %u "
+                   "bytes for stream %u\n",
+                   assoc_id, queue->count, queue->bytes, length,
+                   SCTP_DATA_REQ(message_p).stream);
+    sctp_free_data_req(message_p, false);
+    return;
+  }
+
+  if (queue->count == queue->size) {
+    MessageDef **msgs = calloc(queue->size * 2, sizeof(MessageDef *));
+
+    if (msgs == NULL) {
+      sctp_free_data_req(message_p, false);
+      return;
+    }
+    for (uint32_t i = 0; i < queue->count; i++) {
+      msgs[i] = queue->msgs[(queue->head + i) & (queue->size - 1)];
+    }
+    free_wrapper((void **)&queue->msgs);
+    queue->msgs = msgs;
+    queue->head = 0;
+    queue->size *= 2;
+  }
+  queue->msgs[(queue->head + queue->count) & (queue->size - 1)] = message_p;
+  queue->count++;
+  queue->bytes += length;
+
+  // A polled queue is flushed when its socket becomes writable
+  if ((!queue->is_pending) && (!queue->is_polled)) {
+    queue->is_pending = true;
+    queue->next_pending = sender->pending_head;
+    sender->pending_head = queue;
+  }
+}
+
+//------------------------------------------------------------------------------
+static void sctp_poll_send_queue(sctp_send_queue_t *queue, int sd) {
+  struct epoll_event event = {0};
+
+  event.events = EPOLLOUT | EPOLLONESHOT;
+  // Not the queue itself, it may be freed before the socket is closed
+  event.data.u64 = (uint64_t)queue->assoc_id;
+  if ((epoll_ctl(sctp_desc.sender.epoll_fd, EPOLL_CTL_MOD, sd, &event) < 0) &&
+      ((ENOENT != errno) ||
+       (epoll_ctl(sctp_desc.sender.epoll_fd, EPOLL_CTL_ADD, sd, &event) < 0))) {
+    OAILOG_ERROR(LOG_SCTP, "[%d] epoll_ctl: %s:%d\n", sd, strerror(errno),
+                 errno);
+    return;
+  }
+  queue->is_polled = true;
+}
 
-  if (assoc_desc->sd == -1) {
+//------------------------------------------------------------------------------
+/*
+ * Send the queued messages of an association, SCTP_SEND_BATCH_SIZE per
+ * sendmmsg(). Nagle is left on for the association sockets so the DATA chunks
+ * of a batch are bundled, a PDU on an idle association is sent at once.
+ */
+static void sctp_flush_send_queue(sctp_send_queue_t *queue) {
+  sctp_sender_t *sender = &sctp_desc.sender;
+  struct sctp_association_s *assoc_desc = NULL;
+  int nb_msgs = 0;
+  int nb_sent = 0;
+
+  // The association can not be removed (and its socket closed) while sending
+  pthread_rwlock_rdlock(&sctp_desc.assoc_lock);
+  if (((assoc_desc = sctp_is_assoc_in_list(queue->assoc_id)) == NULL) ||
+      (assoc_desc->sd == -1)) {
+    pthread_rwlock_unlock(&sctp_desc.assoc_lock);
     /*
      * The socket is invalid may be closed.
      */
-    OAILOG_DEBUG(LOG_SCTP,
-                 "The socket is invalid may be closed (assoc id %d)\n",
-                 sctp_assoc_id);
-    return -1;
+    OAILOG_DEBUG(LOG_SCTP, "Association %d is down, dropping %u messages\n",
+                 queue->assoc_id, queue->count);
+    sctp_remove_send_queue(queue->assoc_id);
+    return;
   }
 
-  OAILOG_DEBUG(
-      LOG_SCTP,
-      "[%d][%d] Sending buffer %p of %d bytes on stream %d with ppid %d\n",
-      assoc_desc->sd, sctp_assoc_id, bdata(*payload), blength(*payload), stream,
-      assoc_desc->ppid);
+  while (queue->count) {
+    nb_msgs = (queue->count < SCTP_SEND_BATCH_SIZE) ? queue->count
+                                                    : SCTP_SEND_BATCH_SIZE;
+    for (int i = 0; i < nb_msgs; i++) {
+      MessageDef *message_p =
+          queue->msgs[(queue->head + i) & (queue->size - 1)];
+      const_bstring payload = sctp_data_req_payload(message_p);
+      struct msghdr *msg = &sender->msgs[i].msg_hdr;
+      struct cmsghdr *cmsg = NULL;
+      struct sctp_sndrcvinfo *sinfo = NULL;
+
+      sender->iovs[i].iov_base = (void *)bdata(payload);
+      sender->iovs[i].iov_len = blength(payload);
+      memset(msg, 0, sizeof(struct msghdr));
+      msg->msg_iov = &sender->iovs[i];
+      msg->msg_iovlen = 1;
+      msg->msg_control = sender->cmsgs[i];
+      msg->msg_controllen = sizeof(sender->cmsgs[i]);
+      cmsg = CMSG_FIRSTHDR(msg);
+      cmsg->cmsg_level = IPPROTO_SCTP;
+      cmsg->cmsg_type = SCTP_SNDRCV;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(struct sctp_sndrcvinfo));
+      sinfo = (struct sctp_sndrcvinfo *)CMSG_DATA(cmsg);
+      memset(sinfo, 0, sizeof(struct sctp_sndrcvinfo));
+      sinfo->sinfo_stream = SCTP_DATA_REQ(message_p).stream;
+      sinfo->sinfo_ppid = htonl(assoc_desc->ppid);
+    }
 
-  /*
-   * Send message_p on specified stream of the sd association
-   */
-  if (sctp_sendmsg(assoc_desc->sd, (const void *)bdata(*payload),
-                   blength(*payload), NULL, 0, htonl(assoc_desc->ppid), 0,
-                   stream, 0, 0) < 0) {
-    bdestroy_wrapper(payload);
-    OAILOG_ERROR(LOG_SCTP, "send: %s:%d", strerror(errno), errno);
-    return -1;
+    nb_sent = sendmmsg(assoc_desc->sd, sender->msgs, nb_msgs,
+                       MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (nb_sent < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+        sctp_poll_send_queue(queue, assoc_desc->sd);
+        break;
+      }
+      OAILOG_ERROR(LOG_SCTP, "[%d][%d] send: %s:%d\n", assoc_desc->sd,
+                   queue->assoc_id, strerror(errno), errno);
+      // Drop the first message, the others are retried
+      sctp_free_data_req(sctp_send_queue_pop(queue), false);
+      continue;
+    }
+
+    for (int i = 0; i < nb_sent; i++) {
+      MessageDef *message_p = sctp_send_queue_pop(queue);
+      sctp_stream_id_t stream = SCTP_DATA_REQ(message_p).stream;
+      uint32_t length = sender->iovs[i].iov_len;
+
+      OAILOG_DEBUG(LOG_SCTP,
+                   "[%d][%d] Sent %u bytes on stream %d with ppid %d\n",
+                   assoc_desc->sd, queue->assoc_id, length, stream,
+                   assoc_desc->ppid);
+      assoc_desc->messages_sent++;
+      assoc_desc->bytes_sent += length;
+      if (stream < assoc_desc->outstreams) {
+        assoc_desc->out_streams_stats[stream].messages_sent++;
+        assoc_desc->out_streams_stats[stream].bytes_sent += length;
+      }
+      sctp_free_data_req(message_p, true);
+    }
   }
-  OAILOG_DEBUG(LOG_SCTP, "Successfully sent %d bytes on stream %d\n",
-               blength(*payload), stream);
-  bdestroy_wrapper(payload);
 
-  assoc_desc->messages_sent++;
-  return 0;
+  for (int i = 0; i < assoc_desc->outstreams; i++) {
+    assoc_desc->out_streams_stats[i].queue_depth = 0;
+  }
+  for (uint32_t i = 0; i < queue->count; i++) {
+    sctp_stream_id_t stream =
+        SCTP_DATA_REQ(queue->msgs[(queue->head + i) & (queue->size - 1)])
+            .stream;
+
+    if (stream < assoc_desc->outstreams) {
+      assoc_desc->out_streams_stats[stream].queue_depth++;
+    }
+  }
+  pthread_rwlock_unlock(&sctp_desc.assoc_lock);
+}
+
+//------------------------------------------------------------------------------
+// Flush the queues which received messages in the last ITTI batch
+static void sctp_flush_pending_send_queues(void) {
+  sctp_sender_t *sender = &sctp_desc.sender;
+  sctp_send_queue_t *queue = NULL;
+
+  while ((queue = sender->pending_head)) {
+    sender->pending_head = queue->next_pending;
+    queue->next_pending = NULL;
+    queue->is_pending = false;
+    sctp_flush_send_queue(queue);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Flush the queues whose socket became writable
+static void sctp_flush_polled_send_queues(void) {
+  sctp_sender_t *sender = &sctp_desc.sender;
+  struct epoll_event events[SCTP_SEND_EPOLL_EVENTS];
+  sctp_send_queue_t *queue = NULL;
+  int nb_events = 0;
+
+  do {
+    nb_events =
+        epoll_wait(sender->epoll_fd, events, SCTP_SEND_EPOLL_EVENTS, 0);
+  } while ((nb_events < 0) && (EINTR == errno));
+
+  for (int e = 0; e < nb_events; e++) {
+    if (HASH_TABLE_OK == hashtable_get(sender->queues,
+                                       (hash_key_t)events[e].data.u64,
+                                       (void **)&queue)) {
+      queue->is_polled = false;
+      sctp_flush_send_queue(queue);
+    }
+  }
 }
 
 //------------------------------------------------------------------------------
 static int sctp_create_new_listener(SctpInit *init_p) {
   struct sctp_event_subscribe event = {0};
   //  struct sockaddr                        *addr = NULL;
-  struct sctp_arg_s *sctp_arg_p = NULL;
+  sctp_receiver_socket_t *socket_p = NULL;
   uint16_t i = 0, j = 0;
   int sd = 0;
   int used_addresses = 0;
@@ -373,6 +728,17 @@ static int sctp_create_new_listener(SctpInit *init_p) {
       return -1;
     }
 
+    /*
+     * Keep Nagle on, inherited by the accepted sockets: the DATA chunks of a
+     * send batch are bundled
+     */
+    int nodelay = 0;
+    if (setsockopt(sd, IPPROTO_SCTP, SCTP_NODELAY, &nodelay,
+                   sizeof(nodelay)) < 0) {
+      OAILOG_ERROR(LOG_SCTP, "setsockopt: %s:%d\n", strerror(errno), errno);
+      goto err;
+    }
+
     /*
      * Some pre-bind socket configuration
      */
@@ -392,17 +758,27 @@ static int sctp_create_new_listener(SctpInit *init_p) {
       return -1;
     }
 
-    if ((sctp_arg_p = malloc(sizeof(struct sctp_arg_s))) == NULL) {
-      return -1;
+    /*
+     * Edge triggered: the receiver accepts until there is no pending
+     * connection
+     */
+    if (fcntl(sd, F_SETFL, fcntl(sd, F_GETFL) | O_NONBLOCK) < 0) {
+      OAILOG_ERROR(LOG_SCTP, "fcntl: %s:%d\n", strerror(errno), errno);
+      goto err;
     }
 
-    sctp_arg_p->sd = sd;
-    sctp_arg_p->ppid = init_p->ppid;
+    if ((socket_p = calloc(1, sizeof(sctp_receiver_socket_t))) == NULL) {
+      goto err;
+    }
 
-    if (pthread_create(&assoc_thread, NULL, &sctp_receiver_thread,
-                       (void *)sctp_arg_p) < 0) {
-      OAILOG_ERROR(LOG_SCTP, "pthread_create: %s:%d\n", strerror(errno), errno);
-      return -1;
+    socket_p->sd = sd;
+    socket_p->ppid = init_p->ppid;
+    socket_p->is_listener = true;
+    socket_p->assoc_id = -1;
+
+    if (sctp_receiver_add_socket(&sctp_desc.receivers[0], socket_p) < 0) {
+      free_wrapper((void **)&socket_p);
+      goto err;
     }
   }
 
@@ -418,135 +794,310 @@ err:
 }
 
 //------------------------------------------------------------------------------
-static inline int sctp_read_from_socket(int sd, int ppid) {
-  int flags = 0, n;
-  socklen_t from_len = 0;
-  struct sctp_sndrcvinfo sinfo = {0};
-  struct sockaddr_in6 addr = {0};
-  uint8_t buffer[SCTP_RECV_BUFFER_SIZE];
-
-  if (sd < 0) {
-    return -1;
+static int sctp_handle_notification(sctp_receiver_socket_t *socket_p,
+                                    union sctp_notification *snp) {
+  /*
+   * Client deconnection
+   */
+  if (SCTP_SHUTDOWN_EVENT == snp->sn_header.sn_type) {
+    OAILOG_DEBUG(LOG_SCTP, "SCTP_SHUTDOWN_EVENT received\n");
+    socket_p->assoc_id = -1;
+    return sctp_handle_com_down(snp->sn_shutdown_event.sse_assoc_id);
   }
+  /*
+   * Association has changed.
+   */
+  else if (SCTP_ASSOC_CHANGE == snp->sn_header.sn_type) {
+    struct sctp_assoc_change *sctp_assoc_changed;
 
-  memset((void *)&addr, 0, sizeof(struct sockaddr_in6));
-  from_len = (socklen_t)sizeof(struct sockaddr_in6);
-  memset((void *)&sinfo, 0, sizeof(struct sctp_sndrcvinfo));
-  n = sctp_recvmsg(sd, (void *)buffer, SCTP_RECV_BUFFER_SIZE,
-                   (struct sockaddr *)&addr, &from_len, &sinfo, &flags);
+    sctp_assoc_changed = &snp->sn_assoc_change;
+    OAILOG_DEBUG(LOG_SCTP, "Client association changed: %d\n",
+                 sctp_assoc_changed->sac_state);
 
-  if (n < 0) {
-    OAILOG_DEBUG(LOG_SCTP, "An error occured during read\n");
-    OAILOG_ERROR(LOG_SCTP, "sctp_recvmsg: %s:%d\n", strerror(errno), errno);
-    return SCTP_RC_ERROR;
+    /*
+     * New physical association requested by a peer
+     */
+    switch (sctp_assoc_changed->sac_state) {
+      case SCTP_COMM_UP: {
+        struct sctp_association_s *new_association = NULL;
+
+        sctp_get_sockinfo(socket_p->sd, NULL, NULL, NULL);
+        OAILOG_DEBUG(LOG_SCTP, "New connection\n");
+
+        if ((new_association =
+                 sctp_new_peer(sctp_assoc_changed->sac_assoc_id,
+                               sctp_assoc_changed->sac_outbound_streams)) ==
+            NULL) {
+          // TODO: handle this case
+          DevMessage("Unexpected error...\n");
+          return SCTP_RC_ERROR;
+        } else {
+          new_association->sd = socket_p->sd;
+          new_association->ppid = socket_p->ppid;
+          new_association->instreams = sctp_assoc_changed->sac_inbound_streams;
+          sctp_get_localaddresses(socket_p->sd, NULL, NULL);
+          sctp_get_peeraddresses(socket_p->sd, &new_association->peer_addresses,
+                                 &new_association->nb_peer_addresses);
+
+          if (sctp_add_peer(new_association) < 0) {
+            sctp_free_peer((void **)&new_association);
+            return SCTP_RC_ERROR;
+          }
+          socket_p->assoc_id = sctp_assoc_changed->sac_assoc_id;
+
+          if (sctp_itti_send_new_association(
+                  sctp_assoc_changed->sac_assoc_id,
+                  sctp_assoc_changed->sac_inbound_streams,
+                  sctp_assoc_changed->sac_outbound_streams) < 0) {
+            OAILOG_ERROR(LOG_SCTP, "Failed to send message to S1AP\n");
+            return SCTP_RC_ERROR;
+          }
+        }
+      } break;
+
+      case SCTP_RESTART: {
+        OAILOG_DEBUG(LOG_SCTP,
+                     "Received SCTP restart for the new connection.\n");
+        /** No separate SCTP INIT will be expected.. */
+        return SCTP_RC_ERROR;
+      } break;
+
+      default:
+        break;
+    }
   }
+  return SCTP_RC_NORMAL_READ;
+}
 
-  if (flags & MSG_NOTIFICATION) {
-    union sctp_notification *snp = (union sctp_notification *)buffer;
+//------------------------------------------------------------------------------
+static int sctp_handle_received_msg(sctp_receiver_t *receiver,
+                                    sctp_receiver_socket_t *socket_p, int i) {
+  struct msghdr *msg = &receiver->msgs[i].msg_hdr;
+  int n = (int)receiver->msgs[i].msg_len;
+  int inline_length = (int)receiver->iovs[i][0].iov_len;
+  bstring payload = receiver->payloads[i];
+  struct sctp_sndrcvinfo *sinfo = NULL;
+  struct cmsghdr *cmsg = NULL;
+  struct sctp_association_s *association = NULL;
+  uint16_t instreams = 0;
+  uint16_t outstreams = 0;
+
+  if (msg->msg_flags & MSG_NOTIFICATION) {
+    if (n > inline_length) {
+      OAILOG_ERROR(LOG_SCTP, "[%d] Notification too long (%d)\n",
+                   socket_p->sd, n);
+      return SCTP_RC_ERROR;
+    }
+    return sctp_handle_notification(socket_p,
+                                    (union sctp_notification *)payload->data);
+  }
 
+  if (n == 0) {
     /*
-     * Client deconnection
+     * Peer closed the association without SHUTDOWN event
      */
-    if (SCTP_SHUTDOWN_EVENT == snp->sn_header.sn_type) {
-      OAILOG_DEBUG(LOG_SCTP, "SCTP_SHUTDOWN_EVENT received\n");
-      return sctp_handle_com_down(snp->sn_shutdown_event.sse_assoc_id);
+    if (socket_p->assoc_id >= 0) {
+      sctp_assoc_id_t assoc_id = socket_p->assoc_id;
+
+      socket_p->assoc_id = -1;
+      return sctp_handle_com_down(assoc_id);
     }
-    /*
-     * Association has changed.
-     */
-    else if (SCTP_ASSOC_CHANGE == snp->sn_header.sn_type) {
-      struct sctp_assoc_change *sctp_assoc_changed;
-
-      sctp_assoc_changed = &snp->sn_assoc_change;
-      OAILOG_DEBUG(LOG_SCTP, "Client association changed: %d\n",
-                   sctp_assoc_changed->sac_state);
-
-      /*
-       * New physical association requested by a peer
-       */
-      switch (sctp_assoc_changed->sac_state) {
-        case SCTP_COMM_UP: {
-          struct sctp_association_s *new_association = NULL;
-
-          sctp_get_sockinfo(sd, NULL, NULL, NULL);
-          OAILOG_DEBUG(LOG_SCTP, "New connection\n");
-
-          if ((new_association = sctp_add_new_peer()) == NULL) {
-            // TODO: handle this case
-            DevMessage("Unexpected error...\n");
-            return SCTP_RC_ERROR;
-          } else {
-            new_association->sd = sd;
-            new_association->ppid = ppid;
-            new_association->instreams =
-                sctp_assoc_changed->sac_inbound_streams;
-            new_association->outstreams =
-                sctp_assoc_changed->sac_outbound_streams;
-            new_association->assoc_id = sctp_assoc_changed->sac_assoc_id;
-            sctp_get_localaddresses(sd, NULL, NULL);
-            sctp_get_peeraddresses(sd, &new_association->peer_addresses,
-                                   &new_association->nb_peer_addresses);
-
-            if (sctp_itti_send_new_association(
-                    new_association->assoc_id, new_association->instreams,
-                    new_association->outstreams) < 0) {
-              OAILOG_ERROR(LOG_SCTP, "Failed to send message to S1AP\n");
-              return SCTP_RC_ERROR;
-            }
-          }
-        } break;
+    return SCTP_RC_DISCONNECT;
+  }
 
-        case SCTP_RESTART: {
-          OAILOG_DEBUG(LOG_SCTP,
-                       "Received SCTP restart for the new connection.\n");
-          /** No separate SCTP INIT will be expected.. */
-          return SCTP_RC_ERROR;
-        } break;
+  if (!(msg->msg_flags & MSG_EOR)) {
+    OAILOG_ERROR(LOG_SCTP, "[%d] Message bigger than %d bytes dropped\n",
+                 socket_p->sd, SCTP_RECV_INLINE_SIZE + SCTP_RECV_BUFFER_SIZE);
+    return SCTP_RC_ERROR;
+  }
 
-        default:
-          break;
-      }
+  for (cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+    if ((IPPROTO_SCTP == cmsg->cmsg_level) &&
+        (SCTP_SNDRCV == cmsg->cmsg_type)) {
+      sinfo = (struct sctp_sndrcvinfo *)CMSG_DATA(cmsg);
     }
-  } else {
+  }
+
+  if (!sinfo) {
+    OAILOG_ERROR(LOG_SCTP, "[%d] No sctp_sndrcvinfo\n", socket_p->sd);
+    return SCTP_RC_ERROR;
+  }
+
+  /*
+   * Data payload received
+   */
+  pthread_rwlock_rdlock(&sctp_desc.assoc_lock);
+  if ((association = sctp_is_assoc_in_list(sinfo->sinfo_assoc_id)) == NULL) {
+    pthread_rwlock_unlock(&sctp_desc.assoc_lock);
+    // TODO: handle this case
+    return SCTP_RC_ERROR;
+  }
+
+  // Only the receiver of the association socket updates this counter
+  association->messages_recv++;
+  association->bytes_recv += n;
+
+  if (ntohl(sinfo->sinfo_ppid) != association->ppid) {
     /*
-     * Data payload received
+     * Mismatch in Payload Protocol Identifier,
+     * * * * may be we received unsollicited traffic from stack other than
+     * S1AP.
      */
-    struct sctp_association_s *association;
-
-    if ((association = sctp_is_assoc_in_list(sinfo.sinfo_assoc_id)) == NULL) {
-      // TODO: handle this case
+    OAILOG_ERROR(
+        LOG_SCTP,
+        "Received data from peer with unsollicited PPID %d, expecting %d\n",
+        ntohl(sinfo->sinfo_ppid), association->ppid);
+    pthread_rwlock_unlock(&sctp_desc.assoc_lock);
+    return SCTP_RC_ERROR;
+  }
+  instreams = association->instreams;
+  outstreams = association->outstreams;
+  pthread_rwlock_unlock(&sctp_desc.assoc_lock);
+
+  OAILOG_DEBUG(LOG_SCTP,
+               "[%d][%d] Msg of length %d received from port %u, on stream "
+               "%d, PPID %d\n",
+               sinfo->sinfo_assoc_id, socket_p->sd, n,
+               ntohs(receiver->addrs[i].sin6_port), sinfo->sinfo_stream,
+               ntohl(sinfo->sinfo_ppid));
+
+  if (n > inline_length) {
+    if (balloc(payload, n + 1) != BSTR_OK) {
       return SCTP_RC_ERROR;
     }
+    memcpy(payload->data + inline_length, receiver->overflows[i],
+           n - inline_length);
+  }
+  payload->slen = n;
+  payload->data[n] = '\0';
+  /*
+   * The receive buffer is handed over to S1AP, a new one is allocated for the
+   * next batch
+   */
+  receiver->payloads[i] = NULL;
+  sctp_itti_send_new_message_ind(&payload, sinfo->sinfo_assoc_id,
+                                 sinfo->sinfo_stream, instreams, outstreams);
+  return SCTP_RC_NORMAL_READ;
+}
 
-    association->messages_recv++;
+//------------------------------------------------------------------------------
+// Read all the messages pending on a socket, SCTP_RECV_BATCH_SIZE at a time
+static int sctp_receiver_read(sctp_receiver_t *receiver,
+                              sctp_receiver_socket_t *socket_p) {
+  int nb_msgs = 0;
+  int rc = SCTP_RC_NORMAL_READ;
+
+  do {
+    for (int i = 0; i < SCTP_RECV_BATCH_SIZE; i++) {
+      struct msghdr *msg = &receiver->msgs[i].msg_hdr;
+
+      if ((!receiver->payloads[i]) &&
+          (!(receiver->payloads[i] =
+                 bfromcstralloc(SCTP_RECV_INLINE_SIZE, "")))) {
+        return SCTP_RC_ERROR;
+      }
+      // Keep room for the trailing '\0' of the bstring
+      receiver->iovs[i][0].iov_base = receiver->payloads[i]->data;
+      receiver->iovs[i][0].iov_len = receiver->payloads[i]->mlen - 1;
+      receiver->iovs[i][1].iov_base = receiver->overflows[i];
+      receiver->iovs[i][1].iov_len = SCTP_RECV_BUFFER_SIZE;
+      memset(msg, 0, sizeof(struct msghdr));
+      msg->msg_name = &receiver->addrs[i];
+      msg->msg_namelen = sizeof(struct sockaddr_in6);
+      msg->msg_iov = receiver->iovs[i];
+      msg->msg_iovlen = 2;
+      msg->msg_control = receiver->cmsgs[i];
+      msg->msg_controllen = sizeof(receiver->cmsgs[i]);
+    }
 
-    if (ntohl(sinfo.sinfo_ppid) != association->ppid) {
-      /*
-       * Mismatch in Payload Protocol Identifier,
-       * * * * may be we received unsollicited traffic from stack other than
-       * S1AP.
-       */
-      OAILOG_ERROR(
-          LOG_SCTP,
-          "Received data from peer with unsollicited PPID %d, expecting %d\n",
-          ntohl(sinfo.sinfo_ppid), association->ppid);
+    nb_msgs = recvmmsg(socket_p->sd, receiver->msgs, SCTP_RECV_BATCH_SIZE,
+                       MSG_DONTWAIT, NULL);
+    if (nb_msgs < 0) {
+      if (EINTR == errno) {
+        nb_msgs = SCTP_RECV_BATCH_SIZE;
+        continue;
+      }
+      if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+        break;
+      }
+      OAILOG_ERROR(LOG_SCTP, "[%d] recvmmsg: %s:%d\n", socket_p->sd,
+                   strerror(errno), errno);
       return SCTP_RC_ERROR;
     }
 
-    OAILOG_DEBUG(LOG_SCTP,
-                 "[%d][%d] Msg of length %d received from port %u, on stream "
-                 "%d, PPID %d\n",
-                 sinfo.sinfo_assoc_id, sd, n, ntohs(addr.sin6_port),
-                 sinfo.sinfo_stream, ntohl(sinfo.sinfo_ppid));
-    bstring payload = blk2bstr(buffer, n);
-    sctp_itti_send_new_message_ind(&payload, sinfo.sinfo_assoc_id,
-                                   sinfo.sinfo_stream, association->instreams,
-                                   association->outstreams);
+    for (int i = 0; (i < nb_msgs) && (SCTP_RC_DISCONNECT != rc); i++) {
+      rc = sctp_handle_received_msg(receiver, socket_p, i);
+    }
+  } while ((SCTP_RECV_BATCH_SIZE == nb_msgs) && (SCTP_RC_DISCONNECT != rc));
+
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+static int sctp_receiver_add_socket(sctp_receiver_t *receiver,
+                                    sctp_receiver_socket_t *socket_p) {
+  struct epoll_event event = {0};
+
+  event.events = EPOLLIN | EPOLLET;
+  event.data.ptr = socket_p;
+  if (epoll_ctl(receiver->epoll_fd, EPOLL_CTL_ADD, socket_p->sd, &event) < 0) {
+    OAILOG_ERROR(LOG_SCTP, "[%d] epoll_ctl: %s:%d\n", socket_p->sd,
+                 strerror(errno), errno);
+    return -1;
   }
+  return 0;
+}
 
-  OAILOG_DEBUG(LOG_SCTP, "SCTP RETURNING!!\n");
+//------------------------------------------------------------------------------
+static void sctp_receiver_close_socket(sctp_receiver_t *receiver,
+                                       sctp_receiver_socket_t *socket_p) {
+  if (socket_p->assoc_id >= 0) {
+    sctp_handle_com_down(socket_p->assoc_id);
+  }
+  epoll_ctl(receiver->epoll_fd, EPOLL_CTL_DEL, socket_p->sd, NULL);
+  close(socket_p->sd);
+  free_wrapper((void **)&socket_p);
+}
 
-  return SCTP_RC_NORMAL_READ;
+//------------------------------------------------------------------------------
+static void sctp_receiver_accept(sctp_receiver_socket_t *listener_p) {
+  sctp_receiver_socket_t *socket_p = NULL;
+  sctp_receiver_t *receiver = NULL;
+  int clientsock = -1;
+
+  while (1) {
+    /*
+     * Client sockets are written with sendmmsg(MSG_DONTWAIT), a full socket
+     * buffer is flushed on EPOLLOUT, and read with MSG_DONTWAIT
+     */
+    if ((clientsock = accept(listener_p->sd, NULL, NULL)) < 0) {
+      if ((EINTR == errno) || (ECONNABORTED == errno)) {
+        continue;
+      }
+      if ((EAGAIN != errno) && (EWOULDBLOCK != errno)) {
+        OAILOG_ERROR(LOG_SCTP, "[%d] accept: %s:%d\n", listener_p->sd,
+                     strerror(errno), errno);
+      }
+      return;
+    }
+
+    if ((socket_p = calloc(1, sizeof(sctp_receiver_socket_t))) == NULL) {
+      close(clientsock);
+      continue;
+    }
+    socket_p->sd = clientsock;
+    socket_p->ppid = listener_p->ppid;
+    socket_p->is_listener = false;
+    socket_p->assoc_id = -1;
+
+    // Associations are spread over the receivers, listeners stay on the first
+    receiver = &sctp_desc.receivers[sctp_desc.next_receiver++ %
+                                    sctp_desc.nb_receivers];
+    if (sctp_receiver_add_socket(receiver, socket_p) < 0) {
+      close(clientsock);
+      free_wrapper((void **)&socket_p);
+    }
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -562,174 +1113,130 @@ static int sctp_handle_com_down(sctp_assoc_id_t assoc_id) {
     OAILOG_ERROR(LOG_SCTP, "Failed to find client in list\n");
   }
 
+  // TASK_SCTP releases the send queue of the association
+  MessageDef *message_p =
+      itti_alloc_new_message(TASK_SCTP, SCTP_CLOSE_ASSOCIATION);
+  SCTP_CLOSE_ASSOCIATION(message_p).assoc_id = assoc_id;
+  itti_send_msg_to_task(TASK_SCTP, INSTANCE_DEFAULT, message_p);
+
   return SCTP_RC_DISCONNECT;
 }
 
 //------------------------------------------------------------------------------
 void *sctp_receiver_thread(void *args_p) {
-  struct sctp_arg_s *sctp_arg_p = NULL;
-
-  /*
-   * maximum file descriptor number
-   */
-  int fdmax, clientsock, i;
-
-  /*
-   * master file descriptor list
-   */
-  fd_set master;
-
-  /*
-   * temp file descriptor list for select()
-   */
-  fd_set read_fds;
-
-  if ((sctp_arg_p = (struct sctp_arg_s *)args_p) == NULL) {
-    pthread_exit(NULL);
-  }
-
-  /*
-   * clear the master and temp sets
-   */
-  FD_ZERO(&master);
-  FD_ZERO(&read_fds);
-  FD_SET(sctp_arg_p->sd, &master);
-  fdmax = sctp_arg_p->sd; /* so far, it's this one */
+  sctp_receiver_t *receiver = (sctp_receiver_t *)args_p;
+  struct epoll_event events[SCTP_RECV_EPOLL_EVENTS];
+  int nb_events = 0;
 
   while (1) {
-    memcpy(&read_fds, &master, sizeof(master));
+    nb_events =
+        epoll_wait(receiver->epoll_fd, events, SCTP_RECV_EPOLL_EVENTS, -1);
 
-    if (select(fdmax + 1, &read_fds, NULL, NULL, NULL) == -1) {
-      OAILOG_ERROR(LOG_SCTP, "[%d] Select() error: %s", sctp_arg_p->sd,
-                   strerror(errno));
-      free_wrapper((void **)&args_p);
+    if (nb_events < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      OAILOG_ERROR(LOG_SCTP, "epoll_wait: %s:%d\n", strerror(errno), errno);
       pthread_exit(NULL);
     }
 
-    for (i = 0; i <= fdmax; i++) {
-      if (FD_ISSET(i, &read_fds)) {
-        if (i == sctp_arg_p->sd) {
-          /*
-           * There is data to read on listener socket. This means we have to
-           * accept
-           * * * * the connection.
-           */
-          if ((clientsock = accept(sctp_arg_p->sd, NULL, NULL)) < 0) {
-            OAILOG_ERROR(LOG_SCTP, "[%d] accept: %s:%d\n", sctp_arg_p->sd,
-                         strerror(errno), errno);
-            free_wrapper((void **)&args_p);
-            pthread_exit(NULL);
-          } else {
-            FD_SET(clientsock, &master); /* add to master set */
-
-            if (clientsock > fdmax) {
-              /*
-               * keep track of the maximum
-               */
-              fdmax = clientsock;
-            }
-          }
-        } else {
-          int ret;
-
-          /*
-           * Read from socket
-           */
-          ret = sctp_read_from_socket(i, sctp_arg_p->ppid);
+    for (int e = 0; e < nb_events; e++) {
+      sctp_receiver_socket_t *socket_p =
+          (sctp_receiver_socket_t *)events[e].data.ptr;
 
-          /*
-           * When the socket is disconnected we have to update
-           * * * * the fd_set.
-           */
-          if (ret == SCTP_RC_DISCONNECT) {
-            /*
-             * Remove the socket from the FD set and update the max sd
-             */
-            FD_CLR(i, &master);
-
-            if (i == fdmax) {
-              while (FD_ISSET(fdmax, &master) == false) fdmax -= 1;
-            }
-          }
-        }
+      if (socket_p->is_listener) {
+        sctp_receiver_accept(socket_p);
+      } else if ((SCTP_RC_DISCONNECT ==
+                  sctp_receiver_read(receiver, socket_p)) ||
+                 (events[e].events & (EPOLLHUP | EPOLLERR))) {
+        sctp_receiver_close_socket(receiver, socket_p);
       }
     }
   }
 
-  free_wrapper((void **)&args_p);
   return NULL;
 }
 
 //------------------------------------------------------------------------------
 static void *sctp_intertask_interface(void *args_p) {
+  MessageDef *received_messages[ITTI_RECEIVE_MSGS_BATCH_SIZE] = {NULL};
+  int nb_received_messages = 0;
+  struct epoll_event *events = NULL;
+  int nb_events = 0;
+
   itti_mark_task_ready(TASK_SCTP);
+  itti_set_task_wake_if_sleeping(TASK_SCTP);
+  itti_subscribe_event_fd(TASK_SCTP, sctp_desc.sender.epoll_fd);
 
   while (1) {
-    MessageDef *received_message_p = NULL;
+    nb_received_messages = itti_receive_msgs(TASK_SCTP, received_messages,
+                                             ITTI_RECEIVE_MSGS_BATCH_SIZE);
 
-    itti_receive_msg(TASK_SCTP, &received_message_p);
+    for (int m = 0; m < nb_received_messages; m++) {
+      MessageDef *received_message_p = received_messages[m];
 
-    switch (ITTI_MSG_ID(received_message_p)) {
-      case SCTP_CLOSE_ASSOCIATION: {
-      } break;
+      switch (ITTI_MSG_ID(received_message_p)) {
+        case SCTP_CLOSE_ASSOCIATION: {
+          sctp_remove_send_queue(
+              SCTP_CLOSE_ASSOCIATION(received_message_p).assoc_id);
+        } break;
 
-      case SCTP_DATA_REQ: {
-        if (sctp_send_msg(SCTP_DATA_REQ(received_message_p).assoc_id,
-                          SCTP_DATA_REQ(received_message_p).stream,
-                          &SCTP_DATA_REQ(received_message_p).payload) < 0) {
-          sctp_itti_send_lower_layer_conf(
-              received_message_p->ittiMsgHeader.originTaskId,
-              SCTP_DATA_REQ(received_message_p).assoc_id,
-              SCTP_DATA_REQ(received_message_p).stream,
-              SCTP_DATA_REQ(received_message_p).mme_ue_s1ap_id, false);
-        } /* NO NEED FOR CONFIRM success yet else {
-          if (INVALID_MME_UE_S1AP_ID != SCTP_DATA_REQ
-        (received_message_p).mme_ue_s1ap_id) {
-            sctp_itti_send_lower_layer_conf(received_message_p->ittiMsgHeader.originTaskId,
-                SCTP_DATA_REQ (received_message_p).assoc_id,
-                SCTP_DATA_REQ (received_message_p).stream,
-                SCTP_DATA_REQ (received_message_p).mme_ue_s1ap_id,
-                true);
-          }
-        }*/
-      } break;
+        case SCTP_DATA_REQ: {
+          // Sent with the other messages of the batch for this association
+          sctp_queue_data_req(received_message_p);
+          continue;
+        } break;
 
-      case SCTP_INIT_MSG: {
-        OAILOG_DEBUG(LOG_SCTP, "Received SCTP_INIT_MSG\n");
+        case SCTP_INIT_MSG: {
+          OAILOG_DEBUG(LOG_SCTP, "Received SCTP_INIT_MSG\n");
 
-        /*
-         * We received a new connection request
-         */
-        if (sctp_create_new_listener(&received_message_p->ittiMsg.sctpInit) <
-            0) {
           /*
-           * SCTP socket creation or bind failed...
+           * We received a new connection request
            */
-          OAILOG_ERROR(LOG_SCTP, "Failed to create new SCTP listener\n");
-        }
-      } break;
+          if (sctp_create_new_listener(&received_message_p->ittiMsg.sctpInit) <
+              0) {
+            /*
+             * SCTP socket creation or bind failed...
+             */
+            OAILOG_ERROR(LOG_SCTP, "Failed to create new SCTP listener\n");
+          }
+        } break;
 
-      case MESSAGE_TEST: {
-        OAI_FPRINTF_INFO("TASK_SCTP received MESSAGE_TEST\n");
-      } break;
+        case MESSAGE_TEST: {
+          OAI_FPRINTF_INFO("TASK_SCTP received MESSAGE_TEST\n");
+        } break;
 
-      case TERMINATE_MESSAGE: {
-        sctp_exit();
-        itti_free_msg_content(received_message_p);
-        itti_free(ITTI_MSG_ORIGIN_ID(received_message_p), received_message_p);
-        itti_exit_task();
-      } break;
+        case TERMINATE_MESSAGE: {
+          sctp_exit();
+          itti_free_msg_content(received_message_p);
+          itti_free(ITTI_MSG_ORIGIN_ID(received_message_p), received_message_p);
+          itti_free_received_msgs(received_messages, m + 1,
+                                  nb_received_messages);
+          itti_exit_task();
+        } break;
 
-      default: {
-        OAILOG_DEBUG(LOG_SCTP, "Unkwnon message ID %d:%s\n",
-                     ITTI_MSG_ID(received_message_p),
-                     ITTI_MSG_NAME(received_message_p));
-      } break;
+        default: {
+          OAILOG_DEBUG(LOG_SCTP, "Unkwnon message ID %d:%s\n",
+                       ITTI_MSG_ID(received_message_p),
+                       ITTI_MSG_NAME(received_message_p));
+        } break;
+      }
+
+      itti_free_msg_content(received_message_p);
+      itti_free(ITTI_MSG_ORIGIN_ID(received_message_p), received_message_p);
+      received_message_p = NULL;
     }
 
-    itti_free_msg_content(received_message_p);
-    itti_free(ITTI_MSG_ORIGIN_ID(received_message_p), received_message_p);
-    received_message_p = NULL;
+    // Flush the SCTP_DATA_REQ of the batch, association by association
+    sctp_flush_pending_send_queues();
+
+    nb_events = itti_get_events(TASK_SCTP, &events);
+    for (int e = 0; e < nb_events; e++) {
+      if ((events[e].data.fd == sctp_desc.sender.epoll_fd) &&
+          (events[e].events & EPOLLIN)) {
+        sctp_flush_polled_send_queues();
+      }
+    }
   }
 
   return NULL;
@@ -744,6 +1251,53 @@ int sctp_init(const mme_config_t *mme_config_p) {
    */
   sctp_desc.nb_instreams = mme_config_p->sctp_config.in_streams;
   sctp_desc.nb_outstreams = mme_config_p->sctp_config.out_streams;
+  pthread_rwlock_init(&sctp_desc.assoc_lock, NULL);
+  bstring b = bfromcstr("sctp_associations");
+  sctp_desc.associations =
+      hashtable_create(SCTP_ASSOC_HTBL_SIZE, NULL, sctp_free_peer, b);
+  bdestroy_wrapper(&b);
+  AssertFatal(sctp_desc.associations, "Failed to create SCTP associations");
+  sctp_desc.associations->log_enabled = false;
+
+  /*
+   * Send queues of TASK_SCTP
+   */
+  b = bfromcstr("sctp_send_queues");
+  sctp_desc.sender.queues =
+      hashtable_create(SCTP_ASSOC_HTBL_SIZE, NULL, sctp_free_send_queue, b);
+  bdestroy_wrapper(&b);
+  AssertFatal(sctp_desc.sender.queues, "Failed to create SCTP send queues");
+  sctp_desc.sender.queues->log_enabled = false;
+  if ((sctp_desc.sender.epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+    OAILOG_ERROR(LOG_SCTP, "epoll_create1: %s:%d\n", strerror(errno), errno);
+    return -1;
+  }
+
+  /*
+   * Receiver threads, the associations are sharded over them
+   */
+  sctp_desc.nb_receivers = mme_config_p->sctp_config.receiver_threads;
+  sctp_desc.receivers =
+      calloc(sctp_desc.nb_receivers, sizeof(sctp_receiver_t));
+  AssertFatal(sctp_desc.receivers, "Failed to allocate SCTP receivers");
+
+  for (int r = 0; r < sctp_desc.nb_receivers; r++) {
+    sctp_receiver_t *receiver = &sctp_desc.receivers[r];
+
+    if ((receiver->epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+      OAILOG_ERROR(LOG_SCTP, "epoll_create1: %s:%d\n", strerror(errno), errno);
+      return -1;
+    }
+    for (int i = 0; i < SCTP_RECV_BATCH_SIZE; i++) {
+      receiver->overflows[i] = malloc(SCTP_RECV_BUFFER_SIZE);
+      AssertFatal(receiver->overflows[i], "Failed to allocate SCTP buffer");
+    }
+    if (pthread_create(&receiver->thread, NULL, &sctp_receiver_thread,
+                       (void *)receiver) < 0) {
+      OAILOG_ERROR(LOG_SCTP, "pthread_create: %s:%d\n", strerror(errno), errno);
+      return -1;
+    }
+  }
 
   if (itti_create_task(TASK_SCTP, &sctp_intertask_interface, NULL) < 0) {
     OAILOG_ERROR(LOG_SCTP, "create task failed");
@@ -757,27 +1311,24 @@ int sctp_init(const mme_config_t *mme_config_p) {
 
 //------------------------------------------------------------------------------
 static void sctp_exit(void) {
-  int rv = pthread_cancel(assoc_thread);
-  if (rv)
-    OAILOG_DEBUG(LOG_SCTP, "pthread_cancel(%08lX) failed: %d:%s\n",
-                 assoc_thread, rv, strerror(rv));
-
-  struct sctp_association_s *sctp_assoc_p =
-      sctp_desc.available_connections_head;
-  struct sctp_association_s *next_sctp_assoc_p =
-      sctp_desc.available_connections_head;
-
-  while (next_sctp_assoc_p) {
-    next_sctp_assoc_p = sctp_assoc_p->next_assoc;
-    if (sctp_assoc_p->peer_addresses) {
-      rv = sctp_freepaddrs(sctp_assoc_p->peer_addresses);
-      if (rv)
-        OAILOG_DEBUG(LOG_SCTP, "sctp_freepaddrs(%p) failed\n",
-                     sctp_assoc_p->peer_addresses);
-    }
-    free_wrapper((void **)&sctp_assoc_p);
-    sctp_desc.number_of_connections--;
-    sctp_assoc_p = next_sctp_assoc_p;
+  int rv = 0;
+
+  for (int r = 0; r < sctp_desc.nb_receivers; r++) {
+    rv = pthread_cancel(sctp_desc.receivers[r].thread);
+    if (rv)
+      OAILOG_DEBUG(LOG_SCTP, "pthread_cancel(%08lX) failed: %d:%s\n",
+                   sctp_desc.receivers[r].thread, rv, strerror(rv));
   }
+
+  hashtable_destroy(sctp_desc.sender.queues);
+  sctp_desc.sender.queues = NULL;
+  sctp_desc.sender.pending_head = NULL;
+  close(sctp_desc.sender.epoll_fd);
+
+  pthread_rwlock_wrlock(&sctp_desc.assoc_lock);
+  hashtable_destroy(sctp_desc.associations);
+  sctp_desc.associations = NULL;
+  sctp_desc.number_of_connections = 0;
+  pthread_rwlock_unlock(&sctp_desc.assoc_lock);
   OAI_FPRINTF_INFO("TASK_SCTP terminated\n");
 }
@@ -22,23 +22,58 @@
 #include <nettle/hmac.h>
 #include "bstrlib.h"
 
+#include "assertions.h"
 #include "dynamic_memory_check.h"
 #include "secu_defs.h"
 #include "security_types.h"
 
 void kdf(const uint8_t *key, const unsigned key_len, uint8_t *s,
          const unsigned s_len, uint8_t *out, const unsigned out_len) {
-  struct hmac_sha256_ctx *ctx = calloc(1, sizeof(struct hmac_sha256_ctx));
+  struct hmac_sha256_ctx ctx;
 
-  // memset (&ctx, 0, sizeof (ctx));
-  hmac_sha256_set_key(ctx, key_len, key);
-  hmac_sha256_update(ctx, s_len, s);
-  hmac_sha256_digest(ctx, out_len, out);
-  free_wrapper((void **)&ctx);
+  hmac_sha256_set_key(&ctx, key_len, key);
+  hmac_sha256_update(&ctx, s_len, s);
+  hmac_sha256_digest(&ctx, out_len, out);
 }
 
+//------------------------------------------------------------------------------
+const kdf_key_t *kdf_key_update(kdf_key_t *const kdf_key, const uint8_t *key,
+                                const unsigned key_len) {
+  DevAssert(key_len <= KDF_KEY_MAX_LENGTH);
+  if ((!kdf_key->is_set) || (kdf_key->key_len != key_len) ||
+      (memcmp(kdf_key->key, key, key_len))) {
+    hmac_sha256_set_key(&kdf_key->hmac, key_len, key);
+    memcpy(kdf_key->key, key, key_len);
+    kdf_key->key_len = key_len;
+    kdf_key->is_set = true;
+  }
+  return kdf_key;
+}
+
+//------------------------------------------------------------------------------
+void kdf_key_derive(const kdf_key_t *const kdf_key, const uint8_t *s,
+                    const unsigned s_len, uint8_t *out,
+                    const unsigned out_len) {
+  // The cached state is left untouched (shared by the derivations of a UE)
+  struct hmac_sha256_ctx ctx = kdf_key->hmac;
+
+  DevAssert(kdf_key->is_set);
+  hmac_sha256_update(&ctx, s_len, s);
+  hmac_sha256_digest(&ctx, out_len, out);
+}
+
+//------------------------------------------------------------------------------
 int derive_keNB(const uint8_t *kasme_32, const uint32_t nas_count,
                 uint8_t *keNB) {
+  kdf_key_t kasme = {.is_set = false};
+
+  return derive_keNB_key(kdf_key_update(&kasme, kasme_32, 32), nas_count,
+                         keNB);
+}
+
+//------------------------------------------------------------------------------
+int derive_keNB_key(const kdf_key_t *const kasme, const uint32_t nas_count,
+                    uint8_t *keNB) {
   uint8_t s[7] = {0};
 
   // FC
@@ -51,21 +86,35 @@ int derive_keNB(const uint8_t *kasme_32, const uint32_t nas_count,
   // Length of NAS count
   s[5] = 0x00;
   s[6] = 0x04;
-  kdf(kasme_32, 32, s, 7, keNB, 32);
+  kdf_key_derive(kasme, s, 7, keNB, 32);
   return 0;
 }
 
+//------------------------------------------------------------------------------
 int derive_nh(const uint8_t *kasme_32, uint8_t *nh) {
+  kdf_key_t kasme = {.is_set = false};
+
+  return derive_nh_key(kdf_key_update(&kasme, kasme_32, 32), nh);
+}
+
+//------------------------------------------------------------------------------
+int derive_nh_key(const kdf_key_t *const kasme, uint8_t *nh) {
+  return derive_nh_chain_key(kasme, nh, 1);
+}
+
+//------------------------------------------------------------------------------
+int derive_nh_chain_key(const kdf_key_t *const kasme, uint8_t *nh,
+                        const unsigned num_hops) {
   uint8_t s[35];
-  memset(s, 0, 35);
 
   s[0] = (FC_NH);
-  // P0
-  memcpy(s + 1, nh, 32);
   // L0 = len(SN input)
   s[33] = 0x00;
   s[34] = 0x20;
-
-  kdf(kasme_32, 32, s, 35, nh, 32);
+  for (unsigned hop = 0; hop < num_hops; hop++) {
+    // P0 = SYNC-input, the previous NH
+    memcpy(s + 1, nh, 32);
+    kdf_key_derive(kasme, s, 35, nh, 32);
+  }
   return 0;
 }
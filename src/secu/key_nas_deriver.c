@@ -43,6 +43,16 @@
 */
 int derive_key_nas(algorithm_type_dist_t nas_alg_type, uint8_t nas_enc_alg_id,
                    const uint8_t *kasme_32, uint8_t *knas) {
+  kdf_key_t kasme = {.is_set = false};
+
+  return derive_key_nas_key(nas_alg_type, nas_enc_alg_id,
+                            kdf_key_update(&kasme, kasme_32, 32), knas);
+}
+
+//------------------------------------------------------------------------------
+int derive_key_nas_key(algorithm_type_dist_t nas_alg_type,
+                       uint8_t nas_enc_alg_id, const kdf_key_t *const kasme,
+                       uint8_t *knas) {
   uint8_t s[7] = {0};
   uint8_t out[32] = {0};
 
@@ -71,8 +81,7 @@ int derive_key_nas(algorithm_type_dist_t nas_alg_type, uint8_t nas_enc_alg_id,
   // OAILOG_TRACE (LOG_NAS, "FC %d nas_alg_type distinguisher %d
   // nas_enc_alg_identity %d\n", FC_ALG_KEY_DER, nas_alg_type, nas_enc_alg_id);
   // OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "s:", s, 7);
-  // OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "kasme_32:", kasme_32, 32);
-  kdf(kasme_32, 32, &s[0], 7, &out[0], 32);
+  kdf_key_derive(kasme, &s[0], 7, &out[0], 32);
   memcpy(knas, &out[31 - 16 + 1], 16);
   return 0;
 }
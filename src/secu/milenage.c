@@ -0,0 +1,351 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#if defined(__x86_64__)
+#include <wmmintrin.h>
+#endif
+
+#include "milenage.h"
+
+#include "assertions.h"
+#include "secu_defs.h"
+#include "security_types.h"
+
+/* Vectors computed per pass, the E_K of a pass are done by 2 AES calls */
+#define MILENAGE_BATCH 16
+/* Blocks in flight in the AES pipeline of the CPU */
+#define MILENAGE_AESNI_LANES 8
+
+/* Constants c2..c5, c1 is zero */
+#define MILENAGE_C2 0x01
+#define MILENAGE_C3 0x02
+#define MILENAGE_C4 0x04
+#define MILENAGE_C5 0x08
+
+#if defined(__x86_64__)
+//------------------------------------------------------------------------------
+__attribute__((target("aes,sse2"))) static inline __m128i _aesni_expand_key(
+    __m128i key, __m128i keygen) {
+  keygen = _mm_shuffle_epi32(keygen, 0xff);
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, keygen);
+}
+
+#define AESNI_EXPAND_KEY(kEYS, rOUND, rCON)                              \
+  kEYS[rOUND] = _aesni_expand_key(                                       \
+      kEYS[rOUND - 1], _mm_aeskeygenassist_si128(kEYS[rOUND - 1], rCON))
+
+//------------------------------------------------------------------------------
+__attribute__((target("aes,sse2"))) static void _aesni_set_key(
+    uint8_t keys[11][16], const uint8_t *k) {
+  __m128i round_keys[11];
+
+  round_keys[0] = _mm_loadu_si128((const __m128i *)k);
+  AESNI_EXPAND_KEY(round_keys, 1, 0x01);
+  AESNI_EXPAND_KEY(round_keys, 2, 0x02);
+  AESNI_EXPAND_KEY(round_keys, 3, 0x04);
+  AESNI_EXPAND_KEY(round_keys, 4, 0x08);
+  AESNI_EXPAND_KEY(round_keys, 5, 0x10);
+  AESNI_EXPAND_KEY(round_keys, 6, 0x20);
+  AESNI_EXPAND_KEY(round_keys, 7, 0x40);
+  AESNI_EXPAND_KEY(round_keys, 8, 0x80);
+  AESNI_EXPAND_KEY(round_keys, 9, 0x1b);
+  AESNI_EXPAND_KEY(round_keys, 10, 0x36);
+  for (int r = 0; r < 11; r++) {
+    _mm_store_si128((__m128i *)keys[r], round_keys[r]);
+  }
+}
+
+// Lanes are spelled out so that the blocks stay in registers
+#define AESNI_LANES(oP)          \
+  do {                           \
+    oP(0);                       \
+    oP(1);                       \
+    oP(2);                       \
+    oP(3);                       \
+    oP(4);                       \
+    oP(5);                       \
+    oP(6);                       \
+    oP(7);                       \
+  } while (0)
+
+//------------------------------------------------------------------------------
+// Blocks are independent: MILENAGE_AESNI_LANES of them go through each round
+// together so that the AESENC latency is hidden.
+__attribute__((target("aes,sse2"))) static void _aesni_encrypt(
+    const uint8_t keys[11][16], unsigned nb_blocks, uint8_t *dst,
+    const uint8_t *src) {
+  __m128i k[11];
+
+  for (int r = 0; r < 11; r++) {
+    k[r] = _mm_load_si128((const __m128i *)keys[r]);
+  }
+  for (; nb_blocks >= MILENAGE_AESNI_LANES; nb_blocks -= MILENAGE_AESNI_LANES) {
+    __m128i b[MILENAGE_AESNI_LANES];
+
+#define AESNI_LOAD(l) \
+  b[l] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)src + l), k[0])
+#define AESNI_ROUND(l) b[l] = _mm_aesenc_si128(b[l], k[r])
+#define AESNI_STORE(l) \
+  _mm_storeu_si128((__m128i *)dst + l, _mm_aesenclast_si128(b[l], k[10]))
+    AESNI_LANES(AESNI_LOAD);
+    for (int r = 1; r < 10; r++) {
+      AESNI_LANES(AESNI_ROUND);
+    }
+    AESNI_LANES(AESNI_STORE);
+#undef AESNI_LOAD
+#undef AESNI_ROUND
+#undef AESNI_STORE
+    src += MILENAGE_AESNI_LANES * 16;
+    dst += MILENAGE_AESNI_LANES * 16;
+  }
+  if (nb_blocks) {
+    // Last blocks through the lanes as well, latency rather than throughput
+    uint8_t tail[MILENAGE_AESNI_LANES * 16] __attribute__((aligned(16)));
+
+    memcpy(tail, src, nb_blocks * 16);
+    _aesni_encrypt(keys, MILENAGE_AESNI_LANES, tail, tail);
+    memcpy(dst, tail, nb_blocks * 16);
+  }
+}
+#endif
+
+//------------------------------------------------------------------------------
+// E_K of nb_blocks consecutive blocks
+static void _milenage_encrypt(const milenage_ctx_t *const ctx,
+                              const unsigned nb_blocks, uint8_t *dst,
+                              const uint8_t *src) {
+#if defined(__x86_64__)
+  if (ctx->use_aesni) {
+    _aesni_encrypt((const uint8_t(*)[16])ctx->aesni_keys, nb_blocks, dst, src);
+    return;
+  }
+#endif
+  nas_stream_aes_encrypt(&ctx->aes, nb_blocks * 16, dst, src);
+}
+
+//------------------------------------------------------------------------------
+static inline void _milenage_sqn_to_buffer(const uint64_t sqn, uint8_t *buf) {
+  for (int i = 0; i < MILENAGE_SQN_LENGTH; i++) {
+    buf[i] = (uint8_t)(sqn >> (8 * (MILENAGE_SQN_LENGTH - 1 - i)));
+  }
+}
+
+/*
+ * Blocks are handled by 32-bit words in memory order: the rotations of
+ * MILENAGE are multiples of 32 bits, a rotation is a permutation of words.
+ */
+typedef struct milenage_block_s {
+  uint32_t w[4];
+} milenage_block_t;
+
+//------------------------------------------------------------------------------
+static inline milenage_block_t _milenage_load(const uint8_t *buf) {
+  milenage_block_t block;
+
+  memcpy(block.w, buf, 16);
+  return block;
+}
+
+//------------------------------------------------------------------------------
+static inline milenage_block_t _milenage_xor(const milenage_block_t a,
+                                             const milenage_block_t b) {
+  milenage_block_t block;
+
+  for (int i = 0; i < 4; i++) {
+    block.w[i] = a.w[i] ^ b.w[i];
+  }
+  return block;
+}
+
+//------------------------------------------------------------------------------
+// x rotated by rotate words (r = 32 * rotate bits), XOR c, stored in buf
+static inline void _milenage_store_rot(const milenage_block_t x,
+                                       const unsigned rotate, const uint8_t c,
+                                       uint8_t *buf) {
+  milenage_block_t block;
+
+  for (int i = 0; i < 4; i++) {
+    block.w[i] = x.w[(i + rotate) % 4];
+  }
+  memcpy(buf, block.w, 16);
+  buf[15] ^= c;
+}
+
+//------------------------------------------------------------------------------
+// IN1 = SQN || AMF || SQN || AMF, XOR OPc, rotated by r1 = 64, XOR TEMP
+static inline void _milenage_out1_input(const milenage_block_t opc,
+                                        const milenage_block_t temp,
+                                        const uint8_t *sqn, const uint8_t *amf,
+                                        uint8_t *input) {
+  uint8_t in1[16];
+  milenage_block_t block;
+
+  memcpy(in1, sqn, MILENAGE_SQN_LENGTH);
+  memcpy(in1 + 6, amf, MILENAGE_AMF_LENGTH);
+  memcpy(in1 + 8, in1, 8);
+  block = _milenage_xor(_milenage_load(in1), opc);
+  _milenage_store_rot(block, 2, 0, input);
+  block = _milenage_xor(_milenage_load(input), temp);
+  memcpy(input, block.w, 16);
+}
+
+//------------------------------------------------------------------------------
+void milenage_compute_opc(const uint8_t k[MILENAGE_KEY_LENGTH],
+                          const uint8_t op[MILENAGE_KEY_LENGTH],
+                          uint8_t opc[MILENAGE_KEY_LENGTH]) {
+  NAS_STREAM_AES_CTX aes;
+
+  nas_stream_aes_set_key(&aes, k);
+  nas_stream_aes_encrypt(&aes, MILENAGE_KEY_LENGTH, opc, op);
+  for (int i = 0; i < MILENAGE_KEY_LENGTH; i++) {
+    opc[i] ^= op[i];
+  }
+}
+
+//------------------------------------------------------------------------------
+void milenage_ctx_setup(milenage_ctx_t *const ctx,
+                        const uint8_t k[MILENAGE_KEY_LENGTH],
+                        const uint8_t opc[MILENAGE_KEY_LENGTH]) {
+  nas_stream_aes_set_key(&ctx->aes, k);
+  ctx->use_aesni = false;
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("aes")) {
+    _aesni_set_key(ctx->aesni_keys, k);
+    ctx->use_aesni = true;
+  }
+#endif
+  memcpy(ctx->opc, opc, MILENAGE_KEY_LENGTH);
+}
+
+//------------------------------------------------------------------------------
+void milenage_generate_vectors(const milenage_ctx_t *const ctx,
+                               const uint8_t amf[MILENAGE_AMF_LENGTH],
+                               const uint64_t sqn, const uint64_t sqn_step,
+                               milenage_vector_t *const vectors,
+                               const unsigned nb_vectors) {
+  const milenage_block_t opc = _milenage_load(ctx->opc);
+  // Per vector: TEMP, then OUT1 to OUT4
+  uint8_t temp[MILENAGE_BATCH][16];
+  uint8_t out[MILENAGE_BATCH][4][16];
+
+  for (unsigned first = 0; first < nb_vectors; first += MILENAGE_BATCH) {
+    unsigned nb = nb_vectors - first;
+    uint8_t sqn_buf[MILENAGE_BATCH][MILENAGE_SQN_LENGTH];
+
+    if (nb > MILENAGE_BATCH) nb = MILENAGE_BATCH;
+    for (unsigned v = 0; v < nb; v++) {
+      milenage_block_t block =
+          _milenage_xor(_milenage_load(vectors[first + v].rand), opc);
+
+      memcpy(temp[v], block.w, 16);
+    }
+    _milenage_encrypt(ctx, nb, temp[0], temp[0]);
+
+    for (unsigned v = 0; v < nb; v++) {
+      milenage_block_t temp_block = _milenage_load(temp[v]);
+      milenage_block_t temp_opc = _milenage_xor(temp_block, opc);
+
+      _milenage_sqn_to_buffer(
+          (sqn + (first + v) * sqn_step) & MILENAGE_SQN_MAX, sqn_buf[v]);
+      _milenage_out1_input(opc, temp_block, sqn_buf[v], amf, out[v][0]);
+      // r2 = 0, r3 = 32, r4 = 64
+      _milenage_store_rot(temp_opc, 0, MILENAGE_C2, out[v][1]);
+      _milenage_store_rot(temp_opc, 1, MILENAGE_C3, out[v][2]);
+      _milenage_store_rot(temp_opc, 2, MILENAGE_C4, out[v][3]);
+    }
+    _milenage_encrypt(ctx, nb * 4, out[0][0], out[0][0]);
+
+    for (unsigned v = 0; v < nb; v++) {
+      milenage_vector_t *vector = &vectors[first + v];
+      milenage_block_t out1 = _milenage_xor(_milenage_load(out[v][0]), opc);
+      milenage_block_t out2 = _milenage_xor(_milenage_load(out[v][1]), opc);
+      milenage_block_t out3 = _milenage_xor(_milenage_load(out[v][2]), opc);
+      milenage_block_t out4 = _milenage_xor(_milenage_load(out[v][3]), opc);
+      uint8_t ak[8];
+
+      // OUT1: MAC-A, OUT2: AK || .. || RES, OUT3: CK, OUT4: IK
+      memcpy(vector->xres, &out2.w[2], MILENAGE_RES_LENGTH);
+      memcpy(vector->ck, out3.w, MILENAGE_KEY_LENGTH);
+      memcpy(vector->ik, out4.w, MILENAGE_KEY_LENGTH);
+      memcpy(ak, out2.w, 8);
+      for (int i = 0; i < MILENAGE_SQN_LENGTH; i++) {
+        vector->autn[i] = sqn_buf[v][i] ^ ak[i];
+      }
+      memcpy(&vector->autn[6], amf, MILENAGE_AMF_LENGTH);
+      memcpy(&vector->autn[8], out1.w, 8);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+int milenage_resync(const milenage_ctx_t *const ctx,
+                    const uint8_t rand[MILENAGE_RAND_LENGTH],
+                    const uint8_t auts[MILENAGE_AUTS_LENGTH],
+                    uint64_t *const sqn_ms) {
+  static const uint8_t amf_resync[MILENAGE_AMF_LENGTH] = {0};
+  const milenage_block_t opc = _milenage_load(ctx->opc);
+  milenage_block_t temp_block;
+  uint8_t temp[16];
+  // OUT5 (AK*) first, then OUT1 (MAC-S) on SQN_MS
+  uint8_t out[2][16];
+  uint8_t sqn_buf[MILENAGE_SQN_LENGTH];
+
+  temp_block = _milenage_xor(_milenage_load(rand), opc);
+  memcpy(temp, temp_block.w, 16);
+  _milenage_encrypt(ctx, 1, temp, temp);
+  temp_block = _milenage_load(temp);
+  // r5 = 96
+  _milenage_store_rot(_milenage_xor(temp_block, opc), 3, MILENAGE_C5, out[0]);
+  _milenage_encrypt(ctx, 1, out[0], out[0]);
+  *sqn_ms = 0;
+  for (int i = 0; i < MILENAGE_SQN_LENGTH; i++) {
+    sqn_buf[i] = auts[i] ^ out[0][i] ^ ctx->opc[i];
+    *sqn_ms = (*sqn_ms << 8) | sqn_buf[i];
+  }
+
+  _milenage_out1_input(opc, temp_block, sqn_buf, amf_resync, out[1]);
+  _milenage_encrypt(ctx, 1, out[1], out[1]);
+  for (int i = 0; i < 8; i++) {
+    if ((out[1][8 + i] ^ ctx->opc[8 + i]) != auts[6 + i]) return -1;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+void milenage_derive_kasme(const milenage_vector_t *const vector,
+                           const uint8_t sn_id[3], uint8_t kasme[32]) {
+  uint8_t key[32];
+  uint8_t s[14];
+
+  memcpy(key, vector->ck, MILENAGE_KEY_LENGTH);
+  memcpy(key + 16, vector->ik, MILENAGE_KEY_LENGTH);
+  // FC || SN id || 0x00 0x03 || SQN^AK || 0x00 0x06
+  s[0] = FC_KASME;
+  memcpy(&s[1], sn_id, 3);
+  s[4] = 0x00;
+  s[5] = 0x03;
+  memcpy(&s[6], vector->autn, MILENAGE_SQN_LENGTH);
+  s[12] = 0x00;
+  s[13] = 0x06;
+  kdf(key, 32, s, 14, kasme, 32);
+}
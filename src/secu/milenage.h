@@ -0,0 +1,102 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file milenage.h
+ * \brief MILENAGE f1-f5, f1*, f5* (3GPP TS 35.206) on a subscriber context,
+ * computing authentication vectors by batches.
+ * Unlike etsi_ts_135_206_V10.0.0_annex3.c there is no global state: once set
+ * up, a context is only read and can be used by several threads at once.
+ */
+
+#ifndef FILE_MILENAGE_SEEN
+#define FILE_MILENAGE_SEEN
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "secu_defs.h"
+
+#define MILENAGE_KEY_LENGTH 16
+#define MILENAGE_RAND_LENGTH 16
+#define MILENAGE_SQN_LENGTH 6
+#define MILENAGE_AMF_LENGTH 2
+#define MILENAGE_RES_LENGTH 8
+#define MILENAGE_AUTN_LENGTH 16
+#define MILENAGE_AUTS_LENGTH 14
+
+/* SQN is a 48-bit counter */
+#define MILENAGE_SQN_MAX ((UINT64_C(1) << 48) - 1)
+
+/*! \struct  milenage_ctx_t
+ * \brief Subscriber K expanded once, with its OPc.
+ */
+typedef struct milenage_ctx_s {
+  NAS_STREAM_AES_CTX aes; /*!< \brief E_K key schedule */
+#if defined(__x86_64__)
+  /*!< \brief E_K round keys for the AES instructions, if the CPU has them */
+  uint8_t aesni_keys[11][16] __attribute__((aligned(16)));
+#endif
+  bool use_aesni;
+  uint8_t opc[MILENAGE_KEY_LENGTH];
+} milenage_ctx_t;
+
+/*! \struct  milenage_vector_t
+ * \brief UMTS authentication vector (33.102 6.3.2), the E-UTRAN vector is
+ * derived from it by milenage_derive_kasme().
+ */
+typedef struct milenage_vector_s {
+  uint8_t rand[MILENAGE_RAND_LENGTH];
+  uint8_t xres[MILENAGE_RES_LENGTH];
+  uint8_t ck[MILENAGE_KEY_LENGTH];
+  uint8_t ik[MILENAGE_KEY_LENGTH];
+  uint8_t autn[MILENAGE_AUTN_LENGTH]; /*!< \brief SQN^AK || AMF || MAC-A */
+} milenage_vector_t;
+
+void milenage_compute_opc(const uint8_t k[MILENAGE_KEY_LENGTH],
+                          const uint8_t op[MILENAGE_KEY_LENGTH],
+                          uint8_t opc[MILENAGE_KEY_LENGTH]);
+
+void milenage_ctx_setup(milenage_ctx_t* const ctx,
+                        const uint8_t k[MILENAGE_KEY_LENGTH],
+                        const uint8_t opc[MILENAGE_KEY_LENGTH]);
+
+/*
+ * Computes nb_vectors vectors for the RAND already in vectors[i].rand, with
+ * SQN sqn + i * sqn_step for vectors[i]. The AES blocks of the vectors are
+ * encrypted together, a batch is cheaper per vector than a single one.
+ */
+void milenage_generate_vectors(const milenage_ctx_t* const ctx,
+                               const uint8_t amf[MILENAGE_AMF_LENGTH],
+                               const uint64_t sqn, const uint64_t sqn_step,
+                               milenage_vector_t* const vectors,
+                               const unsigned nb_vectors);
+
+/*
+ * Re-synchronisation (33.102 6.3.5): checks MAC-S of the AUTS sent by the
+ * USIM for rand, the AMF is zero. Returns 0 with SQN_MS in sqn_ms, -1 if
+ * MAC-S is wrong.
+ */
+int milenage_resync(const milenage_ctx_t* const ctx,
+                    const uint8_t rand[MILENAGE_RAND_LENGTH],
+                    const uint8_t auts[MILENAGE_AUTS_LENGTH],
+                    uint64_t* const sqn_ms);
+
+/* K_ASME (33.401 A.2) of vector for the serving network sn_id (TBCD) */
+void milenage_derive_kasme(const milenage_vector_t* const vector,
+                           const uint8_t sn_id[3], uint8_t kasme[32]);
+
+#endif /* FILE_MILENAGE_SEEN */
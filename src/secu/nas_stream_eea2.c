@@ -22,8 +22,6 @@
 #include <string.h>
 
 #include <nettle/aes.h>
-#include <nettle/ctr.h>
-#include <nettle/nettle-meta.h>
 #include "bstrlib.h"
 
 #include "assertions.h"
@@ -31,15 +29,33 @@
 #include "dynamic_memory_check.h"
 #include "secu_defs.h"
 
+// Counter blocks ciphered by one nas_stream_aes_encrypt() call
+#define EEA2_CTR_BLOCKS 8
+
 int nas_stream_encrypt_eea2(nas_stream_cipher_t *const stream_cipher,
                             uint8_t *const out) {
-  uint8_t m[16];
+  nas_stream_key_t stream_key;
+
+  DevAssert(stream_cipher != NULL);
+  DevAssert(stream_cipher->key != NULL);
+  DevAssert(stream_cipher->key_length == 16);
+  nas_stream_key_setup(&stream_key, stream_cipher->key);
+  return nas_stream_encrypt_eea2_key(&stream_key, stream_cipher, out);
+}
+
+//------------------------------------------------------------------------------
+int nas_stream_encrypt_eea2_key(const nas_stream_key_t *const stream_key,
+                                nas_stream_cipher_t *const stream_cipher,
+                                uint8_t *const out) {
+  uint8_t ctr[EEA2_CTR_BLOCKS * AES_BLOCK_SIZE];
+  uint8_t ks[EEA2_CTR_BLOCKS * AES_BLOCK_SIZE];
   uint32_t local_count;
-  void *ctx;
-  uint8_t *data;
   uint32_t zero_bit = 0;
   uint32_t byte_length;
+  uint64_t block = 0;
 
+  DevAssert(stream_key != NULL);
+  DevAssert(stream_key->is_set);
   DevAssert(stream_cipher != NULL);
   DevAssert(out != NULL);
   zero_bit = stream_cipher->blength & 0x7;
@@ -47,31 +63,41 @@ int nas_stream_encrypt_eea2(nas_stream_cipher_t *const stream_cipher,
 
   if (zero_bit > 0) byte_length += 1;
 
-  ctx = malloc(nettle_aes128.context_size);
-  data = calloc(1, byte_length);
-  local_count = hton_int32(stream_cipher->count);
-  memset(m, 0, sizeof(m));
-  memcpy(&m[0], &local_count, 4);
-  m[4] = ((stream_cipher->bearer & 0x1F) << 3) |
-         ((stream_cipher->direction & 0x01) << 2);
   /*
-   * Other bits are 0
+   * Initial counter block: COUNT || BEARER || DIRECTION || 0..0, the 64
+   * least significant bits are the block counter
    */
-#if NETTLE_VERSION_MAJOR < 3
-  nettle_aes128.set_encrypt_key(ctx, stream_cipher->key_length,
-                                stream_cipher->key);
-#else
-  nettle_aes128.set_encrypt_key(ctx, stream_cipher->key);
-#endif
-  nettle_ctr_crypt(ctx, nettle_aes128.encrypt, nettle_aes128.block_size, m,
-                   byte_length, data, stream_cipher->message);
+  local_count = hton_int32(stream_cipher->count);
+  memset(ctr, 0, AES_BLOCK_SIZE);
+  memcpy(&ctr[0], &local_count, 4);
+  ctr[4] = ((stream_cipher->bearer & 0x1F) << 3) |
+           ((stream_cipher->direction & 0x01) << 2);
+
+  for (uint32_t offset = 0; offset < byte_length;) {
+    uint32_t length = byte_length - offset;
+    uint32_t nb_blocks = 0;
+
+    if (length > sizeof(ks)) length = sizeof(ks);
+    nb_blocks = (length + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE;
+    for (uint32_t b = 0; b < nb_blocks; b++, block++) {
+      uint8_t *cb = &ctr[b * AES_BLOCK_SIZE];
+
+      if (b) memcpy(cb, ctr, 8);
+      for (int i = 0; i < 8; i++) {
+        cb[15 - i] = (uint8_t)(block >> (8 * i));
+      }
+    }
+    nas_stream_aes_encrypt(&stream_key->aes, nb_blocks * AES_BLOCK_SIZE, ks,
+                           ctr);
+    for (uint32_t i = 0; i < length; i++) {
+      out[offset + i] = stream_cipher->message[offset + i] ^ ks[i];
+    }
+    offset += length;
+  }
 
   if (zero_bit > 0)
-    data[byte_length - 1] =
-        data[byte_length - 1] & (uint8_t)(0xFF << (8 - zero_bit));
+    out[byte_length - 1] =
+        out[byte_length - 1] & (uint8_t)(0xFF << (8 - zero_bit));
 
-  memcpy(out, data, byte_length);
-  free_wrapper((void **)&data);
-  free_wrapper((void **)&ctx);
   return 0;
 }
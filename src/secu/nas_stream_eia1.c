@@ -21,6 +21,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#if defined(__x86_64__)
+#include <wmmintrin.h>
+#endif
 
 #include "secu_defs.h"
 
@@ -31,6 +34,7 @@
 uint64_t MUL64x(uint64_t V, uint64_t c);
 uint64_t MUL64xPOW(uint64_t V, uint32_t i, uint64_t c);
 uint64_t MUL64(uint64_t V, uint64_t P, uint64_t c);
+static uint64_t MUL64_select(uint64_t V, uint64_t P, uint64_t c);
 int nas_stream_encrypt_eia1(nas_stream_cipher_t *const stream_cipher,
                             uint8_t const out[4]);
 
@@ -79,15 +83,55 @@ uint64_t MUL64xPOW(uint64_t V, uint32_t i, uint64_t c) {
 */
 uint64_t MUL64(uint64_t V, uint64_t P, uint64_t c) {
   uint64_t result = 0;
-  int i = 0;
 
-  for (i = 0; i < 64; i++) {
-    if ((P >> i) & 0x1) result ^= MUL64xPOW(V, i, c);
+  // V * x^i is obtained from V * x^(i-1), no need to restart from V (MUL64xPOW)
+  while (P) {
+    if (P & 0x1) result ^= V;
+    V = MUL64x(V, c);
+    P >>= 1;
   }
 
   return result;
 }
 
+#if defined(__x86_64__)
+/* MUL64_clmul.
+   Same as MUL64 with the carry-less multiply instruction: the 128-bit
+   product V * P is reduced modulo x^64 + c by multiplying twice the upper
+   64 bits by c (c is at most 8 bits wide, 0x1b for EIA1).
+*/
+__attribute__((target("pclmul,sse2"))) static uint64_t MUL64_clmul(
+    uint64_t V, uint64_t P, uint64_t c) {
+  __m128i C = _mm_cvtsi64_si128((long long)c);
+  __m128i R = _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)V),
+                                   _mm_cvtsi64_si128((long long)P), 0x00);
+  uint64_t result = (uint64_t)_mm_cvtsi128_si64(R);
+
+  // upper 64 bits times c, then the few bits exceeding 64 times c again
+  R = _mm_clmulepi64_si128(_mm_unpackhi_epi64(R, R), C, 0x00);
+  result ^= (uint64_t)_mm_cvtsi128_si64(R);
+  R = _mm_clmulepi64_si128(_mm_unpackhi_epi64(R, R), C, 0x00);
+  result ^= (uint64_t)_mm_cvtsi128_si64(R);
+  return result;
+}
+#endif
+
+/* MUL64 implementation used by nas_stream_encrypt_eia1(), the carry-less
+   multiply instruction is used when the CPU supports it.
+*/
+static uint64_t (*MUL64_impl)(uint64_t V, uint64_t P, uint64_t c) =
+    MUL64_select;
+
+static uint64_t MUL64_select(uint64_t V, uint64_t P, uint64_t c) {
+  uint64_t (*impl)(uint64_t V, uint64_t P, uint64_t c) = MUL64;
+
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("pclmul")) impl = MUL64_clmul;
+#endif
+  __atomic_store_n(&MUL64_impl, impl, __ATOMIC_RELAXED);
+  return impl(V, P, c);
+}
+
 /* mask32bit.
   Input n: an integer in 1-32.
   Output : a 32 bit mask.
@@ -124,6 +168,7 @@ int nas_stream_encrypt_eia1(nas_stream_cipher_t *const stream_cipher,
   int rem_bits;
   uint32_t mask = 0;
   uint32_t *message;
+  uint64_t (*mul64)(uint64_t V, uint64_t P, uint64_t c);
 
   message =
       (uint32_t *)
@@ -189,6 +234,7 @@ int nas_stream_encrypt_eia1(nas_stream_cipher_t *const stream_cipher,
   // printf ("D:%d\n",D);
   EVAL = 0;
   c = 0x1b;
+  mul64 = __atomic_load_n(&MUL64_impl, __ATOMIC_RELAXED);
 
   /*
    * for 0 <= i <= D-3
@@ -196,7 +242,7 @@ int nas_stream_encrypt_eia1(nas_stream_cipher_t *const stream_cipher,
   for (i = 0; i < D - 2; i++) {
     V = EVAL ^ ((uint64_t)hton_int32(message[2 * i]) << 32 |
                 (uint64_t)hton_int32(message[2 * i + 1]));
-    EVAL = MUL64(V, P, c);
+    EVAL = mul64(V, P, c);
     // printf ("Mi: %16X %16X\tEVAL:
     // %16lX\n",hton_int32(message[2*i]),hton_int32(message[2*i+1]), EVAL);
   }
@@ -218,7 +264,7 @@ int nas_stream_encrypt_eia1(nas_stream_cipher_t *const stream_cipher,
   }
 
   V = EVAL ^ M_D_2;
-  EVAL = MUL64(V, P, c);
+  EVAL = mul64(V, P, c);
   /*
    * for D-1
    */
@@ -226,7 +272,7 @@ int nas_stream_encrypt_eia1(nas_stream_cipher_t *const stream_cipher,
   /*
    * Multiply by Q
    */
-  EVAL = MUL64(EVAL, Q, c);
+  EVAL = mul64(EVAL, Q, c);
   MAC_I = (uint32_t)(EVAL >> 32) ^ z[4];
   // printf ("MAC_I:%16X\n",MAC_I);
   MAC_I = hton_int32(MAC_I);
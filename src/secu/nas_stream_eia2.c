@@ -21,16 +21,10 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "secu_defs.h"
+#include <nettle/aes.h>
 
-#include <openssl/aes.h>
-#include <openssl/cmac.h>
-#include <openssl/evp.h>
+#include "secu_defs.h"
 
-// test
-#include <openssl/bio.h>
-#include <openssl/err.h>
-#include <openssl/ssl.h>
 #include "bstrlib.h"
 
 #include "assertions.h"
@@ -39,6 +33,37 @@
 #include "gcc_diag.h"
 #include "log.h"
 
+/*
+ * AES-CMAC (RFC 4493) computed directly with the expanded key: the
+ * subkeys K1/K2 are derived once in nas_stream_key_setup().
+ */
+
+// Multiplication by x in GF(2^128), RFC 4493 section 2.3
+static void cmac_double(uint8_t out[AES_BLOCK_SIZE],
+                        const uint8_t in[AES_BLOCK_SIZE]) {
+  uint8_t msb = in[0] & 0x80;
+
+  for (int i = 0; i < AES_BLOCK_SIZE - 1; i++) {
+    out[i] = (uint8_t)(in[i] << 1) | (in[i + 1] >> 7);
+  }
+  out[AES_BLOCK_SIZE - 1] =
+      (uint8_t)(in[AES_BLOCK_SIZE - 1] << 1) ^ ((msb) ? 0x87 : 0x00);
+}
+
+//------------------------------------------------------------------------------
+void nas_stream_key_setup(nas_stream_key_t *const stream_key,
+                          const uint8_t *const key) {
+  uint8_t L[AES_BLOCK_SIZE] = {0};
+
+  DevAssert(stream_key != NULL);
+  DevAssert(key != NULL);
+  nas_stream_aes_set_key(&stream_key->aes, key);
+  nas_stream_aes_encrypt(&stream_key->aes, AES_BLOCK_SIZE, L, L);
+  cmac_double(stream_key->k1, L);
+  cmac_double(stream_key->k2, stream_key->k1);
+  stream_key->is_set = true;
+}
+
 /*!
    @brief Create integrity cmac t for a given message.
    @param[in] stream_cipher Structure containing various variables to setup
@@ -47,47 +72,84 @@
 */
 int nas_stream_encrypt_eia2(nas_stream_cipher_t *const stream_cipher,
                             uint8_t const out[4]) {
-  uint8_t *m = NULL;
+  nas_stream_key_t stream_key;
+
+  DevAssert(stream_cipher != NULL);
+  DevAssert(stream_cipher->key != NULL);
+  DevAssert(stream_cipher->key_length == 16);
+  nas_stream_key_setup(&stream_key, stream_cipher->key);
+  return nas_stream_encrypt_eia2_key(&stream_key, stream_cipher,
+                                     (uint8_t *)out);
+}
+
+//------------------------------------------------------------------------------
+int nas_stream_encrypt_eia2_key(const nas_stream_key_t *const stream_key,
+                                nas_stream_cipher_t *const stream_cipher,
+                                uint8_t out[4]) {
+  uint8_t x[AES_BLOCK_SIZE] = {0};
+  uint8_t *message = NULL;
   uint32_t local_count = 0;
-  size_t size = 4;
-  uint8_t data[16] = {0};
-  CMAC_CTX *cmac_ctx = NULL;
-  const EVP_CIPHER *cipher = EVP_aes_128_cbc();
   uint32_t zero_bit = 0;
   uint32_t m_length;
+  uint32_t offset = 0;
+  uint32_t remaining = 0;
 
+  DevAssert(stream_key != NULL);
+  DevAssert(stream_key->is_set);
   DevAssert(stream_cipher != NULL);
-  DevAssert(stream_cipher->key != NULL);
-  DevAssert(stream_cipher->key_length > 0);
   DevAssert(out != NULL);
   zero_bit = stream_cipher->blength & 0x7;
   m_length = stream_cipher->blength >> 3;
 
   if (zero_bit > 0) m_length += 1;
 
+  OAILOG_TRACE(LOG_NAS, "Byte length: %u, Zero bits: %u:\n", m_length + 8,
+               zero_bit);
+  /*
+   * M = COUNT || BEARER || DIRECTION || 0..0 (64 bits) || MESSAGE, the first
+   * block is the 8 bytes header followed by the first 8 bytes of the message
+   */
   local_count = hton_int32(stream_cipher->count);
-  m = calloc(1, m_length + 8);
-  memcpy(&m[0], &local_count, 4);
-  m[4] = ((stream_cipher->bearer & 0x1F) << 3) |
+  memcpy(&x[0], &local_count, 4);
+  x[4] = ((stream_cipher->bearer & 0x1F) << 3) |
          ((stream_cipher->direction & 0x01) << 2);
-  memcpy(&m[8], stream_cipher->message, m_length);
+  message = stream_cipher->message;
+  offset = (m_length < 8) ? m_length : 8;
+  for (uint32_t i = 0; i < offset; i++) {
+    x[8 + i] ^= message[i];
+  }
+  remaining = m_length - offset;
 
-  OAILOG_TRACE(LOG_NAS, "Byte length: %u, Zero bits: %u:\n", m_length + 8,
-               zero_bit);
-  OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "m:", m, m_length + 8);
-  OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "Key:", stream_cipher->key,
-                    stream_cipher->key_length);
-  OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS,
-                    "Message:", stream_cipher->message, m_length);
-
-  cmac_ctx = CMAC_CTX_new();
-  CMAC_Init(cmac_ctx, stream_cipher->key, stream_cipher->key_length, cipher,
-            NULL);
-  CMAC_Update(cmac_ctx, m, m_length + 8);
-  CMAC_Final(cmac_ctx, data, &size);
-  CMAC_CTX_free(cmac_ctx);
-  OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "Out:", data, size);
-  memcpy((void *)out, data, 4);
-  free_wrapper((void **)&m);
+  if (remaining > 0) {
+    nas_stream_aes_encrypt(&stream_key->aes, AES_BLOCK_SIZE, x, x);
+    // All the blocks but the last one
+    while (remaining > AES_BLOCK_SIZE) {
+      for (int i = 0; i < AES_BLOCK_SIZE; i++) {
+        x[i] ^= message[offset + i];
+      }
+      nas_stream_aes_encrypt(&stream_key->aes, AES_BLOCK_SIZE, x, x);
+      offset += AES_BLOCK_SIZE;
+      remaining -= AES_BLOCK_SIZE;
+    }
+    for (uint32_t i = 0; i < remaining; i++) {
+      x[i] ^= message[offset + i];
+    }
+  } else {
+    // The header and the message fit in the first block
+    remaining = 8 + m_length;
+  }
+
+  if (AES_BLOCK_SIZE == remaining) {
+    for (int i = 0; i < AES_BLOCK_SIZE; i++) {
+      x[i] ^= stream_key->k1[i];
+    }
+  } else {
+    x[remaining] ^= 0x80;
+    for (int i = 0; i < AES_BLOCK_SIZE; i++) {
+      x[i] ^= stream_key->k2[i];
+    }
+  }
+  nas_stream_aes_encrypt(&stream_key->aes, AES_BLOCK_SIZE, x, x);
+  memcpy(out, x, 4);
   return 0;
 }
@@ -18,22 +18,66 @@
 #ifndef FILE_SECU_DEFS_SEEN
 #define FILE_SECU_DEFS_SEEN
 
+#include <stdbool.h>
+#include <nettle/aes.h>
+#include <nettle/hmac.h>
+
 #include "security_types.h"
 
 #define SECU_DIRECTION_UPLINK 0
 #define SECU_DIRECTION_DOWNLINK 1
 
+#define KDF_KEY_MAX_LENGTH 32
+
+/*! \struct  kdf_key_t
+ * \brief KDF (HMAC-SHA-256) key with its ipad/opad blocks already
+ * compressed, a derivation with this key only hashes S and the inner digest.
+ */
+typedef struct kdf_key_s {
+  uint8_t key[KDF_KEY_MAX_LENGTH]; /*!< \brief to detect a key change */
+  unsigned key_len;
+  struct hmac_sha256_ctx hmac; /*!< \brief state after the key blocks */
+  bool is_set;
+} kdf_key_t;
+
 void kdf(const uint8_t* key, const unsigned key_len, uint8_t* s,
          const unsigned s_len, uint8_t* out, const unsigned out_len);
 
+/*
+ * Set up kdf_key for key, unless it is already set up for the same key (keep
+ * a kdf_key_t along with the K_ASME in use), returns kdf_key.
+ */
+const kdf_key_t* kdf_key_update(kdf_key_t* const kdf_key, const uint8_t* key,
+                                const unsigned key_len);
+
+void kdf_key_derive(const kdf_key_t* const kdf_key, const uint8_t* s,
+                    const unsigned s_len, uint8_t* out,
+                    const unsigned out_len);
+
 int derive_keNB(const uint8_t* kasme_32, const uint32_t nas_count,
                 uint8_t* keNB);
 
+int derive_keNB_key(const kdf_key_t* const kasme, const uint32_t nas_count,
+                    uint8_t* keNB);
+
 int derive_key_nas(algorithm_type_dist_t nas_alg_type, uint8_t nas_enc_alg_id,
                    const uint8_t* kasme_32, uint8_t* knas);
 
+int derive_key_nas_key(algorithm_type_dist_t nas_alg_type,
+                       uint8_t nas_enc_alg_id, const kdf_key_t* const kasme,
+                       uint8_t* knas);
+
 int derive_nh(const uint8_t* kasme_32, uint8_t* nh);
 
+int derive_nh_key(const kdf_key_t* const kasme, uint8_t* nh);
+
+/*
+ * NH chain (33.401 A.4): nh holds NH (or KeNB for the first hop) and is
+ * replaced by the num_hops next NH values in turn, returns the last one.
+ */
+int derive_nh_chain_key(const kdf_key_t* const kasme, uint8_t* nh,
+                        const unsigned num_hops);
+
 #define derive_key_nas_enc(aLGiD, kASME, kNAS) \
   derive_key_nas(NAS_ENC_ALG, aLGiD, kASME, kNAS)
 
@@ -66,6 +110,30 @@ typedef struct {
   uint32_t blength;
 } nas_stream_cipher_t;
 
+#if NETTLE_VERSION_MAJOR < 3
+#define NAS_STREAM_AES_CTX struct aes_ctx
+#define nas_stream_aes_set_key(cTX, kEY) aes_set_encrypt_key(cTX, 16, kEY)
+#define nas_stream_aes_encrypt aes_encrypt
+#else
+#define NAS_STREAM_AES_CTX struct aes128_ctx
+#define nas_stream_aes_set_key aes128_set_encrypt_key
+#define nas_stream_aes_encrypt aes128_encrypt
+#endif
+
+/*! \struct  nas_stream_key_t
+ * \brief 128-bit NAS key expanded once for EEA2/EIA2: AES key schedule and
+ * CMAC subkeys, so that protecting a message only costs its AES blocks.
+ */
+typedef struct nas_stream_key_s {
+  NAS_STREAM_AES_CTX aes;     /*!< \brief encryption key schedule */
+  uint8_t k1[AES_BLOCK_SIZE]; /*!< \brief CMAC subkey, complete last block */
+  uint8_t k2[AES_BLOCK_SIZE]; /*!< \brief CMAC subkey, padded last block */
+  bool is_set;
+} nas_stream_key_t;
+
+void nas_stream_key_setup(nas_stream_key_t* const stream_key,
+                          const uint8_t* const key);
+
 int nas_stream_encrypt_eea1(nas_stream_cipher_t* const stream_cipher,
                             uint8_t* const out);
 
@@ -78,6 +146,19 @@ int nas_stream_encrypt_eea2(nas_stream_cipher_t* const stream_cipher,
 int nas_stream_encrypt_eia2(nas_stream_cipher_t* const stream_cipher,
                             uint8_t const out[4]);
 
+/*
+ * Same as nas_stream_encrypt_eea2/eia2 with an already expanded key,
+ * stream_cipher->key is not used. out may be stream_cipher->message (in
+ * place ciphering).
+ */
+int nas_stream_encrypt_eea2_key(const nas_stream_key_t* const stream_key,
+                                nas_stream_cipher_t* const stream_cipher,
+                                uint8_t* const out);
+
+int nas_stream_encrypt_eia2_key(const nas_stream_key_t* const stream_key,
+                                nas_stream_cipher_t* const stream_cipher,
+                                uint8_t out[4]);
+
 #undef SECU_DEBUG
 
 #endif /* FILE_SECU_DEFS_SEEN */
@@ -15,6 +15,7 @@
  *      contact@openairinterface.org
  */
 
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -29,6 +30,7 @@ static uint32_t _MULalpha(uint8_t c);
 static uint32_t _DIValpha(uint8_t c);
 static uint32_t _S1(uint32_t w);
 static uint32_t _S2(uint32_t w);
+static void _snow3g_init_tables(void);
 static void _snow3g_clock_LFSR_initialization_mode(
     uint32_t F, snow_3g_context_t* s3g_ctx_pP);
 static void _snow3g_clock_LFSR_key_stream_mode(
@@ -39,6 +41,19 @@ void snow3g_initialize(uint32_t k[4], uint32_t IV[4],
 void snow3g_generate_key_stream(uint32_t n, uint32_t* ks,
                                 snow_3g_context_t* snow_3g_context_pP);
 
+/*
+ * MULalpha, DIValpha and the S-Boxes S1, S2 only depend on one byte of their
+ * input: they are computed once for the 256 byte values (_snow3g_init_tables)
+ * and the clocking functions only do table lookups.
+ * S1 (resp. S2) is split in 4 tables, one per input byte, each entry holding
+ * the contribution of this byte to the 4 output bytes (AES like T-tables).
+ */
+static uint32_t _snow3g_MULalpha_table[256];
+static uint32_t _snow3g_DIValpha_table[256];
+static uint32_t _snow3g_S1_table[4][256];
+static uint32_t _snow3g_S2_table[4][256];
+static pthread_once_t _snow3g_tables_once = PTHREAD_ONCE_INIT;
+
 /* _MULx.
   Input V: an 8-bit input.
   Input c: an 8-bit input.
@@ -63,16 +78,17 @@ static uint8_t _MULx(uint8_t V, uint8_t c) {
 */
 
 static uint8_t _MULxPOW(uint8_t V, uint8_t i, uint8_t c) {
-  if (i == 0)
-    return V;
-  else
-    return _MULx(_MULxPOW(V, i - 1, c), c);
+  while (i--) {
+    V = _MULx(V, c);
+  }
+  return V;
 }
 
 /* The function _MULalpha.
   Input c: 8-bit input.
   Output : 32-bit output.
   maps 8 bits to 32 bits.
+  Only used to fill _snow3g_MULalpha_table.
 */
 
 static uint32_t _MULalpha(uint8_t c) {
@@ -86,6 +102,7 @@ static uint32_t _MULalpha(uint8_t c) {
   Input c: 8-bit input.
   Output : 32-bit output.
   maps 8 bits to 32 bit.
+  Only used to fill _snow3g_DIValpha_table.
 */
 
 static uint32_t _DIValpha(uint8_t c) {
@@ -104,19 +121,10 @@ static uint32_t _DIValpha(uint8_t c) {
   least significant byte.
 */
 
-static uint32_t _S1(uint32_t w) {
-  uint8_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
-  uint8_t srw0 = SR[(uint8_t)((w >> 24) & 0xff)];
-  uint8_t srw1 = SR[(uint8_t)((w >> 16) & 0xff)];
-  uint8_t srw2 = SR[(uint8_t)((w >> 8) & 0xff)];
-  uint8_t srw3 = SR[(uint8_t)((w)&0xff)];
-
-  r0 = ((_MULx(srw0, 0x1b)) ^ (srw1) ^ (srw2) ^ ((_MULx(srw3, 0x1b)) ^ srw3));
-  r1 = (((_MULx(srw0, 0x1b)) ^ srw0) ^ (_MULx(srw1, 0x1b)) ^ (srw2) ^ (srw3));
-  r2 = ((srw0) ^ ((_MULx(srw1, 0x1b)) ^ srw1) ^ (_MULx(srw2, 0x1b)) ^ (srw3));
-  r3 = ((srw0) ^ (srw1) ^ ((_MULx(srw2, 0x1b)) ^ srw2) ^ (_MULx(srw3, 0x1b)));
-  return ((((uint32_t)r0) << 24) | (((uint32_t)r1) << 16) |
-          (((uint32_t)r2) << 8) | (((uint32_t)r3)));
+static inline uint32_t _S1(uint32_t w) {
+  return _snow3g_S1_table[0][(w >> 24) & 0xff] ^
+         _snow3g_S1_table[1][(w >> 16) & 0xff] ^
+         _snow3g_S1_table[2][(w >> 8) & 0xff] ^ _snow3g_S1_table[3][w & 0xff];
 }
 
 /* The 32x32-bit S-Box S2
@@ -128,19 +136,39 @@ static uint32_t _S1(uint32_t w) {
   r3 the least significant byte.
 */
 
-static uint32_t _S2(uint32_t w) {
-  uint8_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
-  uint8_t sqw0 = SQ[(uint8_t)((w >> 24) & 0xff)];
-  uint8_t sqw1 = SQ[(uint8_t)((w >> 16) & 0xff)];
-  uint8_t sqw2 = SQ[(uint8_t)((w >> 8) & 0xff)];
-  uint8_t sqw3 = SQ[(uint8_t)((w)&0xff)];
-
-  r0 = ((_MULx(sqw0, 0x69)) ^ (sqw1) ^ (sqw2) ^ ((_MULx(sqw3, 0x69)) ^ sqw3));
-  r1 = (((_MULx(sqw0, 0x69)) ^ sqw0) ^ (_MULx(sqw1, 0x69)) ^ (sqw2) ^ (sqw3));
-  r2 = ((sqw0) ^ ((_MULx(sqw1, 0x69)) ^ sqw1) ^ (_MULx(sqw2, 0x69)) ^ (sqw3));
-  r3 = ((sqw0) ^ (sqw1) ^ ((_MULx(sqw2, 0x69)) ^ sqw2) ^ (_MULx(sqw3, 0x69)));
-  return ((((uint32_t)r0) << 24) | (((uint32_t)r1) << 16) |
-          (((uint32_t)r2) << 8) | (((uint32_t)r3)));
+static inline uint32_t _S2(uint32_t w) {
+  return _snow3g_S2_table[0][(w >> 24) & 0xff] ^
+         _snow3g_S2_table[1][(w >> 16) & 0xff] ^
+         _snow3g_S2_table[2][(w >> 8) & 0xff] ^ _snow3g_S2_table[3][w & 0xff];
+}
+
+/* Fill the lookup tables.
+  For an input byte x of S1 with s = SR[x] and m = MULx(s, 0x1b):
+  r0 = m0 ^ s1 ^ s2 ^ (m3 ^ s3)      r1 = (m0 ^ s0) ^ m1 ^ s2 ^ s3
+  r2 = s0 ^ (m1 ^ s1) ^ m2 ^ s3      r3 = s0 ^ s1 ^ (m2 ^ s2) ^ m3
+  S2 is built the same way with SQ and 0x69.
+*/
+
+static void _snow3g_init_tables(void) {
+  for (int x = 0; x < 256; x++) {
+    uint32_t s = SR[x];
+    uint32_t m = _MULx(SR[x], 0x1b);
+    uint32_t q = SQ[x];
+    uint32_t n = _MULx(SQ[x], 0x69);
+
+    _snow3g_MULalpha_table[x] = _MULalpha((uint8_t)x);
+    _snow3g_DIValpha_table[x] = _DIValpha((uint8_t)x);
+
+    _snow3g_S1_table[0][x] = (m << 24) | ((m ^ s) << 16) | (s << 8) | s;
+    _snow3g_S1_table[1][x] = (s << 24) | (m << 16) | ((m ^ s) << 8) | s;
+    _snow3g_S1_table[2][x] = (s << 24) | (s << 16) | (m << 8) | (m ^ s);
+    _snow3g_S1_table[3][x] = ((m ^ s) << 24) | (s << 16) | (s << 8) | m;
+
+    _snow3g_S2_table[0][x] = (n << 24) | ((n ^ q) << 16) | (q << 8) | q;
+    _snow3g_S2_table[1][x] = (q << 24) | (n << 16) | ((n ^ q) << 8) | q;
+    _snow3g_S2_table[2][x] = (q << 24) | (q << 16) | (n << 8) | (n ^ q);
+    _snow3g_S2_table[3][x] = ((n ^ q) << 24) | (q << 16) | (q << 8) | n;
+  }
 }
 
 /* Clocking LFSR in initialization mode.
@@ -149,13 +177,13 @@ static uint32_t _S2(uint32_t w) {
   See section 3.4.4.
 */
 
-static void _snow3g_clock_LFSR_initialization_mode(
+static inline void _snow3g_clock_LFSR_initialization_mode(
     uint32_t F, snow_3g_context_t* s3g_ctx_pP) {
   uint32_t v =
       (((s3g_ctx_pP->LFSR_S0 << 8) & 0xffffff00) ^
-       (_MULalpha((uint8_t)((s3g_ctx_pP->LFSR_S0 >> 24) & 0xff))) ^
+       (_snow3g_MULalpha_table[(s3g_ctx_pP->LFSR_S0 >> 24) & 0xff]) ^
        (s3g_ctx_pP->LFSR_S2) ^ ((s3g_ctx_pP->LFSR_S11 >> 8) & 0x00ffffff) ^
-       (_DIValpha((uint8_t)((s3g_ctx_pP->LFSR_S11) & 0xff))) ^ (F));
+       (_snow3g_DIValpha_table[s3g_ctx_pP->LFSR_S11 & 0xff]) ^ (F));
 
   s3g_ctx_pP->LFSR_S0 = s3g_ctx_pP->LFSR_S1;
   s3g_ctx_pP->LFSR_S1 = s3g_ctx_pP->LFSR_S2;
@@ -179,14 +207,14 @@ static void _snow3g_clock_LFSR_initialization_mode(
   LFSR Registers S0 to S15 are updated as the LFSR receives a single clock.
   See section 3.4.5.
 */
-static void _snow3g_clock_LFSR_key_stream_mode(
+static inline void _snow3g_clock_LFSR_key_stream_mode(
     snow_3g_context_t* snow_3g_context_pP) {
   uint32_t v =
       (((snow_3g_context_pP->LFSR_S0 << 8) & 0xffffff00) ^
-       (_MULalpha((uint8_t)((snow_3g_context_pP->LFSR_S0 >> 24) & 0xff))) ^
+       (_snow3g_MULalpha_table[(snow_3g_context_pP->LFSR_S0 >> 24) & 0xff]) ^
        (snow_3g_context_pP->LFSR_S2) ^
        ((snow_3g_context_pP->LFSR_S11 >> 8) & 0x00ffffff) ^
-       (_DIValpha((uint8_t)((snow_3g_context_pP->LFSR_S11) & 0xff))));
+       (_snow3g_DIValpha_table[snow_3g_context_pP->LFSR_S11 & 0xff]));
 
   snow_3g_context_pP->LFSR_S0 = snow_3g_context_pP->LFSR_S1;
   snow_3g_context_pP->LFSR_S1 = snow_3g_context_pP->LFSR_S2;
@@ -212,7 +240,8 @@ static void _snow3g_clock_LFSR_key_stream_mode(
   See Section 3.4.6.
 */
 
-static uint32_t _snow3g_clock_fsm(snow_3g_context_t* snow_3g_context_pP) {
+static inline uint32_t _snow3g_clock_fsm(
+    snow_3g_context_t* snow_3g_context_pP) {
   uint32_t F = ((snow_3g_context_pP->LFSR_S15 + snow_3g_context_pP->FSM_R1) &
                 0xffffffff) ^
                snow_3g_context_pP->FSM_R2;
@@ -238,6 +267,7 @@ void snow3g_initialize(uint32_t k[4], uint32_t IV[4],
   uint8_t i = 0;
   uint32_t F = 0x0;
 
+  pthread_once(&_snow3g_tables_once, _snow3g_init_tables);
   snow_3g_context_pP->LFSR_S15 = k[3] ^ IV[0];
   snow_3g_context_pP->LFSR_S14 = k[2];
   snow_3g_context_pP->LFSR_S13 = k[1];
@@ -0,0 +1,296 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * Parsing of the S11 responses received by the MME (Create Session, Modify
+ * Bearer and Delete Session Response, as sent by the SPGW):
+ *  - stack IE parsing of the received buffer (nwGtpv2cMsgIeParse),
+ *  - the same plus a message parser created, filled and deleted for each
+ *    message, with the IEs the S11 handlers register,
+ *  - the same with a message parser kept per message type,
+ *  - the message parser per message with messages referencing the receive
+ *    buffer instead of a copy of the datagram,
+ * then the statistics of the message and parser pools of the stack.
+ *
+ * usage: oaisim_mme_gtpv2c_benchmark [nb_messages]
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "NwGtpv2c.h"
+#include "NwGtpv2cIe.h"
+#include "NwGtpv2cMsg.h"
+#include "NwGtpv2cMsgParser.h"
+#include "NwGtpv2cPrivate.h"
+#include "assertions.h"
+#include "dynamic_memory_check.h"
+#include "log.h"
+#include "shared_ts_log.h"
+
+#define DEFAULT_NB_MESSAGES 1000000
+#define MAX_PARSER_IES 16
+
+typedef struct bench_ie_s {
+  uint8_t type;
+  uint8_t instance;
+  uint8_t presence;
+} bench_ie_t;
+
+typedef struct bench_msg_s {
+  const char *name;
+  uint8_t type;
+  const uint8_t *buf;
+  uint32_t len;
+  bench_ie_t ies[MAX_PARSER_IES];
+  int nb_ies;
+  nw_gtpv2c_msg_parser_t *parser;
+} bench_msg_t;
+
+static const uint8_t create_session_rsp[] = {
+    0x48, 0x21, 0x00, 0x72, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00,
+    /* Cause */
+    0x02, 0x00, 0x02, 0x00, 0x10, 0x00,
+    /* Sender F-TEID for control plane */
+    0x57, 0x00, 0x09, 0x00, 0x8b, 0x00, 0x00, 0x00, 0x01, 0xc0, 0xa8, 0x0c,
+    0x01,
+    /* PGW S5/S8 F-TEID for control plane */
+    0x57, 0x00, 0x09, 0x01, 0x87, 0x00, 0x00, 0x00, 0x02, 0xc0, 0xa8, 0x0c,
+    0x02,
+    /* PAA */
+    0x4f, 0x00, 0x05, 0x00, 0x01, 0x0a, 0x00, 0x00, 0x02,
+    /* APN restriction */
+    0x7f, 0x00, 0x01, 0x00, 0x00,
+    /* APN-AMBR */
+    0x48, 0x00, 0x08, 0x00, 0x00, 0x00, 0xc3, 0x50, 0x00, 0x00, 0xc3, 0x50,
+    /* PCO, DNS server */
+    0x4e, 0x00, 0x08, 0x00, 0x80, 0x00, 0x0d, 0x04, 0x08, 0x08, 0x08, 0x08,
+    /* Bearer context created: EBI, cause, S1-U SGW F-TEID, charging id */
+    0x5d, 0x00, 0x20, 0x00, 0x49, 0x00, 0x01, 0x00, 0x05, 0x02, 0x00, 0x02,
+    0x00, 0x10, 0x00, 0x57, 0x00, 0x09, 0x00, 0x81, 0x00, 0x00, 0x00, 0x03,
+    0xc0, 0xa8, 0x0d, 0x01, 0x5e, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x01};
+
+static const uint8_t modify_bearer_rsp[] = {
+    0x48, 0x23, 0x00, 0x2a, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x02, 0x00,
+    /* Cause */
+    0x02, 0x00, 0x02, 0x00, 0x10, 0x00,
+    /* Bearer context modified: EBI, cause, S1-U SGW F-TEID */
+    0x5d, 0x00, 0x18, 0x00, 0x49, 0x00, 0x01, 0x00, 0x05, 0x02, 0x00, 0x02,
+    0x00, 0x10, 0x00, 0x57, 0x00, 0x09, 0x00, 0x81, 0x00, 0x00, 0x00, 0x03,
+    0xc0, 0xa8, 0x0d, 0x01};
+
+static const uint8_t delete_session_rsp[] = {
+    0x48, 0x25, 0x00, 0x1a, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x03, 0x00,
+    /* Cause */
+    0x02, 0x00, 0x02, 0x00, 0x10, 0x00,
+    /* PCO, DNS server */
+    0x4e, 0x00, 0x08, 0x00, 0x80, 0x00, 0x0d, 0x04, 0x08, 0x08, 0x08, 0x08};
+
+static bench_msg_t g_corpus[] = {
+    {"Create Session Response",
+     NW_GTP_CREATE_SESSION_RSP,
+     create_session_rsp,
+     sizeof(create_session_rsp),
+     {{NW_GTPV2C_IE_CAUSE, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_MANDATORY},
+      {NW_GTPV2C_IE_FTEID, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL},
+      {NW_GTPV2C_IE_FTEID, NW_GTPV2C_IE_INSTANCE_ONE,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL},
+      {NW_GTPV2C_IE_EBI, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL},
+      {NW_GTPV2C_IE_PAA, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL},
+      {NW_GTPV2C_IE_APN_RESTRICTION, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL},
+      {NW_GTPV2C_IE_AMBR, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL},
+      {NW_GTPV2C_IE_PCO, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL},
+      {NW_GTPV2C_IE_BEARER_CONTEXT, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL},
+      {NW_GTPV2C_IE_BEARER_CONTEXT, NW_GTPV2C_IE_INSTANCE_ONE,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL}},
+     10,
+     NULL},
+    {"Modify Bearer Response",
+     NW_GTP_MODIFY_BEARER_RSP,
+     modify_bearer_rsp,
+     sizeof(modify_bearer_rsp),
+     {{NW_GTPV2C_IE_CAUSE, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_MANDATORY},
+      {NW_GTPV2C_IE_EBI, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL},
+      {NW_GTPV2C_IE_RECOVERY, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_OPTIONAL},
+      {NW_GTPV2C_IE_BEARER_CONTEXT, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL},
+      {NW_GTPV2C_IE_BEARER_CONTEXT, NW_GTPV2C_IE_INSTANCE_ONE,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL}},
+     5,
+     NULL},
+    {"Delete Session Response",
+     NW_GTP_DELETE_SESSION_RSP,
+     delete_session_rsp,
+     sizeof(delete_session_rsp),
+     {{NW_GTPV2C_IE_CAUSE, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_MANDATORY},
+      {NW_GTPV2C_IE_RECOVERY, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_OPTIONAL},
+      {NW_GTPV2C_IE_PCO, NW_GTPV2C_IE_INSTANCE_ZERO,
+       NW_GTPV2C_IE_PRESENCE_CONDITIONAL}},
+     3,
+     NULL},
+};
+
+#define NB_CORPUS_MESSAGES (sizeof(g_corpus) / sizeof(g_corpus[0]))
+
+static uint64_t nb_messages = DEFAULT_NB_MESSAGES;
+static nw_gtpv2c_stack_handle_t g_stack = 0;
+static volatile uint64_t g_sink = 0;
+
+static nw_rc_t bench_ie_get(uint8_t ieType, uint16_t ieLength,
+                            uint8_t ieInstance, uint8_t *ieValue, void *arg) {
+  g_sink += ieType + ieLength + ieInstance + ieValue[0];
+  return NW_OK;
+}
+
+static nw_gtpv2c_msg_parser_t *bench_parser_new(const bench_msg_t *msg) {
+  nw_gtpv2c_msg_parser_t *parser = NULL;
+  nw_rc_t rc;
+
+  rc = nwGtpv2cMsgParserNew(g_stack, msg->type, bench_ie_get, NULL, &parser);
+  NW_ASSERT(NW_OK == rc);
+  for (int i = 0; i < msg->nb_ies; i++) {
+    rc = nwGtpv2cMsgParserAddIe(parser, msg->ies[i].type, msg->ies[i].instance,
+                                msg->ies[i].presence, bench_ie_get, NULL);
+    NW_ASSERT(NW_OK == rc);
+  }
+  return parser;
+}
+
+static double elapsed_ns(const struct timespec *start,
+                         const struct timespec *end) {
+  return ((double)(end->tv_sec - start->tv_sec) * 1e9) +
+         (double)(end->tv_nsec - start->tv_nsec);
+}
+
+static void print_result(const char *label, const struct timespec *start,
+                         const struct timespec *end) {
+  double ns = elapsed_ns(start, end);
+
+  printf("  %-36s %8.1f ns/message %10.0f messages/s\n", label,
+         ns / (double)nb_messages, ((double)nb_messages * 1e9) / ns);
+}
+
+/*
+ * ulp_parser: 0 no message parser, 1 parser per message, 2 parser kept
+ * rx_buffer: receive buffer referenced by the messages, NULL to copy
+ */
+static void bench_parse(const char *label, bench_msg_t *msg, int ulp_parser,
+                        shared_buffer_t *rx_buffer) {
+  nw_gtpv2c_stack_t *stack = (nw_gtpv2c_stack_t *)g_stack;
+  struct timespec start, end;
+  nw_gtpv2c_msg_handle_t hMsg;
+  nw_gtpv2c_error_t error;
+  uint8_t offendingIeType, offendingIeInstance;
+  uint16_t offendingIeLength;
+  nw_rc_t rc;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint64_t n = 0; n < nb_messages; n++) {
+    if (rx_buffer) {
+      rc = nwGtpv2cMsgFromSharedBufferNew(g_stack, rx_buffer, rx_buffer->data,
+                                          msg->len, &hMsg);
+    } else {
+      rc = nwGtpv2cMsgFromBufferNew(g_stack, (uint8_t *)msg->buf, msg->len,
+                                    &hMsg);
+    }
+    NW_ASSERT(NW_OK == rc);
+    rc = nwGtpv2cMsgIeParse(stack->pGtpv2cMsgIeParseInfo[msg->type], hMsg,
+                            &error);
+    NW_ASSERT(NW_OK == rc);
+    if (ulp_parser) {
+      nw_gtpv2c_msg_parser_t *parser =
+          (ulp_parser == 1) ? bench_parser_new(msg) : msg->parser;
+
+      rc = nwGtpv2cMsgParserRun(parser, hMsg, &offendingIeType,
+                                &offendingIeInstance, &offendingIeLength);
+      NW_ASSERT(NW_OK == rc);
+      if (ulp_parser == 1) nwGtpv2cMsgParserDelete(g_stack, parser);
+    }
+    nwGtpv2cMsgDelete(g_stack, hMsg);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  print_result(label, &start, &end);
+}
+
+static void print_pool_stats(const char *label, nw_gtpv2c_pool_type_t type) {
+  nw_gtpv2c_pool_stats_t stats;
+
+  NW_ASSERT(NW_OK == nwGtpv2cGetPoolStats(g_stack, type, &stats));
+  printf("%s: %" PRIu64 " allocated, %" PRIu64 " reused, %" PRIu64
+         " freed, %u kept (high water %u, max %u)\n",
+         label, stats.nbAllocs, stats.nbReuses, stats.nbFrees, stats.size,
+         stats.highWater, stats.maxSize);
+}
+
+int main(int argc, char *argv[]) {
+  nw_rc_t rc;
+
+  if (argc > 1) nb_messages = strtoull(argv[1], NULL, 0);
+  if (!nb_messages) {
+    fprintf(stderr, "Bad arguments\n");
+    return EXIT_FAILURE;
+  }
+
+  CHECK_INIT_RETURN(shared_log_init(MAX_LOG_PROTOS));
+  CHECK_INIT_RETURN(
+      OAILOG_INIT(LOG_SPGW_ENV, OAILOG_LEVEL_ERROR, MAX_LOG_PROTOS));
+  rc = nwGtpv2cInitialize(&g_stack);
+  NW_ASSERT(NW_OK == rc);
+  for (int m = 0; m < NB_CORPUS_MESSAGES; m++) {
+    g_corpus[m].parser = bench_parser_new(&g_corpus[m]);
+  }
+
+  printf("%" PRIu64 " messages\n", nb_messages);
+  for (int m = 0; m < NB_CORPUS_MESSAGES; m++) {
+    shared_buffer_t *rx_buffer = shared_buffer_create(g_corpus[m].len);
+
+    memcpy(rx_buffer->data, g_corpus[m].buf, g_corpus[m].len);
+    printf("%s (%u bytes)\n", g_corpus[m].name, g_corpus[m].len);
+    bench_parse("stack IE parsing", &g_corpus[m], 0, NULL);
+    bench_parse("+ message parser per message", &g_corpus[m], 1, NULL);
+    bench_parse("+ message parser kept", &g_corpus[m], 2, NULL);
+    bench_parse("parser per message, no copy", &g_corpus[m], 1, rx_buffer);
+    NW_ASSERT(rx_buffer->refcount == 1);
+    shared_buffer_unref(&rx_buffer);
+  }
+  print_pool_stats("message pool", NW_GTPV2C_POOL_MSG);
+  print_pool_stats("message parser pool", NW_GTPV2C_POOL_MSG_PARSER);
+
+  for (int m = 0; m < NB_CORPUS_MESSAGES; m++) {
+    nwGtpv2cMsgParserDelete(g_stack, g_corpus[m].parser);
+  }
+  nwGtpv2cFinalize(g_stack);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * Compares the open addressing hash_table_uint64_ts_t against the chained
+ * hash_table_ts_t (same design as the former uint64 table: one malloc per node,
+ * one mutex per bucket) with keys allocated like mme_ue_s1ap_id or S11 TEIDs.
+ *
+ * usage: oaisim_mme_hashtable_benchmark [nb_keys] [initial_size]
+ */
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "bstrlib.h"
+
+#include "hashtable.h"
+
+#define DEFAULT_NB_KEYS 1000000
+
+static double elapsed_ns(const struct timespec *start,
+                         const struct timespec *end) {
+  return ((double)(end->tv_sec - start->tv_sec) * 1e9) +
+         (double)(end->tv_nsec - start->tv_nsec);
+}
+
+#define BENCH(lABEL, nB, sTATEMENT)                                    \
+  do {                                                                 \
+    struct timespec start, end;                                        \
+    clock_gettime(CLOCK_MONOTONIC, &start);                            \
+    for (uint64_t i = 0; i < (nB); i++) {                              \
+      sTATEMENT;                                                       \
+    }                                                                  \
+    clock_gettime(CLOCK_MONOTONIC, &end);                              \
+    printf("  %-24s %8.1f ns/op\n", lABEL, elapsed_ns(&start, &end) / (nB)); \
+  } while (0)
+
+static uint64_t key_of(uint64_t i, bool teid) {
+  // TEIDs are allocated with a stride in the upper bits, ids are sequential
+  return teid ? ((i << 8) | 0x1) : i + 1;
+}
+
+static int bench_uint64_ts(uint64_t nb_keys, hash_size_t size, bool teid) {
+  bstring name = bfromcstr("bench_uint64_ts");
+  hash_table_uint64_ts_t *htbl = hashtable_uint64_ts_create(size, NULL, name);
+  uint64_t data = 0;
+  uint64_t misses = 0;
+
+  printf("hash_table_uint64_ts_t (%s keys):\n", teid ? "TEID" : "sequential");
+  BENCH("insert", nb_keys,
+        hashtable_uint64_ts_insert(htbl, key_of(i, teid), i));
+  BENCH("get (hit)", nb_keys, {
+    if (hashtable_uint64_ts_get(htbl, key_of(i, teid), &data) !=
+            HASH_TABLE_OK ||
+        data != i)
+      misses++;
+  });
+  BENCH("get (miss)", nb_keys,
+        hashtable_uint64_ts_get(htbl, key_of(i + nb_keys, teid), &data));
+  BENCH("remove", nb_keys, {
+    if (hashtable_uint64_ts_remove(htbl, key_of(i, teid)) != HASH_TABLE_OK)
+      misses++;
+  });
+  hashtable_uint64_ts_destroy(htbl);
+  bdestroy(name);
+  return misses ? -1 : 0;
+}
+
+static int bench_ts(uint64_t nb_keys, hash_size_t size, bool teid) {
+  bstring name = bfromcstr("bench_ts");
+  hash_table_ts_t *htbl = hashtable_ts_create(size, NULL, NULL, name);
+  void *data = NULL;
+  uint64_t misses = 0;
+
+  printf("hash_table_ts_t (%s keys):\n", teid ? "TEID" : "sequential");
+  BENCH("insert", nb_keys,
+        hashtable_ts_insert(htbl, key_of(i, teid), (void *)(uintptr_t)i));
+  BENCH("get (hit)", nb_keys, {
+    if (hashtable_ts_get(htbl, key_of(i, teid), &data) != HASH_TABLE_OK ||
+        data != (void *)(uintptr_t)i)
+      misses++;
+  });
+  BENCH("get (miss)", nb_keys,
+        hashtable_ts_get(htbl, key_of(i + nb_keys, teid), &data));
+  BENCH("remove", nb_keys, {
+    if (hashtable_ts_remove(htbl, key_of(i, teid), &data) != HASH_TABLE_OK)
+      misses++;
+  });
+  hashtable_ts_destroy(htbl);
+  bdestroy(name);
+  return misses ? -1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+  uint64_t nb_keys = DEFAULT_NB_KEYS;
+  hash_size_t size = 0;
+  int rc = 0;
+
+  if (argc > 1) nb_keys = strtoull(argv[1], NULL, 0);
+  // Same sizing as mme_app_init() with MAX_UE = nb_keys by default
+  size = (argc > 2) ? strtoull(argv[2], NULL, 0) : nb_keys;
+
+  printf("%" PRIu64 " keys, initial size %zu\n", nb_keys, size);
+  for (int teid = 0; teid < 2; teid++) {
+    rc |= bench_ts(nb_keys, size, teid);
+    rc |= bench_uint64_ts(nb_keys, size, teid);
+  }
+  // Growth from a small table, as when MAX_UE is under-estimated
+  printf("grown from 1024 buckets:\n");
+  rc |= bench_ts(nb_keys, 1024, false);
+  rc |= bench_uint64_ts(nb_keys, 1024, false);
+  if (rc) {
+    fprintf(stderr, "Lookup errors detected\n");
+  }
+  return rc ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * Key derivations during a handover storm: every UE of the pool performs
+ * hops_per_ue successive handovers, each one deriving the next NH from the
+ * K_ASME of the UE (33.401 A.4):
+ *  - former kdf(): HMAC context allocated and K_ASME keyed for each NH,
+ *  - key setup per derivation (derive_nh()),
+ *  - HMAC state of the K_ASME cached in the UE context (derive_nh_key()).
+ *
+ * usage: oaisim_mme_kdf_benchmark [nb_ue] [hops_per_ue]
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <nettle/hmac.h>
+
+#include "secu_defs.h"
+#include "security_types.h"
+
+#define DEFAULT_NB_UE 10000
+#define DEFAULT_HOPS_PER_UE 8
+
+typedef struct bench_ue_s {
+  uint8_t kasme[32];
+  uint8_t nh[32];
+  kdf_key_t kasme_key;
+} bench_ue_t;
+
+static bench_ue_t *g_ues = NULL;
+static uint64_t nb_ue = DEFAULT_NB_UE;
+static uint64_t hops_per_ue = DEFAULT_HOPS_PER_UE;
+static volatile uint32_t g_sink = 0;
+
+// Former kdf()
+static void kdf_alloc(const uint8_t *key, const unsigned key_len, uint8_t *s,
+                      const unsigned s_len, uint8_t *out,
+                      const unsigned out_len) {
+  struct hmac_sha256_ctx *ctx = calloc(1, sizeof(struct hmac_sha256_ctx));
+
+  hmac_sha256_set_key(ctx, key_len, key);
+  hmac_sha256_update(ctx, s_len, s);
+  hmac_sha256_digest(ctx, out_len, out);
+  free(ctx);
+}
+
+static void handover_alloc(bench_ue_t *ue) {
+  uint8_t s[35] = {0};
+
+  s[0] = FC_NH;
+  memcpy(s + 1, ue->nh, 32);
+  s[34] = 0x20;
+  kdf_alloc(ue->kasme, 32, s, 35, ue->nh, 32);
+}
+
+static void handover_key_setup(bench_ue_t *ue) {
+  derive_nh(ue->kasme, ue->nh);
+}
+
+static void handover_cached(bench_ue_t *ue) {
+  derive_nh_key(kdf_key_update(&ue->kasme_key, ue->kasme, 32), ue->nh);
+}
+
+typedef void (*handover_t)(bench_ue_t *ue);
+
+static double elapsed_ns(const struct timespec *start,
+                         const struct timespec *end) {
+  return ((double)(end->tv_sec - start->tv_sec) * 1e9) +
+         (double)(end->tv_nsec - start->tv_nsec);
+}
+
+static void bench(const char *label, handover_t handover) {
+  struct timespec start, end;
+  uint64_t nb_derivations = nb_ue * hops_per_ue;
+  double ns = 0;
+
+  // Initial NH is the KeNB, same start for all the variants
+  for (uint64_t u = 0; u < nb_ue; u++) {
+    memset(g_ues[u].nh, (int)u, sizeof(g_ues[u].nh));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  // Handovers of the UEs are interleaved like in a storm
+  for (uint64_t h = 0; h < hops_per_ue; h++) {
+    for (uint64_t u = 0; u < nb_ue; u++) {
+      handover(&g_ues[u]);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  for (uint64_t u = 0; u < nb_ue; u++) {
+    g_sink += g_ues[u].nh[0];
+  }
+  ns = elapsed_ns(&start, &end);
+  printf("  %-32s %8.1f ns/derivation %12.0f derivations/s\n", label,
+         ns / (double)nb_derivations, ((double)nb_derivations * 1e9) / ns);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1) nb_ue = strtoull(argv[1], NULL, 0);
+  if (argc > 2) hops_per_ue = strtoull(argv[2], NULL, 0);
+  if ((!nb_ue) || (!hops_per_ue)) {
+    fprintf(stderr, "Bad arguments\n");
+    return EXIT_FAILURE;
+  }
+
+  g_ues = calloc(nb_ue, sizeof(bench_ue_t));
+  for (uint64_t u = 0; u < nb_ue; u++) {
+    for (int i = 0; i < 32; i++) {
+      g_ues[u].kasme[i] = (uint8_t)(u * 31 + i);
+    }
+  }
+
+  printf("%" PRIu64 " UEs, %" PRIu64 " handovers each\n", nb_ue, hops_per_ue);
+  bench("former kdf (calloc + HMAC key)", handover_alloc);
+  bench("HMAC key per derivation", handover_key_setup);
+  bench("cached K_ASME HMAC state", handover_cached);
+  free(g_ues);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * Cost of the OAILOG_FUNC_IN/OAILOG_FUNC_RETURN brackets of log.c per attach
+ * procedure, as traversed by the nas/ and mme_app/ functions:
+ *  - TRACE filtered out for the protocol (level mask off), 1 to nb_threads
+ *    threads bracketing concurrently,
+ *  - TRACE enabled for the protocol (level mask on), the traces are written
+ *    to /dev/null,
+ * oaisim_mme_log_benchmark_elide is the same program built with
+ * LOG_OAI_FUNC_ELIDE, the brackets compiled out.
+ *
+ * usage: oaisim_mme_log_benchmark [nb_attach] [brackets_per_attach] [threads]
+ * brackets_per_attach is the number of bracketed nas/ and mme_app/ functions
+ * traversed by one attach, check it with TRACE level on a real attach.
+ */
+
+#if LOG_BENCHMARK_FUNC_ELIDE
+#undef LOG_OAI_FUNC_ELIDE
+#define LOG_OAI_FUNC_ELIDE 1
+#endif
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bstrlib.h"
+
+#include "assertions.h"
+#include "common_defs.h"
+#include "log.h"
+#include "shared_ts_log.h"
+
+#define DEFAULT_NB_ATTACH 100000
+#define DEFAULT_BRACKETS_PER_ATTACH 400
+#define DEFAULT_NB_THREADS 4
+// Traces are formatted and written when enabled, fewer attach
+#define TRACE_ON_ATTACH_DIVIDER 1000
+
+static uint64_t nb_brackets_per_attach = DEFAULT_BRACKETS_PER_ATTACH;
+static uint64_t nb_attach = DEFAULT_NB_ATTACH;
+static volatile uint64_t g_sink = 0;
+
+// A bracketed function of the NAS layer
+static __attribute__((noinline)) uint64_t bench_procedure(uint64_t arg) {
+  OAILOG_FUNC_IN(LOG_NAS);
+  OAILOG_FUNC_RETURN(LOG_NAS, arg + 1);
+}
+
+static void *bench_thread(void *arg) {
+  uint64_t nb = *(uint64_t *)arg;
+  uint64_t acc = 0;
+
+  for (uint64_t a = 0; a < nb; a++) {
+    for (uint64_t b = 0; b < nb_brackets_per_attach; b++) {
+      acc = bench_procedure(acc);
+    }
+  }
+  g_sink += acc;
+  return NULL;
+}
+
+static double elapsed_ns(const struct timespec *start,
+                         const struct timespec *end) {
+  return ((double)(end->tv_sec - start->tv_sec) * 1e9) +
+         (double)(end->tv_nsec - start->tv_nsec);
+}
+
+static void bench(const char *label, uint64_t nb, int nb_threads) {
+  pthread_t threads[nb_threads];
+  struct timespec start, end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int t = 0; t < nb_threads; t++) {
+    pthread_create(&threads[t], NULL, bench_thread, (void *)&nb);
+  }
+  for (int t = 0; t < nb_threads; t++) {
+    pthread_join(threads[t], NULL);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  // Wall clock time over all the attach of all the threads
+  printf("  %-36s %10.1f ns/attach\n", label,
+         elapsed_ns(&start, &end) / (double)(nb * nb_threads));
+}
+
+static void set_nas_log_level(log_level_t level) {
+  log_config_t config;
+
+  memset(&config, 0, sizeof(config));
+  config.output = bfromcstr("/dev/null");
+  config.udp_log_level = MAX_LOG_LEVEL;
+  config.gtpv1u_log_level = MAX_LOG_LEVEL;
+  config.gtpv2c_log_level = MAX_LOG_LEVEL;
+  config.sctp_log_level = MAX_LOG_LEVEL;
+  config.s1ap_log_level = MAX_LOG_LEVEL;
+  config.mme_app_log_level = MAX_LOG_LEVEL;
+  config.spgw_app_log_level = MAX_LOG_LEVEL;
+  config.s10_log_level = MAX_LOG_LEVEL;
+  config.s11_log_level = MAX_LOG_LEVEL;
+  config.s6a_log_level = MAX_LOG_LEVEL;
+  config.secu_log_level = MAX_LOG_LEVEL;
+  config.util_log_level = MAX_LOG_LEVEL;
+  config.itti_log_level = MAX_LOG_LEVEL;
+  config.msc_log_level = MAX_LOG_LEVEL;
+  config.xml_log_level = MAX_LOG_LEVEL;
+  config.mme_scenario_player_log_level = MAX_LOG_LEVEL;
+  config.async_system_log_level = MAX_LOG_LEVEL;
+  config.nas_log_level = level;
+  OAILOG_SET_CONFIG(&config);
+  bdestroy(config.output);
+}
+
+int main(int argc, char *argv[]) {
+  uint64_t nb_trace_attach = 0;
+  int nb_threads = DEFAULT_NB_THREADS;
+
+  if (argc > 1) nb_attach = strtoull(argv[1], NULL, 0);
+  if (argc > 2) nb_brackets_per_attach = strtoull(argv[2], NULL, 0);
+  if (argc > 3) nb_threads = atoi(argv[3]);
+  if ((!nb_attach) || (nb_threads <= 0)) {
+    fprintf(stderr, "Bad arguments\n");
+    return EXIT_FAILURE;
+  }
+  nb_trace_attach = nb_attach / TRACE_ON_ATTACH_DIVIDER;
+  if (!nb_trace_attach) nb_trace_attach = 1;
+
+  CHECK_INIT_RETURN(shared_log_init(MAX_LOG_PROTOS));
+  CHECK_INIT_RETURN(
+      OAILOG_INIT(LOG_SPGW_ENV, OAILOG_LEVEL_ERROR, MAX_LOG_PROTOS));
+
+  printf("%" PRIu64 " attach, %" PRIu64 " bracketed functions each%s\n",
+         nb_attach, nb_brackets_per_attach,
+#if LOG_OAI_FUNC_ELIDE || !LOG_OAI || !DEBUG_IS_ON || !TRACE_IS_ON
+         ", brackets compiled out"
+#else
+         ""
+#endif
+  );
+  set_nas_log_level(OAILOG_LEVEL_INFO);
+  for (int threads = 1; threads <= nb_threads; threads *= 2) {
+    char label[64];
+
+    snprintf(label, sizeof(label), "NAS TRACE off, %d thread(s)", threads);
+    bench(label, nb_attach, threads);
+  }
+  set_nas_log_level(OAILOG_LEVEL_TRACE);
+  bench("NAS TRACE on, 1 thread", nb_trace_attach, 1);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * Authentication vectors computed by the HSS emulation of the S6A task:
+ *  - reference code of 35.206 annex 3 (f1 + f2345, key schedule per call),
+ *  - MILENAGE engine, one vector per call or batches of batch_size vectors,
+ *    with nettle AES or the AES instructions when the CPU has them,
+ *  - the same plus the K_ASME derivation of the E-UTRAN vector.
+ *
+ * usage: oaisim_mme_milenage_benchmark [nb_vectors] [batch_size]
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "milenage.h"
+
+#define DEFAULT_NB_VECTORS 200000
+#define DEFAULT_BATCH_SIZE 32
+
+extern uint8_t OP[16];
+void f1(uint8_t k[16], uint8_t rand[16], uint8_t sqn[6], uint8_t amf[2],
+        uint8_t mac_a[8]);
+void f2345(uint8_t k[16], uint8_t rand[16], uint8_t res[8], uint8_t ck[16],
+           uint8_t ik[16], uint8_t ak[6]);
+
+static uint8_t k[16] = {0x46, 0x5b, 0x5c, 0xe8, 0xb1, 0x99, 0xb4, 0x9f,
+                        0xaa, 0x5f, 0x0a, 0x2e, 0xe2, 0x38, 0xa6, 0xbc};
+static uint8_t op[16] = {0xcd, 0xc2, 0x02, 0xd5, 0x12, 0x3e, 0x20, 0xf6,
+                         0x2b, 0x6d, 0x67, 0x6a, 0xc7, 0x2c, 0xb3, 0x18};
+static uint8_t amf[2] = {0x80, 0x00};
+static uint8_t sn_id[3] = {0x02, 0xf8, 0x59};
+static uint64_t nb_vectors = DEFAULT_NB_VECTORS;
+static unsigned batch_size = DEFAULT_BATCH_SIZE;
+static milenage_vector_t *g_vectors = NULL;
+static volatile uint32_t g_sink = 0;
+
+static double elapsed_ns(const struct timespec *start,
+                         const struct timespec *end) {
+  return ((double)(end->tv_sec - start->tv_sec) * 1e9) +
+         (double)(end->tv_nsec - start->tv_nsec);
+}
+
+static void print_result(const char *label, const struct timespec *start,
+                         const struct timespec *end) {
+  double ns = elapsed_ns(start, end);
+
+  printf("  %-36s %8.1f ns/vector %12.0f vectors/s\n", label,
+         ns / (double)nb_vectors, ((double)nb_vectors * 1e9) / ns);
+}
+
+static void bench_reference(void) {
+  struct timespec start, end;
+  uint8_t res[8], ck[16], ik[16], ak[6], mac_a[8];
+  uint8_t sqn[6] = {0};
+
+  memcpy(OP, op, sizeof(OP));
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint64_t v = 0; v < nb_vectors; v++) {
+    sqn[5] = (uint8_t)v;
+    f1(k, g_vectors[v].rand, sqn, amf, mac_a);
+    f2345(k, g_vectors[v].rand, res, ck, ik, ak);
+    g_sink += mac_a[0] + res[0] + ck[0] + ik[0] + ak[0];
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  print_result("35.206 annex 3 (f1 + f2345)", &start, &end);
+}
+
+static void bench_engine(const char *label, bool use_aesni, unsigned batch,
+                         bool with_kasme) {
+  struct timespec start, end;
+  milenage_ctx_t ctx;
+  uint8_t opc[16];
+  uint8_t kasme[32];
+
+  milenage_compute_opc(k, op, opc);
+  milenage_ctx_setup(&ctx, k, opc);
+  if (use_aesni && !ctx.use_aesni) {
+    printf("  %-36s no AES instructions on this CPU\n", label);
+    return;
+  }
+  ctx.use_aesni = use_aesni;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint64_t v = 0; v < nb_vectors; v += batch) {
+    unsigned nb = (nb_vectors - v < batch) ? nb_vectors - v : batch;
+
+    milenage_generate_vectors(&ctx, amf, v * 32, 32, &g_vectors[v], nb);
+    if (with_kasme) {
+      for (unsigned i = 0; i < nb; i++) {
+        milenage_derive_kasme(&g_vectors[v + i], sn_id, kasme);
+        g_sink += kasme[0];
+      }
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  for (uint64_t v = 0; v < nb_vectors; v++) {
+    g_sink += g_vectors[v].xres[0];
+  }
+  print_result(label, &start, &end);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1) nb_vectors = strtoull(argv[1], NULL, 0);
+  if (argc > 2) batch_size = (unsigned)strtoul(argv[2], NULL, 0);
+  if ((!nb_vectors) || (!batch_size)) {
+    fprintf(stderr, "Bad arguments\n");
+    return EXIT_FAILURE;
+  }
+
+  g_vectors = calloc(nb_vectors, sizeof(milenage_vector_t));
+  for (uint64_t v = 0; v < nb_vectors; v++) {
+    for (int i = 0; i < 16; i++) {
+      g_vectors[v].rand[i] = (uint8_t)(v * 131 + i);
+    }
+  }
+
+  printf("%" PRIu64 " vectors, batches of %u\n", nb_vectors, batch_size);
+  bench_reference();
+  bench_engine("nettle AES, 1 vector per call", false, 1, false);
+  bench_engine("nettle AES, batch", false, batch_size, false);
+  bench_engine("AES instructions, 1 vector per call", true, 1, false);
+  bench_engine("AES instructions, batch", true, batch_size, false);
+  bench_engine("AES instructions, batch + K_ASME", true, batch_size, true);
+  free(g_vectors);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,206 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * Decoding of the uplink NAS messages of an attach and of the idle mode
+ * mobility of a UE (nas_message_decode as called by the EMM AS SAP):
+ *  - plain Attach Request with its PDN Connectivity Request,
+ *  - TAU Request integrity protected (EIA2), then integrity protected and
+ *    ciphered (EIA2 + EEA2),
+ *  - Service Request,
+ * with the number of heap allocations per message (malloc, calloc and
+ * realloc of the process are counted).
+ *
+ * usage: oaisim_mme_nas_benchmark [nb_messages]
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bstrlib.h"
+
+#include "assertions.h"
+#include "common_defs.h"
+#include "emm_data.h"
+#include "emm_msg.h"
+#include "log.h"
+#include "nas_message.h"
+#include "secu_defs.h"
+#include "shared_ts_log.h"
+
+#define DEFAULT_NB_MESSAGES 1000000
+#define BENCH_BUFFER_SIZE 256
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static uint64_t nb_messages = DEFAULT_NB_MESSAGES;
+static uint64_t g_nb_allocs = 0;
+static emm_security_context_t g_secu = {0};
+
+// IMSI 208930123456789, PDN Connectivity Request in the ESM container,
+// DRX parameter and supported codecs
+static const uint8_t attach_request[] = {
+    0x07, 0x41, 0x71, 0x08, 0x29, 0x80, 0x39, 0x10, 0x32, 0x54, 0x76, 0x98,
+    0x02, 0xe0, 0xe0, 0x00, 0x04, 0x02, 0x01, 0xd0, 0x11, 0x5c, 0x0a, 0x00,
+    0x40, 0x08, 0x04, 0x02, 0x60, 0x04, 0x00, 0x02, 0x1f, 0x00};
+
+// Old GUTI, UE network capability, last visited TAI, DRX parameter, EPS
+// bearer context status and supported codecs
+static const uint8_t tau_request[] = {
+    0x07, 0x48, 0x00, 0x0b, 0xf6, 0x02, 0xf8, 0x39, 0x80, 0x01, 0x01,
+    0x01, 0x02, 0x03, 0x04, 0x58, 0x02, 0xe0, 0xe0, 0x52, 0x02, 0xf8,
+    0x39, 0x00, 0x01, 0x5c, 0x0a, 0x00, 0x57, 0x02, 0x20, 0x00, 0x40,
+    0x08, 0x04, 0x02, 0x60, 0x04, 0x00, 0x02, 0x1f, 0x00};
+
+// KSI 0, sequence number 1
+static const uint8_t service_request[] = {0xc7, 0x01, 0x00, 0x00};
+
+void *malloc(size_t size) {
+  g_nb_allocs++;
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+  g_nb_allocs++;
+  return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+  g_nb_allocs++;
+  return __libc_realloc(ptr, size);
+}
+
+static double elapsed_ns(const struct timespec *start,
+                         const struct timespec *end) {
+  return ((double)(end->tv_sec - start->tv_sec) * 1e9) +
+         (double)(end->tv_nsec - start->tv_nsec);
+}
+
+static void print_result(const char *label, const struct timespec *start,
+                         const struct timespec *end, uint64_t nb_allocs) {
+  double ns = elapsed_ns(start, end);
+
+  printf("  %-36s %8.1f ns/message %6.2f allocations/message\n", label,
+         ns / (double)nb_messages, (double)nb_allocs / (double)nb_messages);
+}
+
+static void secu_setup(uint8_t encryption) {
+  for (int i = 0; i < AUTH_KNAS_ENC_SIZE; i++) {
+    g_secu.knas_enc[i] = (uint8_t)(0x30 + i);
+    g_secu.knas_int[i] = (uint8_t)(0x50 + i);
+  }
+  nas_stream_key_setup(&g_secu.knas_enc_key, g_secu.knas_enc);
+  nas_stream_key_setup(&g_secu.knas_int_key, g_secu.knas_int);
+  g_secu.sc_type = SECURITY_CTX_TYPE_FULL_NATIVE;
+  g_secu.selected_algorithms.integrity = NAS_SECURITY_ALGORITHMS_EIA2;
+  g_secu.selected_algorithms.encryption = encryption;
+  g_secu.direction_encode = SECU_DIRECTION_UPLINK;
+  g_secu.direction_decode = SECU_DIRECTION_UPLINK;
+  g_secu.ul_count.overflow = 0;
+  g_secu.ul_count.seq_num = 0;
+}
+
+// Protect a plain message as the UE would, with g_secu
+static int protect(const uint8_t *plain, size_t plain_len,
+                   uint8_t security_header_type, uint8_t *buffer) {
+  nas_message_t msg = {0};
+  nas_message_t protected_msg = {0};
+  nas_message_decode_status_t status = {0};
+  int size;
+
+  size = nas_message_decode(plain, &msg, plain_len, NULL, NULL, &status);
+  AssertFatal(size > 0, "Bad plain message %d", size);
+  protected_msg.header.protocol_discriminator =
+      EPS_MOBILITY_MANAGEMENT_MESSAGE;
+  protected_msg.header.security_header_type = security_header_type;
+  protected_msg.header.sequence_number = g_secu.ul_count.seq_num;
+  protected_msg.security_protected.plain = msg.plain;
+  size = nas_message_encode(buffer, &protected_msg, BENCH_BUFFER_SIZE, &g_secu);
+  AssertFatal(size > 0, "Cannot protect the message %d", size);
+  g_secu.ul_count.seq_num = 0;
+  emm_msg_free(&msg.plain.emm);
+  return size;
+}
+
+static void bench_decode(const char *label, const uint8_t *buffer,
+                         size_t len, emm_security_context_t *secu) {
+  struct timespec start, end;
+  uint64_t nb_allocs;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  nb_allocs = g_nb_allocs;
+  for (uint64_t i = 0; i < nb_messages; i++) {
+    nas_message_t msg = {0};
+    nas_message_decode_status_t status = {0};
+    uint8_t ul_seq_no = 0;
+    int size = nas_message_decode(buffer, &msg, len, secu, &ul_seq_no, &status);
+
+    AssertFatal(size > 0, "%s not decoded %d", label, size);
+    AssertFatal((!secu) || (status.mac_matched) ||
+                    (SERVICE_REQUEST == msg.plain.emm.header.message_type),
+                "%s MAC mismatch", label);
+    emm_msg_free(&msg.plain.emm);
+  }
+  nb_allocs = g_nb_allocs - nb_allocs;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  print_result(label, &start, &end, nb_allocs);
+}
+
+int main(int argc, char *argv[]) {
+  uint8_t tau_integrity[BENCH_BUFFER_SIZE];
+  uint8_t tau_ciphered[BENCH_BUFFER_SIZE];
+  int tau_integrity_len;
+  int tau_ciphered_len;
+
+  if (argc > 1) nb_messages = strtoull(argv[1], NULL, 0);
+  if (!nb_messages) {
+    fprintf(stderr, "Bad arguments\n");
+    return EXIT_FAILURE;
+  }
+
+  CHECK_INIT_RETURN(shared_log_init(MAX_LOG_PROTOS));
+  CHECK_INIT_RETURN(
+      OAILOG_INIT(LOG_SPGW_ENV, OAILOG_LEVEL_ERROR, MAX_LOG_PROTOS));
+
+  secu_setup(NAS_SECURITY_ALGORITHMS_EEA0);
+  tau_integrity_len =
+      protect(tau_request, sizeof(tau_request),
+              SECURITY_HEADER_TYPE_INTEGRITY_PROTECTED, tau_integrity);
+  secu_setup(NAS_SECURITY_ALGORITHMS_EEA2);
+  tau_ciphered_len =
+      protect(tau_request, sizeof(tau_request),
+              SECURITY_HEADER_TYPE_INTEGRITY_PROTECTED_CYPHERED, tau_ciphered);
+
+  printf("%" PRIu64 " messages\n", nb_messages);
+  bench_decode("Attach Request, plain", attach_request, sizeof(attach_request),
+               NULL);
+  secu_setup(NAS_SECURITY_ALGORITHMS_EEA0);
+  bench_decode("TAU Request, EIA2", tau_integrity, tau_integrity_len, &g_secu);
+  secu_setup(NAS_SECURITY_ALGORITHMS_EEA2);
+  bench_decode("TAU Request, EIA2 + EEA2", tau_ciphered, tau_ciphered_len,
+               &g_secu);
+  bench_decode("Service Request", service_request, sizeof(service_request),
+               &g_secu);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,231 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * S6A requests of a mass re-attach, with the configuration of the MME and
+ * its freeDiameter dictionary (no peer, nothing is sent):
+ *  - AIR built as before: freeDiameter session per request and each AVP
+ *    created and valued in the builder,
+ *  - AIR and ULR built from the request templates,
+ *  - encoding of an AIR (fd_msg_bufferize) and parsing of the encoded AIR
+ *    (fd_msg_parse_buffer + fd_msg_parse_dict).
+ *
+ * usage: oaisim_mme_s6a_benchmark mme.conf [nb_requests]
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bstrlib.h"
+
+#include "assertions.h"
+#include "common_defs.h"
+#include "common_types.h"
+#include "conversions.h"
+#include "intertask_interface.h"
+#include "log.h"
+#include "mme_config.h"
+#include "s6a_defs.h"
+#include "s6a_messages.h"
+#include "shared_ts_log.h"
+
+#define DEFAULT_NB_REQUESTS 100000
+
+static uint64_t nb_requests = DEFAULT_NB_REQUESTS;
+static s6a_auth_info_req_t g_air = {0};
+static s6a_update_location_req_t g_ulr = {0};
+
+static double elapsed_ns(const struct timespec *start,
+                         const struct timespec *end) {
+  return ((double)(end->tv_sec - start->tv_sec) * 1e9) +
+         (double)(end->tv_nsec - start->tv_nsec);
+}
+
+static void print_result(const char *label, const struct timespec *start,
+                         const struct timespec *end) {
+  double ns = elapsed_ns(start, end);
+
+  printf("  %-36s %8.1f ns/request %10.0f requests/s\n", label,
+         ns / (double)nb_requests, ((double)nb_requests * 1e9) / ns);
+}
+
+static void set_imsi(uint64_t i) {
+  snprintf(g_air.imsi, sizeof(g_air.imsi), "20893%010" PRIu64, i);
+  g_air.imsi_length = strlen(g_air.imsi);
+  memcpy(g_ulr.imsi, g_air.imsi, sizeof(g_ulr.imsi));
+  g_ulr.imsi_length = g_air.imsi_length;
+}
+
+// AIR as built before the templates
+static int build_air_legacy(struct msg **msg_p) {
+  struct avp *avp;
+  struct avp *child_avp;
+  struct msg *msg;
+  struct session *sess;
+  union avp_value value;
+  uint8_t plmn[3] = {0};
+  os0_t sid;
+  size_t sidlen;
+
+  CHECK_FCT(fd_msg_new(s6a_fd_cnf.dataobj_s6a_air, 0, &msg));
+  *msg_p = msg;
+  CHECK_FCT(fd_sess_new(&sess, fd_g_config->cnf_diamid,
+                        fd_g_config->cnf_diamid_len, (os0_t) "apps6a", 6));
+  CHECK_FCT(fd_sess_getsid(sess, &sid, &sidlen));
+  CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_session_id, 0, &avp));
+  value.os.data = sid;
+  value.os.len = sidlen;
+  CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
+  CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_FIRST_CHILD, avp));
+  CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_auth_session_state, 0, &avp));
+  value.i32 = 1;
+  CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
+  CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
+  CHECK_FCT(fd_msg_add_origin(msg, 0));
+  CHECK_FCT(s6a_add_destination(msg));
+  CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_user_name, 0, &avp));
+  value.os.data = (unsigned char *)g_air.imsi;
+  value.os.len = strlen(g_air.imsi);
+  CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
+  CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
+  CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_visited_plmn_id, 0, &avp));
+  PLMN_T_TO_TBCD(
+      g_air.visited_plmn, plmn,
+      mme_config_find_mnc_length(
+          g_air.visited_plmn.mcc_digit1, g_air.visited_plmn.mcc_digit2,
+          g_air.visited_plmn.mcc_digit3, g_air.visited_plmn.mnc_digit1,
+          g_air.visited_plmn.mnc_digit2, g_air.visited_plmn.mnc_digit3));
+  value.os.data = plmn;
+  value.os.len = 3;
+  CHECK_FCT(fd_msg_avp_setvalue(avp, &value));
+  CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
+  CHECK_FCT(
+      fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_req_eutran_auth_info, 0, &avp));
+  CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_number_of_requested_vectors,
+                           0, &child_avp));
+  value.u32 = g_air.nb_of_vectors;
+  CHECK_FCT(fd_msg_avp_setvalue(child_avp, &value));
+  CHECK_FCT(fd_msg_avp_add(avp, MSG_BRW_LAST_CHILD, child_avp));
+  CHECK_FCT(fd_msg_avp_new(s6a_fd_cnf.dataobj_s6a_immediate_response_pref, 0,
+                           &child_avp));
+  value.u32 = 0;
+  CHECK_FCT(fd_msg_avp_setvalue(child_avp, &value));
+  CHECK_FCT(fd_msg_avp_add(avp, MSG_BRW_LAST_CHILD, child_avp));
+  CHECK_FCT(fd_msg_avp_add(msg, MSG_BRW_LAST_CHILD, avp));
+  return 0;
+}
+
+static int build_air(struct msg **msg) {
+  return s6a_build_authentication_info_req(&g_air, msg);
+}
+
+static int build_ulr(struct msg **msg) {
+  return s6a_build_update_location(&g_ulr, msg);
+}
+
+static int bench_build(const char *label, int (*build)(struct msg **)) {
+  struct timespec start, end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint64_t i = 0; i < nb_requests; i++) {
+    struct msg *msg = NULL;
+
+    set_imsi(i);
+    CHECK_FCT(build(&msg));
+    fd_msg_free(msg);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  print_result(label, &start, &end);
+  return 0;
+}
+
+static int bench_encode_parse(void) {
+  struct timespec start, end;
+  struct msg *msg = NULL;
+  uint8_t *buf = NULL;
+  size_t len = 0;
+
+  set_imsi(0);
+  CHECK_FCT(build_air(&msg));
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint64_t i = 0; i < nb_requests; i++) {
+    CHECK_FCT(fd_msg_bufferize(msg, &buf, &len));
+    free(buf);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  print_result("AIR encoding", &start, &end);
+
+  CHECK_FCT(fd_msg_bufferize(msg, &buf, &len));
+  fd_msg_free(msg);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint64_t i = 0; i < nb_requests; i++) {
+    // fd_msg_parse_buffer() takes the buffer
+    uint8_t *copy = malloc(len);
+
+    memcpy(copy, buf, len);
+    CHECK_FCT(fd_msg_parse_buffer(&copy, len, &msg));
+    CHECK_FCT(fd_msg_parse_dict(msg, fd_g_config->cnf_dict, NULL));
+    fd_msg_free(msg);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  print_result("AIR parsing", &start, &end);
+  free(buf);
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  char *config_argv[] = {argv[0], "-c", NULL, NULL};
+  plmn_t plmn = {0};
+
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s mme.conf [nb_requests]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (argc > 2) nb_requests = strtoull(argv[2], NULL, 0);
+
+  CHECK_INIT_RETURN(shared_log_init(MAX_LOG_PROTOS));
+  CHECK_INIT_RETURN(
+      OAILOG_INIT(LOG_SPGW_ENV, OAILOG_LEVEL_ERROR, MAX_LOG_PROTOS));
+  config_argv[2] = argv[1];
+  CHECK_INIT_RETURN(mme_config_parse_opt_line(3, config_argv, &mme_config));
+  CHECK_INIT_RETURN(fd_core_initialize());
+  CHECK_INIT_RETURN(
+      fd_core_parseconf(bdata(mme_config.s6a_config.conf_file)));
+  CHECK_INIT_RETURN(s6a_fd_init_dict_objs());
+  CHECK_INIT_RETURN(s6a_fd_init_templates());
+
+  plmn = mme_config.gummei.gummei[0].plmn;
+  g_air.visited_plmn = plmn;
+  g_air.nb_of_vectors = 1;
+  g_ulr.visited_plmn = plmn;
+  g_ulr.rat_type = RAT_EUTRAN;
+  g_ulr.initial_attach = INITIAL_ATTACH;
+
+  printf("%" PRIu64 " requests\n", nb_requests);
+  bench_build("AIR, session per request", build_air_legacy);
+  bench_build("AIR, templates", build_air);
+  bench_build("ULR, templates", build_ulr);
+  bench_encode_parse();
+
+  fd_core_shutdown();
+  fd_core_wait_shutdown_complete();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * Throughput of 128-EEA1 (ciphering) and 128-EIA1 (integrity) on NAS message
+ * sizes, each message with a new COUNT, so the SNOW 3G initialization
+ * (33 clocks) is paid for every message like in the MME.
+ *
+ * usage: oaisim_mme_snow3g_benchmark [nb_messages]
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "secu_defs.h"
+
+#define DEFAULT_NB_MESSAGES 200000
+
+static const uint32_t message_sizes[] = {16, 64, 128, 256, 1024};
+static uint8_t key[16] = {0x2b, 0xd6, 0x45, 0x9f, 0x82, 0xc5, 0xb3, 0x00,
+                          0x95, 0x2c, 0x49, 0x10, 0x48, 0x81, 0xff, 0x48};
+static volatile uint32_t g_sink = 0;
+
+static double elapsed_ns(const struct timespec *start,
+                         const struct timespec *end) {
+  return ((double)(end->tv_sec - start->tv_sec) * 1e9) +
+         (double)(end->tv_nsec - start->tv_nsec);
+}
+
+static void bench(const char *label, bool is_integrity, uint32_t size,
+                  uint64_t nb_messages) {
+  // EIA1/EEA1 process the message by 32 bits words
+  uint8_t *message = calloc(1, size + 8);
+  uint8_t *out = calloc(1, size + 8);
+  nas_stream_cipher_t stream_cipher = {0};
+  struct timespec start, end;
+  double ns = 0;
+
+  for (uint32_t i = 0; i < size; i++) {
+    message[i] = (uint8_t)i;
+  }
+  stream_cipher.key = key;
+  stream_cipher.key_length = sizeof(key);
+  stream_cipher.bearer = 0;
+  stream_cipher.direction = SECU_DIRECTION_DOWNLINK;
+  stream_cipher.message = message;
+  stream_cipher.blength = size << 3;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint64_t n = 0; n < nb_messages; n++) {
+    stream_cipher.count = (uint32_t)n;
+    if (is_integrity) {
+      nas_stream_encrypt_eia1(&stream_cipher, out);
+    } else {
+      nas_stream_encrypt_eea1(&stream_cipher, out);
+    }
+    g_sink += out[0];
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  ns = elapsed_ns(&start, &end);
+  printf("  %-8s %5u bytes %10.1f MB/s %12.0f msgs/s\n", label, size,
+         ((double)size * (double)nb_messages * 1e3) / ns,
+         ((double)nb_messages * 1e9) / ns);
+  free(message);
+  free(out);
+}
+
+int main(int argc, char *argv[]) {
+  uint64_t nb_messages = DEFAULT_NB_MESSAGES;
+
+  if (argc > 1) nb_messages = strtoull(argv[1], NULL, 0);
+  if (!nb_messages) {
+    fprintf(stderr, "Bad arguments\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("%" PRIu64 " messages per size\n", nb_messages);
+  for (int i = 0; i < sizeof(message_sizes) / sizeof(message_sizes[0]); i++) {
+    bench("128-EEA1", false, message_sizes[i], nb_messages);
+  }
+  for (int i = 0; i < sizeof(message_sizes) / sizeof(message_sizes[0]); i++) {
+    bench("128-EIA1", true, message_sizes[i], nb_messages);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+#include <check.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bstrlib.h"
+
+#include "log.h"
+#include "shared_ts_log.h"
+
+#define TEST_LOG_BIN_PATH_TEMPLATE "/tmp/test_log_bin_XXXXXX"
+#define TEST_LOG_BIN_DECODED_MAX_LENGTH 8192
+
+// Deferred sites (binary records) and text only sites (text records) in the
+// same binary log, decoded by oai_log_decoder
+static void log_mixed_sites(const bool is_output_thread_safe,
+                            char *decoded) {
+  char path[] = TEST_LOG_BIN_PATH_TEMPLATE;
+  char command[sizeof(OAI_LOG_DECODER) + sizeof(path) + 1];
+  struct shared_log_queue_item_s *message = NULL;
+  log_config_t config;
+  FILE *fp = NULL;
+  size_t length = 0;
+  int fd = mkstemp(path);
+
+  ck_assert(fd >= 0);
+  close(fd);
+  ck_assert_int_eq(shared_log_init(MAX_LOG_PROTOS), 0);
+  ck_assert_int_eq(log_init(LOG_MME_ENV, OAILOG_LEVEL_ERROR, MAX_LOG_PROTOS),
+                   0);
+  memset(&config, 0, sizeof(config));
+  config.output = bfromcstr(path);
+  config.is_output_thread_safe = is_output_thread_safe;
+  config.deferred_mode = LOG_DEFERRED_BINARY;
+  config.udp_log_level = MAX_LOG_LEVEL;
+  config.gtpv1u_log_level = MAX_LOG_LEVEL;
+  config.gtpv2c_log_level = MAX_LOG_LEVEL;
+  config.sctp_log_level = MAX_LOG_LEVEL;
+  config.s1ap_log_level = MAX_LOG_LEVEL;
+  config.nas_log_level = MAX_LOG_LEVEL;
+  config.mme_app_log_level = MAX_LOG_LEVEL;
+  config.spgw_app_log_level = MAX_LOG_LEVEL;
+  config.s10_log_level = MAX_LOG_LEVEL;
+  config.s11_log_level = MAX_LOG_LEVEL;
+  config.s6a_log_level = MAX_LOG_LEVEL;
+  config.secu_log_level = MAX_LOG_LEVEL;
+  config.itti_log_level = MAX_LOG_LEVEL;
+  config.msc_log_level = MAX_LOG_LEVEL;
+  config.xml_log_level = MAX_LOG_LEVEL;
+  config.mme_scenario_player_log_level = MAX_LOG_LEVEL;
+  config.async_system_log_level = MAX_LOG_LEVEL;
+  config.util_log_level = OAILOG_LEVEL_INFO;
+  log_set_config(&config);
+  bdestroy(config.output);
+
+  OAILOG_INFO(LOG_UTIL, "deferred site %d\n", 42);
+  // %ls can't be deferred, formatted by the logging thread
+  OAILOG_INFO(LOG_UTIL, "text only site %ls\n", L"wide");
+  log_stream_hex(OAILOG_LEVEL_INFO, LOG_UTIL, __FILE__, __LINE__, "buffer",
+                 "\xde\xad\xbe\xef", 4);
+  OAILOG_MESSAGE_START(OAILOG_LEVEL_INFO, LOG_UTIL, &message, "message ");
+  OAILOG_MESSAGE_ADD(message, "added %s", "part");
+  OAILOG_MESSAGE_FINISH(message);
+  OAILOG_INFO(LOG_UTIL, "deferred site again %s\n", "after text");
+
+  log_flush_deferred_messages();
+  shared_log_flush_messages();
+  OAILOG_EXIT();
+
+  snprintf(command, sizeof(command), "%s %s", OAI_LOG_DECODER, path);
+  fp = popen(command, "r");
+  ck_assert(fp != NULL);
+  length = fread(decoded, 1, TEST_LOG_BIN_DECODED_MAX_LENGTH - 1, fp);
+  decoded[length] = '\0';
+  ck_assert_int_eq(pclose(fp), 0);
+  unlink(path);
+}
+
+static void check_decoded(const char *decoded) {
+  ck_assert(strstr(decoded, "deferred site 42") != NULL);
+  ck_assert(strstr(decoded, "text only site wide") != NULL);
+  ck_assert(strstr(decoded, "hex stream buffer de ad be ef") != NULL);
+  ck_assert(strstr(decoded, "message added part") != NULL);
+  ck_assert(strstr(decoded, "deferred site again after text") != NULL);
+}
+
+START_TEST(test_log_bin_mixed_sites) {
+  char decoded[TEST_LOG_BIN_DECODED_MAX_LENGTH];
+
+  log_mixed_sites(false, decoded);
+  check_decoded(decoded);
+}
+END_TEST
+
+START_TEST(test_log_bin_mixed_sites_thread_safe_output) {
+  char decoded[TEST_LOG_BIN_DECODED_MAX_LENGTH];
+
+  log_mixed_sites(true, decoded);
+  check_decoded(decoded);
+}
+END_TEST
+
+Suite *log_bin_suite(void) {
+  Suite *s = suite_create("Binary deferred log");
+  TCase *tc_core = tcase_create("Core");
+
+  tcase_add_test(tc_core, test_log_bin_mixed_sites);
+  tcase_add_test(tc_core, test_log_bin_mixed_sites_thread_safe_output);
+  suite_add_tcase(s, tc_core);
+  return s;
+}
+
+int main(void) {
+  int number_failed;
+  Suite *s = log_bin_suite();
+  SRunner *sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
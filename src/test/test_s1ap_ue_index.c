@@ -0,0 +1,147 @@
+#include <check.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "bstrlib.h"
+
+#include "hashtable.h"
+#include "mme_config.h"
+#include "s1ap_mme.h"
+
+#define TEST_MME_UE_S1AP_ID 7
+#define TEST_SOURCE_ASSOC_ID 1
+#define TEST_TARGET_ASSOC_ID 2
+
+extern hash_table_ts_t g_s1ap_enb_coll;
+extern hash_table_ts_t g_s1ap_mme_id2assoc_id_coll;
+extern hash_table_ts_t g_s1ap_mme_ue_id_coll;
+
+static enb_description_t *source_enb = NULL;
+static enb_description_t *target_enb = NULL;
+
+static void init_coll(hash_table_ts_t *coll, const char *name,
+                      void (*freefunc)(void **)) {
+  bstring bs = bfromcstr(name);
+
+  ck_assert(hashtable_ts_init(coll, 16, NULL, freefunc, bs) != NULL);
+  bdestroy(bs);
+}
+
+static enb_description_t *new_enb(const sctp_assoc_id_t sctp_assoc_id) {
+  enb_description_t *enb_ref = s1ap_new_enb();
+
+  enb_ref->sctp_assoc_id = sctp_assoc_id;
+  enb_ref->s1_state = S1AP_READY;
+  hashtable_ts_insert(&g_s1ap_enb_coll, (const hash_key_t)sctp_assoc_id,
+                      (void *)enb_ref);
+  return enb_ref;
+}
+
+static ue_description_t *new_ue(const sctp_assoc_id_t sctp_assoc_id,
+                                const enb_ue_s1ap_id_t enb_ue_s1ap_id) {
+  ue_description_t *ue_ref = s1ap_new_ue(sctp_assoc_id, enb_ue_s1ap_id);
+
+  ck_assert(ue_ref != NULL);
+  ue_ref->s1ap_ue_context_rel_timer.id = S1AP_TIMER_INACTIVE_ID;
+  ue_ref->s1ap_handover_completion_timer.id = S1AP_TIMER_INACTIVE_ID;
+  s1ap_set_ue_mme_ue_s1ap_id(ue_ref, TEST_MME_UE_S1AP_ID);
+  return ue_ref;
+}
+
+static void setup(void) {
+  mme_config.max_ues = 16;
+  mme_config.max_s1_enbs = 16;
+  init_coll(&g_s1ap_enb_coll, "s1ap_eNB_coll", hash_free_int_func);
+  init_coll(&g_s1ap_mme_id2assoc_id_coll, "s1ap_mme_id2assoc_id_coll",
+            hash_free_int_func);
+  init_coll(&g_s1ap_mme_ue_id_coll, "s1ap_mme_ue_id_coll", hash_free_int_func);
+  source_enb = new_enb(TEST_SOURCE_ASSOC_ID);
+  target_enb = new_enb(TEST_TARGET_ASSOC_ID);
+}
+
+static void teardown(void) {
+  hashtable_ts_destroy(&source_enb->ue_coll);
+  hashtable_ts_destroy(&target_enb->ue_coll);
+  free(source_enb);
+  free(target_enb);
+  hashtable_ts_destroy(&g_s1ap_enb_coll);
+  hashtable_ts_destroy(&g_s1ap_mme_id2assoc_id_coll);
+  hashtable_ts_destroy(&g_s1ap_mme_ue_id_coll);
+}
+
+START_TEST(handover_cancel_test) {
+  ue_description_t *source_ue = new_ue(TEST_SOURCE_ASSOC_ID, 1);
+  ue_description_t *target_ue = new_ue(TEST_TARGET_ASSOC_ID, 2);
+
+  /* The target UE description is the last associated one */
+  ck_assert_ptr_eq(s1ap_is_ue_mme_id_in_list(TEST_MME_UE_S1AP_ID), target_ue);
+
+  /* Handover cancelled (or failed): the source UE is still found */
+  s1ap_remove_ue(target_ue);
+  ck_assert_ptr_eq(s1ap_is_ue_mme_id_in_list(TEST_MME_UE_S1AP_ID), source_ue);
+
+  s1ap_remove_ue(source_ue);
+  ck_assert_ptr_eq(s1ap_is_ue_mme_id_in_list(TEST_MME_UE_S1AP_ID), NULL);
+}
+END_TEST
+
+START_TEST(handover_complete_test) {
+  ue_description_t *source_ue = new_ue(TEST_SOURCE_ASSOC_ID, 1);
+  ue_description_t *target_ue = new_ue(TEST_TARGET_ASSOC_ID, 2);
+
+  /* Source released after the handover: the target UE stays indexed */
+  s1ap_remove_ue(source_ue);
+  ck_assert_ptr_eq(s1ap_is_ue_mme_id_in_list(TEST_MME_UE_S1AP_ID), target_ue);
+
+  s1ap_remove_ue(target_ue);
+  ck_assert_ptr_eq(s1ap_is_ue_mme_id_in_list(TEST_MME_UE_S1AP_ID), NULL);
+}
+END_TEST
+
+START_TEST(reassociation_test) {
+  ue_description_t *source_ue = new_ue(TEST_SOURCE_ASSOC_ID, 1);
+  ue_description_t *target_ue = new_ue(TEST_TARGET_ASSOC_ID, 2);
+
+  /* The source UE gets a new mme_ue_s1ap_id, the target keeps the old one */
+  s1ap_set_ue_mme_ue_s1ap_id(source_ue, TEST_MME_UE_S1AP_ID + 1);
+  ck_assert_ptr_eq(s1ap_is_ue_mme_id_in_list(TEST_MME_UE_S1AP_ID + 1),
+                   source_ue);
+  s1ap_remove_ue(target_ue);
+  ck_assert_ptr_eq(s1ap_is_ue_mme_id_in_list(TEST_MME_UE_S1AP_ID), NULL);
+  ck_assert_ptr_eq(s1ap_is_ue_mme_id_in_list(TEST_MME_UE_S1AP_ID + 1),
+                   source_ue);
+  s1ap_remove_ue(source_ue);
+}
+END_TEST
+
+Suite *s1ap_ue_index_suite(void) {
+  Suite *s;
+  TCase *tc_core;
+
+  s = suite_create("S1AP UE index tests");
+
+  /* Core test case */
+  tc_core = tcase_create("mme_ue_s1ap_id index");
+  tcase_add_checked_fixture(tc_core, setup, teardown);
+  tcase_add_test(tc_core, handover_cancel_test);
+  tcase_add_test(tc_core, handover_complete_test);
+  tcase_add_test(tc_core, reassociation_test);
+
+  suite_add_tcase(s, tc_core);
+
+  return s;
+}
+
+int main(void) {
+  int number_failed;
+  Suite *s;
+  SRunner *sr;
+
+  s = s1ap_ue_index_suite();
+  sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
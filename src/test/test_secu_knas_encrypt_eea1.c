@@ -35,6 +35,8 @@ static void eea1_encrypt(uint8_t direction, uint32_t count, uint8_t bearer,
   if (zero_bits > 0) byte_length += 1;
 
   nas_cipher = calloc(1, sizeof(nas_stream_cipher_t));
+  // The key stream is applied by 32 bits words
+  result = calloc(1, ((length + 31) / 32) * 4);
   nas_cipher->direction = direction;
   nas_cipher->count = count;
   nas_cipher->key = key;
@@ -43,7 +45,7 @@ static void eea1_encrypt(uint8_t direction, uint32_t count, uint8_t bearer,
   nas_cipher->blength = length;
   nas_cipher->message = message;
 
-  if (nas_stream_encrypt_eea1(nas_cipher, &result) != 0)
+  if (nas_stream_encrypt_eea1(nas_cipher, result) != 0)
     fail("Fail: nas_stream_encrypt_eea1\n");
 
   if (compare_buffer(result, byte_length, expected, byte_length) != 0) {
@@ -0,0 +1,115 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "test_util.h"
+
+#include "milenage.h"
+
+#define NB_BATCH_VECTORS 37
+
+static uint64_t sqn_from_buffer(const uint8_t *sqn) {
+  uint64_t value = 0;
+
+  for (int i = 0; i < MILENAGE_SQN_LENGTH; i++) {
+    value = (value << 8) | sqn[i];
+  }
+  return value;
+}
+
+static void do_milenage(const uint8_t *k, const uint8_t *rand,
+                        const uint8_t *sqn, const uint8_t *amf,
+                        const uint8_t *op, const uint8_t *opc_exp,
+                        const uint8_t *f1_exp, const uint8_t *f2_exp,
+                        const uint8_t *f3_exp, const uint8_t *f4_exp,
+                        const uint8_t *f5_exp, const uint8_t *auts) {
+  milenage_ctx_t ctx;
+  milenage_vector_t vector;
+  milenage_vector_t batch[NB_BATCH_VECTORS];
+  uint8_t opc[MILENAGE_KEY_LENGTH];
+  uint8_t sqn_ak[MILENAGE_SQN_LENGTH];
+  uint64_t sqn_ms = 0;
+
+  milenage_compute_opc(k, op, opc);
+  if (compare_buffer(opc, 16, opc_exp, 16) != 0) {
+    fail("Fail: milenage OPc\n");
+  }
+  milenage_ctx_setup(&ctx, k, opc);
+  memcpy(vector.rand, rand, MILENAGE_RAND_LENGTH);
+  milenage_generate_vectors(&ctx, amf, sqn_from_buffer(sqn), 0, &vector, 1);
+  for (int i = 0; i < MILENAGE_SQN_LENGTH; i++) {
+    sqn_ak[i] = sqn[i] ^ f5_exp[i];
+  }
+  if ((compare_buffer(&vector.autn[8], 8, f1_exp, 8) != 0) ||
+      (compare_buffer(vector.xres, 8, f2_exp, 8) != 0) ||
+      (compare_buffer(vector.ck, 16, f3_exp, 16) != 0) ||
+      (compare_buffer(vector.ik, 16, f4_exp, 16) != 0) ||
+      (compare_buffer(vector.autn, 6, sqn_ak, 6) != 0) ||
+      (compare_buffer(&vector.autn[6], 2, amf, 2) != 0)) {
+    fail("Fail: milenage f1-f5\n");
+  }
+
+  // f1* and f5*: AUTS computed for SQN, AMF 0
+  if ((milenage_resync(&ctx, rand, auts, &sqn_ms) != 0) ||
+      (sqn_ms != sqn_from_buffer(sqn))) {
+    fail("Fail: milenage resync\n");
+  }
+
+  // A batch gives the same vectors as single computations
+  for (int v = 0; v < NB_BATCH_VECTORS; v++) {
+    memcpy(batch[v].rand, rand, MILENAGE_RAND_LENGTH);
+    batch[v].rand[v % MILENAGE_RAND_LENGTH] ^= (uint8_t)v;
+  }
+  milenage_generate_vectors(&ctx, amf, sqn_from_buffer(sqn), 32, batch,
+                            NB_BATCH_VECTORS);
+  for (int v = 0; v < NB_BATCH_VECTORS; v++) {
+    memcpy(vector.rand, batch[v].rand, MILENAGE_RAND_LENGTH);
+    milenage_generate_vectors(&ctx, amf, sqn_from_buffer(sqn) + 32 * v, 0,
+                              &vector, 1);
+    if (memcmp(&vector, &batch[v], sizeof(vector)) != 0) {
+      fail("Fail: milenage batch vector %d\n", v);
+    }
+  }
+}
+
+void doit(void) {
+  /*
+   * 3GPP TS 35.207 Test Set 1
+   */
+  do_milenage(H("465b5ce8b199b49faa5f0a2ee238a6bc"),
+              H("23553cbe9637a89d218ae64dae47bf35"), H("ff9bb4d0b607"),
+              H("b9b9"), H("cdc202d5123e20f62b6d676ac72cb318"),
+              H("cd63cb71954a9f4e48a5994e37a02baf"), H("4a9ffac354dfafb3"),
+              H("a54211d5e3ba50bf"), H("b40ba9a3c58b2a05bbf0d987b21bf8cb"),
+              H("f769bcd751044604127672711c6d3441"), H("aa689c648370"),
+              H("ba853f3c123ccf44e93596e355c6"));
+  /*
+   * 3GPP TS 35.207 Test Set 2
+   */
+  do_milenage(H("0396eb317b6d1c36f19c1c84cd6ffd16"),
+              H("c00d603103dcee52c4478119494202e8"), H("fd8eef40df7d"),
+              H("af17"), H("ff53bade17df5d4e793073ce9d7579fa"),
+              H("53c15671c60a4b731c55b4a441c0bde2"), H("5df5b31807e258b0"),
+              H("d3a628ed988620f0"), H("58c433ff7a7082acd424220f2b67c556"),
+              H("21a8c1f929702adb3e738488b9f5c5da"), H("c47783995f72"),
+              H("cd7ff630bebc1fb5eba74924b0e0"));
+}
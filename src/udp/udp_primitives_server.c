@@ -22,6 +22,7 @@
   \email: lionel.gauthier@eurecom.fr
 */
 
+#define _GNU_SOURCE  // recvmmsg
 #include <arpa/inet.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -47,8 +48,26 @@
 #include "queue.h"
 #include "udp_primitives_server.h"
 
+// Datagrams read by one recvmmsg() call on a socket
+#define UDP_RECV_BATCH_SIZE 64
+// Receive buffers of a socket, power of 2
+#define UDP_RECV_RING_SIZE 256
+
 struct udp_socket_desc_s {
-  uint8_t buffer[4096];
+  /*
+   * Ring of receive buffers handed to the tasks with UDP_DATA_IND, a buffer
+   * is reused once its last reference is released
+   */
+  shared_buffer_t ring[UDP_RECV_RING_SIZE];
+  uint8_t *ring_data;
+  uint32_t ring_next;
+
+  // One recvmmsg() batch
+  struct mmsghdr msgs[UDP_RECV_BATCH_SIZE];
+  struct iovec iovs[UDP_RECV_BATCH_SIZE];
+  struct sockaddr_in6 addrs[UDP_RECV_BATCH_SIZE];
+  shared_buffer_t *buffers[UDP_RECV_BATCH_SIZE];
+
   int sd; /* Socket descriptor to use */
 
   pthread_t listener_thread; /* Thread affected to recv */
@@ -141,70 +160,132 @@ static void udp_server_flush_sockets(struct epoll_event *events,
   }
 }
 
+//------------------------------------------------------------------------------
+static void udp_server_init_ring(struct udp_socket_desc_s *udp_sock_pP) {
+  udp_sock_pP->ring_data = malloc(UDP_RECV_RING_SIZE * UDP_DATA_MAX_MSG_LEN);
+  DevAssert(udp_sock_pP->ring_data != NULL);
+  for (int i = 0; i < UDP_RECV_RING_SIZE; i++) {
+    udp_sock_pP->ring[i].refcount = 0;
+    udp_sock_pP->ring[i].size = UDP_DATA_MAX_MSG_LEN;
+    udp_sock_pP->ring[i].is_pooled = 1;
+    udp_sock_pP->ring[i].data =
+        &udp_sock_pP->ring_data[i * UDP_DATA_MAX_MSG_LEN];
+  }
+}
+
+//------------------------------------------------------------------------------
+/*
+ * Set up the receive buffers of a recvmmsg() batch: the free slots of the
+ * ring following the last one used, or a single allocated buffer if the tasks
+ * still hold the next slot.
+ */
+static int udp_server_prepare_batch(struct udp_socket_desc_s *udp_sock_pP) {
+  int nb_buffers = 0;
+
+  while (nb_buffers < UDP_RECV_BATCH_SIZE) {
+    shared_buffer_t *buffer =
+        &udp_sock_pP->ring[(udp_sock_pP->ring_next + nb_buffers) &
+                           (UDP_RECV_RING_SIZE - 1)];
+
+    // Acquire: pairs with the release in shared_buffer_unref()
+    if (__atomic_load_n(&buffer->refcount, __ATOMIC_ACQUIRE)) {
+      break;
+    }
+    udp_sock_pP->buffers[nb_buffers++] = buffer;
+  }
+  if (!nb_buffers) {
+    OAILOG_DEBUG(LOG_UDP, "Receive ring of sd %d exhausted\n",
+                 udp_sock_pP->sd);
+    udp_sock_pP->buffers[nb_buffers++] =
+        shared_buffer_create(UDP_DATA_MAX_MSG_LEN);
+  }
+
+  for (int i = 0; i < nb_buffers; i++) {
+    struct msghdr *msg = &udp_sock_pP->msgs[i].msg_hdr;
+
+    udp_sock_pP->iovs[i].iov_base = udp_sock_pP->buffers[i]->data;
+    udp_sock_pP->iovs[i].iov_len = udp_sock_pP->buffers[i]->size;
+    memset(msg, 0, sizeof(struct msghdr));
+    msg->msg_name = &udp_sock_pP->addrs[i];
+    msg->msg_namelen = sizeof(struct sockaddr_in6);
+    msg->msg_iov = &udp_sock_pP->iovs[i];
+    msg->msg_iovlen = 1;
+  }
+  return nb_buffers;
+}
+
+//------------------------------------------------------------------------------
+static void udp_server_send_data_ind(struct udp_socket_desc_s *udp_sock_pP,
+                                     shared_buffer_t *buffer,
+                                     uint32_t bytes_received,
+                                     struct sockaddr_in6 *peer_addr) {
+  MessageDef *message_p = NULL;
+  udp_data_ind_t *udp_data_ind_p;
+  bool ipv6 = peer_addr->sin6_family == AF_INET6;
+  struct sockaddr_in *addr = (struct sockaddr_in *)peer_addr;
+
+  message_p = itti_alloc_new_message(TASK_UDP, UDP_DATA_IND);
+  DevAssert(message_p != NULL);
+  udp_data_ind_p = &message_p->ittiMsg.udp_data_ind;
+  // The reference of the receive buffer goes with the message
+  udp_data_ind_p->buffer = buffer;
+  udp_data_ind_p->msgBuf = buffer->data;
+  udp_data_ind_p->buffer_length = bytes_received;
+  udp_data_ind_p->local_port = udp_sock_pP->local_port;
+  udp_data_ind_p->peer_port =
+      ipv6 ? htons(peer_addr->sin6_port) : htons(addr->sin_port);
+  memcpy((void *)&udp_data_ind_p->sock_addr, peer_addr,
+         (ipv6) ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in));
+
+  OAILOG_DEBUG(LOG_UDP, "Msg of length %d received from %s:%u\n",
+               bytes_received,
+               (!ipv6) ? inet_ntoa(addr->sin_addr) : "TODO_IPV6",
+               ntohs(addr->sin_port));
+
+  if (itti_send_msg_to_task(udp_sock_pP->task_id, INSTANCE_DEFAULT,
+                            message_p) < 0) {
+    OAILOG_DEBUG(LOG_UDP, "Failed to send message %d to task %d\n",
+                 UDP_DATA_IND, udp_sock_pP->task_id);
+    // Still ours: release the receive buffer reference with the message
+    itti_free_msg_content(message_p);
+    itti_free(ITTI_MSG_ORIGIN_ID(message_p), message_p);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Read the pending datagrams, UDP_RECV_BATCH_SIZE at a time
 static void udp_server_receive_and_process(
     struct udp_socket_desc_s *udp_sock_pP) {
-  OAILOG_DEBUG(LOG_UDP, "Inserting new descriptor for task %d, sd %d\n",
-               udp_sock_pP->task_id, udp_sock_pP->sd);
-  {
-    int bytes_received = 0;
-    socklen_t from_len;
-    struct sockaddr_in addr;
-    struct sockaddr_in6 addr6;
-
-    bool ipv6 = udp_sock_pP->local_addr.sa_family == AF_INET6;
-
-    if (ipv6) {
-      from_len = (socklen_t)sizeof(struct sockaddr_in6);
-      memset(&addr, 0, sizeof(struct sockaddr_in6));
-    } else {
-      from_len = (socklen_t)sizeof(struct sockaddr_in);
-      memset(&addr6, 0, sizeof(struct sockaddr_in));
+  int nb_buffers = 0;
+  int nb_msgs = 0;
+
+  do {
+    nb_buffers = udp_server_prepare_batch(udp_sock_pP);
+
+    if ((nb_msgs = recvmmsg(udp_sock_pP->sd, udp_sock_pP->msgs, nb_buffers, 0,
+                            NULL)) <= 0) {
+      if ((nb_msgs < 0) && (EAGAIN != errno) && (EWOULDBLOCK != errno)) {
+        OAILOG_ERROR(LOG_UDP, "Recvfrom failed %s\n", strerror(errno));
+      }
+      nb_msgs = 0;
     }
 
-    if ((bytes_received = recvfrom(
-             udp_sock_pP->sd, udp_sock_pP->buffer, sizeof(udp_sock_pP->buffer),
-             0, ipv6 ? (struct sockaddr *)&addr6 : (struct sockaddr *)&addr,
-             &from_len)) <= 0) {
-      OAILOG_ERROR(LOG_UDP, "Recvfrom failed %s\n", strerror(errno));
-      // break;
-    } else {
-      MessageDef *message_p = NULL;
-      udp_data_ind_t *udp_data_ind_p;
-      AssertFatal(sizeof(udp_sock_pP->buffer) >= bytes_received,
-                  "UDP BUFFER OVERFLOW");
-      message_p = itti_alloc_new_message(TASK_UDP, UDP_DATA_IND);
-      DevAssert(message_p != NULL);
-      udp_data_ind_p = &message_p->ittiMsg.udp_data_ind;
-      memcpy(udp_data_ind_p->msgBuf, udp_sock_pP->buffer, bytes_received);
-
-      udp_data_ind_p->buffer_length = bytes_received;
-      udp_data_ind_p->local_port = udp_sock_pP->local_port;
-      udp_data_ind_p->peer_port =
-          ipv6 ? htons(addr6.sin6_port) : htons(addr.sin_port);
-      memcpy(
-          (void *)&udp_data_ind_p->sock_addr,
-          (ipv6) ? (struct sockaddr_in6 *)&addr6 : (struct sockaddr_in *)&addr,
-          (ipv6) ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in));
-
-      OAILOG_DEBUG(LOG_UDP, "Msg of length %d received from %s:%u\n",
-                   bytes_received,
-                   (!ipv6) ? inet_ntoa(addr.sin_addr) : "TODO_IPV6",
-                   ntohs(addr.sin_port));
-
-      if (itti_send_msg_to_task(udp_sock_pP->task_id, INSTANCE_DEFAULT,
-                                message_p) < 0) {
-        OAILOG_DEBUG(LOG_UDP, "Failed to send message %d to task %d\n",
-                     UDP_DATA_IND, udp_sock_pP->task_id);
-        // break;
+    for (int i = 0; i < nb_msgs; i++) {
+      shared_buffer_t *buffer = udp_sock_pP->buffers[i];
+
+      if (buffer->is_pooled) {
+        __atomic_store_n(&buffer->refcount, 1, __ATOMIC_RELAXED);
+        udp_sock_pP->ring_next =
+            (udp_sock_pP->ring_next + 1) & (UDP_RECV_RING_SIZE - 1);
       }
+      udp_server_send_data_ind(udp_sock_pP, buffer,
+                               udp_sock_pP->msgs[i].msg_len,
+                               &udp_sock_pP->addrs[i]);
     }
-  }
-  // close(udp_sock_pP->sd);
-  // udp_sock_pP->sd = -1;
-  // pthread_mutex_lock(&udp_socket_list_mutex);
-  // STAILQ_REMOVE(&udp_socket_list, udp_sock_pP, udp_socket_desc_s, entries);
-  // pthread_mutex_unlock(&udp_socket_list_mutex);
-  // return NULL;
+    if ((!nb_msgs) && (!udp_sock_pP->buffers[0]->is_pooled)) {
+      shared_buffer_unref(&udp_sock_pP->buffers[0]);
+    }
+  } while (nb_msgs == nb_buffers);
 }
 
 //------------------------------------------------------------------------------
@@ -275,6 +356,7 @@ static int udp_server_create_socket_v4(uint16_t port, struct in_addr *address,
   socket_desc_p->local_addr.sa_family = AF_INET;
   socket_desc_p->local_port = ntohs(addr_check.sin_port);
   socket_desc_p->task_id = task_id;
+  udp_server_init_ring(socket_desc_p);
   OAILOG_DEBUG(LOG_UDP, "(IPv4) Inserting new descriptor for task %d, sd %d\n",
                socket_desc_p->task_id, socket_desc_p->sd);
   pthread_mutex_lock(&udp_socket_list_mutex);
@@ -352,6 +434,7 @@ static int udp_server_create_socket_v6(uint16_t port, struct in6_addr *address,
   //  ((struct sockaddr_in6*)&socket_desc_p->local_addr)->sin6_family = AF_INET;
   socket_desc_p->local_port = ntohs(addr_check.sin_port);
   socket_desc_p->task_id = task_id;
+  udp_server_init_ring(socket_desc_p);
   OAILOG_DEBUG(LOG_UDP, "(IPv6) Inserting new descriptor for task %d, sd %d\n",
                socket_desc_p->task_id, socket_desc_p->sd);
   pthread_mutex_lock(&udp_socket_list_mutex);
@@ -48,3 +48,63 @@ void bdestroy_wrapper(bstring *b) {
     *b = NULL;
   }
 }
+
+//------------------------------------------------------------------------------
+// Takes the ownership of *b, the returned shared bstring has one reference
+shared_bstring_t *shared_bstring_create(bstring *b) {
+  shared_bstring_t *sb = calloc(1, sizeof(shared_bstring_t));
+
+  AssertFatal(sb, "Failed to allocate shared bstring");
+  sb->b = *b;
+  *b = NULL;
+  sb->refcount = 1;
+  return sb;
+}
+
+//------------------------------------------------------------------------------
+shared_bstring_t *shared_bstring_ref(shared_bstring_t *sb) {
+  __sync_fetch_and_add(&sb->refcount, 1);
+  return sb;
+}
+
+//------------------------------------------------------------------------------
+void shared_bstring_unref(shared_bstring_t **sb) {
+  if ((sb) && (*sb)) {
+    if (__sync_sub_and_fetch(&(*sb)->refcount, 1) == 0) {
+      bdestroy_wrapper(&(*sb)->b);
+      free_wrapper((void **)sb);
+    }
+    *sb = NULL;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Unpooled buffer with one reference, data follows the header
+shared_buffer_t *shared_buffer_create(uint32_t size) {
+  shared_buffer_t *sb = malloc(sizeof(shared_buffer_t) + size);
+
+  AssertFatal(sb, "Failed to allocate shared buffer");
+  sb->refcount = 1;
+  sb->size = size;
+  sb->is_pooled = 0;
+  sb->data = (uint8_t *)(sb + 1);
+  return sb;
+}
+
+//------------------------------------------------------------------------------
+shared_buffer_t *shared_buffer_ref(shared_buffer_t *sb) {
+  __atomic_add_fetch(&sb->refcount, 1, __ATOMIC_RELAXED);
+  return sb;
+}
+
+//------------------------------------------------------------------------------
+void shared_buffer_unref(shared_buffer_t **sb) {
+  if ((sb) && (*sb)) {
+    // Release: the producer of a pooled buffer may reuse it at once
+    if ((__atomic_sub_fetch(&(*sb)->refcount, 1, __ATOMIC_ACQ_REL) == 0) &&
+        (!(*sb)->is_pooled)) {
+      free(*sb);
+    }
+    *sb = NULL;
+  }
+}
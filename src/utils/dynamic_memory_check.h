@@ -24,9 +24,39 @@
 
 #ifndef FILE_DYNAMIC_MEMORY_CHECK_SEEN
 #define FILE_DYNAMIC_MEMORY_CHECK_SEEN
+#include <stdint.h>
+
 #include "bstrlib.h"
 
 void free_wrapper(void** ptr) __attribute__((hot));
 void bdestroy_wrapper(bstring* b);
 
+/* Reference counted bstring, for a buffer handed to several tasks or
+ * destinations (ex: one encoded S1AP PDU sent to several eNBs).
+ * The bstring is destroyed with the last reference.
+ */
+typedef struct shared_bstring_s {
+  bstring b;
+  uint32_t refcount;
+} shared_bstring_t;
+
+shared_bstring_t* shared_bstring_create(bstring* b);
+shared_bstring_t* shared_bstring_ref(shared_bstring_t* sb);
+void shared_bstring_unref(shared_bstring_t** sb);
+
+/* Reference counted receive buffer. A pooled buffer is a slot of a ring
+ * owned by its producer, which reuses it once the count drops to 0; an
+ * unpooled one is freed with the last reference.
+ */
+typedef struct shared_buffer_s {
+  uint32_t refcount;
+  uint32_t size;
+  uint8_t is_pooled;
+  uint8_t* data;
+} shared_buffer_t;
+
+shared_buffer_t* shared_buffer_create(uint32_t size);
+shared_buffer_t* shared_buffer_ref(shared_buffer_t* sb);
+void shared_buffer_unref(shared_buffer_t** sb);
+
 #endif /* FILE_DYNAMIC_MEMORY_CHECK_SEEN */
@@ -162,7 +162,7 @@ hash_table_t *hashtable_init(hash_table_t *const hashtblP,
     hashtblP->freefunc = free_wrapper;
 
   if (display_name_pP) {
-    bassign(hashtblP->name, display_name_pP);
+    hashtblP->name = bstrcpy(display_name_pP);
   } else {
     hashtblP->name = bformat("hashtable%u@%p", size, hashtblP);
   }
@@ -91,12 +91,22 @@ typedef struct hash_table_uint64_s {
   bool log_enabled;
 } hash_table_uint64_t;
 
+typedef struct hash_slot_uint64_s {
+  hash_key_t key;
+  uint64_t data;
+} hash_slot_uint64_t;
+
+struct hash_uint64_array_s;
+
+// Open addressing table, lock free readers, see hashtable_uint64.c
 typedef struct hash_table_uint64_ts_s {
-  pthread_mutex_t mutex;
-  hash_size_t size;
+  pthread_mutex_t mutex;  // serializes writers
+  uint32_t seq;           // odd while a writer modifies the table
   hash_size_t num_elements;
-  struct hash_node_uint64_s** nodes;
-  pthread_mutex_t* lock_nodes;
+  struct hash_uint64_array_s* current;
+  struct hash_uint64_array_s* old;  // being migrated to current
+  hash_size_t migrate_pos;
+  struct hash_uint64_array_s* retired;  // freed on destroy only
   hash_size_t (*hashfunc)(const hash_key_t);
   bstring name;
   bool is_allocated_by_malloc;
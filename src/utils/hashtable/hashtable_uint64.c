@@ -46,14 +46,21 @@
 //------------------------------------------------------------------------------
 /*
    Default hash function
-   def_hashfunc() is the default used by hashtable_uint64_create() when the user
-   didn't specify one. This is a simple/naive hash function which adds the key's
-   ASCII char values. It will probably generate lots of collisions on large hash
-   tables.
+   def_hashfunc() is the default used by hashtable_uint64_create() and
+   hashtable_uint64_ts_create() when the user didn't specify one. Keys such as
+   S1AP ids or TEIDs are allocated sequentially, the 64 bits finalizer of
+   MurmurHash3 spreads them over all buckets.
 */
 
 static inline hash_size_t def_hashfunc(const uint64_t keyP) {
-  return (hash_size_t)keyP;
+  uint64_t h = keyP;
+
+  h ^= h >> 33;
+  h *= UINT64_C(0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  h *= UINT64_C(0xc4ceb53a9ed8ccd9);
+  h ^= h >> 33;
+  return (hash_size_t)h;
 }
 
 //------------------------------------------------------------------------------
@@ -141,105 +148,6 @@ hash_table_uint64_t *hashtable_uint64_create(
   return hashtbl;
 }
 
-//------------------------------------------------------------------------------
-/*
-   Initialization
-   hashtable_uint64_ts_init() sets up the initial structure of the thread safe
-   hash table. The user specified size will be allocated and initialized to
-   NULL. The user can also specify a hash function. If the hashfunc argument is
-   NULL, a default hash function is used. If an error occurred, NULL is
-   returned. All other values in the returned hash_table_uint64_t pointer should
-   be released with hashtable_uint64_destroy().
-*/
-hash_table_uint64_ts_t *hashtable_uint64_ts_init(
-    hash_table_uint64_ts_t *const hashtblP, const hash_size_t sizeP,
-    hash_size_t (*hashfuncP)(const hash_key_t), bstring display_name_pP) {
-  hash_size_t size = sizeP;
-  // upper power of two:
-  // http://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2Float
-  //  By Sean Eron Anderson
-  // seander@cs.stanford.edu
-  // Individually, the code snippets here are in the public domain (unless
-  // otherwise noted) — feel free to use them however you please. The aggregate
-  // collection and descriptions are © 1997-2005 Sean Eron Anderson. The code
-  // and descriptions are distributed in the hope that they will be useful, but
-  // WITHOUT ANY WARRANTY and without even the implied warranty of
-  // merchantability or fitness for a particular purpose. As of May 5, 2005, all
-  // the code has been tested thoroughly. Thousands of people have read it.
-  // Moreover, Professor Randal Bryant, the Dean of Computer Science at Carnegie
-  // Mellon University, has personally tested almost everything with his Uclid
-  // code verification system. What he hasn't tested, I have checked against all
-  // possible inputs on a 32-bit machine. To the first person to inform me of a
-  // legitimate bug in the code, I'll pay a bounty of US$10 (by check or
-  // Paypal). If directed to a charity, I'll pay US$20.
-  size--;
-  size |= size >> 1;
-  size |= size >> 2;
-  size |= size >> 4;
-  size |= size >> 8;
-  size |= size >> 16;
-  size++;
-
-  memset(hashtblP, 0, sizeof(*hashtblP));
-
-  if (!(hashtblP->nodes = calloc(size, sizeof(hash_node_uint64_t *)))) {
-    free_wrapper((void **)&hashtblP);
-    return NULL;
-  }
-
-  if (!(hashtblP->lock_nodes = calloc(size, sizeof(pthread_mutex_t)))) {
-    free_wrapper((void **)&hashtblP->nodes);
-    free_wrapper((void **)&hashtblP->name);
-    free_wrapper((void **)&hashtblP);
-    return NULL;
-  }
-
-  pthread_mutex_init(&hashtblP->mutex, NULL);
-  for (int i = 0; i < size; i++) {
-    pthread_mutex_init(&hashtblP->lock_nodes[i], NULL);
-  }
-
-  hashtblP->size = size;
-
-  if (hashfuncP)
-    hashtblP->hashfunc = hashfuncP;
-  else
-    hashtblP->hashfunc = def_hashfunc;
-
-  if (display_name_pP) {
-    hashtblP->name = bstrcpy(display_name_pP);
-  } else {
-    hashtblP->name = bformat("hashtable@%p", hashtblP);
-  }
-  hashtblP->is_allocated_by_malloc = false;
-  hashtblP->log_enabled = true;
-  return hashtblP;
-}
-//------------------------------------------------------------------------------
-/*
-   Initialization
-   hashtable_uint64_ts_create() allocate and sets up the initial structure of
-   the thread safe hash table. The user specified size will be allocated and
-   initialized to NULL. The user can also specify a hash function. If the
-   hashfunc argument is NULL, a default hash function is used. If an error
-   occurred, NULL is returned. All other values in the returned
-   hash_table_uint64_t pointer should be released with
-   hashtable_uint64_destroy().
-*/
-hash_table_uint64_ts_t *hashtable_uint64_ts_create(
-    const hash_size_t sizeP, hash_size_t (*hashfuncP)(const hash_key_t),
-    bstring display_name_pP) {
-  hash_table_uint64_ts_t *hashtbl = NULL;
-
-  if (!(hashtbl = calloc(1, sizeof(hash_table_uint64_ts_t)))) {
-    return NULL;
-  }
-  hashtbl =
-      hashtable_uint64_ts_init(hashtbl, sizeP, hashfuncP, display_name_pP);
-  hashtbl->is_allocated_by_malloc = true;
-  return hashtbl;
-}
-
 //------------------------------------------------------------------------------
 /*
    Cleanup
@@ -273,44 +181,6 @@ hashtable_rc_t hashtable_uint64_destroy(hash_table_uint64_t *hashtblP) {
   return HASH_TABLE_OK;
 }
 
-//------------------------------------------------------------------------------
-/*
-   Cleanup
-   The hashtable_uint64_destroy() walks through the linked lists for each
-   possible hash value, and releases the elements. It also releases the nodes
-   array and the hash_table_uint64_t.
-*/
-hashtable_rc_t hashtable_uint64_ts_destroy(hash_table_uint64_ts_t *hashtblP) {
-  hash_size_t n = 0;
-  hash_node_uint64_t *node = NULL, *oldnode = NULL;
-
-  if (!hashtblP) {
-    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
-  }
-
-  for (n = 0; n < hashtblP->size; ++n) {
-    pthread_mutex_lock(&hashtblP->lock_nodes[n]);
-    node = hashtblP->nodes[n];
-
-    while (node) {
-      oldnode = node;
-      node = node->next;
-      free_wrapper((void **)&oldnode);
-    }
-
-    pthread_mutex_unlock(&hashtblP->lock_nodes[n]);
-    pthread_mutex_destroy(&hashtblP->lock_nodes[n]);
-  }
-
-  free_wrapper((void **)&hashtblP->nodes);
-  bdestroy_wrapper(&hashtblP->name);
-  free_wrapper((void **)&hashtblP->lock_nodes);
-  if (hashtblP->is_allocated_by_malloc) {
-    free_wrapper((void **)&hashtblP);
-  }
-  return HASH_TABLE_OK;
-}
-
 //------------------------------------------------------------------------------
 hashtable_rc_t hashtable_uint64_is_key_exists(
     const hash_table_uint64_t *const hashtblP, const hash_key_t keyP) {
@@ -338,36 +208,6 @@ hashtable_rc_t hashtable_uint64_is_key_exists(
   return HASH_TABLE_KEY_NOT_EXISTS;
 }
 
-//------------------------------------------------------------------------------
-hashtable_rc_t hashtable_uint64_ts_is_key_exists(
-    const hash_table_uint64_ts_t *const hashtblP, const hash_key_t keyP) {
-  hash_node_uint64_t *node = NULL;
-  hash_size_t hash = 0;
-
-  if (!hashtblP) {
-    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
-  }
-
-  hash = hashtblP->hashfunc(keyP) % hashtblP->size;
-  pthread_mutex_lock(&hashtblP->lock_nodes[hash]);
-  node = hashtblP->nodes[hash];
-
-  while (node) {
-    if (node->key == keyP) {
-      pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
-      PRINT_HASHTABLE(hashtblP, "%s(%s,key 0x%" PRIx64 ") return OK\n",
-                      __FUNCTION__, bdata(hashtblP->name), keyP);
-      return HASH_TABLE_OK;
-    }
-
-    node = node->next;
-  }
-  pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
-  PRINT_HASHTABLE(hashtblP, "%s(%s,key 0x%" PRIx64 ") return KEY_NOT_EXISTS\n",
-                  __FUNCTION__, bdata(hashtblP->name), keyP);
-  return HASH_TABLE_KEY_NOT_EXISTS;
-}
-
 //------------------------------------------------------------------------------
 // may cost a lot CPU...
 // Also useful if we want to find an element in the collection based on compare
@@ -404,104 +244,6 @@ hashtable_rc_t hashtable_uint64_apply_callback_on_elements(
   return HASH_TABLE_OK;
 }
 
-//------------------------------------------------------------------------------
-// may cost a lot CPU...
-hashtable_key_array_t *hashtable_uint64_ts_get_keys(
-    hash_table_uint64_ts_t *const hashtblP) {
-  hash_node_uint64_t *node = NULL;
-  unsigned int i = 0;
-  hashtable_key_array_t *ka = NULL;
-
-  if ((!hashtblP) || !(hashtblP->num_elements)) {
-    return NULL;
-  }
-  ka = calloc(1, sizeof(hashtable_key_array_t));
-  ka->keys = calloc(hashtblP->num_elements, sizeof(hash_key_t *));
-
-  while ((ka->num_keys < hashtblP->num_elements) && (i < hashtblP->size)) {
-    pthread_mutex_lock(&hashtblP->lock_nodes[i]);
-    if (hashtblP->nodes[i] != NULL) {
-      node = hashtblP->nodes[i];
-      while (node) {
-        ka->keys[ka->num_keys++] = node->key;
-        node = node->next;
-      }
-    }
-    pthread_mutex_unlock(&hashtblP->lock_nodes[i]);
-    i++;
-  }
-  return ka;
-}
-
-//------------------------------------------------------------------------------
-// may cost a lot CPU...
-hashtable_uint64_element_array_t *hashtable_uint64_ts_get_elements(
-    hash_table_uint64_ts_t *const hashtblP) {
-  hash_node_uint64_t *node = NULL;
-  unsigned int i = 0;
-  hashtable_uint64_element_array_t *ea = NULL;
-
-  if ((!hashtblP) || !(hashtblP->num_elements)) {
-    return NULL;
-  }
-
-  ea = calloc(1, sizeof(hashtable_uint64_element_array_t));
-  ea->elements = calloc(hashtblP->num_elements, sizeof(uint64_t *));
-
-  while ((ea->num_elements < hashtblP->num_elements) && (i < hashtblP->size)) {
-    pthread_mutex_lock(&hashtblP->lock_nodes[i]);
-    if (hashtblP->nodes[i] != NULL) {
-      node = hashtblP->nodes[i];
-      while (node) {
-        ea->elements[ea->num_elements++] = node->data;
-        node = node->next;
-      }
-    }
-    pthread_mutex_unlock(&hashtblP->lock_nodes[i]);
-    i++;
-  }
-  return ea;
-}
-
-//------------------------------------------------------------------------------
-// may cost a lot CPU...
-// Also useful if we want to find an element in the collection based on compare
-// criteria different than the single key The compare criteria in implemented in
-// the funct_cb function
-hashtable_rc_t hashtable_uint64_ts_apply_callback_on_elements(
-    hash_table_uint64_ts_t *const hashtblP,
-    bool funct_cb(const hash_key_t keyP, const uint64_t dataP, void *parameterP,
-                  void **resultP),
-    void *parameterP, void **resultP) {
-  hash_node_uint64_t *node = NULL;
-  unsigned int i = 0;
-  unsigned int num_elements = 0;
-
-  if (!hashtblP) {
-    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
-  }
-
-  while ((num_elements < hashtblP->num_elements) && (i < hashtblP->size)) {
-    pthread_mutex_lock(&hashtblP->lock_nodes[i]);
-    if (hashtblP->nodes[i] != NULL) {
-      node = hashtblP->nodes[i];
-
-      while (node) {
-        num_elements++;
-        if (funct_cb(node->key, node->data, parameterP, resultP)) {
-          pthread_mutex_unlock(&hashtblP->lock_nodes[i]);
-          return HASH_TABLE_OK;
-        }
-        node = node->next;
-      }
-    }
-    pthread_mutex_unlock(&hashtblP->lock_nodes[i]);
-    i++;
-  }
-
-  return HASH_TABLE_OK;
-}
-
 //------------------------------------------------------------------------------
 hashtable_rc_t hashtable_uint64_dump_content(
     const hash_table_uint64_t *const hashtblP, bstring str) {
@@ -535,58 +277,23 @@ hashtable_rc_t hashtable_uint64_dump_content(
 }
 
 //------------------------------------------------------------------------------
-hashtable_rc_t hashtable_uint64_ts_dump_content(
-    const hash_table_uint64_ts_t *const hashtblP, bstring str) {
+/*
+   Adding a new element
+   To make sure the hash value is not bigger than size, the result of the user
+   provided hash function is used modulo size.
+*/
+hashtable_rc_t hashtable_uint64_insert(hash_table_uint64_t *const hashtblP,
+                                       const hash_key_t keyP,
+                                       const uint64_t dataP) {
   hash_node_uint64_t *node = NULL;
-  unsigned int i = 0;
+  hash_size_t hash = 0;
 
   if (!hashtblP) {
-    bcatcstr(str, "HASH_TABLE_BAD_PARAMETER_HASHTABLE");
     return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
 
-  while (i < hashtblP->size) {
-    if (hashtblP->nodes[i] != NULL) {
-      pthread_mutex_lock(&hashtblP->lock_nodes[i]);
-      node = hashtblP->nodes[i];
-
-      while (node) {
-        bstring b0 =
-            bformat("Key 0x%" PRIx64 " Element %" PRIx64 " Node %p Next %p\n",
-                    node->key, node->data, node, node->next);
-        if (!b0) {
-          PRINT_HASHTABLE(hashtblP, "Error while dumping hashtable content");
-        } else {
-          bconcat(str, b0);
-          bdestroy_wrapper(&b0);
-        }
-        node = node->next;
-      }
-      pthread_mutex_unlock(&hashtblP->lock_nodes[i]);
-    }
-    i += 1;
-  }
-  return HASH_TABLE_OK;
-}
-
-//------------------------------------------------------------------------------
-/*
-   Adding a new element
-   To make sure the hash value is not bigger than size, the result of the user
-   provided hash function is used modulo size.
-*/
-hashtable_rc_t hashtable_uint64_insert(hash_table_uint64_t *const hashtblP,
-                                       const hash_key_t keyP,
-                                       const uint64_t dataP) {
-  hash_node_uint64_t *node = NULL;
-  hash_size_t hash = 0;
-
-  if (!hashtblP) {
-    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
-  }
-
-  hash = hashtblP->hashfunc(keyP) % hashtblP->size;
-  node = hashtblP->nodes[hash];
+  hash = hashtblP->hashfunc(keyP) % hashtblP->size;
+  node = hashtblP->nodes[hash];
 
   while (node) {
     if (node->key == keyP) {
@@ -628,68 +335,6 @@ hashtable_rc_t hashtable_uint64_insert(hash_table_uint64_t *const hashtblP,
   return HASH_TABLE_OK;
 }
 
-//------------------------------------------------------------------------------
-/*
-   Adding a new element
-   To make sure the hash value is not bigger than size, the result of the user
-   provided hash function is used modulo size.
-*/
-hashtable_rc_t hashtable_uint64_ts_insert(
-    hash_table_uint64_ts_t *const hashtblP, const hash_key_t keyP,
-    const uint64_t dataP) {
-  hash_node_uint64_t *node = NULL;
-  hash_size_t hash = 0;
-
-  if (!hashtblP) {
-    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
-  }
-
-  hash = hashtblP->hashfunc(keyP) % hashtblP->size;
-  pthread_mutex_lock(&hashtblP->lock_nodes[hash]);
-  node = hashtblP->nodes[hash];
-
-  while (node) {
-    if (node->key == keyP) {
-      if (node->data != dataP) {
-        node->data = dataP;
-        pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
-        PRINT_HASHTABLE(hashtblP,
-                        "%s(%s,key 0x%" PRIx64 " data %" PRIx64
-                        ") return INSERT_OVERWRITTEN_DATA\n",
-                        __FUNCTION__, bdata(hashtblP->name), keyP, dataP);
-        return HASH_TABLE_INSERT_OVERWRITTEN_DATA;
-      }
-      node->data = dataP;
-      pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
-      PRINT_HASHTABLE(hashtblP,
-                      "%s(%s,key 0x%" PRIx64 " data %" PRIx64 ") return OK\n",
-                      __FUNCTION__, bdata(hashtblP->name), keyP, dataP);
-      return HASH_TABLE_OK;
-    }
-
-    node = node->next;
-  }
-
-  if (!(node = malloc(sizeof(hash_node_uint64_t)))) return -1;
-
-  node->key = keyP;
-  node->data = dataP;
-
-  if (hashtblP->nodes[hash]) {
-    node->next = hashtblP->nodes[hash];
-  } else {
-    node->next = NULL;
-  }
-
-  hashtblP->nodes[hash] = node;
-  __sync_fetch_and_add(&hashtblP->num_elements, 1);
-  pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
-  PRINT_HASHTABLE(hashtblP,
-                  "%s(%s,key 0x%" PRIx64 " data %p) next %p return OK\n",
-                  __FUNCTION__, bdata(hashtblP->name), keyP, dataP, node->next);
-  return HASH_TABLE_OK;
-}
-
 //------------------------------------------------------------------------------
 /*
    To free_wrapper an element from the hash table, we just search for it in the
@@ -731,50 +376,6 @@ hashtable_rc_t hashtable_uint64_free(hash_table_uint64_t *const hashtblP,
   return HASH_TABLE_KEY_NOT_EXISTS;
 }
 
-//------------------------------------------------------------------------------
-/*
-   To free_wrapper an element from the hash table, we just search for it in the
-   linked list for that hash value, and free_wrapper it if it is found. If it
-   was not found, it is an error and -1 is returned.
-*/
-hashtable_rc_t hashtable_uint64_ts_free(hash_table_uint64_ts_t *const hashtblP,
-                                        const hash_key_t keyP) {
-  hash_node_uint64_t *node, *prevnode = NULL;
-  hash_size_t hash = 0;
-
-  if (!hashtblP) {
-    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
-  }
-
-  hash = hashtblP->hashfunc(keyP) % hashtblP->size;
-  pthread_mutex_lock(&hashtblP->lock_nodes[hash]);
-  node = hashtblP->nodes[hash];
-
-  while (node) {
-    if (node->key == keyP) {
-      if (prevnode)
-        prevnode->next = node->next;
-      else
-        hashtblP->nodes[hash] = node->next;
-
-      free_wrapper((void **)&node);
-      __sync_fetch_and_sub(&hashtblP->num_elements, 1);
-      pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
-      PRINT_HASHTABLE(hashtblP, "%s(%s,key 0x%" PRIx64 ") return OK\n",
-                      __FUNCTION__, bdata(hashtblP->name), keyP);
-      return HASH_TABLE_OK;
-    }
-
-    prevnode = node;
-    node = node->next;
-  }
-
-  pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
-  PRINT_HASHTABLE(hashtblP, "%s(%s,key 0x%" PRIx64 ") return KEY_NOT_EXISTS\n",
-                  __FUNCTION__, bdata(hashtblP->name), keyP);
-  return HASH_TABLE_KEY_NOT_EXISTS;
-}
-
 //------------------------------------------------------------------------------
 /*
    To remove an element from the hash table, we just search for it in the linked
@@ -816,50 +417,6 @@ hashtable_rc_t hashtable_uint64_remove(hash_table_uint64_t *const hashtblP,
   return HASH_TABLE_KEY_NOT_EXISTS;
 }
 
-//------------------------------------------------------------------------------
-/*
-   To remove an element from the hash table, we just search for it in the linked
-   list for that hash value, and remove it if it is found. If it was not found,
-   it is an error and -1 is returned.
-*/
-hashtable_rc_t hashtable_uint64_ts_remove(
-    hash_table_uint64_ts_t *const hashtblP, const hash_key_t keyP) {
-  hash_node_uint64_t *node, *prevnode = NULL;
-  hash_size_t hash = 0;
-
-  if (!hashtblP) {
-    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
-  }
-
-  hash = hashtblP->hashfunc(keyP) % hashtblP->size;
-  pthread_mutex_lock(&hashtblP->lock_nodes[hash]);
-  node = hashtblP->nodes[hash];
-
-  while (node) {
-    if (node->key == keyP) {
-      if (prevnode)
-        prevnode->next = node->next;
-      else
-        hashtblP->nodes[hash] = node->next;
-
-      free_wrapper((void **)&node);
-      __sync_fetch_and_sub(&hashtblP->num_elements, 1);
-      pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
-      PRINT_HASHTABLE(hashtblP, "%s(%s,key 0x%" PRIx64 ") return OK\n",
-                      __FUNCTION__, bdata(hashtblP->name), keyP);
-      return HASH_TABLE_OK;
-    }
-
-    prevnode = node;
-    node = node->next;
-  }
-  pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
-
-  PRINT_HASHTABLE(hashtblP, "%s(%s,key 0x%" PRIx64 ") return KEY_NOT_EXISTS\n",
-                  __FUNCTION__, bdata(hashtblP->name), keyP);
-  return HASH_TABLE_KEY_NOT_EXISTS;
-}
-
 //------------------------------------------------------------------------------
 /*
    Searching for an element is easy. We just search through the linked list for
@@ -894,43 +451,6 @@ hashtable_rc_t hashtable_uint64_get(const hash_table_uint64_t *const hashtblP,
   return HASH_TABLE_KEY_NOT_EXISTS;
 }
 
-//------------------------------------------------------------------------------
-/*
-   Searching for an element is easy. We just search through the linked list for
-   the corresponding hash value. NULL is returned if we didn't find it.
-*/
-hashtable_rc_t hashtable_uint64_ts_get(
-    const hash_table_uint64_ts_t *const hashtblP, const hash_key_t keyP,
-    uint64_t *const dataP) {
-  hash_node_uint64_t *node = NULL;
-  hash_size_t hash = 0;
-
-  if (!hashtblP) {
-    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
-  }
-
-  hash = hashtblP->hashfunc(keyP) % hashtblP->size;
-
-  pthread_mutex_lock(&hashtblP->lock_nodes[hash]);
-  node = hashtblP->nodes[hash];
-
-  while (node) {
-    if (node->key == keyP) {
-      *dataP = node->data;
-      pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
-      PRINT_HASHTABLE(hashtblP, "%s(%s,key 0x%" PRIx64 " data %p) return OK\n",
-                      __FUNCTION__, bdata(hashtblP->name), keyP, *dataP);
-      return HASH_TABLE_OK;
-    }
-
-    node = node->next;
-  }
-  pthread_mutex_unlock(&hashtblP->lock_nodes[hash]);
-  PRINT_HASHTABLE(hashtblP, "%s(%s,key 0x%" PRIx64 ") return KEY_NOT_EXISTS\n",
-                  __FUNCTION__, bdata(hashtblP->name), keyP);
-  return HASH_TABLE_KEY_NOT_EXISTS;
-}
-
 //------------------------------------------------------------------------------
 /*
    Resizing
@@ -1003,84 +523,691 @@ hashtable_rc_t hashtable_uint64_resize(hash_table_uint64_t *const hashtblP,
 
 //------------------------------------------------------------------------------
 /*
-   Resizing
-   The number of elements in a hash table is not always known when creating the
-   table. If the number of elements grows too large, it will seriously reduce
-   the performance of most hash table operations. If the number of elements are
-   reduced, the hash table will waste memory. That is why we provide a function
-   for resizing the table. Resizing a hash table is not as easy as a realloc().
-   All hash values must be recalculated and each element must be inserted into
-   its new position. We create a temporary hash_table_uint64_t object (newtbl)
-   to be used while building the new hashes. This allows us to reuse
-   hashtable_uint64_insert() and hashtable_uint64_free(), when moving the
-   elements to the new table. After that, we can just free_wrapper the old table
-   and copy the elements from newtbl to hashtbl. Dangerous not really thread
-   safe.
+   Thread safe uint64 hash table
+
+   hash_table_uint64_ts_t is a flat open addressing table using robin hood
+   hashing: each slot records its distance to its home bucket, so a lookup stops
+   as soon as it meets an element closer to its home than the searched key, and
+   no node is allocated per insertion.
+
+   Writers are serialized by the table mutex. Readers (get, is_key_exists) never
+   lock, they validate what they read against a sequence counter that writers
+   make odd while they modify the table (seqlock).
+
+   When the load factor is reached a table twice as large is allocated and
+   elements are migrated incrementally, HASH_UINT64_MIGRATE_STEP slots on each
+   write, so no single insertion pays for the whole rehash. While migrating,
+   lookups search the new then the old array, elements leaving the old array
+   are replaced by tombstones. A reader may still walk an array after it was
+   retired, with no bound on how long, so retired arrays are only released when
+   the table is destroyed. The table never shrinks, the retired arrays add up
+   to less than the current one.
 */
 
-hashtable_rc_t hashtable_uint64_ts_resize(
-    hash_table_uint64_ts_t *const hashtblP, const hash_size_t sizeP) {
-  hash_table_uint64_ts_t newtbl = {.mutex = PTHREAD_MUTEX_INITIALIZER, 0};
-  hash_size_t n = 0;
-  hash_node_uint64_t *node = NULL, *next = NULL;
+#define HASH_UINT64_META_TOMBSTONE 0x80
+#define HASH_UINT64_META_DIST_MASK 0x7f
+#define HASH_UINT64_MAX_DIST (HASH_UINT64_META_DIST_MASK - 1)
+#define HASH_UINT64_MIN_SIZE 16
+#define HASH_UINT64_MIGRATE_STEP 64
+// Max load factor is 7/8
+#define HASH_UINT64_MAX_LOAD(sIZE) (((sIZE) >> 3) * 7)
+
+struct hash_uint64_array_s {
+  hash_size_t size;
+  hash_size_t num_elements;
+  uint8_t *meta;  // 0 if empty, else probe distance + 1 (| tombstone flag)
+  hash_slot_uint64_t *slots;
+  struct hash_uint64_array_s *next_retired;
+};
 
-  if (!hashtblP) {
-    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
-  }
-  hash_size_t size = sizeP;
-  // upper power of two:
-  // http://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2Float
-  //  By Sean Eron Anderson
-  // seander@cs.stanford.edu
-  // Individually, the code snippets here are in the public domain (unless
-  // otherwise noted) — feel free to use them however you please. The aggregate
-  // collection and descriptions are © 1997-2005 Sean Eron Anderson. The code
-  // and descriptions are distributed in the hope that they will be useful, but
-  // WITHOUT ANY WARRANTY and without even the implied warranty of
-  // merchantability or fitness for a particular purpose. As of May 5, 2005, all
-  // the code has been tested thoroughly. Thousands of people have read it.
-  // Moreover, Professor Randal Bryant, the Dean of Computer Science at Carnegie
-  // Mellon University, has personally tested almost everything with his Uclid
-  // code verification system. What he hasn't tested, I have checked against all
-  // possible inputs on a 32-bit machine. To the first person to inform me of a
-  // legitimate bug in the code, I'll pay a bounty of US$10 (by check or
-  // Paypal). If directed to a charity, I'll pay US$20.
-  size--;
-  size |= size >> 1;
-  size |= size >> 2;
-  size |= size >> 4;
-  size |= size >> 8;
-  size |= size >> 16;
-  size++;
+//------------------------------------------------------------------------------
+static hash_size_t hashtable_uint64_ts_round_size(const hash_size_t sizeP) {
+  hash_size_t size = HASH_UINT64_MIN_SIZE;
 
-  newtbl.size = size;
-  newtbl.hashfunc = hashtblP->hashfunc;
+  while (size < sizeP) {
+    size <<= 1;
+  }
+  return size;
+}
 
-  if (!(newtbl.nodes = calloc(size, sizeof(hash_node_uint64_t *))))
-    return HASH_TABLE_SYSTEM_ERROR;
+//------------------------------------------------------------------------------
+static struct hash_uint64_array_s *hashtable_uint64_ts_array_create(
+    const hash_size_t size) {
+  struct hash_uint64_array_s *array = NULL;
 
-  if (!(newtbl.lock_nodes = calloc(size, sizeof(pthread_mutex_t)))) {
-    free_wrapper((void **)&newtbl.nodes);
-    return HASH_TABLE_SYSTEM_ERROR;
+  if (!(array = calloc(1, sizeof(struct hash_uint64_array_s)))) {
+    return NULL;
   }
-  for (n = 0; n < hashtblP->size; ++n) {
-    pthread_mutex_init(&newtbl.lock_nodes[n], NULL);
+  array->size = size;
+  array->meta = calloc(size, sizeof(uint8_t));
+  array->slots = malloc(size * sizeof(hash_slot_uint64_t));
+  if ((!array->meta) || (!array->slots)) {
+    free_wrapper((void **)&array->meta);
+    free_wrapper((void **)&array->slots);
+    free_wrapper((void **)&array);
+    return NULL;
+  }
+  return array;
+}
+
+//------------------------------------------------------------------------------
+static void hashtable_uint64_ts_array_destroy(
+    struct hash_uint64_array_s *array) {
+  if (array) {
+    free_wrapper((void **)&array->meta);
+    free_wrapper((void **)&array->slots);
+    free_wrapper((void **)&array);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Lookup without lock, the caller validates the result with the seqlock
+static inline bool hashtable_uint64_ts_array_lookup(
+    const struct hash_uint64_array_s *const array, const hash_size_t hash,
+    const hash_key_t keyP, uint64_t *const dataP) {
+  const hash_size_t mask = array->size - 1;
+  hash_size_t i = hash & mask;
+
+  for (unsigned int dist = 0; dist <= HASH_UINT64_MAX_DIST; dist++) {
+    uint8_t meta = __atomic_load_n(&array->meta[i], __ATOMIC_RELAXED);
+
+    if ((meta == 0) || (((meta & HASH_UINT64_META_DIST_MASK) - 1) < dist)) {
+      return false;
+    }
+    if ((!(meta & HASH_UINT64_META_TOMBSTONE)) &&
+        (__atomic_load_n(&array->slots[i].key, __ATOMIC_RELAXED) == keyP)) {
+      if (dataP) {
+        *dataP = __atomic_load_n(&array->slots[i].data, __ATOMIC_RELAXED);
+      }
+      return true;
+    }
+    i = (i + 1) & mask;
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Must be called with the table mutex held, returns the slot index or -1
+static long hashtable_uint64_ts_array_find(
+    const struct hash_uint64_array_s *const array, const hash_size_t hash,
+    const hash_key_t keyP) {
+  const hash_size_t mask = array->size - 1;
+  hash_size_t i = hash & mask;
+
+  for (unsigned int dist = 0; dist <= HASH_UINT64_MAX_DIST; dist++) {
+    uint8_t meta = array->meta[i];
+
+    if ((meta == 0) || (((meta & HASH_UINT64_META_DIST_MASK) - 1) < dist)) {
+      return -1;
+    }
+    if ((!(meta & HASH_UINT64_META_TOMBSTONE)) &&
+        (array->slots[i].key == keyP)) {
+      return (long)i;
+    }
+    i = (i + 1) & mask;
+  }
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+/*
+   Robin hood insertion of a key known to be absent from the array. Returns
+   false if the probe distance limit was reached, in that case *slotP holds the
+   element that could not be placed (may differ from the inserted one).
+*/
+static bool hashtable_uint64_ts_array_insert(
+    struct hash_uint64_array_s *const array,
+    hash_size_t (*hashfunc)(const hash_key_t), hash_slot_uint64_t *slotP) {
+  const hash_size_t mask = array->size - 1;
+  hash_slot_uint64_t carried = *slotP;
+  hash_size_t i = hashfunc(carried.key) & mask;
+  unsigned int dist = 0;
+
+  while (dist <= HASH_UINT64_MAX_DIST) {
+    uint8_t meta = array->meta[i];
+
+    if (meta == 0) {
+      array->slots[i] = carried;
+      array->meta[i] = dist + 1;
+      array->num_elements++;
+      return true;
+    }
+    if (((meta & HASH_UINT64_META_DIST_MASK) - 1) < dist) {
+      // Steal the slot from the richer element and carry it further
+      hash_slot_uint64_t tmp = array->slots[i];
+
+      array->slots[i] = carried;
+      array->meta[i] = dist + 1;
+      carried = tmp;
+      dist = (meta & HASH_UINT64_META_DIST_MASK) - 1;
+    }
+    i = (i + 1) & mask;
+    dist++;
+  }
+  *slotP = carried;
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Backward shift deletion, must be called with the table mutex held
+static void hashtable_uint64_ts_array_delete(
+    struct hash_uint64_array_s *const array, hash_size_t i) {
+  const hash_size_t mask = array->size - 1;
+  hash_size_t j = (i + 1) & mask;
+
+  while ((array->meta[j] & HASH_UINT64_META_DIST_MASK) > 1) {
+    array->slots[i] = array->slots[j];
+    array->meta[i] = array->meta[j] - 1;
+    i = j;
+    j = (j + 1) & mask;
+  }
+  array->meta[i] = 0;
+  array->num_elements--;
+}
+
+//------------------------------------------------------------------------------
+static inline void hashtable_uint64_ts_write_begin(
+    hash_table_uint64_ts_t *const hashtblP) {
+  __atomic_store_n(&hashtblP->seq, hashtblP->seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+static inline void hashtable_uint64_ts_write_end(
+    hash_table_uint64_ts_t *const hashtblP) {
+  __atomic_store_n(&hashtblP->seq, hashtblP->seq + 1, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+// Must be called with the table mutex held, inside a write section
+static void hashtable_uint64_ts_migrate(hash_table_uint64_ts_t *const hashtblP,
+                                        hash_size_t nb_slots) {
+  struct hash_uint64_array_s *old = hashtblP->old;
+  hash_slot_uint64_t slot;
+
+  if (!old) return;
+
+  while ((nb_slots--) && (hashtblP->migrate_pos < old->size)) {
+    hash_size_t i = hashtblP->migrate_pos++;
+
+    if ((old->meta[i]) && (!(old->meta[i] & HASH_UINT64_META_TOMBSTONE))) {
+      slot = old->slots[i];
+      if (!hashtable_uint64_ts_array_insert(hashtblP->current,
+                                            hashtblP->hashfunc, &slot)) {
+        // Cannot happen with a twice as large array and a decent hash function
+        AssertFatal(0, "%s: probe limit reached while migrating\n",
+                    bdata(hashtblP->name));
+      }
+      // Keep the distance so that probing in old array still works
+      old->meta[i] |= HASH_UINT64_META_TOMBSTONE;
+      old->num_elements--;
+    }
+  }
+
+  if (hashtblP->migrate_pos >= old->size) {
+    old->next_retired = hashtblP->retired;
+    hashtblP->retired = old;
+    hashtblP->old = NULL;
+    hashtblP->migrate_pos = 0;
+    PRINT_HASHTABLE(hashtblP, "%s(%s) migration to size %zu done\n",
+                    __FUNCTION__, bdata(hashtblP->name),
+                    hashtblP->current->size);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Must be called with the table mutex held, inside a write section
+static hashtable_rc_t hashtable_uint64_ts_grow(
+    hash_table_uint64_ts_t *const hashtblP, const hash_size_t sizeP) {
+  struct hash_uint64_array_s *array = NULL;
+
+  // Only one migration at a time
+  hashtable_uint64_ts_migrate(hashtblP, (hash_size_t)-1);
+
+  if (!(array = hashtable_uint64_ts_array_create(
+            hashtable_uint64_ts_round_size(sizeP)))) {
+    return HASH_TABLE_SYSTEM_ERROR;
+  }
+  hashtblP->old = hashtblP->current;
+  hashtblP->migrate_pos = 0;
+  __atomic_store_n(&hashtblP->current, array, __ATOMIC_RELEASE);
+  PRINT_HASHTABLE(hashtblP, "%s(%s) resizing to %zu\n", __FUNCTION__,
+                  bdata(hashtblP->name), array->size);
+  return HASH_TABLE_OK;
+}
+
+//------------------------------------------------------------------------------
+/*
+   Initialization
+   hashtable_uint64_ts_init() sets up the initial structure of the thread safe
+   hash table. The user specified size is rounded up to a power of two, the
+   table grows on demand. The user can also specify a hash function. If the
+   hashfunc argument is NULL, a default hash function is used. If an error
+   occurred, NULL is returned. All other values in the returned
+   hash_table_uint64_ts_t pointer should be released with
+   hashtable_uint64_ts_destroy().
+*/
+hash_table_uint64_ts_t *hashtable_uint64_ts_init(
+    hash_table_uint64_ts_t *const hashtblP, const hash_size_t sizeP,
+    hash_size_t (*hashfuncP)(const hash_key_t), bstring display_name_pP) {
+  memset(hashtblP, 0, sizeof(*hashtblP));
+
+  if (!(hashtblP->current = hashtable_uint64_ts_array_create(
+            hashtable_uint64_ts_round_size(sizeP)))) {
+    free_wrapper((void **)&hashtblP);
+    return NULL;
+  }
+
+  pthread_mutex_init(&hashtblP->mutex, NULL);
+
+  if (hashfuncP)
+    hashtblP->hashfunc = hashfuncP;
+  else
+    hashtblP->hashfunc = def_hashfunc;
+
+  if (display_name_pP) {
+    hashtblP->name = bstrcpy(display_name_pP);
+  } else {
+    hashtblP->name = bformat("hashtable@%p", hashtblP);
+  }
+  hashtblP->is_allocated_by_malloc = false;
+  hashtblP->log_enabled = true;
+  return hashtblP;
+}
+
+//------------------------------------------------------------------------------
+/*
+   Initialization
+   hashtable_uint64_ts_create() allocate and sets up the initial structure of
+   the thread safe hash table. See hashtable_uint64_ts_init().
+*/
+hash_table_uint64_ts_t *hashtable_uint64_ts_create(
+    const hash_size_t sizeP, hash_size_t (*hashfuncP)(const hash_key_t),
+    bstring display_name_pP) {
+  hash_table_uint64_ts_t *hashtbl = NULL;
+
+  if (!(hashtbl = calloc(1, sizeof(hash_table_uint64_ts_t)))) {
+    return NULL;
+  }
+  hashtbl =
+      hashtable_uint64_ts_init(hashtbl, sizeP, hashfuncP, display_name_pP);
+  if (hashtbl) {
+    hashtbl->is_allocated_by_malloc = true;
+  }
+  return hashtbl;
+}
+
+//------------------------------------------------------------------------------
+/*
+   Cleanup
+   The hashtable_uint64_ts_destroy() releases the slot arrays and the
+   hash_table_uint64_ts_t. There must be no concurrent access to the table.
+*/
+hashtable_rc_t hashtable_uint64_ts_destroy(hash_table_uint64_ts_t *hashtblP) {
+  struct hash_uint64_array_s *retired = NULL;
+
+  if (!hashtblP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
   }
 
   pthread_mutex_lock(&hashtblP->mutex);
-  for (n = 0; n < hashtblP->size; ++n) {
-    for (node = hashtblP->nodes[n]; node; node = next) {
-      next = node->next;
-      hashtable_uint64_ts_remove(hashtblP, node->key);
-      hashtable_uint64_ts_insert(&newtbl, node->key, node->data);
+  hashtable_uint64_ts_array_destroy(hashtblP->current);
+  hashtable_uint64_ts_array_destroy(hashtblP->old);
+  while ((retired = hashtblP->retired)) {
+    hashtblP->retired = retired->next_retired;
+    hashtable_uint64_ts_array_destroy(retired);
+  }
+  hashtblP->current = NULL;
+  hashtblP->old = NULL;
+  pthread_mutex_unlock(&hashtblP->mutex);
+  pthread_mutex_destroy(&hashtblP->mutex);
+
+  bdestroy_wrapper(&hashtblP->name);
+  if (hashtblP->is_allocated_by_malloc) {
+    free_wrapper((void **)&hashtblP);
+  }
+  return HASH_TABLE_OK;
+}
+
+//------------------------------------------------------------------------------
+hashtable_rc_t hashtable_uint64_ts_is_key_exists(
+    const hash_table_uint64_ts_t *const hashtblP, const hash_key_t keyP) {
+  if (!hashtblP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+
+  if (HASH_TABLE_OK == hashtable_uint64_ts_get(hashtblP, keyP, NULL)) {
+    return HASH_TABLE_OK;
+  }
+  return HASH_TABLE_KEY_NOT_EXISTS;
+}
+
+//------------------------------------------------------------------------------
+// may cost a lot CPU...
+hashtable_key_array_t *hashtable_uint64_ts_get_keys(
+    hash_table_uint64_ts_t *const hashtblP) {
+  hashtable_key_array_t *ka = NULL;
+  struct hash_uint64_array_s *arrays[2] = {NULL, NULL};
+
+  if (!hashtblP) {
+    return NULL;
+  }
+  pthread_mutex_lock(&hashtblP->mutex);
+  if (!(hashtblP->num_elements)) {
+    pthread_mutex_unlock(&hashtblP->mutex);
+    return NULL;
+  }
+  ka = calloc(1, sizeof(hashtable_key_array_t));
+  ka->keys = calloc(hashtblP->num_elements, sizeof(hash_key_t));
+  arrays[0] = hashtblP->current;
+  arrays[1] = hashtblP->old;
+
+  for (int a = 0; a < 2; a++) {
+    for (hash_size_t i = 0; (arrays[a]) && (i < arrays[a]->size); i++) {
+      if ((arrays[a]->meta[i]) &&
+          (!(arrays[a]->meta[i] & HASH_UINT64_META_TOMBSTONE))) {
+        ka->keys[ka->num_keys++] = arrays[a]->slots[i].key;
+      }
     }
   }
+  pthread_mutex_unlock(&hashtblP->mutex);
+  return ka;
+}
 
-  free_wrapper((void **)&hashtblP->nodes);
-  free_wrapper((void **)&hashtblP->lock_nodes);
-  hashtblP->size = newtbl.size;
-  hashtblP->nodes = newtbl.nodes;
-  hashtblP->lock_nodes = newtbl.lock_nodes;
+//------------------------------------------------------------------------------
+// may cost a lot CPU...
+hashtable_uint64_element_array_t *hashtable_uint64_ts_get_elements(
+    hash_table_uint64_ts_t *const hashtblP) {
+  hashtable_uint64_element_array_t *ea = NULL;
+  struct hash_uint64_array_s *arrays[2] = {NULL, NULL};
+
+  if (!hashtblP) {
+    return NULL;
+  }
+
+  pthread_mutex_lock(&hashtblP->mutex);
+  if (!(hashtblP->num_elements)) {
+    pthread_mutex_unlock(&hashtblP->mutex);
+    return NULL;
+  }
+  ea = calloc(1, sizeof(hashtable_uint64_element_array_t));
+  ea->elements = calloc(hashtblP->num_elements, sizeof(uint64_t));
+  arrays[0] = hashtblP->current;
+  arrays[1] = hashtblP->old;
+
+  for (int a = 0; a < 2; a++) {
+    for (hash_size_t i = 0; (arrays[a]) && (i < arrays[a]->size); i++) {
+      if ((arrays[a]->meta[i]) &&
+          (!(arrays[a]->meta[i] & HASH_UINT64_META_TOMBSTONE))) {
+        ea->elements[ea->num_elements++] = arrays[a]->slots[i].data;
+      }
+    }
+  }
+  pthread_mutex_unlock(&hashtblP->mutex);
+  return ea;
+}
+
+//------------------------------------------------------------------------------
+// may cost a lot CPU...
+// Also useful if we want to find an element in the collection based on compare
+// criteria different than the single key The compare criteria in implemented in
+// the funct_cb function. The callback must not modify the table.
+hashtable_rc_t hashtable_uint64_ts_apply_callback_on_elements(
+    hash_table_uint64_ts_t *const hashtblP,
+    bool funct_cb(const hash_key_t keyP, const uint64_t dataP, void *parameterP,
+                  void **resultP),
+    void *parameterP, void **resultP) {
+  struct hash_uint64_array_s *arrays[2] = {NULL, NULL};
+
+  if (!hashtblP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+
+  pthread_mutex_lock(&hashtblP->mutex);
+  arrays[0] = hashtblP->current;
+  arrays[1] = hashtblP->old;
+  for (int a = 0; a < 2; a++) {
+    for (hash_size_t i = 0; (arrays[a]) && (i < arrays[a]->size); i++) {
+      if ((arrays[a]->meta[i]) &&
+          (!(arrays[a]->meta[i] & HASH_UINT64_META_TOMBSTONE))) {
+        if (funct_cb(arrays[a]->slots[i].key, arrays[a]->slots[i].data,
+                     parameterP, resultP)) {
+          pthread_mutex_unlock(&hashtblP->mutex);
+          return HASH_TABLE_OK;
+        }
+      }
+    }
+  }
   pthread_mutex_unlock(&hashtblP->mutex);
   return HASH_TABLE_OK;
 }
+
+//------------------------------------------------------------------------------
+hashtable_rc_t hashtable_uint64_ts_dump_content(
+    const hash_table_uint64_ts_t *const hashtblP, bstring str) {
+  struct hash_uint64_array_s *arrays[2] = {NULL, NULL};
+
+  if (!hashtblP) {
+    bcatcstr(str, "HASH_TABLE_BAD_PARAMETER_HASHTABLE");
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+
+  pthread_mutex_lock((pthread_mutex_t *)&hashtblP->mutex);
+  arrays[0] = hashtblP->current;
+  arrays[1] = hashtblP->old;
+  for (int a = 0; a < 2; a++) {
+    for (hash_size_t i = 0; (arrays[a]) && (i < arrays[a]->size); i++) {
+      if ((arrays[a]->meta[i]) &&
+          (!(arrays[a]->meta[i] & HASH_UINT64_META_TOMBSTONE))) {
+        bstring b0 = bformat("Key 0x%" PRIx64 " Element %" PRIx64
+                             " Slot %zu Dist %u\n",
+                             arrays[a]->slots[i].key, arrays[a]->slots[i].data,
+                             i,
+                             (arrays[a]->meta[i] & HASH_UINT64_META_DIST_MASK) -
+                                 1);
+        if (!b0) {
+          PRINT_HASHTABLE(hashtblP, "Error while dumping hashtable content");
+        } else {
+          bconcat(str, b0);
+          bdestroy_wrapper(&b0);
+        }
+      }
+    }
+  }
+  pthread_mutex_unlock((pthread_mutex_t *)&hashtblP->mutex);
+  return HASH_TABLE_OK;
+}
+
+//------------------------------------------------------------------------------
+/*
+   Adding a new element
+   An existing key is updated in place (in the old array it is moved to the
+   current one). A new key may trigger the growth of the table.
+*/
+hashtable_rc_t hashtable_uint64_ts_insert(
+    hash_table_uint64_ts_t *const hashtblP, const hash_key_t keyP,
+    const uint64_t dataP) {
+  hashtable_rc_t rc = HASH_TABLE_OK;
+  hash_size_t hash = 0;
+  hash_slot_uint64_t slot = {.key = keyP, .data = dataP};
+  long i = -1;
+
+  if (!hashtblP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+
+  hash = hashtblP->hashfunc(keyP);
+  pthread_mutex_lock(&hashtblP->mutex);
+  hashtable_uint64_ts_write_begin(hashtblP);
+  hashtable_uint64_ts_migrate(hashtblP, HASH_UINT64_MIGRATE_STEP);
+
+  if ((i = hashtable_uint64_ts_array_find(hashtblP->current, hash, keyP)) >=
+      0) {
+    if (hashtblP->current->slots[i].data != dataP) {
+      hashtblP->current->slots[i].data = dataP;
+      rc = HASH_TABLE_INSERT_OVERWRITTEN_DATA;
+    }
+    goto unlock;
+  }
+
+  if ((hashtblP->old) &&
+      ((i = hashtable_uint64_ts_array_find(hashtblP->old, hash, keyP)) >= 0)) {
+    // Only the current array receives new elements
+    if (hashtblP->old->slots[i].data != dataP) {
+      rc = HASH_TABLE_INSERT_OVERWRITTEN_DATA;
+    }
+    hashtblP->old->meta[i] |= HASH_UINT64_META_TOMBSTONE;
+    hashtblP->old->num_elements--;
+    hashtblP->num_elements--;
+  }
+
+  if (hashtblP->current->num_elements + 1 >
+      HASH_UINT64_MAX_LOAD(hashtblP->current->size)) {
+    if (HASH_TABLE_OK !=
+        hashtable_uint64_ts_grow(hashtblP, hashtblP->current->size << 1)) {
+      rc = HASH_TABLE_SYSTEM_ERROR;
+      goto unlock;
+    }
+  }
+
+  while (!hashtable_uint64_ts_array_insert(hashtblP->current,
+                                           hashtblP->hashfunc, &slot)) {
+    // Probe limit reached (bad hash function), grow synchronously
+    hashtable_uint64_ts_grow(hashtblP, hashtblP->current->size << 1);
+    hashtable_uint64_ts_migrate(hashtblP, (hash_size_t)-1);
+  }
+  hashtblP->num_elements++;
+
+unlock:
+  hashtable_uint64_ts_write_end(hashtblP);
+  pthread_mutex_unlock(&hashtblP->mutex);
+  PRINT_HASHTABLE(hashtblP,
+                  "%s(%s,key 0x%" PRIx64 " data %" PRIx64 ") return %s\n",
+                  __FUNCTION__, bdata(hashtblP->name), keyP, dataP,
+                  hashtable_rc_code2string(rc));
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+/*
+   Removing an element, data being a plain uint64_t, free and remove are the
+   same operation.
+*/
+hashtable_rc_t hashtable_uint64_ts_free(hash_table_uint64_ts_t *const hashtblP,
+                                        const hash_key_t keyP) {
+  return hashtable_uint64_ts_remove(hashtblP, keyP);
+}
+
+//------------------------------------------------------------------------------
+hashtable_rc_t hashtable_uint64_ts_remove(
+    hash_table_uint64_ts_t *const hashtblP, const hash_key_t keyP) {
+  hashtable_rc_t rc = HASH_TABLE_KEY_NOT_EXISTS;
+  hash_size_t hash = 0;
+  long i = -1;
+
+  if (!hashtblP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+
+  hash = hashtblP->hashfunc(keyP);
+  pthread_mutex_lock(&hashtblP->mutex);
+  hashtable_uint64_ts_write_begin(hashtblP);
+  hashtable_uint64_ts_migrate(hashtblP, HASH_UINT64_MIGRATE_STEP);
+
+  if ((i = hashtable_uint64_ts_array_find(hashtblP->current, hash, keyP)) >=
+      0) {
+    hashtable_uint64_ts_array_delete(hashtblP->current, i);
+    hashtblP->num_elements--;
+    rc = HASH_TABLE_OK;
+  } else if ((hashtblP->old) && ((i = hashtable_uint64_ts_array_find(
+                                      hashtblP->old, hash, keyP)) >= 0)) {
+    hashtblP->old->meta[i] |= HASH_UINT64_META_TOMBSTONE;
+    hashtblP->old->num_elements--;
+    hashtblP->num_elements--;
+    rc = HASH_TABLE_OK;
+  }
+
+  hashtable_uint64_ts_write_end(hashtblP);
+  pthread_mutex_unlock(&hashtblP->mutex);
+  PRINT_HASHTABLE(hashtblP, "%s(%s,key 0x%" PRIx64 ") return %s\n",
+                  __FUNCTION__, bdata(hashtblP->name), keyP,
+                  hashtable_rc_code2string(rc));
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+/*
+   Lock free lookup: the lookup is retried if a writer modified the table
+   meanwhile. dataP may be NULL if only the existence of the key matters.
+*/
+hashtable_rc_t hashtable_uint64_ts_get(
+    const hash_table_uint64_ts_t *const hashtblP, const hash_key_t keyP,
+    uint64_t *const dataP) {
+  hash_size_t hash = 0;
+  uint64_t data = 0;
+  uint32_t seq = 0;
+  bool found = false;
+
+  if (!hashtblP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+
+  hash = hashtblP->hashfunc(keyP);
+  do {
+    struct hash_uint64_array_s *array = NULL;
+
+    seq = __atomic_load_n(&hashtblP->seq, __ATOMIC_ACQUIRE);
+    if (seq & 1) {
+      // A writer is modifying the table
+      continue;
+    }
+    array = __atomic_load_n(&hashtblP->current, __ATOMIC_ACQUIRE);
+    found = hashtable_uint64_ts_array_lookup(array, hash, keyP, &data);
+    if (!found) {
+      array = __atomic_load_n(&hashtblP->old, __ATOMIC_ACQUIRE);
+      if (array) {
+        found = hashtable_uint64_ts_array_lookup(array, hash, keyP, &data);
+      }
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  } while ((seq & 1) ||
+           (seq != __atomic_load_n(&hashtblP->seq, __ATOMIC_RELAXED)));
+
+  if (found) {
+    if (dataP) *dataP = data;
+    PRINT_HASHTABLE(hashtblP,
+                    "%s(%s,key 0x%" PRIx64 " data %" PRIx64 ") return OK\n",
+                    __FUNCTION__, bdata(hashtblP->name), keyP, data);
+    return HASH_TABLE_OK;
+  }
+  PRINT_HASHTABLE(hashtblP, "%s(%s,key 0x%" PRIx64 ") return KEY_NOT_EXISTS\n",
+                  __FUNCTION__, bdata(hashtblP->name), keyP);
+  return HASH_TABLE_KEY_NOT_EXISTS;
+}
+
+//------------------------------------------------------------------------------
+/*
+   Resizing
+   The table grows by itself, hashtable_uint64_ts_resize() can be used to
+   pre-size it before a known burst of insertions. The requested size is
+   rounded up to a power of two, a size not larger than the current one is
+   ignored: the table never shrinks. Elements are migrated incrementally as for
+   an automatic growth.
+*/
+hashtable_rc_t hashtable_uint64_ts_resize(
+    hash_table_uint64_ts_t *const hashtblP, const hash_size_t sizeP) {
+  hashtable_rc_t rc = HASH_TABLE_OK;
+
+  if (!hashtblP) {
+    return HASH_TABLE_BAD_PARAMETER_HASHTABLE;
+  }
+
+  pthread_mutex_lock(&hashtblP->mutex);
+  if (hashtable_uint64_ts_round_size(sizeP) > hashtblP->current->size) {
+    hashtable_uint64_ts_write_begin(hashtblP);
+    rc = hashtable_uint64_ts_grow(hashtblP, sizeP);
+    hashtable_uint64_ts_write_end(hashtblP);
+  }
+  pthread_mutex_unlock(&hashtblP->mutex);
+  return rc;
+}
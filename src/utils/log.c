@@ -42,6 +42,7 @@
 #include "dynamic_memory_check.h"
 #include "intertask_interface.h"
 #include "log.h"
+#include "log_bin.h"
 #include "shared_ts_log.h"
 #include "timer.h"
 
@@ -117,12 +118,38 @@ typedef struct oai_log_s {
 
   log_message_number_t
       log_message_number; /*!< \brief Counter of log message        */
-  hash_table_ts_t
-      *thread_context_htbl; /*!< \brief Container for log_thread_ctxt_t */
+
+  log_deferred_mode_t deferred_mode; /*!< \brief see log_bin.h */
+  pthread_mutex_t deferred_mutex; /*!< \brief Only one consumer of the rings */
+  FILE *deferred_fd;              /*!< \brief binary header written in it */
+  uint32_t deferred_num_sites;    /*!< \brief sites written in deferred_fd */
+  bstring deferred_bstr;          /*!< \brief text formatting buffer */
 } oai_log_t;
 
 static oai_log_t g_oai_log = {
-    0}; /*!< \brief  logging utility internal variables global var definition*/
+    .deferred_mutex = PTHREAD_MUTEX_INITIALIZER,
+}; /*!< \brief  logging utility internal variables global var definition*/
+
+uint32_t g_oai_log_level_mask[MAX_LOG_PROTOS] = {0};
+
+static __thread log_thread_ctxt_t t_log_thread_ctxt = {0};
+static __thread bool t_log_thread_ctxt_is_set = false;
+
+//------------------------------------------------------------------------------
+// Levels are changed at run time only by log_set_config(), a log call may see
+// the previous mask for a short time
+static void log_update_level_mask(void) {
+  for (int proto = MIN_LOG_PROTOS; proto < MAX_LOG_PROTOS; proto++) {
+    uint32_t mask = 0;
+
+    for (int level = MIN_LOG_LEVEL; level < MAX_LOG_LEVEL; level++) {
+      if (level <= g_oai_log.log_level[proto]) {
+        mask |= (1U << level);
+      }
+    }
+    __atomic_store_n(&g_oai_log_level_mask[proto], mask, __ATOMIC_RELAXED);
+  }
+}
 
 //------------------------------------------------------------------------------
 void *log_task(__attribute__((unused)) void *args_p) {
@@ -302,6 +329,7 @@ void log_set_config(const log_config_t *const config) {
     if ((MAX_LOG_LEVEL > config->async_system_log_level) &&
         (MIN_LOG_LEVEL <= config->async_system_log_level))
       g_oai_log.log_level[LOG_ASYNC_SYSTEM] = config->async_system_log_level;
+    log_update_level_mask();
 
     g_oai_log.is_output_fd_buffered = config->is_output_thread_safe;
 
@@ -351,6 +379,15 @@ void log_set_config(const log_config_t *const config) {
         }
       }
     }
+
+    if ((LOG_DEFERRED_BINARY == config->deferred_mode) &&
+        ((!g_oai_log.is_output_is_fd) || (stdout == g_oai_log.log_fd))) {
+      OAI_FPRINTF_ERR(
+          "Binary logging needs a file or a TCP output, using text\n");
+      g_oai_log.deferred_mode = LOG_DEFERRED_TEXT;
+    } else {
+      g_oai_log.deferred_mode = config->deferred_mode;
+    }
   }
 }
 
@@ -399,26 +436,7 @@ int log_init(__attribute__((unused)) const log_env_t envP,
   g_oai_log.log_fd = NULL;
 
   g_oai_log.log_start_time_second = shared_log_get_start_time_sec();
-
-  bstring b = bfromcstr("Logging thread context hashtable");
-  g_oai_log.thread_context_htbl =
-      hashtable_ts_create(LOG_MESSAGE_MIN_ALLOC_SIZE, NULL, free_wrapper, b);
-  bdestroy_wrapper(&b);
-  AssertFatal(NULL != g_oai_log.thread_context_htbl,
-              "Could not create hashtable for Log!\n");
-  g_oai_log.thread_context_htbl->log_enabled = false;
-
-  log_thread_ctxt_t *thread_ctxt = calloc(1, sizeof(log_thread_ctxt_t));
-  AssertFatal(NULL != thread_ctxt,
-              "Error Could not create log thread context\n");
-  pthread_t p = pthread_self();
-  thread_ctxt->tid = p;
-  hashtable_rc_t hash_rc = hashtable_ts_insert(g_oai_log.thread_context_htbl,
-                                               (hash_key_t)p, thread_ctxt);
-  if (HASH_TABLE_OK != hash_rc) {
-    OAI_FPRINTF_ERR("Error Could not register log thread context\n");
-    free_wrapper((void **)thread_ctxt);
-  }
+  log_bin_init();
 
   log_start_use();
 
@@ -506,6 +524,7 @@ int log_init(__attribute__((unused)) const log_env_t envP,
   for (i = MIN_LOG_PROTOS; i < MAX_LOG_PROTOS; i++) {
     g_oai_log.log_level[i] = default_log_levelP;
   }
+  log_update_level_mask();
   // did not check return value of snprintf...
   for (i = MIN_LOG_LEVEL; i < MAX_LOG_LEVEL; i++) {
     g_oai_log.log_level2str[i][LOG_LEVEL_NAME_MAX_LENGTH - 1] = '\0';
@@ -527,34 +546,90 @@ void log_itti_connect(void) {
 
 //------------------------------------------------------------------------------
 void log_start_use(void) {
-  pthread_t p = pthread_self();
-  hashtable_rc_t hash_rc =
-      hashtable_ts_is_key_exists(g_oai_log.thread_context_htbl, (hash_key_t)p);
-  if (HASH_TABLE_KEY_NOT_EXISTS == hash_rc) {
-    log_thread_ctxt_t *thread_ctxt = calloc(1, sizeof(log_thread_ctxt_t));
-    if (thread_ctxt) {
-      thread_ctxt->tid = p;
-      hash_rc = hashtable_ts_insert(g_oai_log.thread_context_htbl,
-                                    (hash_key_t)p, thread_ctxt);
-      if (HASH_TABLE_OK != hash_rc) {
-        OAI_FPRINTF_ERR("Error Could not register log thread context\n");
-        free_wrapper((void **)&thread_ctxt);
-      }
+  if (!t_log_thread_ctxt_is_set) {
+    t_log_thread_ctxt.tid = pthread_self();
+    t_log_thread_ctxt.indent = 0;
+    t_log_thread_ctxt_is_set = true;
+  }
+}
+
+//------------------------------------------------------------------------------
+static inline log_thread_ctxt_t *log_get_thread_ctxt(void) {
+  if (!t_log_thread_ctxt_is_set) {
+    log_start_use();
+  }
+  return &t_log_thread_ctxt;
+}
+
+//------------------------------------------------------------------------------
+// Under deferred_mutex, returns false if there is no stream to write in
+static bool log_deferred_binary_sync_stream(void) {
+  uint32_t num_sites = log_bin_get_num_sites();
+
+  if (!g_oai_log.log_fd) {
+    return false;
+  }
+  if (g_oai_log.deferred_fd != g_oai_log.log_fd) {
+    // New stream (TCP reconnection), it needs the names and sites again
+    g_oai_log.deferred_fd = g_oai_log.log_fd;
+    g_oai_log.deferred_num_sites = 0;
+    log_bin_write_header(g_oai_log.log_fd, g_oai_log.log_start_time_second);
+    for (int i = MIN_LOG_LEVEL; i < MAX_LOG_LEVEL; i++) {
+      log_bin_write_name(g_oai_log.log_fd, LOG_BIN_NAME_LEVEL, i,
+                         &g_oai_log.log_level2str[i][0]);
+    }
+    for (int i = MIN_LOG_PROTOS; i < MAX_LOG_PROTOS; i++) {
+      log_bin_write_name(g_oai_log.log_fd, LOG_BIN_NAME_PROTO, i,
+                         &g_oai_log.log_proto2str[i][0]);
+    }
+  }
+  while (g_oai_log.deferred_num_sites < num_sites) {
+    log_bin_write_site(g_oai_log.log_fd,
+                       log_bin_get_site(++g_oai_log.deferred_num_sites));
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Under deferred_mutex
+static void log_deferred_binary_write_error(void) {
+  OAI_FPRINTF_ERR("Error while writing binary log\n");
+  if (LOG_TCP_STATE_DISABLED != g_oai_log.tcp_state) {
+    // Let ITTI LOG Timer do the reconnection
+    fclose(g_oai_log.log_fd);
+    g_oai_log.log_fd = NULL;
+    g_oai_log.deferred_fd = NULL;
+    g_oai_log.tcp_state = LOG_TCP_STATE_NOT_CONNECTED;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Messages of text only sites, hex streams, etc. are already formatted, they
+// go in the binary stream as text records (raw text would corrupt it)
+static void log_write_deferred_binary_text(const_bstring bstr) {
+  pthread_mutex_lock(&g_oai_log.deferred_mutex);
+  if (log_deferred_binary_sync_stream()) {
+    if (log_bin_write_text(g_oai_log.log_fd, (const char *)bstr->data,
+                           blength(bstr))) {
+      log_deferred_binary_write_error();
     } else {
-      OAI_FPRINTF_ERR("Error Could not create log thread context\n");
+      fflush(g_oai_log.log_fd);
     }
   }
+  pthread_mutex_unlock(&g_oai_log.deferred_mutex);
 }
 
 //------------------------------------------------------------------------------
-void log_flush_message(struct shared_log_queue_item_s *item_p) {
+static void log_write(const int log_level, const_bstring bstr) {
   int rv = 0;
   int rv_put = 0;
 
-  if (blength(item_p->bstr) > 0) {
+  if (blength(bstr) > 0) {
     if (g_oai_log.is_output_is_fd) {
-      if (g_oai_log.log_fd) {
-        rv_put = fputs((const char *)item_p->bstr->data, g_oai_log.log_fd);
+      if (LOG_DEFERRED_BINARY == g_oai_log.deferred_mode) {
+        log_write_deferred_binary_text(bstr);
+      } else if (g_oai_log.log_fd) {
+        rv_put = fputs((const char *)bstr->data, g_oai_log.log_fd);
 
         if (rv_put < 0) {
           // error occured
@@ -574,16 +649,106 @@ void log_flush_message(struct shared_log_queue_item_s *item_p) {
         fflush(g_oai_log.log_fd);
       }
     } else {
-      syslog(item_p->u_app_log.log.log_level, "%s", bdata(item_p->bstr));
+      syslog(log_level, "%s", bdata(bstr));
     }
   }
 }
 
+//------------------------------------------------------------------------------
+void log_flush_message(struct shared_log_queue_item_s *item_p) {
+  log_write(item_p->u_app_log.log.log_level, item_p->bstr);
+}
+
+//------------------------------------------------------------------------------
+static int log_format_prefix(bstring bstr, const log_level_t log_levelP,
+                             const log_proto_t protoP,
+                             const char *source_fileP,
+                             const unsigned int line_numP,
+                             const struct timeval *const elapsed_time,
+                             const pthread_t tid, const int indent) {
+  int filename_length = strlen(source_fileP);
+  int rv = 0;
+
+  if (g_oai_log.is_ansi_codes) {
+    rv = bformata(bstr, "%s", &g_oai_log.log_level2ansi[log_levelP][0]);
+  }
+  if (filename_length > LOG_DISPLAYED_FILENAME_MAX_LENGTH) {
+    source_fileP += filename_length - LOG_DISPLAYED_FILENAME_MAX_LENGTH;
+  }
+  rv = bformata(
+      bstr, "%06" PRIu64 " %05ld:%06ld %08lX %-*.*s %-*.*s %-*.*s:%04u   %*s",
+      __sync_fetch_and_add(&g_oai_log.log_message_number, 1),
+      elapsed_time->tv_sec, elapsed_time->tv_usec, tid,
+      LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
+      LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
+      &g_oai_log.log_level2str[log_levelP][0],
+      LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH, LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
+      &g_oai_log.log_proto2str[protoP][0], LOG_DISPLAYED_FILENAME_MAX_LENGTH,
+      LOG_DISPLAYED_FILENAME_MAX_LENGTH, source_fileP, line_numP, indent, " ");
+  return rv;
+}
+
+//------------------------------------------------------------------------------
+static void log_flush_deferred_text(
+    __attribute__((unused)) void *cb_arg, const log_bin_ring_t *ring,
+    const log_bin_record_t *record, const log_site_t *site,
+    const uint8_t *args, size_t args_length) {
+  struct timeval elapsed_time;
+
+  log_bin_get_time(record->tsc, &elapsed_time);
+  elapsed_time.tv_sec -= g_oai_log.log_start_time_second;
+  btrunc(g_oai_log.deferred_bstr, 0);
+  log_format_prefix(g_oai_log.deferred_bstr, record->level, record->proto,
+                    site->file, site->line, &elapsed_time, ring->tid, 0);
+  log_bin_format(g_oai_log.deferred_bstr, site->format, args, args_length);
+  if (g_oai_log.is_ansi_codes) {
+    bcatcstr(g_oai_log.deferred_bstr, ANSI_COLOR_RESET);
+  }
+  log_write(record->level, g_oai_log.deferred_bstr);
+}
+
+//------------------------------------------------------------------------------
+static void log_flush_deferred_binary(
+    __attribute__((unused)) void *cb_arg, const log_bin_ring_t *ring,
+    const log_bin_record_t *record,
+    __attribute__((unused)) const log_site_t *site, const uint8_t *args,
+    size_t args_length) {
+  if ((log_deferred_binary_sync_stream()) &&
+      (log_bin_write_message(g_oai_log.log_fd, ring, record, args,
+                             args_length))) {
+    log_deferred_binary_write_error();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Called periodically by the shared log task, formats or writes the records
+// of all the logging threads
+void log_flush_deferred_messages(void) {
+  if (LOG_DEFERRED_NONE == g_oai_log.deferred_mode) {
+    return;
+  }
+  pthread_mutex_lock(&g_oai_log.deferred_mutex);
+  if (LOG_DEFERRED_BINARY == g_oai_log.deferred_mode) {
+    log_bin_drain(log_flush_deferred_binary, NULL);
+    if (g_oai_log.log_fd) {
+      fflush(g_oai_log.log_fd);
+    }
+  } else {
+    if (!g_oai_log.deferred_bstr) {
+      g_oai_log.deferred_bstr = bfromcstralloc(LOG_MESSAGE_MIN_ALLOC_SIZE, "");
+    }
+    log_bin_drain(log_flush_deferred_text, NULL);
+  }
+  pthread_mutex_unlock(&g_oai_log.deferred_mutex);
+}
+
 //------------------------------------------------------------------------------
 void log_exit(void) {
   int rv = 0;
 
   OAI_FPRINTF_INFO("[TRACE] Entering %s\n", __FUNCTION__);
+  log_flush_deferred_messages();
+  g_oai_log.deferred_mode = LOG_DEFERRED_NONE;
   if (g_oai_log.log_fd) {
     rv = fflush(g_oai_log.log_fd);
 
@@ -597,11 +762,13 @@ void log_exit(void) {
     if (rv != 0) {
       OAI_FPRINTF_ERR("Error while closing Log file: %s", strerror(errno));
     }
+    g_oai_log.log_fd = NULL;
   }
   if (!g_oai_log.is_output_is_fd) {
     closelog();
   }
-  hashtable_ts_destroy(g_oai_log.thread_context_htbl);
+  log_bin_exit();
+  bdestroy_wrapper(&g_oai_log.deferred_bstr);
   bdestroy_wrapper(&g_oai_log.bserver_address);
   bdestroy_wrapper(&g_oai_log.bserver_port);
   OAI_FPRINTF_INFO("[TRACE] Leaving %s\n", __FUNCTION__);
@@ -616,18 +783,11 @@ void log_stream_hex(const log_level_t log_levelP, const log_proto_t protoP,
   size_t octet_index = 0;
   int rv = 0;
   log_thread_ctxt_t *thread_ctxt = NULL;
-  hashtable_rc_t hash_rc = HASH_TABLE_OK;
 
-  pthread_t p = pthread_self();
-  hash_rc = hashtable_ts_get(g_oai_log.thread_context_htbl, (hash_key_t)p,
-                             (void **)&thread_ctxt);
-  if (HASH_TABLE_KEY_NOT_EXISTS == hash_rc) {
-    // make the thread safe LFDS collections usable by this thread
-    log_start_use();
+  if (!log_is_enabled(log_levelP, protoP)) {
+    return;
   }
-  hash_rc = hashtable_ts_get(g_oai_log.thread_context_htbl, (hash_key_t)p,
-                             (void **)&thread_ctxt);
-  AssertFatal(NULL != thread_ctxt, "Could not get new log thread context\n");
+  thread_ctxt = log_get_thread_ctxt();
   if (messageP) {
     log_message_start(thread_ctxt, log_levelP, protoP, &message, source_fileP,
                       line_numP, "hex stream ");
@@ -664,18 +824,11 @@ void log_stream_hex_array(const log_level_t log_levelP,
   unsigned long octet_index = 0;
   unsigned long index = 0;
   log_thread_ctxt_t *thread_ctxt = NULL;
-  hashtable_rc_t hash_rc = HASH_TABLE_OK;
 
-  pthread_t p = pthread_self();
-  hash_rc = hashtable_ts_get(g_oai_log.thread_context_htbl, (hash_key_t)p,
-                             (void **)&thread_ctxt);
-  if (HASH_TABLE_KEY_NOT_EXISTS == hash_rc) {
-    // make the thread safe LFDS collections usable by this thread
-    log_start_use();
+  if (!log_is_enabled(log_levelP, protoP)) {
+    return;
   }
-  hash_rc = hashtable_ts_get(g_oai_log.thread_context_htbl, (hash_key_t)p,
-                             (void **)&thread_ctxt);
-  AssertFatal(NULL != thread_ctxt, "Could not get new log thread context\n");
+  thread_ctxt = log_get_thread_ctxt();
 
   if (messageP) {
     log_message(thread_ctxt, log_levelP, protoP, source_fileP, line_numP,
@@ -752,7 +905,11 @@ void log_message_finish(struct shared_log_queue_item_s *messageP) {
       shared_log_item(messageP);
     } else {
       if (g_oai_log.is_output_is_fd) {
-        fprintf(g_oai_log.log_fd, "%s", bdata(messageP->bstr));
+        if (LOG_DEFERRED_BINARY == g_oai_log.deferred_mode) {
+          log_write_deferred_binary_text(messageP->bstr);
+        } else {
+          fprintf(g_oai_log.log_fd, "%s", bdata(messageP->bstr));
+        }
       } else {
         syslog(messageP->u_app_log.log.log_level, "%s", bdata(messageP->bstr));
       }
@@ -770,32 +927,13 @@ void log_message_start(
     ...) {
   va_list args;
   int rv = 0;
-  int filename_length = 0;
   log_thread_ctxt_t *thread_ctxt = thread_ctxtP;
-  hashtable_rc_t hash_rc = HASH_TABLE_OK;
 
-  if ((MIN_LOG_PROTOS > protoP) || (MAX_LOG_PROTOS <= protoP)) {
+  if (!log_is_enabled(log_levelP, protoP)) {
     return;
   }
-  if ((MIN_LOG_LEVEL > log_levelP) || (MAX_LOG_LEVEL <= log_levelP)) {
-    return;
-  }
-  if (log_levelP > g_oai_log.log_level[protoP]) {
-    return;
-  }
-
   if (NULL == thread_ctxt) {
-    pthread_t p = pthread_self();
-    hash_rc = hashtable_ts_get(g_oai_log.thread_context_htbl, (hash_key_t)p,
-                               (void **)&thread_ctxt);
-    if (HASH_TABLE_KEY_NOT_EXISTS == hash_rc) {
-      // make the thread safe LFDS collections usable by this thread
-      log_start_use();
-      hash_rc = hashtable_ts_get(g_oai_log.thread_context_htbl, (hash_key_t)p,
-                                 (void **)&thread_ctxt);
-      AssertFatal(NULL != thread_ctxt,
-                  "Could not get new log thread context\n");
-    }
+    thread_ctxt = log_get_thread_ctxt();
   }
 
   if (!*messageP) {
@@ -806,41 +944,9 @@ void log_message_start(
     (*messageP)->u_app_log.log.log_level = log_levelP;
     shared_log_get_elapsed_time_since_start(&elapsed_time);
 
-    filename_length = strlen(source_fileP);
-    if (g_oai_log.is_ansi_codes) {
-      rv = bformata((*messageP)->bstr, "%s",
-                    &g_oai_log.log_level2ansi[log_levelP][0]);
-    }
-    if (filename_length > LOG_DISPLAYED_FILENAME_MAX_LENGTH) {
-      rv = bformata(
-          (*messageP)->bstr,
-          "%06" PRIu64 " %05ld:%06ld %08lX %-*.*s %-*.*s %-*.*s:%04u   %*s",
-          __sync_fetch_and_add(&g_oai_log.log_message_number, 1),
-          elapsed_time.tv_sec, elapsed_time.tv_usec, thread_ctxt->tid,
-          LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
-          LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
-          &g_oai_log.log_level2str[log_levelP][0],
-          LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
-          LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
-          &g_oai_log.log_proto2str[protoP][0],
-          LOG_DISPLAYED_FILENAME_MAX_LENGTH, LOG_DISPLAYED_FILENAME_MAX_LENGTH,
-          &source_fileP[filename_length - LOG_DISPLAYED_FILENAME_MAX_LENGTH],
-          line_numP, thread_ctxt->indent, " ");
-    } else {
-      rv = bformata(
-          (*messageP)->bstr,
-          "%06" PRIu64 " %05ld:%06ld %08lX %-*.*s %-*.*s %-*.*s:%04u   %*s",
-          __sync_fetch_and_add(&g_oai_log.log_message_number, 1),
-          elapsed_time.tv_sec, elapsed_time.tv_usec, thread_ctxt->tid,
-          LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
-          LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
-          &g_oai_log.log_level2str[log_levelP][0],
-          LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
-          LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
-          &g_oai_log.log_proto2str[protoP][0],
-          LOG_DISPLAYED_FILENAME_MAX_LENGTH, LOG_DISPLAYED_FILENAME_MAX_LENGTH,
-          source_fileP, line_numP, thread_ctxt->indent, " ");
-    }
+    rv = log_format_prefix((*messageP)->bstr, log_levelP, protoP,
+                           source_fileP, line_numP, &elapsed_time,
+                           thread_ctxt->tid, thread_ctxt->indent);
 
     if (BSTR_ERR == rv) {
       OAI_FPRINTF_ERR("Error while logging message : %s",
@@ -869,140 +975,35 @@ error_event_start:
 }
 
 //------------------------------------------------------------------------------
-// hard-coded to use LOG_LEVEL_TRACE
-void log_func(const bool is_enteringP, const log_proto_t protoP,
-              const char *const source_fileP, const unsigned int line_numP,
-              const char *const functionP) {
-  log_thread_ctxt_t *thread_ctxt = NULL;
-  hashtable_rc_t hash_rc = HASH_TABLE_OK;
-  pthread_t p = pthread_self();
-
-  hash_rc = hashtable_ts_get(g_oai_log.thread_context_htbl, (hash_key_t)p,
-                             (void **)&thread_ctxt);
-  if (HASH_TABLE_KEY_NOT_EXISTS == hash_rc) {
-    // make the thread safe LFDS collections usable by this thread
-    log_start_use();
-  }
-  hash_rc = hashtable_ts_get(g_oai_log.thread_context_htbl, (hash_key_t)p,
-                             (void **)&thread_ctxt);
-  AssertFatal(NULL != thread_ctxt, "Could not get new log thread context\n");
-  if (is_enteringP) {
-    log_message(thread_ctxt, OAILOG_LEVEL_TRACE, protoP, source_fileP,
-                line_numP, "Entering %s()\n", functionP);
-    thread_ctxt->indent += LOG_FUNC_INDENT_SPACES;
-  } else {
-    thread_ctxt->indent -= LOG_FUNC_INDENT_SPACES;
-    if (thread_ctxt->indent < 0) thread_ctxt->indent = 0;
-    log_message(thread_ctxt, OAILOG_LEVEL_TRACE, protoP, source_fileP,
-                line_numP, "Leaving %s()\n", functionP);
-  }
-}
-//------------------------------------------------------------------------------
-// hard-coded to use LOG_LEVEL_TRACE
-void log_func_return(const log_proto_t protoP, const char *const source_fileP,
-                     const unsigned int line_numP, const char *const functionP,
-                     const long return_codeP) {
-  log_thread_ctxt_t *thread_ctxt = NULL;
-  hashtable_rc_t hash_rc = HASH_TABLE_OK;
-  pthread_t p = pthread_self();
-
-  hash_rc = hashtable_ts_get(g_oai_log.thread_context_htbl, (hash_key_t)p,
-                             (void **)&thread_ctxt);
-  if (HASH_TABLE_KEY_NOT_EXISTS == hash_rc) {
-    // make the thread safe LFDS collections usable by this thread
-    log_start_use();
-  }
-  hash_rc = hashtable_ts_get(g_oai_log.thread_context_htbl, (hash_key_t)p,
-                             (void **)&thread_ctxt);
-  AssertFatal(NULL != thread_ctxt, "Could not get new log thread context\n");
-  thread_ctxt->indent -= LOG_FUNC_INDENT_SPACES;
-  if (thread_ctxt->indent < 0) thread_ctxt->indent = 0;
-  log_message(thread_ctxt, OAILOG_LEVEL_TRACE, protoP, source_fileP, line_numP,
-              "Leaving %s() (rc=%ld)\n", functionP, return_codeP);
-}
-//------------------------------------------------------------------------------
-void log_message(log_thread_ctxt_t *thread_ctxtP, const log_level_t log_levelP,
-                 const log_proto_t protoP, const char *const source_fileP,
-                 const unsigned int line_numP, char *format, ...) {
-  va_list args;
+static void log_message_v(log_thread_ctxt_t *thread_ctxtP,
+                          const log_level_t log_levelP,
+                          const log_proto_t protoP,
+                          const char *const source_fileP,
+                          const unsigned int line_numP, const char *format,
+                          va_list args) {
   int rv = 0;
-  int filename_length = 0;
   struct shared_log_queue_item_s *new_item_p = NULL;
   log_thread_ctxt_t *thread_ctxt = thread_ctxtP;
-  hashtable_rc_t hash_rc = HASH_TABLE_OK;
 
-  if ((MIN_LOG_PROTOS > protoP) || (MAX_LOG_PROTOS <= protoP)) {
-    return;
-  }
-  if ((MIN_LOG_LEVEL > log_levelP) || (MAX_LOG_LEVEL <= log_levelP)) {
-    return;
-  }
-  if (log_levelP > g_oai_log.log_level[protoP]) {
-    return;
-  }
   if (NULL == thread_ctxt) {
-    pthread_t p = pthread_self();
-    hash_rc = hashtable_ts_get(g_oai_log.thread_context_htbl, (hash_key_t)p,
-                               (void **)&thread_ctxt);
-    if (HASH_TABLE_KEY_NOT_EXISTS == hash_rc) {
-      // make the thread safe LFDS collections usable by this thread
-      log_start_use();
-      hash_rc = hashtable_ts_get(g_oai_log.thread_context_htbl, (hash_key_t)p,
-                                 (void **)&thread_ctxt);
-      AssertFatal(NULL != thread_ctxt,
-                  "Could not get new log thread context\n");
-    }
+    thread_ctxt = log_get_thread_ctxt();
   }
 
   new_item_p = get_new_log_queue_item(SH_TS_LOG_TXT);
 
   if (new_item_p) {
-    if (g_oai_log.is_ansi_codes) {
-      rv = bformata(new_item_p->bstr, "%s",
-                    &g_oai_log.log_level2ansi[log_levelP][0]);
-    }
     struct timeval elapsed_time;
     shared_log_get_elapsed_time_since_start(&elapsed_time);
-    filename_length = strlen(source_fileP);
-    if (filename_length > LOG_DISPLAYED_FILENAME_MAX_LENGTH) {
-      rv = bformata(
-          new_item_p->bstr,
-          "%06" PRIu64 " %05ld:%06ld %08lX %-*.*s %-*.*s %-*.*s:%04u   %*s",
-          __sync_fetch_and_add(&g_oai_log.log_message_number, 1),
-          elapsed_time.tv_sec, elapsed_time.tv_usec, thread_ctxt->tid,
-          LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
-          LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
-          &g_oai_log.log_level2str[log_levelP][0],
-          LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
-          LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
-          &g_oai_log.log_proto2str[protoP][0],
-          LOG_DISPLAYED_FILENAME_MAX_LENGTH, LOG_DISPLAYED_FILENAME_MAX_LENGTH,
-          &source_fileP[filename_length - LOG_DISPLAYED_FILENAME_MAX_LENGTH],
-          line_numP, thread_ctxt->indent, " ");
-    } else {
-      rv = bformata(
-          new_item_p->bstr,
-          "%06" PRIu64 " %05ld:%06ld %08lX %-*.*s %-*.*s %-*.*s:%04u   %*s",
-          __sync_fetch_and_add(&g_oai_log.log_message_number, 1),
-          elapsed_time.tv_sec, elapsed_time.tv_usec, thread_ctxt->tid,
-          LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
-          LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
-          &g_oai_log.log_level2str[log_levelP][0],
-          LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
-          LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
-          &g_oai_log.log_proto2str[protoP][0],
-          LOG_DISPLAYED_FILENAME_MAX_LENGTH, LOG_DISPLAYED_FILENAME_MAX_LENGTH,
-          source_fileP, line_numP, thread_ctxt->indent, " ");
-    }
+    rv = log_format_prefix(new_item_p->bstr, log_levelP, protoP, source_fileP,
+                           line_numP, &elapsed_time, thread_ctxt->tid,
+                           thread_ctxt->indent);
 
     if (BSTR_ERR == rv) {
       OAI_FPRINTF_ERR("Error while logging LOG message : %s",
                       &g_oai_log.log_proto2str[protoP][0]);
       goto error_event;
     }
-    va_start(args, format);
     rv = bvcformata(new_item_p->bstr, 4096, format, args);  // big number
-    va_end(args);
 
     if (BSTR_ERR == rv) {
       OAI_FPRINTF_ERR("Error while logging LOG message : %s",
@@ -1014,14 +1015,18 @@ void log_message(log_thread_ctxt_t *thread_ctxtP, const log_level_t log_levelP,
     }
 
     if (g_oai_log.is_output_fd_buffered) {
+      new_item_p->u_app_log.log.log_level = log_levelP;
       shared_log_item(new_item_p);
     } else {
       if (g_oai_log.is_output_is_fd) {
-        fprintf(g_oai_log.log_fd, "%s", bdata(new_item_p->bstr));
+        if (LOG_DEFERRED_BINARY == g_oai_log.deferred_mode) {
+          log_write_deferred_binary_text(new_item_p->bstr);
+        } else {
+          fprintf(g_oai_log.log_fd, "%s", bdata(new_item_p->bstr));
+        }
       } else {
 #if DAEMONIZE
-        syslog(new_item_p->u_app_log.log.log_level, "%s",
-	                 bdata(new_item_p->bstr));
+        syslog(log_levelP, "%s", bdata(new_item_p->bstr));
 #else
         fprintf(stdout, "%s", bdata(new_item_p->bstr));
 #endif
@@ -1035,3 +1040,105 @@ error_event:
   btrunc(new_item_p->bstr, 0);
   shared_log_reuse_item(new_item_p);
 }
+
+//------------------------------------------------------------------------------
+// In deferred mode, only the arguments are copied in the ring of the thread,
+// the site (file, line, format) is known by the shared log task
+static void log_site_v(log_site_t *const siteP, const log_level_t log_levelP,
+                       const log_proto_t protoP, const char *format,
+                       va_list args) {
+  if ((LOG_DEFERRED_NONE != g_oai_log.deferred_mode) &&
+      (log_bin_register_site(siteP, format))) {
+    log_bin_message(siteP, log_levelP, protoP, args);
+  } else {
+    log_message_v(NULL, log_levelP, protoP, siteP->file, siteP->line, format,
+                  args);
+  }
+}
+
+//------------------------------------------------------------------------------
+static void log_site(log_site_t *const siteP, const log_level_t log_levelP,
+                     const log_proto_t protoP, const char *format, ...) {
+  va_list args;
+
+  va_start(args, format);
+  log_site_v(siteP, log_levelP, protoP, format, args);
+  va_end(args);
+}
+
+//------------------------------------------------------------------------------
+// hard-coded to use LOG_LEVEL_TRACE
+void log_func(log_site_t *const siteP, const bool is_enteringP,
+              const log_proto_t protoP, const char *const functionP) {
+  log_thread_ctxt_t *thread_ctxt = NULL;
+
+  if (!log_is_enabled(OAILOG_LEVEL_TRACE, protoP)) {
+    return;
+  }
+  if (LOG_DEFERRED_NONE != g_oai_log.deferred_mode) {
+    // No indentation of deferred messages
+    log_site(siteP, OAILOG_LEVEL_TRACE, protoP,
+             (is_enteringP) ? "Entering %s()\n" : "Leaving %s()\n",
+             functionP);
+    return;
+  }
+  thread_ctxt = log_get_thread_ctxt();
+  if (is_enteringP) {
+    log_message(thread_ctxt, OAILOG_LEVEL_TRACE, protoP, siteP->file,
+                siteP->line, "Entering %s()\n", functionP);
+    thread_ctxt->indent += LOG_FUNC_INDENT_SPACES;
+  } else {
+    thread_ctxt->indent -= LOG_FUNC_INDENT_SPACES;
+    if (thread_ctxt->indent < 0) thread_ctxt->indent = 0;
+    log_message(thread_ctxt, OAILOG_LEVEL_TRACE, protoP, siteP->file,
+                siteP->line, "Leaving %s()\n", functionP);
+  }
+}
+//------------------------------------------------------------------------------
+// hard-coded to use LOG_LEVEL_TRACE
+void log_func_return(log_site_t *const siteP, const log_proto_t protoP,
+                     const char *const functionP, const long return_codeP) {
+  log_thread_ctxt_t *thread_ctxt = NULL;
+
+  if (!log_is_enabled(OAILOG_LEVEL_TRACE, protoP)) {
+    return;
+  }
+  if (LOG_DEFERRED_NONE != g_oai_log.deferred_mode) {
+    log_site(siteP, OAILOG_LEVEL_TRACE, protoP, "Leaving %s() (rc=%ld)\n",
+             functionP, return_codeP);
+    return;
+  }
+  thread_ctxt = log_get_thread_ctxt();
+  thread_ctxt->indent -= LOG_FUNC_INDENT_SPACES;
+  if (thread_ctxt->indent < 0) thread_ctxt->indent = 0;
+  log_message(thread_ctxt, OAILOG_LEVEL_TRACE, protoP, siteP->file,
+              siteP->line, "Leaving %s() (rc=%ld)\n", functionP,
+              return_codeP);
+}
+//------------------------------------------------------------------------------
+void log_message(log_thread_ctxt_t *thread_ctxtP, const log_level_t log_levelP,
+                 const log_proto_t protoP, const char *const source_fileP,
+                 const unsigned int line_numP, char *format, ...) {
+  va_list args;
+
+  if (!log_is_enabled(log_levelP, protoP)) {
+    return;
+  }
+  va_start(args, format);
+  log_message_v(thread_ctxtP, log_levelP, protoP, source_fileP, line_numP,
+                format, args);
+  va_end(args);
+}
+
+//------------------------------------------------------------------------------
+void log_message_site(log_site_t *const siteP, const log_level_t log_levelP,
+                      const log_proto_t protoP, char *format, ...) {
+  va_list args;
+
+  if (!log_is_enabled(log_levelP, protoP)) {
+    return;
+  }
+  va_start(args, format);
+  log_site_v(siteP, log_levelP, protoP, format, args);
+  va_end(args);
+}
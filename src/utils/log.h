@@ -27,6 +27,7 @@
 
 #include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "bstrlib.h"
 
@@ -78,6 +79,10 @@ extern int fd_g_debug_lvl;
 
 #define LOG_CONFIG_STRING_ASYNC_SYSTEM_LOG_LEVEL "ASYNC_SYSTEM"
 #define LOG_CONFIG_STRING_COLOR "COLOR"
+#define LOG_CONFIG_STRING_DEFERRED "DEFERRED"
+#define LOG_CONFIG_STRING_DEFERRED_NO "NO"
+#define LOG_CONFIG_STRING_DEFERRED_TEXT "TEXT"
+#define LOG_CONFIG_STRING_DEFERRED_BINARY "BINARY"
 #define LOG_CONFIG_STRING_OUTPUT_CONSOLE "CONSOLE"
 #define LOG_CONFIG_STRING_GTPV1U_LOG_LEVEL "GTPV1U_LOG_LEVEL"
 #define LOG_CONFIG_STRING_GTPV2C_LOG_LEVEL "GTPV2C_LOG_LEVEL"
@@ -151,6 +156,29 @@ typedef enum {
   MAX_LOG_PROTOS,
 } log_proto_t;
 
+typedef enum {
+  LOG_DEFERRED_NONE = 0, /*!< \brief formatted by the logging thread */
+  LOG_DEFERRED_TEXT,     /*!< \brief formatted by the shared log task */
+  LOG_DEFERRED_BINARY,   /*!< \brief written raw, see oai_log_decoder */
+} log_deferred_mode_t;
+
+/*! \struct  log_site_t
+ * \brief Static descriptor of a log call site, registered with its format on
+ * first use in deferred mode (see log_bin.h).
+ */
+typedef struct log_site_s {
+  uint32_t id;        /*!< \brief 0 until registered */
+  uint32_t line;      /*!< \brief source line of the call */
+  const char* file;   /*!< \brief source file of the call */
+  const char* format; /*!< \brief format the specs were parsed from */
+  struct log_bin_spec_s* specs;
+  uint16_t num_specs;
+  bool is_text_only; /*!< \brief arguments formatted by the logging thread */
+} log_site_t;
+
+#define LOG_SITE_INITIALIZER \
+  { .id = 0, .line = __LINE__, .file = __FILE__ }
+
 /*! \struct  log_thread_ctxt_t
  * \brief Structure containing a thread context.
  */
@@ -239,10 +267,25 @@ typedef struct log_config_s {
   uint8_t asn1_verbosity_level; /*!< \brief related to asn1c generated code for
                                    S1AP verbosity level */
   bool color;                   /*!< \brief use of ANSI styling codes or no */
+  log_deferred_mode_t
+      deferred_mode; /*!< \brief Copy only the raw arguments of the log calls,
+                        format them in the shared log task or offline */
 } log_config_t;
 
 #if LOG_OAI
 
+/*! \brief per protocol bitmask of enabled levels (bit log_level_t), written
+ * by log_set_config(), read without lock by every log call */
+extern uint32_t g_oai_log_level_mask[MAX_LOG_PROTOS];
+
+static inline bool log_is_enabled(const log_level_t log_levelP,
+                                  const log_proto_t protoP) {
+  return ((unsigned int)protoP < MAX_LOG_PROTOS) &&
+         ((unsigned int)log_levelP < MAX_LOG_LEVEL) &&
+         (__atomic_load_n(&g_oai_log_level_mask[protoP], __ATOMIC_RELAXED) &
+          (1U << log_levelP));
+}
+
 void log_connect_to_server(void);
 void log_set_config(const log_config_t* const config);
 const char* log_level_int2str(const log_level_t log_level);
@@ -258,6 +301,7 @@ struct shared_log_queue_item_s;
 
 void log_flush_message(struct shared_log_queue_item_s* item_p)
     __attribute__((hot));
+void log_flush_deferred_messages(void);
 void log_exit(void);
 
 void log_stream_hex(const log_level_t log_levelP, const log_proto_t protoP,
@@ -284,19 +328,21 @@ void log_message_start(
     const char* const source_fileP, const unsigned int line_numP, char* format,
     ...) __attribute__((format(printf, 7, 8)));
 
-void log_func(bool is_entering, const log_proto_t protoP,
-              const char* const source_fileP, const unsigned int line_numP,
-              const char* const function);
+void log_func(log_site_t* const siteP, bool is_entering,
+              const log_proto_t protoP, const char* const function);
 
-void log_func_return(const log_proto_t protoP, const char* const source_fileP,
-                     const unsigned int line_numP, const char* const functionP,
-                     const long return_codeP);
+void log_func_return(log_site_t* const siteP, const log_proto_t protoP,
+                     const char* const functionP, const long return_codeP);
 
 void log_message(log_thread_ctxt_t* const thread_ctxtP,
                  const log_level_t log_levelP, const log_proto_t protoP,
                  const char* const source_fileP, const unsigned int line_numP,
                  char* format, ...) __attribute__((format(printf, 6, 7)));
 
+void log_message_site(log_site_t* const siteP, const log_level_t log_levelP,
+                      const log_proto_t protoP, char* format, ...)
+    __attribute__((format(printf, 4, 5)));
+
 int log_get_start_time_sec(void);
 
 #define OAILOG_SET_CONFIG log_set_config
@@ -305,46 +351,37 @@ int log_get_start_time_sec(void);
 #define OAILOG_INIT log_init
 #define OAILOG_ITTI_CONNECT log_itti_connect
 #define OAILOG_EXIT() log_exit()
-#define OAILOG_SPEC(pRoTo, ...)                                       \
-  do {                                                                \
-    log_message(NULL, OAILOG_LEVEL_NOTICE, pRoTo, __FILE__, __LINE__, \
-                ##__VA_ARGS__);                                       \
-  } while (0) /*!< \brief 3GPP trace on specifications */
-#define OAILOG_EMERGENCY(pRoTo, ...)                                     \
-  do {                                                                   \
-    log_message(NULL, OAILOG_LEVEL_EMERGENCY, pRoTo, __FILE__, __LINE__, \
-                ##__VA_ARGS__);                                          \
-  } while (0) /*!< \brief system is unusable */
-#define OAILOG_ALERT(pRoTo, ...)                                     \
+/*! \brief log call with a static descriptor per call site */
+#define OAILOG_SITE(lOgLeVeL, pRoTo, ...)                            \
   do {                                                               \
-    log_message(NULL, OAILOG_LEVEL_ALERT, pRoTo, __FILE__, __LINE__, \
-                ##__VA_ARGS__);                                      \
-  } while (0) /*!< \brief action must be taken immediately */
-#define OAILOG_CRITICAL(pRoTo, ...)                                     \
-  do {                                                                  \
-    log_message(NULL, OAILOG_LEVEL_CRITICAL, pRoTo, __FILE__, __LINE__, \
-                ##__VA_ARGS__);                                         \
-  } while (0) /*!< \brief critical conditions */
-#define OAILOG_ERROR(pRoTo, ...)                                     \
-  do {                                                               \
-    log_message(NULL, OAILOG_LEVEL_ERROR, pRoTo, __FILE__, __LINE__, \
-                ##__VA_ARGS__);                                      \
-  } while (0) /*!< \brief error conditions */
-#define OAILOG_WARNING(pRoTo, ...)                                     \
-  do {                                                                 \
-    log_message(NULL, OAILOG_LEVEL_WARNING, pRoTo, __FILE__, __LINE__, \
-                ##__VA_ARGS__);                                        \
-  } while (0) /*!< \brief warning conditions */
-#define OAILOG_NOTICE(pRoTo, ...)                                     \
-  do {                                                                \
-    log_message(NULL, OAILOG_LEVEL_NOTICE, pRoTo, __FILE__, __LINE__, \
-                ##__VA_ARGS__);                                       \
-  } while (0) /*!< \brief normal but significant condition */
-#define OAILOG_INFO(pRoTo, ...)                                     \
-  do {                                                              \
-    log_message(NULL, OAILOG_LEVEL_INFO, pRoTo, __FILE__, __LINE__, \
-                ##__VA_ARGS__);                                     \
-  } while (0) /*!< \brief informational */
+    static log_site_t _log_site_ = LOG_SITE_INITIALIZER;             \
+    if (log_is_enabled(lOgLeVeL, pRoTo))                             \
+      log_message_site(&_log_site_, lOgLeVeL, pRoTo, ##__VA_ARGS__); \
+  } while (0)
+/*! \brief 3GPP trace on specifications */
+#define OAILOG_SPEC(pRoTo, ...) \
+  OAILOG_SITE(OAILOG_LEVEL_NOTICE, pRoTo, ##__VA_ARGS__)
+/*! \brief system is unusable */
+#define OAILOG_EMERGENCY(pRoTo, ...) \
+  OAILOG_SITE(OAILOG_LEVEL_EMERGENCY, pRoTo, ##__VA_ARGS__)
+/*! \brief action must be taken immediately */
+#define OAILOG_ALERT(pRoTo, ...) \
+  OAILOG_SITE(OAILOG_LEVEL_ALERT, pRoTo, ##__VA_ARGS__)
+/*! \brief critical conditions */
+#define OAILOG_CRITICAL(pRoTo, ...) \
+  OAILOG_SITE(OAILOG_LEVEL_CRITICAL, pRoTo, ##__VA_ARGS__)
+/*! \brief error conditions */
+#define OAILOG_ERROR(pRoTo, ...) \
+  OAILOG_SITE(OAILOG_LEVEL_ERROR, pRoTo, ##__VA_ARGS__)
+/*! \brief warning conditions */
+#define OAILOG_WARNING(pRoTo, ...) \
+  OAILOG_SITE(OAILOG_LEVEL_WARNING, pRoTo, ##__VA_ARGS__)
+/*! \brief normal but significant condition */
+#define OAILOG_NOTICE(pRoTo, ...) \
+  OAILOG_SITE(OAILOG_LEVEL_NOTICE, pRoTo, ##__VA_ARGS__)
+/*! \brief informational */
+#define OAILOG_INFO(pRoTo, ...) \
+  OAILOG_SITE(OAILOG_LEVEL_INFO, pRoTo, ##__VA_ARGS__)
 #define OAILOG_MESSAGE_START(lOgLeVeL, pRoTo, cOnTeXt, ...)               \
   do {                                                                    \
     log_message_start(NULL, lOgLeVeL, pRoTo, cOnTeXt, __FILE__, __LINE__, \
@@ -369,36 +406,38 @@ int log_get_start_time_sec(void);
     OAI_GCC_DIAG_ON(pointer - sign);                                     \
   } while (0); /*!< \brief trace buffer content */
 #if DEBUG_IS_ON
-#define OAILOG_DEBUG(pRoTo, ...)                                     \
-  do {                                                               \
-    log_message(NULL, OAILOG_LEVEL_DEBUG, pRoTo, __FILE__, __LINE__, \
-                ##__VA_ARGS__);                                      \
-  } while (0) /*!< \brief debug informations */
+/*! \brief debug informations */
+#define OAILOG_DEBUG(pRoTo, ...) \
+  OAILOG_SITE(OAILOG_LEVEL_DEBUG, pRoTo, ##__VA_ARGS__)
 #if TRACE_IS_ON
-#define OAILOG_EXTERNAL(lOgLeVeL, pRoTo, ...)                              \
-  do {                                                                     \
-    log_message(NULL, lOgLeVeL, pRoTo, __FILE__, __LINE__, ##__VA_ARGS__); \
-  } while (0)
-#define OAILOG_TRACE(pRoTo, ...)                                     \
-  do {                                                               \
-    log_message(NULL, OAILOG_LEVEL_TRACE, pRoTo, __FILE__, __LINE__, \
-                ##__VA_ARGS__);                                      \
-  } while (0) /*!< \brief most detailled informations, struct dumps */
-#define OAILOG_FUNC_IN(pRoTo)                                \
-  do {                                                       \
-    log_func(true, pRoTo, __FILE__, __LINE__, __FUNCTION__); \
+#define OAILOG_EXTERNAL(lOgLeVeL, pRoTo, ...) \
+  OAILOG_SITE(lOgLeVeL, pRoTo, ##__VA_ARGS__)
+/*! \brief most detailled informations, struct dumps */
+#define OAILOG_TRACE(pRoTo, ...) \
+  OAILOG_SITE(OAILOG_LEVEL_TRACE, pRoTo, ##__VA_ARGS__)
+#if !LOG_OAI_FUNC_ELIDE
+#define OAILOG_FUNC_IN(pRoTo)                              \
+  do {                                                     \
+    static log_site_t _log_site_ = LOG_SITE_INITIALIZER;   \
+    if (log_is_enabled(OAILOG_LEVEL_TRACE, pRoTo))         \
+      log_func(&_log_site_, true, pRoTo, __FUNCTION__);    \
   } while (0) /*!< \brief informational */
-#define OAILOG_FUNC_OUT(pRoTo)                                \
-  do {                                                        \
-    log_func(false, pRoTo, __FILE__, __LINE__, __FUNCTION__); \
-    return;                                                   \
+#define OAILOG_FUNC_OUT(pRoTo)                             \
+  do {                                                     \
+    static log_site_t _log_site_ = LOG_SITE_INITIALIZER;   \
+    if (log_is_enabled(OAILOG_LEVEL_TRACE, pRoTo))         \
+      log_func(&_log_site_, false, pRoTo, __FUNCTION__);   \
+    return;                                                \
   } while (0) /*!< \brief informational */
-#define OAILOG_FUNC_RETURN(pRoTo, rEtUrNcOdE)                \
-  do {                                                       \
-    log_func_return(pRoTo, __FILE__, __LINE__, __FUNCTION__, \
-                    (long)rEtUrNcOdE);                       \
-    return rEtUrNcOdE;                                       \
+#define OAILOG_FUNC_RETURN(pRoTo, rEtUrNcOdE)                     \
+  do {                                                            \
+    static log_site_t _log_site_ = LOG_SITE_INITIALIZER;          \
+    if (log_is_enabled(OAILOG_LEVEL_TRACE, pRoTo))                \
+      log_func_return(&_log_site_, pRoTo, __FUNCTION__,           \
+                      (long)rEtUrNcOdE);                          \
+    return rEtUrNcOdE;                                            \
   } while (0) /*!< \brief informational */
+#endif /* !LOG_OAI_FUNC_ELIDE */
 #define OAILOG_STREAM_HEX_ARRAY(pRoTo, mEsSaGe, sTrEaM, sIzE)           \
   do {                                                                  \
     log_stream_hex_array(OAILOG_LEVEL_TRACE, pRoTo, __FILE__, __LINE__, \
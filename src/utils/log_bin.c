@@ -0,0 +1,640 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file log_bin.c
+   \brief Deferred logging: per thread rings of raw log arguments, formatting
+   and binary output of the records.
+*/
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "bstrlib.h"
+
+#include "log.h"
+#include "log_bin.h"
+
+#define LOG_BIN_RING_MASK (LOG_BIN_RING_SIZE - 1)
+#define LOG_BIN_RECORD_ALIGN 16
+#define LOG_BIN_SITES_PER_CHUNK 1024
+// 2 '*' ints + a long double
+#define LOG_BIN_MAX_FIXED_ARG_SIZE (2 * sizeof(int) + sizeof(long double))
+#define LOG_BIN_MAX_SPEC_LENGTH 32
+#define LOG_BIN_NULL_STRING UINT16_MAX
+#define LOG_BIN_CALIBRATION_MIN_NS 10000000
+
+/*! \struct  log_bin_t
+ * \brief Sites and rings registries, timestamp calibration.
+ */
+typedef struct log_bin_s {
+  pthread_mutex_t mutex; /*!< \brief sites and rings registration */
+  log_site_t** sites[LOG_BIN_MAX_SITES / LOG_BIN_SITES_PER_CHUNK];
+  uint32_t num_sites;
+  log_bin_ring_t* rings;
+  uint64_t tsc_start;
+  struct timespec monotonic_start;
+  struct timeval real_start;
+  double ticks_per_ns;
+} log_bin_t;
+
+static log_bin_t g_log_bin = {.mutex = PTHREAD_MUTEX_INITIALIZER,
+                              .ticks_per_ns = 1.0};
+
+static __thread log_bin_ring_t* t_log_bin_ring = NULL;
+
+//------------------------------------------------------------------------------
+static inline uint64_t log_bin_timestamp(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+//------------------------------------------------------------------------------
+int log_bin_parse_format(const char* format, log_bin_spec_t* specs,
+                         int max_specs) {
+  const char* p = format;
+  int num_specs = 0;
+
+  while ((p = strchr(p, '%'))) {
+    log_bin_spec_t* spec = &specs[num_specs];
+    const char* start = p++;
+    int length_modifier = 0;  // number of 'l', -1 for 'L'
+
+    if (num_specs == max_specs) {
+      return -1;
+    }
+    memset(spec, 0, sizeof(*spec));
+    spec->precision = -1;
+    spec->offset = start - format;
+    while ((*p) && (strchr("-+ #0'", *p))) p++;
+    if ('*' == *p) {
+      spec->num_stars++;
+      p++;
+    } else {
+      while ((*p >= '0') && (*p <= '9')) p++;
+    }
+    if ('.' == *p) {
+      p++;
+      if ('*' == *p) {
+        spec->num_stars++;
+        spec->is_star_precision = true;
+        p++;
+      } else {
+        spec->precision = 0;
+        while ((*p >= '0') && (*p <= '9')) {
+          spec->precision = spec->precision * 10 + (*p - '0');
+          p++;
+        }
+      }
+    }
+    while ((*p) && (strchr("hlLqjzt", *p))) {
+      if ('l' == *p) {
+        length_modifier++;
+      } else if (('L' == *p) || ('q' == *p)) {
+        length_modifier = ('L' == *p) ? -1 : 2;
+      } else if (('j' == *p) || ('z' == *p) || ('t' == *p)) {
+        length_modifier = 1;  // same size as long on LP64 and ILP32
+      }
+      p++;
+    }
+    switch (*p) {
+      case '%':
+        spec->kind = LOG_BIN_ARG_NONE;
+        break;
+      case 'd':
+      case 'i':
+      case 'o':
+      case 'u':
+      case 'x':
+      case 'X':
+        spec->kind = (length_modifier >= 2)
+                         ? LOG_BIN_ARG_LLONG
+                         : (length_modifier == 1) ? LOG_BIN_ARG_LONG
+                                                  : LOG_BIN_ARG_INT;
+        break;
+      case 'c':
+        spec->kind = (length_modifier) ? LOG_BIN_ARG_UNSUPPORTED
+                                       : LOG_BIN_ARG_INT;
+        break;
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        spec->kind = (length_modifier < 0) ? LOG_BIN_ARG_LDOUBLE
+                                           : LOG_BIN_ARG_DOUBLE;
+        break;
+      case 'p':
+        spec->kind = LOG_BIN_ARG_PTR;
+        break;
+      case 's':
+        spec->kind = (length_modifier) ? LOG_BIN_ARG_UNSUPPORTED
+                                       : LOG_BIN_ARG_STR;
+        break;
+      default:  // 'n', 'm', end of string, ...
+        spec->kind = LOG_BIN_ARG_UNSUPPORTED;
+        break;
+    }
+    if (*p) p++;
+    spec->length = p - start;
+    if ((LOG_BIN_ARG_UNSUPPORTED != spec->kind) &&
+        (spec->length >= LOG_BIN_MAX_SPEC_LENGTH)) {
+      spec->kind = LOG_BIN_ARG_UNSUPPORTED;
+    }
+    num_specs++;
+  }
+  return num_specs;
+}
+
+//------------------------------------------------------------------------------
+bool log_bin_register_site(log_site_t* site, const char* format) {
+  log_bin_spec_t specs[LOG_BIN_MAX_SPECS];
+
+  if (__atomic_load_n(&site->id, __ATOMIC_ACQUIRE)) {
+    return (!site->is_text_only) && (format == site->format);
+  }
+  pthread_mutex_lock(&g_log_bin.mutex);
+  if (!site->id) {
+    int num_specs = log_bin_parse_format(format, specs, LOG_BIN_MAX_SPECS);
+    uint32_t id = g_log_bin.num_sites + 1;
+    uint32_t chunk = id / LOG_BIN_SITES_PER_CHUNK;
+
+    site->format = format;
+    site->is_text_only = (num_specs < 0);
+    for (int i = 0; i < num_specs; i++) {
+      if (LOG_BIN_ARG_UNSUPPORTED == specs[i].kind) {
+        site->is_text_only = true;
+      }
+    }
+    if ((!site->is_text_only) && (num_specs)) {
+      site->specs = malloc(num_specs * sizeof(log_bin_spec_t));
+      if (site->specs) {
+        memcpy(site->specs, specs, num_specs * sizeof(log_bin_spec_t));
+        site->num_specs = num_specs;
+      } else {
+        site->is_text_only = true;
+      }
+    }
+    if ((id < LOG_BIN_MAX_SITES) && (!g_log_bin.sites[chunk])) {
+      g_log_bin.sites[chunk] =
+          calloc(LOG_BIN_SITES_PER_CHUNK, sizeof(log_site_t*));
+    }
+    if ((id < LOG_BIN_MAX_SITES) && (g_log_bin.sites[chunk])) {
+      g_log_bin.sites[chunk][id % LOG_BIN_SITES_PER_CHUNK] = site;
+      __atomic_store_n(&g_log_bin.num_sites, id, __ATOMIC_RELEASE);
+    } else {
+      id = LOG_BIN_INVALID_SITE_ID;
+      site->is_text_only = true;
+    }
+    __atomic_store_n(&site->id, id, __ATOMIC_RELEASE);
+  }
+  pthread_mutex_unlock(&g_log_bin.mutex);
+  return (!site->is_text_only) && (format == site->format);
+}
+
+//------------------------------------------------------------------------------
+log_site_t* log_bin_get_site(uint32_t site_id) {
+  if ((!site_id) ||
+      (site_id > __atomic_load_n(&g_log_bin.num_sites, __ATOMIC_ACQUIRE))) {
+    return NULL;
+  }
+  return g_log_bin.sites[site_id / LOG_BIN_SITES_PER_CHUNK]
+                        [site_id % LOG_BIN_SITES_PER_CHUNK];
+}
+
+//------------------------------------------------------------------------------
+uint32_t log_bin_get_num_sites(void) {
+  return __atomic_load_n(&g_log_bin.num_sites, __ATOMIC_ACQUIRE);
+}
+
+//------------------------------------------------------------------------------
+static log_bin_ring_t* log_bin_ring_create(void) {
+  log_bin_ring_t* ring = NULL;
+
+  if (posix_memalign((void**)&ring, 64, sizeof(log_bin_ring_t))) {
+    return NULL;
+  }
+  memset(ring, 0, sizeof(*ring));
+  if (posix_memalign((void**)&ring->buffer, 64, LOG_BIN_RING_SIZE)) {
+    free(ring);
+    return NULL;
+  }
+  ring->tid = pthread_self();
+  pthread_mutex_lock(&g_log_bin.mutex);
+  ring->next = g_log_bin.rings;
+  __atomic_store_n(&g_log_bin.rings, ring, __ATOMIC_RELEASE);
+  pthread_mutex_unlock(&g_log_bin.mutex);
+  t_log_bin_ring = ring;
+  return ring;
+}
+
+//------------------------------------------------------------------------------
+void log_bin_message(const log_site_t* site, const log_level_t log_level,
+                     const log_proto_t proto, va_list args) {
+  uint8_t buffer[sizeof(log_bin_record_t) + LOG_BIN_MAX_ARGS_SIZE]
+      __attribute__((aligned(LOG_BIN_RECORD_ALIGN)));
+  log_bin_record_t* record = (log_bin_record_t*)buffer;
+  uint8_t* p = buffer + sizeof(log_bin_record_t);
+  uint8_t* const end = buffer + sizeof(buffer);
+  log_bin_ring_t* ring = t_log_bin_ring;
+
+  record->tsc = log_bin_timestamp();
+  for (int i = 0; i < site->num_specs; i++) {
+    const log_bin_spec_t* spec = &site->specs[i];
+    int precision = spec->precision;
+
+    for (int star = 0; star < spec->num_stars; star++) {
+      int value = va_arg(args, int);
+      if ((spec->is_star_precision) && (star == spec->num_stars - 1)) {
+        precision = value;
+      }
+      memcpy(p, &value, sizeof(value));
+      p += sizeof(value);
+    }
+    switch (spec->kind) {
+      case LOG_BIN_ARG_INT: {
+        int value = va_arg(args, int);
+        memcpy(p, &value, sizeof(value));
+        p += sizeof(value);
+      } break;
+      case LOG_BIN_ARG_LONG: {
+        int64_t value = va_arg(args, long);
+        memcpy(p, &value, sizeof(value));
+        p += sizeof(value);
+      } break;
+      case LOG_BIN_ARG_LLONG: {
+        int64_t value = va_arg(args, long long);
+        memcpy(p, &value, sizeof(value));
+        p += sizeof(value);
+      } break;
+      case LOG_BIN_ARG_DOUBLE: {
+        double value = va_arg(args, double);
+        memcpy(p, &value, sizeof(value));
+        p += sizeof(value);
+      } break;
+      case LOG_BIN_ARG_LDOUBLE: {
+        long double value = va_arg(args, long double);
+        memcpy(p, &value, sizeof(value));
+        p += sizeof(value);
+      } break;
+      case LOG_BIN_ARG_PTR: {
+        uint64_t value = (uintptr_t)va_arg(args, void*);
+        memcpy(p, &value, sizeof(value));
+        p += sizeof(value);
+      } break;
+      case LOG_BIN_ARG_STR: {
+        const char* value = va_arg(args, const char*);
+        // Keep room for the fixed size arguments left
+        size_t room = (end - p) - sizeof(uint16_t) -
+                      (site->num_specs - i - 1) * LOG_BIN_MAX_FIXED_ARG_SIZE;
+        size_t max_length = LOG_BIN_MAX_STRING_LENGTH;
+        uint16_t length = LOG_BIN_NULL_STRING;
+
+        if ((precision >= 0) && ((size_t)precision < max_length)) {
+          max_length = precision;
+        }
+        if (room < max_length) {
+          max_length = room;
+        }
+        if (value) {
+          length = strnlen(value, max_length);
+        }
+        memcpy(p, &length, sizeof(length));
+        p += sizeof(length);
+        if (value) {
+          memcpy(p, value, length);
+          p += length;
+        }
+      } break;
+      default:
+        break;
+    }
+  }
+
+  if ((!ring) && (!(ring = log_bin_ring_create()))) {
+    return;
+  }
+  size_t length = p - buffer;
+  uint64_t size = (length + LOG_BIN_RECORD_ALIGN - 1) &
+                  ~((uint64_t)LOG_BIN_RECORD_ALIGN - 1);
+  uint64_t head = ring->head;
+  uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+  uint64_t contiguous = LOG_BIN_RING_SIZE - (head & LOG_BIN_RING_MASK);
+  uint64_t needed = (contiguous < size) ? contiguous + size : size;
+
+  if (LOG_BIN_RING_SIZE - (head - tail) < needed) {
+    __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+    return;
+  }
+  if (contiguous < size) {
+    // Records are contiguous, skip the end of the ring
+    log_bin_record_t* padding =
+        (log_bin_record_t*)&ring->buffer[head & LOG_BIN_RING_MASK];
+    padding->size = contiguous;
+    padding->site_id = 0;
+    head += contiguous;
+  }
+  record->size = size;
+  record->level = log_level;
+  record->proto = proto;
+  record->site_id = site->id;
+  memcpy(&ring->buffer[head & LOG_BIN_RING_MASK], buffer, length);
+  __atomic_store_n(&ring->head, head + size, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+static void log_bin_calibrate(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  struct timespec now;
+  uint64_t tsc = log_bin_timestamp();
+  int64_t elapsed_ns = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  elapsed_ns =
+      (int64_t)(now.tv_sec - g_log_bin.monotonic_start.tv_sec) * 1000000000 +
+      (now.tv_nsec - g_log_bin.monotonic_start.tv_nsec);
+  if (elapsed_ns > LOG_BIN_CALIBRATION_MIN_NS) {
+    g_log_bin.ticks_per_ns =
+        (double)(tsc - g_log_bin.tsc_start) / (double)elapsed_ns;
+  }
+#endif
+}
+
+//------------------------------------------------------------------------------
+void log_bin_drain(log_bin_record_cb_t cb, void* cb_arg) {
+  log_bin_calibrate();
+  for (log_bin_ring_t* ring =
+           __atomic_load_n(&g_log_bin.rings, __ATOMIC_ACQUIRE);
+       ring; ring = ring->next) {
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t tail = ring->tail;
+
+    while (tail < head) {
+      const log_bin_record_t* record =
+          (log_bin_record_t*)&ring->buffer[tail & LOG_BIN_RING_MASK];
+      if (record->site_id) {
+        const log_site_t* site = log_bin_get_site(record->site_id);
+        if (site) {
+          (*cb)(cb_arg, ring, record, site,
+                (const uint8_t*)record + sizeof(log_bin_record_t),
+                record->size - sizeof(log_bin_record_t));
+        }
+      }
+      tail += record->size;
+    }
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+  }
+}
+
+//------------------------------------------------------------------------------
+void log_bin_get_time(uint64_t tsc, struct timeval* tv) {
+  uint64_t elapsed_us =
+      (uint64_t)((double)(tsc - g_log_bin.tsc_start) / g_log_bin.ticks_per_ns /
+                 1000);
+
+  tv->tv_sec = g_log_bin.real_start.tv_sec + elapsed_us / 1000000;
+  tv->tv_usec = g_log_bin.real_start.tv_usec + elapsed_us % 1000000;
+  if (tv->tv_usec >= 1000000) {
+    tv->tv_sec++;
+    tv->tv_usec -= 1000000;
+  }
+}
+
+//------------------------------------------------------------------------------
+#define LOG_BIN_GET(vAlUe)                              \
+  do {                                                  \
+    if (p + sizeof(vAlUe) > end) goto truncated;        \
+    memcpy(&(vAlUe), p, sizeof(vAlUe));                 \
+    p += sizeof(vAlUe);                                 \
+  } while (0)
+
+#define LOG_BIN_FORMATA(vAlUe)                                          \
+  ((0 == spec->num_stars)                                               \
+       ? bformata(b, spec_format, vAlUe)                                \
+       : (1 == spec->num_stars)                                         \
+             ? bformata(b, spec_format, stars[0], vAlUe)                \
+             : bformata(b, spec_format, stars[0], stars[1], vAlUe))
+
+int log_bin_format(bstring b, const char* format, const uint8_t* args,
+                   size_t args_length) {
+  log_bin_spec_t specs[LOG_BIN_MAX_SPECS];
+  const uint8_t* p = args;
+  const uint8_t* const end = args + args_length;
+  const char* literal = format;
+  int num_specs = log_bin_parse_format(format, specs, LOG_BIN_MAX_SPECS);
+
+  for (int i = 0; i < num_specs; i++) {
+    const log_bin_spec_t* spec = &specs[i];
+    char spec_format[LOG_BIN_MAX_SPEC_LENGTH];
+    int stars[2] = {0};
+
+    bcatblk(b, literal, (format + spec->offset) - literal);
+    literal = format + spec->offset + spec->length;
+    if (LOG_BIN_ARG_NONE == spec->kind) {
+      bconchar(b, '%');
+      continue;
+    }
+    memcpy(spec_format, format + spec->offset, spec->length);
+    spec_format[spec->length] = '\0';
+    for (int star = 0; star < spec->num_stars; star++) {
+      LOG_BIN_GET(stars[star]);
+    }
+    switch (spec->kind) {
+      case LOG_BIN_ARG_INT: {
+        int value = 0;
+        LOG_BIN_GET(value);
+        LOG_BIN_FORMATA(value);
+      } break;
+      case LOG_BIN_ARG_LONG: {
+        int64_t value = 0;
+        LOG_BIN_GET(value);
+        LOG_BIN_FORMATA((long)value);
+      } break;
+      case LOG_BIN_ARG_LLONG: {
+        int64_t value = 0;
+        LOG_BIN_GET(value);
+        LOG_BIN_FORMATA((long long)value);
+      } break;
+      case LOG_BIN_ARG_DOUBLE: {
+        double value = 0;
+        LOG_BIN_GET(value);
+        LOG_BIN_FORMATA(value);
+      } break;
+      case LOG_BIN_ARG_LDOUBLE: {
+        long double value = 0;
+        LOG_BIN_GET(value);
+        LOG_BIN_FORMATA(value);
+      } break;
+      case LOG_BIN_ARG_PTR: {
+        uint64_t value = 0;
+        LOG_BIN_GET(value);
+        LOG_BIN_FORMATA((void*)(uintptr_t)value);
+      } break;
+      case LOG_BIN_ARG_STR: {
+        char value[LOG_BIN_MAX_STRING_LENGTH + 1];
+        uint16_t length = 0;
+        LOG_BIN_GET(length);
+        if (LOG_BIN_NULL_STRING == length) {
+          LOG_BIN_FORMATA((char*)NULL);
+        } else {
+          if ((length > LOG_BIN_MAX_STRING_LENGTH) || (p + length > end)) {
+            goto truncated;
+          }
+          memcpy(value, p, length);
+          value[length] = '\0';
+          p += length;
+          LOG_BIN_FORMATA(value);
+        }
+      } break;
+      default:
+        goto truncated;
+    }
+  }
+  return bcatcstr(b, literal);
+
+truncated:
+  bcatcstr(b, "<truncated log arguments>\n");
+  return BSTR_ERR;
+}
+
+//------------------------------------------------------------------------------
+#define LOG_BIN_PUT(fP, vAlUe)                          \
+  do {                                                  \
+    if (1 != fwrite(&(vAlUe), sizeof(vAlUe), 1, fP)) {  \
+      return -1;                                        \
+    }                                                   \
+  } while (0)
+
+int log_bin_write_header(FILE* fp, int64_t start_time_sec) {
+  if (1 != fwrite(LOG_BIN_FILE_MAGIC, strlen(LOG_BIN_FILE_MAGIC), 1, fp)) {
+    return -1;
+  }
+  LOG_BIN_PUT(fp, start_time_sec);
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+int log_bin_write_name(FILE* fp, uint8_t kind, uint8_t index,
+                       const char* name) {
+  uint8_t type = LOG_BIN_RECORD_NAME;
+  uint8_t length = strnlen(name, UINT8_MAX);
+
+  LOG_BIN_PUT(fp, type);
+  LOG_BIN_PUT(fp, kind);
+  LOG_BIN_PUT(fp, index);
+  LOG_BIN_PUT(fp, length);
+  if ((length) && (1 != fwrite(name, length, 1, fp))) {
+    return -1;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+int log_bin_write_site(FILE* fp, const log_site_t* site) {
+  uint8_t type = LOG_BIN_RECORD_SITE;
+  uint16_t file_length = strnlen(site->file, UINT16_MAX);
+  uint16_t format_length = strnlen(site->format, UINT16_MAX);
+
+  LOG_BIN_PUT(fp, type);
+  LOG_BIN_PUT(fp, site->id);
+  LOG_BIN_PUT(fp, site->line);
+  LOG_BIN_PUT(fp, file_length);
+  LOG_BIN_PUT(fp, format_length);
+  if ((1 != fwrite(site->file, file_length, 1, fp)) ||
+      ((format_length) && (1 != fwrite(site->format, format_length, 1, fp)))) {
+    return -1;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+int log_bin_write_message(FILE* fp, const log_bin_ring_t* ring,
+                          const log_bin_record_t* record,
+                          const uint8_t* args, size_t args_length) {
+  uint8_t type = LOG_BIN_RECORD_MESSAGE;
+  uint64_t tid = (uint64_t)ring->tid;
+  uint16_t length = args_length;
+  struct timeval tv;
+  int64_t sec = 0;
+  int32_t usec = 0;
+
+  log_bin_get_time(record->tsc, &tv);
+  sec = tv.tv_sec;
+  usec = tv.tv_usec;
+  LOG_BIN_PUT(fp, type);
+  LOG_BIN_PUT(fp, record->level);
+  LOG_BIN_PUT(fp, record->proto);
+  LOG_BIN_PUT(fp, record->site_id);
+  LOG_BIN_PUT(fp, tid);
+  LOG_BIN_PUT(fp, sec);
+  LOG_BIN_PUT(fp, usec);
+  LOG_BIN_PUT(fp, length);
+  if ((length) && (1 != fwrite(args, length, 1, fp))) {
+    return -1;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+int log_bin_write_text(FILE* fp, const char* text, size_t text_length) {
+  uint8_t type = LOG_BIN_RECORD_TEXT;
+  uint32_t length = text_length;
+
+  LOG_BIN_PUT(fp, type);
+  LOG_BIN_PUT(fp, length);
+  if ((length) && (1 != fwrite(text, length, 1, fp))) {
+    return -1;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+void log_bin_init(void) {
+  g_log_bin.tsc_start = log_bin_timestamp();
+  clock_gettime(CLOCK_MONOTONIC, &g_log_bin.monotonic_start);
+  gettimeofday(&g_log_bin.real_start, NULL);
+}
+
+//------------------------------------------------------------------------------
+// Rings and sites of the logging threads are kept until the end of the process
+void log_bin_exit(void) {
+  log_bin_ring_t* ring = NULL;
+
+  pthread_mutex_lock(&g_log_bin.mutex);
+  while ((ring = g_log_bin.rings)) {
+    g_log_bin.rings = ring->next;
+    free(ring->buffer);
+    free(ring);
+  }
+  pthread_mutex_unlock(&g_log_bin.mutex);
+}
@@ -0,0 +1,150 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file log_bin.h
+   \brief Deferred logging: the logging thread only copies the raw arguments of
+   a log call in a per thread ring, the formatting is done later by the shared
+   log task or offline (binary output) by oai_log_decoder.
+*/
+
+#ifndef FILE_LOG_BIN_SEEN
+#define FILE_LOG_BIN_SEEN
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+#include "bstrlib.h"
+#include "log.h"
+
+#define LOG_BIN_RING_SIZE (1 << 20)  // per thread, power of 2
+#define LOG_BIN_MAX_ARGS_SIZE 2048   // raw arguments of one log call
+#define LOG_BIN_MAX_STRING_LENGTH 512
+#define LOG_BIN_MAX_SPECS 32  // conversion specifications per format
+#define LOG_BIN_MAX_SITES (64 * 1024)
+#define LOG_BIN_INVALID_SITE_ID UINT32_MAX
+
+#define LOG_BIN_FILE_MAGIC "OAILOGB1"
+#define LOG_BIN_RECORD_NAME 'N'
+#define LOG_BIN_RECORD_SITE 'S'
+#define LOG_BIN_RECORD_MESSAGE 'M'
+#define LOG_BIN_RECORD_TEXT 'T'  // already formatted, from a text only site
+
+#define LOG_BIN_NAME_LEVEL 0
+#define LOG_BIN_NAME_PROTO 1
+
+typedef enum {
+  LOG_BIN_ARG_NONE = 0,  // "%%"
+  LOG_BIN_ARG_INT,
+  LOG_BIN_ARG_LONG,
+  LOG_BIN_ARG_LLONG,
+  LOG_BIN_ARG_DOUBLE,
+  LOG_BIN_ARG_LDOUBLE,
+  LOG_BIN_ARG_PTR,
+  LOG_BIN_ARG_STR,
+  LOG_BIN_ARG_UNSUPPORTED,  // %n, %m, wide chars: formatted by the caller
+} log_bin_arg_kind_t;
+
+/*! \struct  log_bin_spec_t
+ * \brief One conversion specification of a format string.
+ */
+typedef struct log_bin_spec_s {
+  uint8_t kind;           /*!< \brief log_bin_arg_kind_t */
+  uint8_t num_stars;      /*!< \brief '*' width and/or precision int args */
+  bool is_star_precision; /*!< \brief last '*' is the precision */
+  int16_t precision;      /*!< \brief -1 if not set in the format */
+  uint16_t offset;        /*!< \brief of the '%' in the format */
+  uint16_t length;        /*!< \brief of the whole specification */
+} log_bin_spec_t;
+
+/*! \struct  log_bin_record_t
+ * \brief Header of a log call in a thread ring, followed by the raw arguments.
+ */
+typedef struct log_bin_record_s {
+  uint16_t size;    /*!< \brief with header, padded, 0 site_id means skip */
+  uint8_t level;    /*!< \brief log_level_t */
+  uint8_t proto;    /*!< \brief log_proto_t */
+  uint32_t site_id; /*!< \brief log_site_t id */
+  uint64_t tsc;     /*!< \brief log_bin_timestamp() */
+} log_bin_record_t;
+
+/*! \struct  log_bin_ring_t
+ * \brief Single producer (logging thread) single consumer ring.
+ */
+typedef struct log_bin_ring_s {
+  uint64_t head __attribute__((aligned(64))); /*!< \brief written by producer */
+  uint64_t dropped;                           /*!< \brief ring full */
+  uint64_t tail __attribute__((aligned(64))); /*!< \brief written by consumer */
+  uint64_t dropped_reported;
+  pthread_t tid;
+  struct log_bin_ring_s* next;
+  uint8_t* buffer;
+} log_bin_ring_t;
+
+typedef void (*log_bin_record_cb_t)(void* cb_arg, const log_bin_ring_t* ring,
+                                    const log_bin_record_t* record,
+                                    const log_site_t* site,
+                                    const uint8_t* args, size_t args_length);
+
+/*
+ * Parse the conversion specifications of format, returns the number of
+ * specifications or -1 if there are more than max_specs.
+ */
+int log_bin_parse_format(const char* format, log_bin_spec_t* specs,
+                         int max_specs);
+
+/*
+ * Register the site with its format on first use, returns false if the
+ * arguments of this site can't be deferred (the caller formats them).
+ */
+bool log_bin_register_site(log_site_t* site, const char* format);
+
+log_site_t* log_bin_get_site(uint32_t site_id);
+
+uint32_t log_bin_get_num_sites(void);
+
+// Copy the raw arguments in the ring of the calling thread
+void log_bin_message(const log_site_t* site, const log_level_t log_level,
+                     const log_proto_t proto, va_list args)
+    __attribute__((hot));
+
+// Single consumer, pops all the records of all the thread rings
+void log_bin_drain(log_bin_record_cb_t cb, void* cb_arg);
+
+// Convert a record timestamp into wall clock time
+void log_bin_get_time(uint64_t tsc, struct timeval* tv);
+
+int log_bin_format(bstring b, const char* format, const uint8_t* args,
+                   size_t args_length);
+
+// Binary output, records are stored in host byte order
+int log_bin_write_header(FILE* fp, int64_t start_time_sec);
+int log_bin_write_name(FILE* fp, uint8_t kind, uint8_t index,
+                       const char* name);
+int log_bin_write_site(FILE* fp, const log_site_t* site);
+int log_bin_write_message(FILE* fp, const log_bin_ring_t* ring,
+                          const log_bin_record_t* record,
+                          const uint8_t* args, size_t args_length);
+int log_bin_write_text(FILE* fp, const char* text, size_t text_length);
+
+void log_bin_init(void);
+void log_bin_exit(void);
+
+#endif /* FILE_LOG_BIN_SEEN */
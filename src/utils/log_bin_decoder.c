@@ -0,0 +1,246 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file log_bin_decoder.c
+   \brief Render as text a binary log (LOGGING.DEFERRED = "binary").
+   Usage: oai_log_decoder [binary log file], reads stdin by default.
+   Must run on a host with the same byte order as the MME.
+*/
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bstrlib.h"
+
+#include "log.h"
+#include "log_bin.h"
+
+#define LOG_DISPLAYED_FILENAME_MAX_LENGTH 32
+#define LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH 5
+#define LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH 6
+#define LOG_BIN_DECODER_MAX_NAMES 256
+
+typedef struct log_bin_decoder_s {
+  FILE* fp;
+  int64_t start_time_sec;
+  uint64_t message_number;
+  char* names[2][LOG_BIN_DECODER_MAX_NAMES];
+  log_site_t** sites;
+  uint32_t max_sites;
+  bstring bstr;
+} log_bin_decoder_t;
+
+#define LOG_BIN_READ(dEcOdEr, vAlUe)                           \
+  do {                                                         \
+    if (1 != fread(&(vAlUe), sizeof(vAlUe), 1, (dEcOdEr)->fp)) \
+      return -1;                                               \
+  } while (0)
+
+//------------------------------------------------------------------------------
+static char* log_bin_read_string(log_bin_decoder_t* decoder, size_t length) {
+  char* string = calloc(1, length + 1);
+
+  if ((string) && (length) && (1 != fread(string, length, 1, decoder->fp))) {
+    free(string);
+    return NULL;
+  }
+  return string;
+}
+
+//------------------------------------------------------------------------------
+static int log_bin_read_name(log_bin_decoder_t* decoder) {
+  uint8_t kind = 0;
+  uint8_t index = 0;
+  uint8_t length = 0;
+  char* name = NULL;
+
+  LOG_BIN_READ(decoder, kind);
+  LOG_BIN_READ(decoder, index);
+  LOG_BIN_READ(decoder, length);
+  if ((kind > LOG_BIN_NAME_PROTO) ||
+      (!(name = log_bin_read_string(decoder, length)))) {
+    return -1;
+  }
+  free(decoder->names[kind][index]);
+  decoder->names[kind][index] = name;
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+static int log_bin_read_site(log_bin_decoder_t* decoder) {
+  log_site_t* site = calloc(1, sizeof(log_site_t));
+  uint16_t file_length = 0;
+  uint16_t format_length = 0;
+
+  if (!site) {
+    return -1;
+  }
+  LOG_BIN_READ(decoder, site->id);
+  LOG_BIN_READ(decoder, site->line);
+  LOG_BIN_READ(decoder, file_length);
+  LOG_BIN_READ(decoder, format_length);
+  if ((!(site->file = log_bin_read_string(decoder, file_length))) ||
+      (!(site->format = log_bin_read_string(decoder, format_length))) ||
+      (LOG_BIN_INVALID_SITE_ID == site->id)) {
+    return -1;
+  }
+  if (site->id >= decoder->max_sites) {
+    uint32_t max_sites = site->id + LOG_BIN_DECODER_MAX_NAMES;
+    log_site_t** sites = realloc(decoder->sites, max_sites * sizeof(*sites));
+    if (!sites) {
+      return -1;
+    }
+    memset(&sites[decoder->max_sites], 0,
+           (max_sites - decoder->max_sites) * sizeof(*sites));
+    decoder->sites = sites;
+    decoder->max_sites = max_sites;
+  }
+  decoder->sites[site->id] = site;
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+static const char* log_bin_name(log_bin_decoder_t* decoder, uint8_t kind,
+                                uint8_t index) {
+  return (decoder->names[kind][index]) ? decoder->names[kind][index] : "?";
+}
+
+//------------------------------------------------------------------------------
+static int log_bin_read_message(log_bin_decoder_t* decoder) {
+  uint8_t args[UINT16_MAX];
+  uint8_t level = 0;
+  uint8_t proto = 0;
+  uint32_t site_id = 0;
+  uint64_t tid = 0;
+  int64_t sec = 0;
+  int32_t usec = 0;
+  uint16_t length = 0;
+  log_site_t* site = NULL;
+  const char* file = NULL;
+  int file_length = 0;
+
+  LOG_BIN_READ(decoder, level);
+  LOG_BIN_READ(decoder, proto);
+  LOG_BIN_READ(decoder, site_id);
+  LOG_BIN_READ(decoder, tid);
+  LOG_BIN_READ(decoder, sec);
+  LOG_BIN_READ(decoder, usec);
+  LOG_BIN_READ(decoder, length);
+  if ((length) && (1 != fread(args, length, 1, decoder->fp))) {
+    return -1;
+  }
+  if ((site_id >= decoder->max_sites) || (!decoder->sites[site_id])) {
+    fprintf(stderr, "Unknown log site %u\n", site_id);
+    return 0;
+  }
+  site = decoder->sites[site_id];
+  file = site->file;
+  file_length = strlen(file);
+  if (file_length > LOG_DISPLAYED_FILENAME_MAX_LENGTH) {
+    file += file_length - LOG_DISPLAYED_FILENAME_MAX_LENGTH;
+  }
+  btrunc(decoder->bstr, 0);
+  bformata(decoder->bstr,
+           "%06" PRIu64 " %05" PRId64 ":%06" PRId32 " %08" PRIX64
+           " %-*.*s %-*.*s %-*.*s:%04u    ",
+           decoder->message_number++, sec - decoder->start_time_sec, usec,
+           tid, LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
+           LOG_DISPLAYED_LOG_LEVEL_NAME_MAX_LENGTH,
+           log_bin_name(decoder, LOG_BIN_NAME_LEVEL, level),
+           LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
+           LOG_DISPLAYED_PROTO_NAME_MAX_LENGTH,
+           log_bin_name(decoder, LOG_BIN_NAME_PROTO, proto),
+           LOG_DISPLAYED_FILENAME_MAX_LENGTH, LOG_DISPLAYED_FILENAME_MAX_LENGTH,
+           file, site->line);
+  log_bin_format(decoder->bstr, site->format, args, length);
+  fwrite(decoder->bstr->data, blength(decoder->bstr), 1, stdout);
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Already formatted by the MME (text only sites, hex streams), copied as is
+static int log_bin_read_text(log_bin_decoder_t* decoder) {
+  uint32_t length = 0;
+  char* text = NULL;
+
+  LOG_BIN_READ(decoder, length);
+  if (!(text = log_bin_read_string(decoder, length))) {
+    return -1;
+  }
+  fwrite(text, length, 1, stdout);
+  free(text);
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+  log_bin_decoder_t decoder = {0};
+  char magic[sizeof(LOG_BIN_FILE_MAGIC)] = {0};
+  uint8_t type = 0;
+  int rc = 0;
+
+  decoder.fp = stdin;
+  if ((argc > 1) && (!(decoder.fp = fopen(argv[1], "rb")))) {
+    fprintf(stderr, "Could not open %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+  decoder.bstr = bfromcstralloc(256, "");
+  if ((1 != fread(magic, strlen(LOG_BIN_FILE_MAGIC), 1, decoder.fp)) ||
+      (strcmp(magic, LOG_BIN_FILE_MAGIC)) ||
+      (1 != fread(&decoder.start_time_sec, sizeof(decoder.start_time_sec), 1,
+                  decoder.fp))) {
+    fprintf(stderr, "Not a binary log\n");
+    return EXIT_FAILURE;
+  }
+  while ((!rc) && (1 == fread(&type, sizeof(type), 1, decoder.fp))) {
+    switch (type) {
+      case LOG_BIN_RECORD_NAME:
+        rc = log_bin_read_name(&decoder);
+        break;
+      case LOG_BIN_RECORD_SITE:
+        rc = log_bin_read_site(&decoder);
+        break;
+      case LOG_BIN_RECORD_MESSAGE:
+        rc = log_bin_read_message(&decoder);
+        break;
+      case LOG_BIN_RECORD_TEXT:
+        rc = log_bin_read_text(&decoder);
+        break;
+      default:
+        // Stream restarted (TCP reconnection)
+        magic[0] = type;
+        if ((1 != fread(magic + 1, strlen(LOG_BIN_FILE_MAGIC) - 1, 1,
+                        decoder.fp)) ||
+            (strcmp(magic, LOG_BIN_FILE_MAGIC)) ||
+            (1 != fread(&decoder.start_time_sec,
+                        sizeof(decoder.start_time_sec), 1, decoder.fp))) {
+          rc = -1;
+        }
+        break;
+    }
+  }
+  if (rc) {
+    fprintf(stderr, "Corrupted binary log\n");
+  }
+  bdestroy(decoder.bstr);
+  if (stdin != decoder.fp) {
+    fclose(decoder.fp);
+  }
+  return (rc) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -59,6 +59,7 @@
 #define SCTP_OUT_STREAMS (32)
 #define SCTP_IN_STREAMS (32)
 #define SCTP_MAX_ATTEMPTS (5)
+#define SCTP_RECEIVER_THREADS (1)
 
 /*******************************************************************************
  * MME global definitions
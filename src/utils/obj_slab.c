@@ -0,0 +1,187 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file obj_slab.c
+   \brief Pool of fixed size objects allocated by chunks.
+*/
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "bstrlib.h"
+
+#include "assertions.h"
+#include "dynamic_memory_check.h"
+#include "log.h"
+#include "obj_slab.h"
+
+#define OBJ_SLAB_ALIGN 64
+
+//------------------------------------------------------------------------------
+static obj_slab_chunk_t *obj_slab_map_chunk(obj_slab_t *const slab,
+                                            const uint32_t num_objects) {
+  obj_slab_chunk_t *chunk = calloc(1, sizeof(obj_slab_chunk_t));
+  size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+
+  if (!chunk) {
+    return NULL;
+  }
+  chunk->num_objects = num_objects;
+  chunk->size = slab->object_size * num_objects;
+  chunk->size = (chunk->size + page_size - 1) & ~(page_size - 1);
+  chunk->objects = mmap(NULL, chunk->size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (MAP_FAILED == chunk->objects) {
+    free_wrapper((void **)&chunk);
+    return NULL;
+  }
+#ifdef MADV_HUGEPAGE
+  // Large UE populations: fewer TLB misses when walking contexts
+  madvise(chunk->objects, chunk->size, MADV_HUGEPAGE);
+#endif
+  return chunk;
+}
+
+//------------------------------------------------------------------------------
+// Must be called with the slab mutex held
+static int obj_slab_grow(obj_slab_t *const slab) {
+  obj_slab_chunk_t *chunk = NULL;
+  uint32_t num_objects = slab->objects_per_chunk;
+  void **free_objects = NULL;
+
+  if (slab->max_objects) {
+    if (slab->num_objects >= slab->max_objects) {
+      return -1;
+    }
+    if (num_objects > slab->max_objects - slab->num_objects) {
+      num_objects = slab->max_objects - slab->num_objects;
+    }
+  }
+  free_objects = realloc(slab->free_objects,
+                         (slab->num_objects + num_objects) * sizeof(void *));
+  if (!free_objects) {
+    return -1;
+  }
+  slab->free_objects = free_objects;
+  if (!(chunk = obj_slab_map_chunk(slab, num_objects))) {
+    OAILOG_ERROR(LOG_UTIL, "Slab %s: failed to map %u objects\n",
+                 bdata(slab->name), num_objects);
+    return -1;
+  }
+  for (uint32_t i = 0; (slab->ctor) && (i < num_objects); i++) {
+    if (slab->ctor(chunk->objects + ((size_t)i * slab->object_size))) {
+      OAILOG_ERROR(LOG_UTIL, "Slab %s: failed to initialize object\n",
+                   bdata(slab->name));
+      while ((slab->dtor) && (i > 0)) {
+        i--;
+        slab->dtor(chunk->objects + ((size_t)i * slab->object_size));
+      }
+      munmap(chunk->objects, chunk->size);
+      free_wrapper((void **)&chunk);
+      return -1;
+    }
+  }
+  // Objects at the beginning of the chunk are allocated first
+  for (uint32_t i = num_objects; i > 0; i--) {
+    slab->free_objects[slab->num_free++] =
+        chunk->objects + ((size_t)(i - 1) * slab->object_size);
+  }
+  chunk->next = slab->chunks;
+  slab->chunks = chunk;
+  slab->num_objects += num_objects;
+  OAILOG_INFO(LOG_UTIL, "Slab %s: grown to %u objects\n", bdata(slab->name),
+              slab->num_objects);
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+obj_slab_t *obj_slab_create(const char *name, const size_t object_size,
+                            const uint32_t objects_per_chunk,
+                            const uint32_t max_objects,
+                            int (*ctor)(void *object),
+                            void (*dtor)(void *object)) {
+  obj_slab_t *slab = calloc(1, sizeof(obj_slab_t));
+
+  AssertFatal(objects_per_chunk, "Bad slab chunk size");
+  if (!slab) {
+    return NULL;
+  }
+  pthread_mutex_init(&slab->mutex, NULL);
+  slab->object_size =
+      (object_size + OBJ_SLAB_ALIGN - 1) & ~((size_t)OBJ_SLAB_ALIGN - 1);
+  slab->objects_per_chunk = objects_per_chunk;
+  slab->max_objects = max_objects;
+  slab->ctor = ctor;
+  slab->dtor = dtor;
+  slab->name = bfromcstr(name);
+  if (obj_slab_grow(slab)) {
+    obj_slab_destroy(&slab);
+    return NULL;
+  }
+  return slab;
+}
+
+//------------------------------------------------------------------------------
+void obj_slab_destroy(obj_slab_t **slab) {
+  obj_slab_chunk_t *chunk = NULL;
+
+  if ((!slab) || (!*slab)) {
+    return;
+  }
+  while ((chunk = (*slab)->chunks)) {
+    (*slab)->chunks = chunk->next;
+    if ((*slab)->dtor) {
+      for (uint32_t i = 0; i < chunk->num_objects; i++) {
+        (*slab)->dtor(chunk->objects + ((size_t)i * (*slab)->object_size));
+      }
+    }
+    munmap(chunk->objects, chunk->size);
+    free_wrapper((void **)&chunk);
+  }
+  if ((*slab)->free_objects) {
+    free_wrapper((void **)&(*slab)->free_objects);
+  }
+  bdestroy_wrapper(&(*slab)->name);
+  pthread_mutex_destroy(&(*slab)->mutex);
+  free_wrapper((void **)slab);
+}
+
+//------------------------------------------------------------------------------
+void *obj_slab_alloc(obj_slab_t *const slab) {
+  void *object = NULL;
+
+  pthread_mutex_lock(&slab->mutex);
+  if ((slab->num_free) || (!obj_slab_grow(slab))) {
+    object = slab->free_objects[--slab->num_free];
+    slab->num_used++;
+  }
+  pthread_mutex_unlock(&slab->mutex);
+  return object;
+}
+
+//------------------------------------------------------------------------------
+void obj_slab_free(obj_slab_t *const slab, void *object) {
+  pthread_mutex_lock(&slab->mutex);
+  DevAssert(slab->num_free < slab->num_objects);
+  slab->free_objects[slab->num_free++] = object;
+  slab->num_used--;
+  pthread_mutex_unlock(&slab->mutex);
+}
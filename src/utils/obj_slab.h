@@ -0,0 +1,77 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file obj_slab.h
+   \brief Pool of fixed size objects allocated by chunks.
+   Objects never move once allocated, chunks are only released with the slab.
+   The object constructor is called once, when the chunk holding the object
+   is allocated, so objects can keep their mutexes between allocations.
+*/
+
+#ifndef FILE_OBJ_SLAB_SEEN
+#define FILE_OBJ_SLAB_SEEN
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "bstrlib.h"
+
+typedef struct obj_slab_chunk_s {
+  struct obj_slab_chunk_s* next;
+  size_t size;  // mapped size
+  uint32_t num_objects;
+  uint8_t* objects;
+} obj_slab_chunk_t;
+
+typedef struct obj_slab_s {
+  pthread_mutex_t mutex;
+  size_t object_size;         // rounded up to a cache line
+  uint32_t objects_per_chunk;
+  uint32_t max_objects;       // 0 if unlimited
+  uint32_t num_objects;       // allocated by chunks
+  uint32_t num_used;
+  uint32_t num_free;
+  void** free_objects;        // stack of free objects, num_objects entries
+  obj_slab_chunk_t* chunks;
+  int (*ctor)(void* object);
+  void (*dtor)(void* object);
+  bstring name;
+} obj_slab_t;
+
+/*
+ * Create a slab of objects of object_size bytes. The first chunk is
+ * allocated immediately, next ones when the free objects are exhausted, up
+ * to max_objects (0: no limit). Chunks are backed by anonymous mappings,
+ * transparent huge pages are requested for them when available.
+ * ctor (optional) initializes an object when its chunk is allocated, it
+ * returns 0 on success. dtor (optional) is called on every object when the
+ * slab is destroyed.
+ */
+obj_slab_t* obj_slab_create(const char* name, const size_t object_size,
+                            const uint32_t objects_per_chunk,
+                            const uint32_t max_objects,
+                            int (*ctor)(void* object),
+                            void (*dtor)(void* object));
+
+void obj_slab_destroy(obj_slab_t** slab);
+
+// Returns NULL if max_objects are in use or if a new chunk can't be mapped
+void* obj_slab_alloc(obj_slab_t* const slab);
+
+void obj_slab_free(obj_slab_t* const slab, void* object);
+
+#endif /* FILE_OBJ_SLAB_SEEN */
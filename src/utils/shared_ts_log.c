@@ -180,6 +180,7 @@ void *shared_log_task(__attribute__((unused)) void *args_p) {
       switch (ITTI_MSG_ID(received_message_p)) {
         case TIMER_HAS_EXPIRED: {
           //    todo:    shared_log_flush_messages ();
+          log_flush_deferred_messages();
           timer_setup(LOG_FLUSH_PERIOD_SEC, LOG_FLUSH_PERIOD_MICRO_SEC,
                       TASK_SHARED_TS_LOG, INSTANCE_DEFAULT, TIMER_ONE_SHOT,
                       NULL, &timer_id);
@@ -351,6 +352,7 @@ static void shared_log_element_pop_cleanup_callback(
 //------------------------------------------------------------------------------
 void shared_log_exit(void) {
   OAI_FPRINTF_INFO("[TRACE] Entering %s\n", __FUNCTION__);
+  log_flush_deferred_messages();
   shared_log_flush_messages();
   hashtable_ts_destroy(g_shared_log.thread_context_htbl);
   lfds710_queue_bmm_cleanup(&g_shared_log.log_message_queue,